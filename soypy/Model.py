@@ -0,0 +1,76 @@
+"""A model of the MPS dialect of Soy, built from NumPy and SciPy arrays.
+
+    model = Model()
+    x = model.add_variables(lower, upper, steps=steps)
+    model.add_rows(A, "L", b)            # A x <= b, A a SciPy sparse matrix
+    model.add_one_hot(x[modes_of_step_0])
+    result, solution = model.solve(timeout=10)
+
+Contiguous float64 values and int32 indices, as in a SciPy CSR matrix, are
+read in place by the solver; other arrays are converted first.
+"""
+
+import numpy as np
+
+from . import SoyCore
+
+_TYPES = {"E": SoyCore.EQ, "G": SoyCore.GE, "L": SoyCore.LE,
+          "==": SoyCore.EQ, ">=": SoyCore.GE, "<=": SoyCore.LE}
+
+
+def _types(senses, number_of_rows):
+    """The row types of a sense ('E', 'G', 'L', '==', '>=' or '<=') or of a
+    sequence of senses."""
+    if isinstance(senses, str):
+        return np.full(number_of_rows, _TYPES[senses], dtype=np.int32)
+    return np.array([_TYPES[sense] for sense in senses], dtype=np.int32)
+
+
+class Model:
+    def __init__(self):
+        self._builder = SoyCore.ModelBuilder()
+
+    @property
+    def number_of_variables(self):
+        return self._builder.getNumberOfVariables()
+
+    @property
+    def number_of_rows(self):
+        return self._builder.getNumberOfRows()
+
+    def add_variables(self, lower_bounds, upper_bounds, steps=None,
+                      integer=None):
+        """Add variables and return their indices. A negative step means
+        that the variable belongs to no step."""
+        first = self._builder.addVariables(lower_bounds, upper_bounds, steps,
+                                           integer)
+        return np.arange(first, self.number_of_variables, dtype=np.int32)
+
+    def add_row(self, indices, values, sense, rhs):
+        self._builder.addRow(indices, values, _TYPES[sense], rhs)
+
+    def add_rows(self, matrix, senses, rhs):
+        """Add the rows matrix x (senses) rhs, for a SciPy sparse matrix
+        (converted to CSR) or any object with CSR indptr, indices and data
+        arrays."""
+        if hasattr(matrix, "tocsr"):
+            matrix = matrix.tocsr()
+        number_of_rows = len(matrix.indptr) - 1
+        rhs = np.broadcast_to(np.asarray(rhs, dtype=np.float64),
+                              (number_of_rows,))
+        self._builder.addRows(matrix.indptr, matrix.indices, matrix.data,
+                              _types(senses, number_of_rows),
+                              np.ascontiguousarray(rhs))
+
+    def add_one_hot(self, variables):
+        """Exactly one of the variables is 1, and the others 0."""
+        self._builder.addOneHot(variables)
+
+    def add_disjunction(self, variables):
+        """At least one of the variables is 1."""
+        self._builder.addDisjunction(variables)
+
+    def solve(self, timeout=0, workers=1):
+        """Return the result ('sat', 'unsat', 'TIMEOUT', ...) and, if sat, a
+        NumPy array with the value of every variable."""
+        return self._builder.solve(timeout, workers)
@@ -0,0 +1,154 @@
+/*********************                                                        */
+/*! \file SoyCore.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Python bindings of ModelBuilder. The arrays are NumPy arrays; those that
+ ** are already contiguous and of the expected type (float64 values, int32
+ ** indices, as in a SciPy CSR matrix) are read in place, the others are
+ ** converted first.
+ **/
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "Equation.h"
+#include "Error.h"
+#include "ModelBuilder.h"
+#include "Options.h"
+
+namespace py = pybind11;
+
+template <typename T>
+using Array = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+static void checkSize(const char *name, py::ssize_t size,
+                      py::ssize_t expected) {
+  if (size != expected)
+    throw std::invalid_argument(std::string(name) + " has " +
+                                std::to_string(size) + " entries, expected " +
+                                std::to_string(expected));
+}
+
+static unsigned addVariables(ModelBuilder &builder, Array<double> lowerBounds,
+                             Array<double> upperBounds, py::object steps,
+                             py::object isInteger) {
+  py::ssize_t count = lowerBounds.size();
+  checkSize("upper_bounds", upperBounds.size(), count);
+
+  Array<int> stepArray;
+  Array<bool> isIntegerArray;
+  if (!steps.is_none()) {
+    stepArray = steps.cast<Array<int>>();
+    checkSize("steps", stepArray.size(), count);
+  }
+  if (!isInteger.is_none()) {
+    isIntegerArray = isInteger.cast<Array<bool>>();
+    checkSize("integer", isIntegerArray.size(), count);
+  }
+
+  return builder.addVariables(
+      count, lowerBounds.data(), upperBounds.data(),
+      steps.is_none() ? NULL : stepArray.data(),
+      isInteger.is_none() ? NULL : isIntegerArray.data());
+}
+
+static void addRow(ModelBuilder &builder, Array<int> indices,
+                   Array<double> values, int type, double scalar) {
+  checkSize("values", values.size(), indices.size());
+  builder.addRow(indices.size(), indices.data(), values.data(),
+                 (Equation::EquationType)type, scalar);
+}
+
+static void addRows(ModelBuilder &builder, Array<int> rowStarts,
+                    Array<int> indices, Array<double> values, Array<int> types,
+                    Array<double> scalars) {
+  py::ssize_t numberOfRows = types.size();
+  checkSize("indptr", rowStarts.size(), numberOfRows + 1);
+  checkSize("rhs", scalars.size(), numberOfRows);
+  checkSize("data", values.size(), indices.size());
+  if (numberOfRows > 0 && (rowStarts.at(0) < 0 ||
+                           rowStarts.at(numberOfRows) > indices.size()))
+    throw std::invalid_argument("indptr does not match indices");
+  for (py::ssize_t i = 0; i < numberOfRows; ++i)
+    if (rowStarts.at(i) > rowStarts.at(i + 1))
+      throw std::invalid_argument("indptr is not sorted");
+
+  builder.addRows(numberOfRows, rowStarts.data(), indices.data(),
+                  values.data(), types.data(), scalars.data());
+}
+
+static void addOneHot(ModelBuilder &builder, Array<int> variables) {
+  builder.addOneHot(variables.size(), variables.data());
+}
+
+static void addDisjunction(ModelBuilder &builder, Array<int> variables) {
+  builder.addDisjunction(variables.size(), variables.data());
+}
+
+static py::tuple solve(const ModelBuilder &builder, unsigned timeoutInSeconds,
+                       unsigned numWorkers) {
+  py::array_t<double> solution((py::ssize_t)builder.getNumberOfVariables());
+  double *values = solution.mutable_data();
+  String result;
+  {
+    py::gil_scoped_release release;
+    result = builder.solve(timeoutInSeconds, numWorkers, values);
+  }
+
+  if (result == "sat")
+    return py::make_tuple(std::string(result.ascii()), solution);
+  return py::make_tuple(std::string(result.ascii()), py::none());
+}
+
+static void setVerbosity(int verbosity) {
+  Options::get()->setInt(Options::VERBOSITY, verbosity);
+}
+
+PYBIND11_MODULE(SoyCore, m) {
+  m.doc() = "Builds and solves Soy models from NumPy arrays";
+
+  py::register_exception_translator([](std::exception_ptr exception) {
+    try {
+      if (exception) std::rethrow_exception(exception);
+    } catch (const Error &e) {
+      PyErr_SetString(PyExc_RuntimeError,
+                      (std::string(e.getErrorClass()) + " " +
+                       std::to_string(e.getCode()) + ": " + e.getUserMessage())
+                          .c_str());
+    }
+  });
+
+  m.attr("EQ") = (int)Equation::EQ;
+  m.attr("GE") = (int)Equation::GE;
+  m.attr("LE") = (int)Equation::LE;
+
+  m.def("setVerbosity", &setVerbosity, "Verbosity of the engine, 0 for none",
+        py::arg("verbosity"));
+
+  py::class_<ModelBuilder>(m, "ModelBuilder")
+      .def(py::init<>())
+      .def("addVariables", &addVariables,
+           "Add variables and return the index of the first one",
+           py::arg("lower_bounds"), py::arg("upper_bounds"),
+           py::arg("steps") = py::none(), py::arg("integer") = py::none())
+      .def("addRow", &addRow, py::arg("indices"), py::arg("values"),
+           py::arg("type"), py::arg("scalar"))
+      .def("addRows", &addRows, "Add the rows of a CSR matrix",
+           py::arg("indptr"), py::arg("indices"), py::arg("data"),
+           py::arg("types"), py::arg("rhs"))
+      .def("addOneHot", &addOneHot, py::arg("variables"))
+      .def("addDisjunction", &addDisjunction, py::arg("variables"))
+      .def("getNumberOfVariables", &ModelBuilder::getNumberOfVariables)
+      .def("getNumberOfRows", &ModelBuilder::getNumberOfRows)
+      .def("solve", &solve,
+           "Return the result and, if sat, the value of every variable",
+           py::arg("timeout") = 0, py::arg("num_workers") = 1);
+}
@@ -0,0 +1,3 @@
+"""Build and solve Soy models in memory, without writing MPS files."""
+
+from .Model import Model
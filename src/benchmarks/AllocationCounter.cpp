@@ -0,0 +1,31 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long long> numberOfAllocations(0);
+
+unsigned long long AllocationCounter::getNumberOfAllocations() {
+  return numberOfAllocations.load(std::memory_order_relaxed);
+}
+
+void *operator new(std::size_t size) {
+  numberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *pointer = std::malloc(size ? size : 1)) return pointer;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
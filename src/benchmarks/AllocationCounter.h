@@ -0,0 +1,14 @@
+#ifndef __AllocationCounter_h__
+#define __AllocationCounter_h__
+
+/*
+  Counts the calls to the global operator new made by the process. Linked
+  into the benchmarks only (see AllocationCounter.cpp), which replaces the
+  global allocation functions.
+*/
+class AllocationCounter {
+ public:
+  static unsigned long long getNumberOfAllocations();
+};
+
+#endif  // __AllocationCounter_h__
@@ -0,0 +1,210 @@
+/*
+  Heap allocations and time of the per-constraint operations of the search,
+  with the list-returning accessors against the span-based and in-place
+  ones:
+
+  - iterating over the participating variables of a constraint,
+  - performing a split: pushing a context level, applying the case split of
+    a phase to the bound manager, and popping the level, and
+  - proposing an alternative feasible phase in the SoI local search.
+
+  Usage: Bench_CaseSplit [number of one-hot constraints] [size of each]
+*/
+
+#include <cstdlib>
+
+#include "AssignmentManager.h"
+#include "Benchmark.h"
+#include "BoundManager.h"
+#include "OneHotConstraint.h"
+#include "context/context.h"
+
+struct VariableListLoop {
+  VariableListLoop(const Vector<PLConstraint *> &constraints)
+      : _constraints(constraints), _sum(0) {}
+
+  void operator()() {
+    for (const auto &constraint : _constraints)
+      for (const auto &variable : constraint->getParticipatingVariables())
+        _sum += variable;
+  }
+
+  const Vector<PLConstraint *> &_constraints;
+  unsigned long long _sum;
+};
+
+struct VariableSpanLoop {
+  VariableSpanLoop(const Vector<PLConstraint *> &constraints)
+      : _constraints(constraints), _sum(0) {}
+
+  void operator()() {
+    for (const auto &constraint : _constraints)
+      for (const auto &variable : constraint->getParticipatingVariableSpan())
+        _sum += variable;
+  }
+
+  const Vector<PLConstraint *> &_constraints;
+  unsigned long long _sum;
+};
+
+/*
+  The split path before the in-place API: build the split, then apply its
+  tightenings one by one as Engine::applySplit does.
+*/
+struct MaterializedSplits {
+  MaterializedSplits(const Vector<PLConstraint *> &constraints,
+                     CVC4::context::Context &context,
+                     BoundManager &boundManager)
+      : _constraints(constraints),
+        _context(context),
+        _boundManager(boundManager) {}
+
+  void operator()() {
+    for (const auto &constraint : _constraints) {
+      _context.push();
+      PiecewiseLinearCaseSplit split =
+          constraint->getCaseSplit(constraint->getNextFeasibleCase());
+      List<Tightening> bounds = split.getBoundTightenings();
+      for (const auto &bound : bounds) {
+        if (bound._type == Tightening::LB)
+          _boundManager.tightenLowerBound(bound._variable, bound._value);
+        else
+          _boundManager.tightenUpperBound(bound._variable, bound._value);
+      }
+      _context.pop();
+    }
+  }
+
+  const Vector<PLConstraint *> &_constraints;
+  CVC4::context::Context &_context;
+  BoundManager &_boundManager;
+};
+
+struct InPlaceSplits {
+  InPlaceSplits(const Vector<PLConstraint *> &constraints,
+                CVC4::context::Context &context, BoundManager &boundManager)
+      : _constraints(constraints),
+        _context(context),
+        _boundManager(boundManager) {}
+
+  void operator()() {
+    for (const auto &constraint : _constraints) {
+      _context.push();
+      _tightenedVariables.clear();
+      constraint->applyCaseSplit(constraint->getNextFeasibleCase(),
+                                 _boundManager, _tightenedVariables);
+      _context.pop();
+    }
+  }
+
+  const Vector<PLConstraint *> &_constraints;
+  CVC4::context::Context &_context;
+  BoundManager &_boundManager;
+  Vector<unsigned> _tightenedVariables;
+};
+
+/*
+  Pick the index-th alternative to the first case, as the SoI proposals did
+  before and after the span-based accessors.
+*/
+struct FeasibleCaseListPick {
+  FeasibleCaseListPick(const Vector<PLConstraint *> &constraints)
+      : _constraints(constraints), _sum(0) {}
+
+  void operator()() {
+    for (const auto &constraint : _constraints) {
+      PhaseStatus currentPhase = *constraint->getCaseSpan().begin();
+      List<PhaseStatus> allPhases = constraint->getAllFeasibleCases();
+      allPhases.erase(currentPhase);
+      auto it = allPhases.begin();
+      unsigned index = _sum % allPhases.size();
+      while (index > 0) {
+        ++it;
+        --index;
+      }
+      _sum += *it;
+    }
+  }
+
+  const Vector<PLConstraint *> &_constraints;
+  unsigned long long _sum;
+};
+
+struct FeasibleAlternativePick {
+  FeasibleAlternativePick(const Vector<PLConstraint *> &constraints)
+      : _constraints(constraints), _sum(0) {}
+
+  void operator()() {
+    for (const auto &constraint : _constraints) {
+      PhaseStatus currentPhase = *constraint->getCaseSpan().begin();
+      unsigned index =
+          _sum % constraint->numberOfFeasibleAlternatives(currentPhase);
+      _sum += constraint->getFeasibleAlternative(currentPhase, index);
+    }
+  }
+
+  const Vector<PLConstraint *> &_constraints;
+  unsigned long long _sum;
+};
+
+int main(int argc, char **argv) {
+  unsigned numberOfConstraints = argc > 1 ? atoi(argv[1]) : 10000;
+  unsigned groupSize = argc > 2 ? atoi(argv[2]) : 8;
+  unsigned runs = 20;
+  unsigned numberOfVariables = numberOfConstraints * groupSize;
+
+  CVC4::context::Context context;
+  BoundManager boundManager(context);
+  boundManager.initialize(numberOfVariables);
+  for (unsigned i = 0; i < numberOfVariables; ++i) {
+    boundManager.setLowerBound(i, 0);
+    boundManager.setUpperBound(i, 1);
+  }
+
+  Vector<PLConstraint *> constraints;
+  for (unsigned i = 0; i < numberOfConstraints; ++i) {
+    Set<unsigned> elements;
+    for (unsigned j = 0; j < groupSize; ++j) elements.insert(i * groupSize + j);
+    PLConstraint *constraint = new OneHotConstraint(elements);
+    constraint->initializeCDOs(&context);
+    constraints.append(constraint);
+  }
+
+  printf("%u one-hot constraints of size %u, %u runs\n", numberOfConstraints,
+         groupSize, runs);
+
+  VariableListLoop variableList(constraints);
+  Benchmark::report(
+      "participating variables, list",
+      Benchmark::measure(variableList, numberOfConstraints, runs));
+  VariableSpanLoop variableSpan(constraints);
+  Benchmark::report(
+      "participating variables, span",
+      Benchmark::measure(variableSpan, numberOfConstraints, runs));
+
+  MaterializedSplits materializedSplits(constraints, context, boundManager);
+  Benchmark::report(
+      "split, materialized",
+      Benchmark::measure(materializedSplits, numberOfConstraints, runs));
+  InPlaceSplits inPlaceSplits(constraints, context, boundManager);
+  Benchmark::report(
+      "split, in place",
+      Benchmark::measure(inPlaceSplits, numberOfConstraints, runs));
+
+  FeasibleCaseListPick listPick(constraints);
+  Benchmark::report("alternative phase, list",
+                    Benchmark::measure(listPick, numberOfConstraints, runs));
+  FeasibleAlternativePick alternativePick(constraints);
+  Benchmark::report(
+      "alternative phase, in place",
+      Benchmark::measure(alternativePick, numberOfConstraints, runs));
+
+  if (variableList._sum != variableSpan._sum ||
+      listPick._sum != alternativePick._sum) {
+    printf("Mismatch between the two versions\n");
+    return 1;
+  }
+
+  for (const auto &constraint : constraints) delete constraint;
+  return 0;
+}
@@ -0,0 +1,146 @@
+/*
+  Compares looping over a list of constraints through the virtual interface
+  with looping over the per-type vectors of TypedPLConstraints, on the two
+  per-constraint scans of the solver:
+
+  - the satisfaction check of the main loop, and
+  - bound propagation, i.e., notifying each constraint of the bounds of its
+    variables as the preprocessor does.
+
+  Usage: Bench_ConstraintDispatch [number of constraints of each type]
+*/
+
+#include <cstdlib>
+
+#include "AssignmentManager.h"
+#include "Benchmark.h"
+#include "BoundManager.h"
+#include "TypedPLConstraints.h"
+#include "context/context.h"
+
+struct SatisfiedCounter {
+  SatisfiedCounter() : _count(0) {}
+
+  template <class T>
+  void operator()(T *constraint) {
+    if (constraint->satisfied()) ++_count;
+  }
+
+  unsigned _count;
+};
+
+struct BoundNotifier {
+  explicit BoundNotifier(const BoundManager &boundManager)
+      : _boundManager(boundManager) {}
+
+  template <class T>
+  void operator()(T *constraint) {
+    for (unsigned variable : constraint->getParticipatingVariableSpan()) {
+      constraint->notifyLowerBound(variable,
+                                   _boundManager.getLowerBound(variable));
+      constraint->notifyUpperBound(variable,
+                                   _boundManager.getUpperBound(variable));
+    }
+  }
+
+  const BoundManager &_boundManager;
+};
+
+template <class Kernel>
+struct VirtualLoop {
+  VirtualLoop(const List<PLConstraint *> &constraints, Kernel &kernel)
+      : _constraints(constraints), _kernel(kernel) {}
+
+  void operator()() {
+    for (const auto &constraint : _constraints) _kernel(constraint);
+  }
+
+  const List<PLConstraint *> &_constraints;
+  Kernel &_kernel;
+};
+
+template <class Kernel>
+struct TypedLoop {
+  TypedLoop(const TypedPLConstraints &constraints, Kernel &kernel)
+      : _constraints(constraints), _kernel(kernel) {}
+
+  void operator()() { _constraints.forEach(_kernel); }
+
+  const TypedPLConstraints &_constraints;
+  Kernel &_kernel;
+};
+
+int main(int argc, char **argv) {
+  unsigned numberOfEachType = argc > 1 ? atoi(argv[1]) : 100000;
+  unsigned runs = 20;
+
+  // Each group of constraints uses 7 fresh variables: x for Integer(x),
+  // (b, f) for Abs, and four elements for OneHot
+  unsigned numberOfVariables = 7 * numberOfEachType;
+
+  CVC4::context::Context context;
+  BoundManager boundManager(context);
+  boundManager.initialize(numberOfVariables);
+  for (unsigned i = 0; i < numberOfVariables; ++i) {
+    boundManager.setLowerBound(i, -10);
+    boundManager.setUpperBound(i, 10);
+  }
+  AssignmentManager assignmentManager(boundManager);
+  assignmentManager.initialize();
+
+  List<PLConstraint *> constraints;
+  for (unsigned i = 0; i < numberOfEachType; ++i) {
+    unsigned first = 7 * i;
+    constraints.append(new IntegerConstraint(first));
+    constraints.append(new AbsoluteValueConstraint(first + 1, first + 2));
+    constraints.append(new OneHotConstraint(
+        Set<unsigned>({first + 3, first + 4, first + 5, first + 6})));
+
+    // Make about half of the constraints hold
+    assignmentManager.setAssignment(first, i % 2 ? 1.5 : 2);
+    assignmentManager.setAssignment(first + 1, -3);
+    assignmentManager.setAssignment(first + 2, i % 2 ? 3 : 2);
+    for (unsigned j = 3; j < 7; ++j)
+      assignmentManager.setAssignment(first + j, j == 3 + i % 4 ? 1 : 0);
+  }
+  for (const auto &constraint : constraints)
+    constraint->registerAssignmentManager(&assignmentManager);
+
+  TypedPLConstraints typedConstraints(constraints);
+  unsigned numberOfConstraints = constraints.size();
+
+  printf("%u constraints, %u variables, %u runs\n", numberOfConstraints,
+         numberOfVariables, runs);
+
+  SatisfiedCounter virtualCounter;
+  VirtualLoop<SatisfiedCounter> virtualSatisfied(constraints, virtualCounter);
+  Benchmark::report(
+      "satisfied, virtual",
+      Benchmark::measure(virtualSatisfied, numberOfConstraints, runs));
+
+  SatisfiedCounter typedCounter;
+  TypedLoop<SatisfiedCounter> typedSatisfied(typedConstraints, typedCounter);
+  Benchmark::report(
+      "satisfied, typed",
+      Benchmark::measure(typedSatisfied, numberOfConstraints, runs));
+
+  if (virtualCounter._count != typedCounter._count) {
+    printf("Mismatch: %u vs %u satisfied\n", virtualCounter._count,
+           typedCounter._count);
+    return 1;
+  }
+
+  BoundNotifier notifier(boundManager);
+  VirtualLoop<BoundNotifier> virtualNotify(constraints, notifier);
+  Benchmark::report(
+      "notify bounds, virtual",
+      Benchmark::measure(virtualNotify, numberOfConstraints, runs));
+
+  TypedLoop<BoundNotifier> typedNotify(typedConstraints, notifier);
+  Benchmark::report(
+      "notify bounds, typed",
+      Benchmark::measure(typedNotify, numberOfConstraints, runs));
+
+  for (const auto &constraint : constraints) delete constraint;
+  return 0;
+}
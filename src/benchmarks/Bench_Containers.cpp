@@ -0,0 +1,179 @@
+/*
+  Time and heap allocations of the basic operations of the container
+  wrappers in src/common, on unsigned keys in a scrambled order:
+
+  - Map: insertion, lookup and iteration,
+  - Set: insertion and membership tests, and
+  - List: appending, iteration and erasing by value, as done when
+    constraints are removed from an InputQuery.
+
+  Usage: Bench_Containers [number of elements]...
+*/
+
+#include "Benchmark.h"
+#include "List.h"
+#include "MStringf.h"
+#include "Map.h"
+#include "Set.h"
+#include "Vector.h"
+
+struct MapInsert {
+  explicit MapInsert(const Vector<unsigned> &keys) : _keys(keys) {}
+
+  void operator()() {
+    _map.clear();
+    for (const auto &key : _keys) _map[key] = key;
+  }
+
+  const Vector<unsigned> &_keys;
+  Map<unsigned, unsigned> _map;
+};
+
+struct MapLookup {
+  MapLookup(const Vector<unsigned> &keys, const Map<unsigned, unsigned> &map)
+      : _keys(keys), _map(map), _sum(0) {}
+
+  void operator()() {
+    for (const auto &key : _keys)
+      if (_map.exists(key)) _sum += _map[key];
+  }
+
+  const Vector<unsigned> &_keys;
+  const Map<unsigned, unsigned> &_map;
+  unsigned long long _sum;
+};
+
+struct MapIterate {
+  explicit MapIterate(const Map<unsigned, unsigned> &map)
+      : _map(map), _sum(0) {}
+
+  void operator()() {
+    for (const auto &pair : _map) _sum += pair.second;
+  }
+
+  const Map<unsigned, unsigned> &_map;
+  unsigned long long _sum;
+};
+
+struct SetInsert {
+  explicit SetInsert(const Vector<unsigned> &keys) : _keys(keys) {}
+
+  void operator()() {
+    _set.clear();
+    for (const auto &key : _keys) _set.insert(key);
+  }
+
+  const Vector<unsigned> &_keys;
+  Set<unsigned> _set;
+};
+
+struct SetExists {
+  SetExists(const Vector<unsigned> &keys, const Set<unsigned> &set)
+      : _keys(keys), _set(set), _count(0) {}
+
+  void operator()() {
+    for (const auto &key : _keys)
+      if (_set.exists(key)) ++_count;
+  }
+
+  const Vector<unsigned> &_keys;
+  const Set<unsigned> &_set;
+  unsigned _count;
+};
+
+struct ListAppend {
+  explicit ListAppend(const Vector<unsigned> &keys) : _keys(keys) {}
+
+  void operator()() {
+    _list.clear();
+    for (const auto &key : _keys) _list.append(key);
+  }
+
+  const Vector<unsigned> &_keys;
+  List<unsigned> _list;
+};
+
+struct ListIterate {
+  explicit ListIterate(const List<unsigned> &list) : _list(list), _sum(0) {}
+
+  void operator()() {
+    for (const auto &value : _list) _sum += value;
+  }
+
+  const List<unsigned> &_list;
+  unsigned long long _sum;
+};
+
+/*
+  Erases the elements in insertion order, so that each erasure finds its
+  element at the front; what is measured is the erasure itself rather than
+  the linear search.
+*/
+struct ListErase {
+  explicit ListErase(const Vector<unsigned> &keys) : _keys(keys) {}
+
+  void operator()() {
+    _list.clear();
+    for (const auto &key : _keys) _list.append(key);
+    for (const auto &key : _keys) _list.erase(key);
+  }
+
+  const Vector<unsigned> &_keys;
+  List<unsigned> _list;
+};
+
+int main(int argc, char **argv) {
+  Vector<unsigned> sizes =
+      Benchmark::getSizes(argc, argv, {1000, 10000, 100000, 1000000});
+
+  for (const auto &size : sizes) {
+    // A bijection on the unsigned integers, so the keys are distinct
+    Vector<unsigned> keys;
+    for (unsigned i = 0; i < size; ++i) keys.append(i * 2654435761u);
+
+    unsigned runs = Benchmark::getRuns(size);
+    printf("%u elements, %u runs\n", size, runs);
+
+    MapInsert mapInsert(keys);
+    Benchmark::report(Stringf("Map insert/%u", size).ascii(),
+                      Benchmark::measure(mapInsert, size, runs));
+
+    MapLookup mapLookup(keys, mapInsert._map);
+    Benchmark::report(Stringf("Map lookup/%u", size).ascii(),
+                      Benchmark::measure(mapLookup, size, runs));
+
+    MapIterate mapIterate(mapInsert._map);
+    Benchmark::report(Stringf("Map iterate/%u", size).ascii(),
+                      Benchmark::measure(mapIterate, size, runs));
+
+    SetInsert setInsert(keys);
+    Benchmark::report(Stringf("Set insert/%u", size).ascii(),
+                      Benchmark::measure(setInsert, size, runs));
+
+    SetExists setExists(keys, setInsert._set);
+    Benchmark::report(Stringf("Set exists/%u", size).ascii(),
+                      Benchmark::measure(setExists, size, runs));
+
+    ListAppend listAppend(keys);
+    Benchmark::report(Stringf("List append/%u", size).ascii(),
+                      Benchmark::measure(listAppend, size, runs));
+
+    ListIterate listIterate(listAppend._list);
+    Benchmark::report(Stringf("List iterate/%u", size).ascii(),
+                      Benchmark::measure(listIterate, size, runs));
+
+    ListErase listErase(keys);
+    Benchmark::report(Stringf("List append and erase/%u", size).ascii(),
+                      Benchmark::measure(listErase, size, runs));
+
+    // Every kernel ran once more for the warm-up, over all the elements
+    if (mapLookup._sum != mapIterate._sum ||
+        mapLookup._sum != listIterate._sum ||
+        setExists._count != size * (runs + 1)) {
+      printf("Mismatch\n");
+      return 1;
+    }
+  }
+
+  return 0;
+}
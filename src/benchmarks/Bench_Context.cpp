@@ -0,0 +1,88 @@
+/*
+  Time and heap allocations of the context-dependent bounds of the
+  BoundManager, i.e., the cost of backtracking:
+
+  - a wide level: pushing a context level, tightening the bounds of every
+    variable and popping the level, as a propagation pass does, and
+  - a deep search: pushing one level per variable with a single tightening
+    at each, then backtracking to the root.
+
+  Usage: Bench_Context [number of variables]...
+*/
+
+#include "Benchmark.h"
+#include "BoundManager.h"
+#include "MStringf.h"
+#include "context/context.h"
+
+struct WideLevel {
+  WideLevel(CVC4::context::Context &context, BoundManager &boundManager)
+      : _context(context), _boundManager(boundManager) {}
+
+  void operator()() {
+    unsigned numberOfVariables = _boundManager.getNumberOfVariables();
+    _context.push();
+    for (unsigned i = 0; i < numberOfVariables; ++i) {
+      _boundManager.tightenLowerBound(i, -5);
+      _boundManager.tightenUpperBound(i, 5);
+    }
+    _context.pop();
+  }
+
+  CVC4::context::Context &_context;
+  BoundManager &_boundManager;
+};
+
+struct DeepSearch {
+  DeepSearch(CVC4::context::Context &context, BoundManager &boundManager)
+      : _context(context), _boundManager(boundManager) {}
+
+  void operator()() {
+    unsigned numberOfVariables = _boundManager.getNumberOfVariables();
+    for (unsigned i = 0; i < numberOfVariables; ++i) {
+      _context.push();
+      _boundManager.tightenLowerBound(i, 0);
+    }
+    _context.popto(0);
+  }
+
+  CVC4::context::Context &_context;
+  BoundManager &_boundManager;
+};
+
+int main(int argc, char **argv) {
+  Vector<unsigned> sizes =
+      Benchmark::getSizes(argc, argv, {1000, 10000, 100000, 1000000});
+
+  for (const auto &size : sizes) {
+    CVC4::context::Context context;
+    BoundManager boundManager(context);
+    boundManager.initialize(size);
+    for (unsigned i = 0; i < size; ++i) {
+      boundManager.setLowerBound(i, -10);
+      boundManager.setUpperBound(i, 10);
+    }
+
+    unsigned runs = Benchmark::getRuns(size);
+    printf("%u variables, %u runs\n", size, runs);
+
+    WideLevel wideLevel(context, boundManager);
+    Benchmark::report(Stringf("push, tighten all, pop/%u", size).ascii(),
+                      Benchmark::measure(wideLevel, 2 * size, runs));
+
+    DeepSearch deepSearch(context, boundManager);
+    Benchmark::report(Stringf("push and tighten, popto(0)/%u", size).ascii(),
+                      Benchmark::measure(deepSearch, size, runs));
+
+    // Backtracking must have restored the bounds
+    for (unsigned i = 0; i < size; ++i) {
+      if (boundManager.getLowerBound(i) != -10 ||
+          boundManager.getUpperBound(i) != 10) {
+        printf("Bounds of x%u not restored\n", i);
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,100 @@
+/*
+  Time and heap allocations of reading an MPS file, per line, on PWA control
+  problems written by PwaMpsGenerator:
+
+  - File::readLine over the whole file,
+  - String::tokenize of each line, as the parser splits them, and
+  - the whole MpsParser pass over the file.
+
+  Usage: Bench_Parsing [number of steps of the problem]...
+*/
+
+#include <cstdio>
+
+#include "Benchmark.h"
+#include "CommonError.h"
+#include "File.h"
+#include "MStringf.h"
+#include "MpsParser.h"
+#include "PwaMpsGenerator.h"
+
+struct ReadLines {
+  ReadLines(const String &path, unsigned numberOfLines)
+      : _path(path), _numberOfLines(numberOfLines), _characters(0) {}
+
+  void operator()() {
+    File file(_path);
+    file.open(IFile::MODE_READ);
+    for (unsigned i = 0; i < _numberOfLines; ++i)
+      _characters += file.readLine().length();
+  }
+
+  String _path;
+  unsigned _numberOfLines;
+  unsigned long long _characters;
+};
+
+struct TokenizeLines {
+  explicit TokenizeLines(const Vector<String> &lines)
+      : _lines(lines), _tokens(0) {}
+
+  void operator()() {
+    for (const auto &line : _lines) _tokens += line.tokenize("\t\n ").size();
+  }
+
+  const Vector<String> &_lines;
+  unsigned long long _tokens;
+};
+
+struct ParseFile {
+  explicit ParseFile(const String &path) : _path(path), _variables(0) {}
+
+  void operator()() {
+    MpsParser parser(_path);
+    _variables += parser.getNumVars();
+  }
+
+  String _path;
+  unsigned long long _variables;
+};
+
+int main(int argc, char **argv) {
+  Vector<unsigned> sizes = Benchmark::getSizes(argc, argv, {100, 1000, 10000});
+
+  for (const auto &size : sizes) {
+    PwaMpsGenerator::Parameters parameters;
+    parameters._horizon = size;
+    parameters._numberOfModes = 4;
+    String path = Stringf("Bench_Parsing_%u.mps", size);
+    PwaMpsGenerator(parameters).writeToFile(path);
+
+    Vector<String> lines;
+    File file(path);
+    file.open(IFile::MODE_READ);
+    try {
+      while (true) lines.append(file.readLine());
+    } catch (const CommonError &) {
+      // End of the file
+    }
+    unsigned numberOfLines = lines.size();
+
+    unsigned runs = Benchmark::getRuns(numberOfLines, 1000000);
+    printf("%u steps, %u lines, %u runs\n", size, numberOfLines, runs);
+
+    ReadLines readLines(path, numberOfLines);
+    Benchmark::report(Stringf("File::readLine/%u", numberOfLines).ascii(),
+                      Benchmark::measure(readLines, numberOfLines, runs));
+
+    TokenizeLines tokenizeLines(lines);
+    Benchmark::report(Stringf("String::tokenize/%u", numberOfLines).ascii(),
+                      Benchmark::measure(tokenizeLines, numberOfLines, runs));
+
+    ParseFile parseFile(path);
+    Benchmark::report(Stringf("MpsParser, per line/%u", numberOfLines).ascii(),
+                      Benchmark::measure(parseFile, numberOfLines, runs));
+
+    remove(path.ascii());
+  }
+
+  return 0;
+}
@@ -0,0 +1,163 @@
+/*
+  Time and heap allocations of the per-node kernels of the search, on PWA
+  control problems written by PwaMpsGenerator and read by MpsParser:
+
+  - bound propagation: pushing a context level, running
+    Preprocessor::preprocessLite to a fixed point on the context-dependent
+    bounds and popping the level, as after each split,
+  - the satisfaction check of the one-hot constraints, and
+  - updating the pseudo-impact score of a constraint, as after each
+    propagation.
+
+  The setup of the larger problems is dominated by MpsParser, as
+  InputQuery::addEquation checks each equation against all previous ones.
+
+  Usage: Bench_Propagation [number of steps of the problem]...
+*/
+
+#include <cstdio>
+
+#include "AssignmentManager.h"
+#include "Benchmark.h"
+#include "BoundManager.h"
+#include "InputQuery.h"
+#include "MStringf.h"
+#include "MpsParser.h"
+#include "Preprocessor.h"
+#include "PseudoImpactTracker.h"
+#include "PwaMpsGenerator.h"
+#include "TypedPLConstraints.h"
+#include "context/context.h"
+
+struct Propagation {
+  Propagation(InputQuery &query, CVC4::context::Context &context,
+              BoundManager &boundManager)
+      : _query(query),
+        _context(context),
+        _boundManager(boundManager),
+        _feasible(true) {}
+
+  void operator()() {
+    _context.push();
+    _feasible = _preprocessor.preprocessLite(_query, _boundManager, true);
+    _context.pop();
+  }
+
+  InputQuery &_query;
+  CVC4::context::Context &_context;
+  BoundManager &_boundManager;
+  Preprocessor _preprocessor;
+  bool _feasible;
+};
+
+struct OneHotSatisfied {
+  explicit OneHotSatisfied(const Vector<OneHotConstraint *> &constraints)
+      : _constraints(constraints), _count(0) {}
+
+  void operator()() {
+    for (const auto &constraint : _constraints)
+      if (constraint->satisfied()) ++_count;
+  }
+
+  const Vector<OneHotConstraint *> &_constraints;
+  unsigned _count;
+};
+
+struct ScoreUpdates {
+  ScoreUpdates(const List<PLConstraint *> &constraints,
+               PseudoImpactTracker &tracker)
+      : _constraints(constraints), _tracker(tracker), _round(0) {}
+
+  void operator()() {
+    unsigned i = _round++;
+    for (const auto &constraint : _constraints)
+      _tracker.updateScore(constraint, (++i * 37 % 101) / 100.0);
+  }
+
+  const List<PLConstraint *> &_constraints;
+  PseudoImpactTracker &_tracker;
+  unsigned _round;
+};
+
+int main(int argc, char **argv) {
+  Vector<unsigned> sizes = Benchmark::getSizes(argc, argv, {100, 300, 1000});
+
+  for (const auto &size : sizes) {
+    PwaMpsGenerator::Parameters parameters;
+    parameters._horizon = size;
+    parameters._numberOfModes = 4;
+    String path = Stringf("Bench_Propagation_%u.mps", size);
+    PwaMpsGenerator(parameters).writeToFile(path);
+
+    InputQuery query;
+    MpsParser(path).generateQuery(query);
+    remove(path.ascii());
+
+    unsigned numberOfVariables = query.getNumberOfVariables();
+    unsigned numberOfEquations = query.getEquations().size();
+    List<PLConstraint *> &constraints = query.getPLConstraints();
+    TypedPLConstraints typedConstraints(constraints);
+    const Vector<OneHotConstraint *> &oneHots =
+        typedConstraints.getOneHotConstraints();
+
+    CVC4::context::Context context;
+    BoundManager boundManager(context);
+    boundManager.initialize(numberOfVariables);
+    for (unsigned i = 0; i < numberOfVariables; ++i) {
+      boundManager.setLowerBound(i, query.getLowerBound(i));
+      boundManager.setUpperBound(i, query.getUpperBound(i));
+    }
+    AssignmentManager assignmentManager(boundManager);
+
+    for (const auto &constraint : constraints) {
+      constraint->initializeCDOs(&context);
+      constraint->registerBoundManager(&boundManager);
+      constraint->registerAssignmentManager(&assignmentManager);
+    }
+
+    // Select a mode at every other step; the rest violate their one-hot
+    // constraint
+    unsigned step = 0;
+    for (const auto &oneHot : oneHots) {
+      bool first = true;
+      for (unsigned variable : oneHot->getParticipatingVariableSpan()) {
+        assignmentManager.setAssignment(variable,
+                                        first && step % 2 == 0 ? 1 : 0);
+        first = false;
+      }
+      ++step;
+    }
+
+    printf("%u steps: %u variables, %u equations, %u constraints\n", size,
+           numberOfVariables, numberOfEquations, constraints.size());
+
+    Propagation propagation(query, context, boundManager);
+    Benchmark::report(
+        Stringf("preprocessLite, per equation/%u", numberOfEquations).ascii(),
+        Benchmark::measure(propagation, numberOfEquations,
+                           Benchmark::getRuns(numberOfEquations, 1000000)));
+    printf("  (%s)\n", propagation._feasible ? "feasible" : "infeasible");
+
+    unsigned runs = Benchmark::getRuns(oneHots.size());
+    OneHotSatisfied satisfied(oneHots);
+    Benchmark::report(
+        Stringf("OneHotConstraint::satisfied/%u", oneHots.size()).ascii(),
+        Benchmark::measure(satisfied, oneHots.size(), runs));
+
+    if (satisfied._count != (oneHots.size() + 1) / 2 * (runs + 1)) {
+      printf("Mismatch: %u satisfied\n", satisfied._count);
+      return 1;
+    }
+
+    PseudoImpactTracker tracker;
+    tracker.initialize(constraints);
+    ScoreUpdates scoreUpdates(constraints, tracker);
+    Benchmark::report(
+        Stringf("PseudoImpactTracker::updateScore/%u", constraints.size())
+            .ascii(),
+        Benchmark::measure(scoreUpdates, constraints.size(),
+                           Benchmark::getRuns(constraints.size())));
+  }
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+/*
+  Time and heap allocations of the phase-pattern cache of the SoI local
+  search. Each probe builds the key of the current phase pattern, whose
+  length grows with the number of constraints, and looks it up:
+
+  - probing for a pattern that is not cached,
+  - probing for a cached pattern, and
+  - loading the assignment cached for a pattern.
+
+  Usage: Bench_SoICache [number of one-hot constraints]...
+*/
+
+#include "AssignmentManager.h"
+#include "Benchmark.h"
+#include "BoundManager.h"
+#include "InputQuery.h"
+#include "MStringf.h"
+#include "OneHotConstraint.h"
+#include "Options.h"
+#include "SoIManager.h"
+#include "context/context.h"
+
+struct CacheProbe {
+  explicit CacheProbe(SoIManager &soiManager)
+      : _soiManager(soiManager), _hits(0) {}
+
+  void operator()() {
+    if (_soiManager.currentPhasePatternCached()) ++_hits;
+  }
+
+  SoIManager &_soiManager;
+  unsigned _hits;
+};
+
+struct CacheLoad {
+  explicit CacheLoad(SoIManager &soiManager)
+      : _soiManager(soiManager), _cost(0) {}
+
+  void operator()() {
+    double cost = 0;
+    _soiManager.loadCachedPhasePattern(cost);
+    _cost += cost;
+  }
+
+  SoIManager &_soiManager;
+  double _cost;
+};
+
+int main(int argc, char **argv) {
+  Vector<unsigned> sizes = Benchmark::getSizes(argc, argv, {1000, 10000});
+
+  // The initial phase pattern from the assignment alone, without the
+  // SAT solver
+  Options::get()->setString(Options::SOI_INITIALIZATION_STRATEGY,
+                            "current-assignment");
+
+  for (const auto &size : sizes) {
+    unsigned numberOfVariables = 4 * size;
+
+    CVC4::context::Context context;
+    BoundManager boundManager(context);
+    boundManager.initialize(numberOfVariables);
+    for (unsigned i = 0; i < numberOfVariables; ++i) {
+      boundManager.setLowerBound(i, 0);
+      boundManager.setUpperBound(i, 1);
+    }
+    AssignmentManager assignmentManager(boundManager);
+
+    InputQuery query;
+    query.setNumberOfVariables(numberOfVariables);
+    for (unsigned i = 0; i < size; ++i) {
+      unsigned first = 4 * i;
+      PLConstraint *constraint = new OneHotConstraint(
+          Set<unsigned>({first, first + 1, first + 2, first + 3}));
+      constraint->initializeCDOs(&context);
+      constraint->registerBoundManager(&boundManager);
+      constraint->registerAssignmentManager(&assignmentManager);
+      query.addPLConstraint(constraint);
+
+      for (unsigned j = 0; j < 4; ++j)
+        assignmentManager.setAssignment(first + j, j == i % 4 ? 1 : 0);
+    }
+
+    SoIManager soiManager(query);
+    soiManager.setAssignmentManager(&assignmentManager);
+    soiManager.initializePhasePattern();
+
+    // Each probe is linear in the number of constraints
+    unsigned runs = Benchmark::getRuns(size, 1000000);
+    printf("%u constraints, %u runs\n", size, runs);
+
+    CacheProbe miss(soiManager);
+    Benchmark::report(Stringf("phase pattern cache miss/%u", size).ascii(),
+                      Benchmark::measure(miss, 1, runs));
+
+    soiManager.cacheCurrentPhasePattern(1);
+
+    CacheProbe hit(soiManager);
+    Benchmark::report(Stringf("phase pattern cache hit/%u", size).ascii(),
+                      Benchmark::measure(hit, 1, runs));
+
+    CacheLoad load(soiManager);
+    Benchmark::report(Stringf("phase pattern cache load/%u", size).ascii(),
+                      Benchmark::measure(load, 1, runs));
+
+    if (miss._hits != 0 || hit._hits != runs + 1) {
+      printf("Mismatch: %u and %u hits\n", miss._hits, hit._hits);
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+#ifndef __Benchmark_h__
+#define __Benchmark_h__
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "AllocationCounter.h"
+#include "TimeUtils.h"
+#include "Vector.h"
+
+/*
+  Minimal timing harness for the micro-benchmarks. A benchmark is a functor
+  whose operator() performs a fixed number of operations; it is run a number
+  of times after a warm-up run, and the average time and number of heap
+  allocations per operation are reported.
+*/
+class Benchmark {
+ public:
+  struct Result {
+    double _nanosecondsPerOperation;
+    double _allocationsPerOperation;
+  };
+
+  template <class Body>
+  static Result measure(Body &body, unsigned operationsPerRun, unsigned runs) {
+    body();
+
+    unsigned long long allocationsBefore =
+        AllocationCounter::getNumberOfAllocations();
+    struct timespec start = TimeUtils::sampleMicro();
+    for (unsigned i = 0; i < runs; ++i) body();
+    struct timespec end = TimeUtils::sampleMicro();
+    unsigned long long allocations =
+        AllocationCounter::getNumberOfAllocations() - allocationsBefore;
+
+    double operations = (double)operationsPerRun * runs;
+    Result result;
+    result._nanosecondsPerOperation =
+        TimeUtils::timePassed(start, end) * 1000.0 / operations;
+    result._allocationsPerOperation = allocations / operations;
+    return result;
+  }
+
+  static void report(const char *name, const Result &result) {
+    printf("%-48s %10.2f ns/op %8.2f allocs/op\n", name,
+           result._nanosecondsPerOperation, result._allocationsPerOperation);
+  }
+
+  /*
+    The problem sizes to sweep over: the command-line arguments if there are
+    any, the given defaults otherwise.
+  */
+  static Vector<unsigned> getSizes(int argc, char **argv,
+                                   const Vector<unsigned> &defaults) {
+    if (argc < 2) return defaults;
+
+    Vector<unsigned> sizes;
+    for (int i = 1; i < argc; ++i) sizes.append(atoi(argv[i]));
+    return sizes;
+  }
+
+  /*
+    Enough runs for about the given total number of operations, so that the
+    small sizes are not dominated by noise and the large ones finish.
+  */
+  static unsigned getRuns(unsigned operationsPerRun,
+                          unsigned long long totalOperations = 10000000) {
+    unsigned long long runs = totalOperations / (operationsPerRun + 1);
+    return runs < 3 ? 3 : runs > 1000 ? 1000 : runs;
+  }
+};
+
+#endif  // __Benchmark_h__
@@ -0,0 +1,382 @@
+/*
+  End-to-end benchmark driver. Runs the Soy binary under a number of
+  configurations over a suite of MPS instances, either given files or PWA
+  control problems generated with PwaMpsGenerator. For every run it reports
+  the result, the wall time, and the numbers of LP calls, SAT calls, splits
+  and conflicts, as a table and optionally as CSV and JSON.
+
+  Every run is a separate process, so that neither options nor global state
+  leak from one run into the next. The statistics are read back from the
+  summary files that Soy writes (--summary-file and its .json companion).
+
+  Usage:
+    benchmark_driver --suite-dir suite --generate 20 --horizon 15
+        --config default= --config walksat="--search-strategy walksat"
+        --milp --timeout 600 --csv results.csv --json results.json
+*/
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Error.h"
+#include "File.h"
+#include "MStringf.h"
+#include "PwaMpsGenerator.h"
+#include "TimeUtils.h"
+#include "Vector.h"
+#include "boost/program_options.hpp"
+
+#ifndef SOY_BINARY
+#define SOY_BINARY "./Soy"
+#endif
+
+struct Configuration {
+  String _name;
+  Vector<String> _arguments;
+};
+
+struct RunResult {
+  String _instance;
+  String _configuration;
+  String _result;
+  double _wallSeconds;
+  unsigned long long _lpCalls;
+  unsigned long long _satCalls;
+  unsigned long long _splits;
+  unsigned long long _conflicts;
+  unsigned long long _visitedStates;
+};
+
+static String readFile(const String &path) {
+  std::ifstream stream(path.ascii());
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  return String(contents.str());
+}
+
+/*
+  The sum over the workers of an attribute in the JSON summary, or 0 if the
+  summary does not have it (e.g., for MILP runs)
+*/
+static unsigned long long getAttributeSum(const String &json,
+                                          const char *attribute) {
+  String key = Stringf("\"%s\": {\"sum\": ", attribute);
+  const char *position = strstr(json.ascii(), key.ascii());
+  if (!position) return 0;
+  return strtoull(position + key.length(), NULL, 10);
+}
+
+static String getStem(const String &path) {
+  std::string name = path.ascii();
+  size_t slash = name.find_last_of('/');
+  if (slash != std::string::npos) name = name.substr(slash + 1);
+  size_t dot = name.find_last_of('.');
+  if (dot != std::string::npos) name = name.substr(0, dot);
+  return String(name);
+}
+
+/*
+  Run Soy to completion with its output redirected to the log file. Returns
+  false if it could not be run or did not exit cleanly.
+*/
+static bool runSoy(const String &soy, const Vector<String> &arguments,
+                   const String &logPath) {
+  std::vector<char *> argv;
+  argv.push_back(const_cast<char *>(soy.ascii()));
+  for (const auto &argument : arguments)
+    argv.push_back(const_cast<char *>(argument.ascii()));
+  argv.push_back(NULL);
+
+  pid_t pid = fork();
+  if (pid < 0) return false;
+
+  if (pid == 0) {
+    int log = open(logPath.ascii(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (log >= 0) {
+      dup2(log, STDOUT_FILENO);
+      dup2(log, STDERR_FILENO);
+      close(log);
+    }
+    execv(soy.ascii(), argv.data());
+    _exit(127);
+  }
+
+  int status = 0;
+  if (waitpid(pid, &status, 0) != pid) return false;
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static RunResult runInstance(const String &soy, const String &instance,
+                             const Configuration &configuration,
+                             const String &suiteDirectory, int timeout) {
+  String prefix = Stringf("%s/%s.%s", suiteDirectory.ascii(),
+                          getStem(instance).ascii(),
+                          configuration._name.ascii());
+  String summaryPath = prefix + ".summary";
+  unlink(summaryPath.ascii());
+  unlink((summaryPath + ".json").ascii());
+
+  Vector<String> arguments;
+  arguments.append(instance);
+  for (const auto &argument : configuration._arguments)
+    arguments.append(argument);
+  arguments.append("--summary-file");
+  arguments.append(summaryPath);
+  arguments.append("--timeout");
+  arguments.append(Stringf("%d", timeout));
+
+  struct timespec start = TimeUtils::sampleMicro();
+  bool exited = runSoy(soy, arguments, prefix + ".log");
+  struct timespec end = TimeUtils::sampleMicro();
+
+  RunResult result;
+  result._instance = getStem(instance);
+  result._configuration = configuration._name;
+  result._wallSeconds = TimeUtils::timePassed(start, end) / 1000000.0;
+  result._result = exited ? "UNKNOWN" : "error";
+  result._visitedStates = 0;
+
+  // Summary fields: result, seconds, visited states (or MILP nodes), ...
+  String summary = readFile(summaryPath);
+  List<String> fields = summary.tokenize(" \n");
+  if (!fields.empty()) {
+    auto it = fields.begin();
+    result._result = *it;
+    if (++it != fields.end() && ++it != fields.end())
+      result._visitedStates = strtoull(it->ascii(), NULL, 10);
+  }
+
+  String json = readFile(summaryPath + ".json");
+  result._lpCalls = getAttributeSum(json, "NUM_LP_FEASIBILITY_CHECK") +
+                    getAttributeSum(json, "NUM_SOI_COST_MINIMIZATIONS");
+  result._satCalls = getAttributeSum(json, "NUM_SAT_SOLVER_CALLS");
+  result._splits = getAttributeSum(json, "NUM_SPLITS");
+  result._conflicts =
+      getAttributeSum(json, "NUM_REFUTATIONS_BY_SAT_SOLVER") +
+      getAttributeSum(json, "NUM_REFUTATIONS_BY_THEORY_SOLVER") +
+      getAttributeSum(json, "NUM_REFUTATIONS_BY_BOUND_TIGHTENING");
+  return result;
+}
+
+static void writeCsv(const String &path, const Vector<RunResult> &results) {
+  File file(path);
+  file.open(File::MODE_WRITE_TRUNCATE);
+  file.write(
+      "instance,configuration,result,wall_seconds,lp_calls,sat_calls,"
+      "splits,conflicts,visited_states\n");
+  for (const auto &result : results)
+    file.write(Stringf("%s,%s,%s,%.3f,%llu,%llu,%llu,%llu,%llu\n",
+                       result._instance.ascii(),
+                       result._configuration.ascii(), result._result.ascii(),
+                       result._wallSeconds, result._lpCalls, result._satCalls,
+                       result._splits, result._conflicts,
+                       result._visitedStates));
+}
+
+static void writeJson(const String &path, const Vector<RunResult> &results) {
+  File file(path);
+  file.open(File::MODE_WRITE_TRUNCATE);
+  file.write("{\"runs\": [");
+  for (unsigned i = 0; i < results.size(); ++i) {
+    const RunResult &result = results[i];
+    file.write(Stringf(
+        "%s\n  {\"instance\": \"%s\", \"configuration\": \"%s\", "
+        "\"result\": \"%s\", \"wall_seconds\": %.3f, \"lp_calls\": %llu, "
+        "\"sat_calls\": %llu, \"splits\": %llu, \"conflicts\": %llu, "
+        "\"visited_states\": %llu}",
+        i > 0 ? "," : "", result._instance.ascii(),
+        result._configuration.ascii(), result._result.ascii(),
+        result._wallSeconds, result._lpCalls, result._satCalls,
+        result._splits, result._conflicts, result._visitedStates));
+  }
+  file.write("\n]}\n");
+}
+
+int main(int argc, char *argv[]) {
+  PwaMpsGenerator::Parameters parameters;
+  std::string geometry = "slabs";
+  std::string soy = SOY_BINARY;
+  std::string suiteDirectory = "benchmark_suite";
+  std::vector<std::string> configurationStrings;
+  std::vector<std::string> instanceArguments;
+  std::string csvPath;
+  std::string jsonPath;
+  unsigned numberOfInstances = 0;
+  int timeout = 600;
+
+  boost::program_options::options_description options(
+      "usage: ./benchmark_driver [<instance.mps> ...] [<options>]");
+  options.add_options()("help", "Print this message.")(
+      "soy", boost::program_options::value<std::string>(&soy)->default_value(
+                 soy),
+      "The Soy binary.")(
+      "suite-dir",
+      boost::program_options::value<std::string>(&suiteDirectory)
+          ->default_value(suiteDirectory),
+      "Where generated instances, logs and summaries go. Without instances "
+      "on the command line, every .mps file in it is run.")(
+      "config",
+      boost::program_options::value<std::vector<std::string>>(
+          &configurationStrings),
+      "A configuration to run, as name=\"<Soy options>\". May be repeated; "
+      "defaults to a single configuration with the default options.")(
+      "milp", "Also run every instance with --milp (Gurobi on the MILP).")(
+      "timeout",
+      boost::program_options::value<int>(&timeout)->default_value(timeout),
+      "Timeout of every run, in seconds.")(
+      "csv", boost::program_options::value<std::string>(&csvPath),
+      "Write the results as CSV to this file.")(
+      "json", boost::program_options::value<std::string>(&jsonPath),
+      "Write the results as JSON to this file.")(
+      "generate",
+      boost::program_options::value<unsigned>(&numberOfInstances)
+          ->default_value(0),
+      "Generate this many PWA instances, with consecutive seeds, into the "
+      "suite directory first.")(
+      "horizon",
+      boost::program_options::value<unsigned>(&parameters._horizon)
+          ->default_value(parameters._horizon),
+      "Generator: number of steps.")(
+      "state-dim",
+      boost::program_options::value<unsigned>(&parameters._stateDimension)
+          ->default_value(parameters._stateDimension),
+      "Generator: dimension of the state.")(
+      "input-dim",
+      boost::program_options::value<unsigned>(&parameters._inputDimension)
+          ->default_value(parameters._inputDimension),
+      "Generator: dimension of the control input.")(
+      "modes",
+      boost::program_options::value<unsigned>(&parameters._numberOfModes)
+          ->default_value(parameters._numberOfModes),
+      "Generator: number of modes.")(
+      "geometry",
+      boost::program_options::value<std::string>(&geometry)->default_value(
+          geometry),
+      "Generator: shape of the mode regions, slabs/voronoi.")(
+      "seed",
+      boost::program_options::value<unsigned>(&parameters._seed)
+          ->default_value(parameters._seed),
+      "Generator: seed of the first instance.")(
+      "unsat-bias",
+      boost::program_options::value<double>(&parameters._unsatBias)
+          ->default_value(parameters._unsatBias),
+      "Generator: in [0, 1], higher makes infeasible instances more "
+      "likely.");
+
+  boost::program_options::options_description positional;
+  positional.add_options()(
+      "instance",
+      boost::program_options::value<std::vector<std::string>>(
+          &instanceArguments),
+      "");
+  boost::program_options::positional_options_description positionalOptions;
+  positionalOptions.add("instance", -1);
+  boost::program_options::options_description allOptions;
+  allOptions.add(options).add(positional);
+
+  try {
+    boost::program_options::variables_map variables;
+    boost::program_options::store(
+        boost::program_options::command_line_parser(argc, argv)
+            .options(allOptions)
+            .positional(positionalOptions)
+            .run(),
+        variables);
+    boost::program_options::notify(variables);
+
+    if (variables.count("help")) {
+      std::cerr << options << std::endl;
+      return 0;
+    }
+
+    mkdir(suiteDirectory.c_str(), 0755);
+
+    Vector<String> instances;
+    for (const auto &instance : instanceArguments)
+      instances.append(instance.c_str());
+
+    if (numberOfInstances > 0) {
+      parameters._geometry = PwaMpsGenerator::parseGeometry(geometry.c_str());
+      unsigned firstSeed = parameters._seed;
+      for (unsigned i = 0; i < numberOfInstances; ++i) {
+        parameters._seed = firstSeed + i;
+        String path = Stringf("%s/pwa_%u.mps", suiteDirectory.c_str(),
+                              parameters._seed);
+        PwaMpsGenerator(parameters).writeToFile(path);
+        instances.append(path);
+      }
+    } else if (instances.empty()) {
+      if (File::directory(suiteDirectory.c_str()))
+        File::listDirectory(suiteDirectory.c_str(), ".mps", instances);
+    }
+
+    if (instances.empty()) {
+      printf("Error: no instances to run\n");
+      return 1;
+    }
+
+    Vector<Configuration> configurations;
+    for (const auto &string : configurationStrings) {
+      size_t separator = string.find('=');
+      Configuration configuration;
+      configuration._name = string.substr(0, separator).c_str();
+      if (separator != std::string::npos) {
+        String arguments = string.substr(separator + 1).c_str();
+        for (const auto &argument : arguments.tokenize(" "))
+          configuration._arguments.append(argument);
+      }
+      configurations.append(configuration);
+    }
+    if (configurations.empty()) {
+      Configuration configuration;
+      configuration._name = "default";
+      configurations.append(configuration);
+    }
+    if (variables.count("milp")) {
+      Configuration configuration;
+      configuration._name = "milp";
+      configuration._arguments.append("--milp");
+      configurations.append(configuration);
+    }
+
+    printf("%-24s %-16s %-8s %10s %10s %10s %10s %10s\n", "instance",
+           "configuration", "result", "seconds", "lp calls", "sat calls",
+           "splits", "conflicts");
+    Vector<RunResult> results;
+    for (const auto &instance : instances) {
+      for (const auto &configuration : configurations) {
+        RunResult result = runInstance(soy.c_str(), instance, configuration,
+                                       suiteDirectory.c_str(), timeout);
+        printf("%-24s %-16s %-8s %10.3f %10llu %10llu %10llu %10llu\n",
+               result._instance.ascii(), result._configuration.ascii(),
+               result._result.ascii(), result._wallSeconds, result._lpCalls,
+               result._satCalls, result._splits, result._conflicts);
+        fflush(stdout);
+        results.append(result);
+      }
+    }
+
+    if (!csvPath.empty()) writeCsv(csvPath.c_str(), results);
+    if (!jsonPath.empty()) writeJson(jsonPath.c_str(), results);
+  } catch (const boost::program_options::error &e) {
+    printf("Error: %s\n", e.what());
+    return 1;
+  } catch (const Error &e) {
+    printf("Caught a %s error. Code: %u, Errno: %i, Message: %s.\n",
+           e.getErrorClass(), e.getCode(), e.getErrno(), e.getUserMessage());
+    return 1;
+  }
+
+  return 0;
+}
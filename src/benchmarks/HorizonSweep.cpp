@@ -0,0 +1,209 @@
+/*
+  Bounded-model-checking style sweep over the horizon of a PWA control
+  problem generated with PwaMpsGenerator: the problem is solved for the
+  horizons start, start + step, ..., end, stopping at the first satisfiable
+  one, in two ways:
+
+  - incrementally, with a single HorizonIncrementalSolver that only adds the
+    new steps of each horizon to the engine of the previous one, and
+  - independently, with a fresh engine per horizon, as Soy does.
+
+  The instances of all horizons are generated from the same seed, so that
+  they share the dynamics, the regions and the initial state. Both ways parse
+  the MPS file of every horizon, which is counted in their times. Reports the
+  result and the time of every horizon, and the totals.
+
+  Usage:
+    horizon_sweep --horizon-start 6 --horizon-end 30 --horizon-step 2
+        --modes 4 --seed 7 --timeout 600
+*/
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "Engine.h"
+#include "Error.h"
+#include "HorizonIncrementalSolver.h"
+#include "InputQuery.h"
+#include "MStringf.h"
+#include "MpsParser.h"
+#include "PwaMpsGenerator.h"
+#include "TimeUtils.h"
+#include "boost/program_options.hpp"
+
+static const char *exitCodeToString(Engine::ExitCode exitCode) {
+  switch (exitCode) {
+    case Engine::SAT:
+      return "sat";
+    case Engine::UNSAT:
+      return "unsat";
+    case Engine::TIMEOUT:
+      return "timeout";
+    default:
+      return "unknown";
+  }
+}
+
+static Engine::ExitCode solveIndependently(const String &path,
+                                           unsigned timeout) {
+  InputQuery query;
+  MpsParser(path).generateQuery(query);
+
+  Engine engine;
+  if (!engine.processInputQuery(query)) return engine.getExitCode();
+  engine.solve(timeout);
+  return engine.getExitCode();
+}
+
+static Engine::ExitCode solveIncrementally(HorizonIncrementalSolver &solver,
+                                           const String &path,
+                                           unsigned timeout) {
+  InputQuery query;
+  MpsParser parser(path);
+  parser.generateQuery(query);
+  return solver.solve(query, parser.getVariableNameToVariableIndex(),
+                      timeout);
+}
+
+int main(int argc, char *argv[]) {
+  PwaMpsGenerator::Parameters parameters;
+  std::string geometry = "slabs";
+  unsigned horizonStart = 6;
+  unsigned horizonEnd = 30;
+  unsigned horizonStep = 2;
+  unsigned timeout = 600;
+
+  boost::program_options::options_description options(
+      "usage: ./horizon_sweep [<options>]");
+  options.add_options()("help", "Print this message.")(
+      "horizon-start",
+      boost::program_options::value<unsigned>(&horizonStart)
+          ->default_value(horizonStart),
+      "The first horizon.")(
+      "horizon-end",
+      boost::program_options::value<unsigned>(&horizonEnd)
+          ->default_value(horizonEnd),
+      "The last horizon.")(
+      "horizon-step",
+      boost::program_options::value<unsigned>(&horizonStep)
+          ->default_value(horizonStep),
+      "The number of steps added at each horizon.")(
+      "all-horizons", "Do not stop at the first satisfiable horizon.")(
+      "timeout",
+      boost::program_options::value<unsigned>(&timeout)->default_value(
+          timeout),
+      "Timeout of every solve, in seconds.")(
+      "state-dim",
+      boost::program_options::value<unsigned>(&parameters._stateDimension)
+          ->default_value(parameters._stateDimension),
+      "Generator: dimension of the state.")(
+      "input-dim",
+      boost::program_options::value<unsigned>(&parameters._inputDimension)
+          ->default_value(parameters._inputDimension),
+      "Generator: dimension of the control input.")(
+      "modes",
+      boost::program_options::value<unsigned>(&parameters._numberOfModes)
+          ->default_value(parameters._numberOfModes),
+      "Generator: number of modes.")(
+      "geometry",
+      boost::program_options::value<std::string>(&geometry)->default_value(
+          geometry),
+      "Generator: shape of the mode regions, slabs/voronoi.")(
+      "seed",
+      boost::program_options::value<unsigned>(&parameters._seed)
+          ->default_value(parameters._seed),
+      "Generator: seed of the instances.")(
+      "unsat-bias",
+      boost::program_options::value<double>(&parameters._unsatBias)
+          ->default_value(parameters._unsatBias),
+      "Generator: in [0, 1], higher makes infeasible instances more "
+      "likely.");
+
+  try {
+    boost::program_options::variables_map variables;
+    boost::program_options::store(
+        boost::program_options::parse_command_line(argc, argv, options),
+        variables);
+    boost::program_options::notify(variables);
+
+    if (variables.count("help")) {
+      std::cerr << options << std::endl;
+      return 0;
+    }
+    if (horizonStep == 0 || horizonStart > horizonEnd) {
+      printf("Error: empty range of horizons\n");
+      return 1;
+    }
+    parameters._geometry = PwaMpsGenerator::parseGeometry(geometry.c_str());
+
+    HorizonIncrementalSolver solver;
+    unsigned long long incrementalTotal = 0;
+    unsigned long long independentTotal = 0;
+    unsigned mismatches = 0;
+    Vector<String> rows;
+
+    for (unsigned horizon = horizonStart; horizon <= horizonEnd;
+         horizon += horizonStep) {
+      parameters._horizon = horizon;
+      String path = Stringf("horizon_sweep_%u_%u.mps", parameters._seed,
+                            horizon);
+      PwaMpsGenerator(parameters).writeToFile(path);
+
+      struct timespec start = TimeUtils::sampleMicro();
+      Engine::ExitCode incremental =
+          solveIncrementally(solver, path, timeout);
+      struct timespec end = TimeUtils::sampleMicro();
+      unsigned long long incrementalTime = TimeUtils::timePassed(start, end);
+
+      start = TimeUtils::sampleMicro();
+      Engine::ExitCode independent = solveIndependently(path, timeout);
+      end = TimeUtils::sampleMicro();
+      unsigned long long independentTime = TimeUtils::timePassed(start, end);
+
+      remove(path.ascii());
+
+      incrementalTotal += incrementalTime;
+      independentTotal += independentTime;
+      bool decided = (incremental == Engine::SAT ||
+                      incremental == Engine::UNSAT) &&
+                     (independent == Engine::SAT ||
+                      independent == Engine::UNSAT);
+      if (decided && incremental != independent) ++mismatches;
+
+      rows.append(Stringf("%8u %12s %12.3f %12s %12.3f", horizon,
+                          exitCodeToString(incremental),
+                          incrementalTime / 1000000.0,
+                          exitCodeToString(independent),
+                          independentTime / 1000000.0));
+
+      if (!variables.count("all-horizons") &&
+          (incremental == Engine::SAT || independent == Engine::SAT))
+        break;
+    }
+
+    // The solvers print as they go, so the table comes last
+    printf("\n%8s %12s %12s %12s %12s\n", "horizon", "incremental",
+           "seconds", "independent", "seconds");
+    for (const auto &row : rows) printf("%s\n", row.ascii());
+    printf("%8s %12s %12.3f %12s %12.3f\n", "total", "",
+           incrementalTotal / 1000000.0, "", independentTotal / 1000000.0);
+    if (incrementalTotal > 0)
+      printf("Speedup of the incremental sweep: %.2fx\n",
+             (double)independentTotal / incrementalTotal);
+
+    if (mismatches > 0) {
+      printf("Mismatch: the results differ at %u horizons\n", mismatches);
+      return 1;
+    }
+  } catch (const boost::program_options::error &e) {
+    printf("Error: %s\n", e.what());
+    return 1;
+  } catch (const Error &e) {
+    printf("Caught a %s error. Code: %u, Errno: %i, Message: %s.\n",
+           e.getErrorClass(), e.getCode(), e.getErrno(), e.getUserMessage());
+    return 1;
+  }
+
+  return 0;
+}
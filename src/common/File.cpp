@@ -15,6 +15,8 @@
 
 #include "File.h"
 
+#include <dirent.h>
+
 #include "CommonError.h"
 #include "ConstSimpleData.h"
 #include "HeapData.h"
@@ -48,6 +50,24 @@ unsigned File::getSize(const String &path) {
   return dataBuffer.st_size;
 }
 
+void File::listDirectory(const String &directory, const String &suffix,
+                         Vector<String> &paths) {
+  DIR *dir = opendir(directory.ascii());
+  if (!dir) throw CommonError(CommonError::OPEN_FAILED, directory.ascii());
+
+  Vector<String> names;
+  while (struct dirent *entry = readdir(dir)) {
+    String name = entry->d_name;
+    if (name.length() > suffix.length() &&
+        name.substring(name.length() - suffix.length(), suffix.length()) ==
+            suffix)
+      names.append(name);
+  }
+  closedir(dir);
+  names.sort();
+  for (const auto &name : names) paths.append(directory + "/" + name);
+}
+
 void File::open(Mode openMode) {
   int flags;
   mode_t mode;
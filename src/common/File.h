@@ -21,6 +21,7 @@ class HeapData;
 
 #include "IFile.h"
 #include "MString.h"
+#include "Vector.h"
 
 #ifdef _WIN32
 #include <io.h>
@@ -66,6 +67,10 @@ class File : public IFile {
   void close();
   static bool directory(const String &path);
   static unsigned getSize(const String &path);
+  // Append the paths of the files of a directory whose names end with the
+  // suffix, sorted by name
+  static void listDirectory(const String &directory, const String &suffix,
+                            Vector<String> &paths);
   void open(Mode openMode);
   void write(const String &line);
   void write(const ConstSimpleData &data);
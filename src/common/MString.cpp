@@ -78,11 +78,13 @@ List<String> String::tokenize(String delimiter) const {
   char *copy(copyVector.data());
   memcpy(copy, ascii(), sizeof(char) * (length() + 1));
 
-  char *token = strtok(copy, delimiter.ascii());
+  // strtok_r, as queries are parsed concurrently by the solver daemon
+  char *state = NULL;
+  char *token = strtok_r(copy, delimiter.ascii(), &state);
 
   while (token != NULL) {
     tokens.append(String(token));
-    token = strtok(NULL, delimiter.ascii());
+    token = strtok_r(NULL, delimiter.ascii(), &state);
   }
 
   return tokens;
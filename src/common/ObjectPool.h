@@ -0,0 +1,137 @@
+/*********************                                                        */
+/*! \file ObjectPool.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** A pool of fixed-size objects carved out of large blocks. Released objects
+ ** go to a free list and are handed out again before the pool touches a new
+ ** slot. Blocks are only returned to the heap when the pool is destroyed, so
+ ** reset() makes every slot available again without any heap traffic.
+ **/
+
+#ifndef __ObjectPool_h__
+#define __ObjectPool_h__
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Debug.h"
+#include "Statistics.h"
+#include "Vector.h"
+
+template <class T>
+class ObjectPool {
+ public:
+  ObjectPool(unsigned objectsPerBlock = 64)
+      : _objectsPerBlock(objectsPerBlock),
+        _freeList(NULL),
+        _currentBlock(0),
+        _nextSlot(objectsPerBlock),
+        _numberOfLiveObjects(0),
+        _numberOfAllocations(0),
+        _statistics(NULL) {
+    ASSERT(_objectsPerBlock > 0);
+  }
+
+  ~ObjectPool() {
+    for (Slot *block : _blocks) delete[] block;
+  }
+
+  void setStatistics(Statistics *statistics) { _statistics = statistics; }
+
+  template <class... Args>
+  T *allocate(Args &&... args) {
+    Slot *slot = _freeList;
+    if (slot)
+      _freeList = slot->_next;
+    else
+      slot = takeFreshSlot();
+
+    ++_numberOfLiveObjects;
+    ++_numberOfAllocations;
+    if (_statistics)
+      _statistics->incLongAttribute(Statistics::NUM_ARENA_ALLOCATIONS);
+    return new (&slot->_storage) T(std::forward<Args>(args)...);
+  }
+
+  void release(T *object) {
+    ASSERT(_numberOfLiveObjects > 0);
+    object->~T();
+    Slot *slot = reinterpret_cast<Slot *>(object);
+    slot->_next = _freeList;
+    _freeList = slot;
+    --_numberOfLiveObjects;
+  }
+
+  /*
+    Make every slot available again. Live objects are dropped without running
+    their destructors, so this is only offered for trivially destructible
+    types.
+  */
+  void reset() {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "ObjectPool::reset() would skip non-trivial destructors");
+    _freeList = NULL;
+    _currentBlock = 0;
+    _nextSlot = _blocks.empty() ? _objectsPerBlock : 0;
+    _numberOfLiveObjects = 0;
+  }
+
+  unsigned getNumberOfLiveObjects() const { return _numberOfLiveObjects; }
+
+  unsigned long long getNumberOfAllocations() const {
+    return _numberOfAllocations;
+  }
+
+  unsigned getNumberOfBlocks() const { return _blocks.size(); }
+
+  unsigned long long getBytesReserved() const {
+    return (unsigned long long)_blocks.size() * _objectsPerBlock *
+           sizeof(Slot);
+  }
+
+ private:
+  union Slot {
+    Slot *_next;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+  };
+
+  unsigned _objectsPerBlock;
+  Vector<Slot *> _blocks;
+  Slot *_freeList;
+
+  // Bump pointer into the blocks, used once the free list is empty
+  unsigned _currentBlock;
+  unsigned _nextSlot;
+
+  unsigned _numberOfLiveObjects;
+  unsigned long long _numberOfAllocations;
+
+  Statistics *_statistics;
+
+  Slot *takeFreshSlot() {
+    if (_nextSlot == _objectsPerBlock) {
+      if (!_blocks.empty() && _currentBlock + 1 < _blocks.size()) {
+        ++_currentBlock;
+      } else {
+        _blocks.append(new Slot[_objectsPerBlock]);
+        _currentBlock = _blocks.size() - 1;
+        if (_statistics) {
+          _statistics->incLongAttribute(
+              Statistics::NUM_ARENA_BLOCK_ALLOCATIONS);
+          _statistics->incLongAttribute(Statistics::ARENA_BYTES_RESERVED,
+                                        _objectsPerBlock * sizeof(Slot));
+        }
+      }
+      _nextSlot = 0;
+    }
+    return &_blocks[_currentBlock][_nextSlot++];
+  }
+};
+
+#endif  // __ObjectPool_h__
@@ -0,0 +1,158 @@
+/*********************                                                        */
+/*! \file Profiler.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** [[ Add lengthier description here ]]
+ **/
+
+#include "Profiler.h"
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#include "Debug.h"
+#include "File.h"
+#include "MStringf.h"
+
+namespace {
+// The profilers of all threads that ever opened a scope
+std::mutex registryMutex;
+Vector<Profiler *> registry;
+}  // namespace
+
+Profiler::Profiler() : _current(0) {
+  // Node 0 is the root of the tree; it is never opened or closed
+  _nodes.append(Node("", 0));
+}
+
+Profiler &Profiler::getThreadProfiler() {
+  // The profilers are never deleted, so that they can be reported after their
+  // threads exit
+  thread_local Profiler *profiler = NULL;
+  if (!profiler) {
+    profiler = new Profiler;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.append(profiler);
+  }
+  return *profiler;
+}
+
+double Profiler::getTicksPerMicrosecond() {
+  static const double ticksPerMicrosecond = []() {
+    auto clockStart = std::chrono::steady_clock::now();
+    unsigned long long ticksStart = readTicks();
+    auto clockEnd = clockStart;
+    do {
+      clockEnd = std::chrono::steady_clock::now();
+    } while (clockEnd - clockStart < std::chrono::milliseconds(20));
+    unsigned long long ticksEnd = readTicks();
+
+    double micro =
+        std::chrono::duration<double, std::micro>(clockEnd - clockStart)
+            .count();
+    return (ticksEnd - ticksStart) / micro;
+  }();
+  return ticksPerMicrosecond;
+}
+
+void Profiler::open(const char *name) {
+  unsigned child = 0;
+  for (unsigned candidate : _nodes[_current]._children) {
+    // The same literal may have several addresses across translation units
+    const char *candidateName = _nodes[candidate]._name;
+    if (candidateName == name || strcmp(candidateName, name) == 0) {
+      child = candidate;
+      break;
+    }
+  }
+
+  if (child == 0) {
+    child = _nodes.size();
+    _nodes.append(Node(name, _current));
+    _nodes[_current]._children.append(child);
+  }
+
+  ++_nodes[child]._calls;
+  _current = child;
+}
+
+void Profiler::close(unsigned long long ticks) {
+  ASSERT(_current != 0);
+  _nodes[_current]._ticks += ticks;
+  _current = _nodes[_current]._parent;
+}
+
+void Profiler::getPathSamples(Map<String, PathSample> &samples) const {
+  for (unsigned child : _nodes[0]._children)
+    getPathSamples(child, "", samples);
+}
+
+void Profiler::getPathSamples(unsigned node, const String &prefix,
+                              Map<String, PathSample> &samples) const {
+  const Node &current = _nodes[node];
+  String path = prefix.length() == 0 ? String(current._name)
+                                     : prefix + ";" + current._name;
+
+  unsigned long long childTicks = 0;
+  for (unsigned child : current._children) childTicks += _nodes[child]._ticks;
+
+  double ticksPerMicrosecond = getTicksPerMicrosecond();
+  PathSample &sample = samples[path];
+  sample._calls += current._calls;
+  sample._inclusiveMicro += current._ticks / ticksPerMicrosecond;
+  // A scope that is still open has fewer ticks than its closed children
+  if (current._ticks > childTicks)
+    sample._selfMicro += (current._ticks - childTicks) / ticksPerMicrosecond;
+
+  for (unsigned child : current._children)
+    getPathSamples(child, path, samples);
+}
+
+void Profiler::getAllPathSamples(Map<String, PathSample> &samples) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  for (const auto &profiler : registry) profiler->getPathSamples(samples);
+}
+
+void Profiler::printReport() {
+  Map<String, PathSample> samples;
+  getAllPathSamples(samples);
+
+  printf("\t--- Profile (all threads) ---\n");
+  printf("\t%12s %14s %14s  %s\n", "calls", "inclusive ms", "self ms",
+         "scope");
+  // The map is ordered by path, so every node follows its parent
+  for (const auto &pair : samples) {
+    const String &path = pair.first;
+    unsigned depth = 0;
+    unsigned nameStart = 0;
+    for (unsigned i = 0; i < path.length(); ++i) {
+      if (path[i] == ';') {
+        ++depth;
+        nameStart = i + 1;
+      }
+    }
+
+    printf("\t%12llu %14.3f %14.3f  %*s%s\n", pair.second._calls,
+           pair.second._inclusiveMicro / 1000, pair.second._selfMicro / 1000,
+           (int)(2 * depth), "", path.ascii() + nameStart);
+  }
+}
+
+void Profiler::writeFoldedStacks(const String &path) {
+  Map<String, PathSample> samples;
+  getAllPathSamples(samples);
+
+  File file(path);
+  file.open(File::MODE_WRITE_TRUNCATE);
+  for (const auto &pair : samples) {
+    unsigned long long selfMicro = pair.second._selfMicro;
+    if (selfMicro == 0) continue;
+    file.write(Stringf("%s %llu\n", pair.first.ascii(), selfMicro));
+  }
+}
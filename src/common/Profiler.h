@@ -0,0 +1,151 @@
+/*********************                                                        */
+/*! \file Profiler.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Scoped timers that record a call tree per thread. A PROFILE_SCOPE("name")
+ ** at the top of a block times the block and places it under the innermost
+ ** enclosing scope, so nested regions are not double counted: every node of
+ ** the tree knows its call count, its inclusive time, and its self time
+ ** (inclusive time minus the time of its children).
+ **
+ ** Timestamps come from the time-stamp counter where available, and are
+ ** converted to microseconds only when reporting. PROFILE_SCOPE expands to
+ ** nothing unless the build defines ENABLE_PROFILING (cmake
+ ** -DENABLE_PROFILING=ON), so the instrumentation costs nothing otherwise.
+ **/
+
+#ifndef __Profiler_h__
+#define __Profiler_h__
+
+#include <chrono>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "MString.h"
+#include "Map.h"
+#include "Vector.h"
+
+#ifdef ENABLE_PROFILING
+#define PROFILE_SCOPE_CONCAT_INNER(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) \
+  ProfileScope PROFILE_SCOPE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+class Profiler {
+ public:
+  /*
+    Merged values of one path of the call tree, e.g. "main_loop;deep_soi"
+  */
+  struct PathSample {
+    PathSample() : _calls(0), _inclusiveMicro(0), _selfMicro(0) {}
+
+    unsigned long long _calls;
+    double _inclusiveMicro;
+    double _selfMicro;
+  };
+
+  /*
+    The profiler of the calling thread. Created on first use, and kept alive
+    after the thread exits so that it can still be reported.
+  */
+  static Profiler &getThreadProfiler();
+
+  static inline unsigned long long readTicks() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  /*
+    Calibrated once, on first use, against the steady clock.
+  */
+  static double getTicksPerMicrosecond();
+
+  /*
+    Open a child of the current node, creating it on first use, and make it
+    the current node. close() closes the current node and charges it
+    the given number of ticks.
+  */
+  void open(const char *name);
+  void close(unsigned long long ticks);
+
+  /*
+    Add the paths of this thread's call tree to the map, keyed by the
+    ';'-separated node names.
+  */
+  void getPathSamples(Map<String, PathSample> &samples) const;
+
+  /*
+    The call trees of all threads, merged by path. Only meaningful once the
+    profiled threads are done.
+  */
+  static void getAllPathSamples(Map<String, PathSample> &samples);
+
+  /*
+    Print every node of the merged call tree with its call count, inclusive
+    time and self time.
+  */
+  static void printReport();
+
+  /*
+    Write the merged call tree as folded stacks, one "a;b;c <self micro>"
+    line per node, the input format of flamegraph.pl and speedscope.
+  */
+  static void writeFoldedStacks(const String &path);
+
+ private:
+  struct Node {
+    Node(const char *name, unsigned parent)
+        : _name(name), _parent(parent), _calls(0), _ticks(0) {}
+
+    const char *_name;
+    unsigned _parent;
+    Vector<unsigned> _children;
+    unsigned long long _calls;
+    unsigned long long _ticks;
+  };
+
+  Profiler();
+
+  Vector<Node> _nodes;
+  unsigned _current;
+
+  void getPathSamples(unsigned node, const String &prefix,
+                      Map<String, PathSample> &samples) const;
+};
+
+class ProfileScope {
+ public:
+  explicit ProfileScope(const char *name)
+      : _profiler(Profiler::getThreadProfiler()) {
+    _profiler.open(name);
+    _start = Profiler::readTicks();
+  }
+
+  ~ProfileScope() { _profiler.close(Profiler::readTicks() - _start); }
+
+ private:
+  Profiler &_profiler;
+  unsigned long long _start;
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#endif  // __Profiler_h__
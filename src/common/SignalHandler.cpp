@@ -16,9 +16,17 @@
 
 #include "SignalHandler.h"
 
+#include <errno.h>
 #include <signal.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include <cstring>
+#include <thread>
+
+#include "CommonError.h"
 
 void got_signal(int signalNumber) {
   SignalHandler::getInstance()->signalReceived(signalNumber);
@@ -30,7 +38,13 @@ SignalHandler *SignalHandler::getInstance() {
 }
 
 void SignalHandler::registerClient(Signalable *client) {
-  _clients.append(client);
+  std::lock_guard<std::mutex> lock(_clientsMutex);
+  if (!_clients.exists(client)) _clients.append(client);
+}
+
+void SignalHandler::unregisterClient(Signalable *client) {
+  std::lock_guard<std::mutex> lock(_clientsMutex);
+  _clients.erase(client);
 }
 
 void SignalHandler::initialize() {
@@ -39,6 +53,14 @@ void SignalHandler::initialize() {
   signal(SIGTERM, got_signal);
   signal(SIGABRT, got_signal);
 #else
+  std::call_once(_dispatcherStarted, [this]() {
+    // The handler must not block on a full pipe
+    if (pipe(_wakeUpPipe) == -1 ||
+        fcntl(_wakeUpPipe[1], F_SETFL, O_NONBLOCK) == -1)
+      throw CommonError(CommonError::OPEN_FAILED, "Signal handler pipe");
+    std::thread(&SignalHandler::runDispatcher, this).detach();
+  });
+
   struct sigaction sa;
   memset(&sa, 0, sizeof(sa));
   sa.sa_handler = got_signal;
@@ -49,9 +71,38 @@ void SignalHandler::initialize() {
 }
 
 void SignalHandler::signalReceived(unsigned /* signalNumber */) {
+  _signalPending = true;
+#ifdef _WIN32
+  // The handler already runs on a thread of its own
+  dispatchSignals();
+#else
+  // A full pipe already wakes up the dispatcher, the write can fail
+  int savedErrno = errno;
+  char byte = 0;
+  ssize_t written = write(_wakeUpPipe[1], &byte, 1);
+  (void)written;
+  errno = savedErrno;
+#endif
+}
+
+void SignalHandler::dispatchSignals() {
+  if (!_signalPending.exchange(false)) return;
+  std::lock_guard<std::mutex> lock(_clientsMutex);
   for (const auto &signalable : _clients) signalable->quitSignal();
 }
 
+void SignalHandler::runDispatcher() {
+#ifndef _WIN32
+  char byte;
+  while (true) {
+    ssize_t bytesRead = read(_wakeUpPipe[0], &byte, 1);
+    if (bytesRead == -1 && errno == EINTR) continue;
+    if (bytesRead <= 0) return;
+    dispatchSignals();
+  }
+#endif
+}
+
 //
 // Local Variables:
 // compile-command: "make -C ../.. "
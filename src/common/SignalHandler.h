@@ -16,6 +16,9 @@
 #ifndef __SignalHandler_h__
 #define __SignalHandler_h__
 
+#include <atomic>
+#include <mutex>
+
 #include "List.h"
 
 class SignalHandler {
@@ -31,27 +34,54 @@ class SignalHandler {
   static SignalHandler *getInstance();
 
   /*
-    Register a client to receive signals
+    Register a client to receive signals. Registering a client twice has no
+    effect. Clients can be registered and unregistered from any thread.
   */
   void registerClient(Signalable *client);
 
   /*
-    Initialize the signal handling
+    Stop sending signals to a client, e.g., before it is destroyed
+  */
+  void unregisterClient(Signalable *client);
+
+  /*
+    Initialize the signal handling, and start the thread that passes the
+    signals on to the clients
   */
   void initialize();
 
   /*
-    Called when a signal is received
+    Called from the signal handler. Taking the lock of the clients or
+    calling them is not async-signal-safe, so this only sets a flag and
+    wakes up the dispatching thread, which calls quitSignal().
   */
   void signalReceived(unsigned signalNumber);
 
  private:
   List<Signalable *> _clients;
+  std::mutex _clientsMutex;
+
+  // Set by the signal handler, cleared once the clients are called
+  std::atomic<bool> _signalPending;
+
+  // The signal handler writes a byte to [1] for every signal
+  int _wakeUpPipe[2];
+  std::once_flag _dispatcherStarted;
+
+  /*
+    Call quitSignal() on the clients if a signal is pending
+  */
+  void dispatchSignals();
+
+  /*
+    The loop of the dispatching thread
+  */
+  void runDispatcher();
 
   /*
     Prevent additional instantiations of the class
   */
-  SignalHandler() {}
+  SignalHandler() : _signalPending(false), _wakeUpPipe{-1, -1} {}
   SignalHandler(const SignalHandler &) {}
 };
 
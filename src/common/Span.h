@@ -0,0 +1,49 @@
+/*********************                                                        */
+/*! \file Span.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** A read-only view of a contiguous range of elements. It does not own the
+ ** elements, and is invalidated when the underlying container changes.
+ **/
+
+#ifndef __Span_h__
+#define __Span_h__
+
+#include "Debug.h"
+#include "Vector.h"
+
+template <class T>
+class Span {
+ public:
+  typedef const T *const_iterator;
+
+  Span() : _begin(NULL), _size(0) {}
+
+  Span(const T *begin, unsigned size) : _begin(begin), _size(size) {}
+
+  Span(const Vector<T> &vector) : _begin(vector.data()), _size(vector.size()) {}
+
+  const_iterator begin() const { return _begin; }
+
+  const_iterator end() const { return _begin + _size; }
+
+  unsigned size() const { return _size; }
+
+  bool empty() const { return _size == 0; }
+
+  const T &operator[](unsigned index) const {
+    ASSERT(index < _size);
+    return _begin[index];
+  }
+
+ private:
+  const T *_begin;
+  unsigned _size;
+};
+
+#endif  // __Span_h__
@@ -18,58 +18,139 @@
 #include "FloatUtils.h"
 #include "TimeUtils.h"
 
+namespace {
+// Indexed by the attribute enums; keep in the same order.
+const char *const UNSIGNED_ATTRIBUTE_NAMES[] = {
+    "NUM_PL_CONSTRAINTS",
+    "NUM_ACTIVE_PL_CONSTRAINTS",
+    "NUM_PL_VALID_CONSTRAINTS",
+    "NUM_PL_SMT_ORIGINATED_SPLITS",
+    "CURRENT_DECISION_LEVEL",
+    "MAX_DECISION_LEVEL",
+    "NUM_VARIABLES",
+    "NUM_EQUATIONS",
+    "NUM_SPLITS",
+    "NUM_POPS",
+    "NUM_RESTART",
+    "NUM_REFUTATIONS_BY_SAT_SOLVER",
+    "NUM_SOI_COST_MINIMIZATIONS",
+    "NUM_LP_FEASIBILITY_CHECK",
+    "NUM_REFUTATIONS_BY_THEORY_SOLVER",
+    "NUM_MILP_CHECKS",
+    "NUM_MILP_CHECKS_EXPIRED",
+    "NUM_REFUTATIONS_BY_BOUND_TIGHTENING",
+    "NUM_VISITED_TREE_STATES",
+    "PP_NUM_TIGHTENING_ITERATIONS",
+    "PP_NUM_EQUATIONS_REMOVED",
+    "PRESOLVE_NUM_VARIABLES_REMOVED",
+    "PRESOLVE_NUM_EQUATIONS_REMOVED",
+    "PRESOLVE_NUM_ADDENDS_REMOVED",
+    "PRESOLVE_NUM_VARIABLES_CONDENSED",
+    "NUM_ROOT_CUTS",
+    "NUM_ROOT_CUT_ROUNDS",
+    "NUM_ROOT_CUT_EXCLUDED_ELEMENTS",
+    "HULL_NUM_GROUPS",
+    "HULL_NUM_VARIABLE_COPIES",
+    "NUM_BOOLEAN_VARIABLES",
+    "NUM_FIXED_BOOLEAN_VARIABLES",
+    "NUM_PROPOSALS_REJECTED_BY_SAT_SOLVER",
+    "NUM_PHASE_PATTERN_INITIALIZATIONS",
+    "NUM_INITIALIZATIONS_REJECTED_BY_SAT_SOLVER",
+    "NUM_SAT_CONSTRAINTS",
+    "NUM_SAT_SOLVER_CALLS",
+    "NUM_HINTED_PHASES",
+    "HINT_SOLVED_QUERY",
+    "NUM_HINTED_PHASES_CHANGED",
+};
+
+const char *const LONG_ATTRIBUTE_NAMES[] = {
+    "PREPROCESSING_TIME_MICRO",
+    "NUM_MAIN_LOOP_ITERATIONS",
+    "TIME_MAIN_LOOP_MICRO",
+    "TIME_LP_FEASIBILITY_CHECK_MICRO",
+    "TIME_MILP_CHECK_MICRO",
+    "TIME_THEORY_EXPLANATION_MICRO",
+    "TIME_SAT_SOLVING_MICRO",
+    "TIME_BOUND_TIGHTENING_MICRO",
+    "TOTAL_TIME_SMT_CORE_MICRO",
+    "TOTAL_TIME_PERFORMING_VALID_CASE_SPLITS_MICRO",
+    "TOTAL_TIME_LOCAL_SEARCH_MICRO",
+    "TIME_ADDING_CONSTRAINTS_TO_MILP_SOLVER_MICRO",
+    "TOTAL_TIME_HANDLING_STATISTICS_MICRO",
+    "TOTAL_TIME_UPDATING_SOI_PHASE_PATTERN_MICRO",
+    "NUM_PROPOSED_PHASE_PATTERN_UPDATE",
+    "NUM_ACCEPTED_PHASE_PATTERN_UPDATE",
+    "NUM_PROPOSALS_SINCE_LAST_REINITIALIZATION",
+    "TOTAL_TIME_GETTING_SOI_PHASE_PATTERN_MICRO",
+    "TOTAL_TIME_MINIMIZING_SOI_COST_WITH_GUROBI_MICRO",
+    "NUM_PHASE_PATTERN_CACHE_HITS",
+    "TOTAL_TIME_OBTAIN_CURRENT_ASSIGNMENT_SOI_MICRO",
+    "TOTAL_TIME_UPDATING_PSEUDO_IMPACT_MICRO",
+    "TOTAL_TIME_SAT_SOLVING_SOI_MICRO",
+    "NUM_ARENA_ALLOCATIONS",
+    "NUM_ARENA_BLOCK_ALLOCATIONS",
+    "ARENA_BYTES_RESERVED",
+    "TIME_CHECKING_HINT_MICRO",
+    "TIME_ROOT_CUTS_MICRO",
+    "NUM_BIG_M_REFRESHES",
+};
+
+const char *const DOUBLE_ATTRIBUTE_NAMES[] = {
+    "COST_OF_CURRENT_PHASE_PATTERN",
+    "MIN_COST_OF_PHASE_PATTERN",
+    "HINT_ASSIGNMENT_DISTANCE",
+    "ROOT_CUT_BOUND_IMPROVEMENT",
+};
+
+static_assert(sizeof(UNSIGNED_ATTRIBUTE_NAMES) / sizeof(const char *) ==
+                  Statistics::NUMBER_OF_UNSIGNED_ATTRIBUTES,
+              "Missing unsigned attribute name");
+static_assert(sizeof(LONG_ATTRIBUTE_NAMES) / sizeof(const char *) ==
+                  Statistics::NUMBER_OF_LONG_ATTRIBUTES,
+              "Missing long attribute name");
+static_assert(sizeof(DOUBLE_ATTRIBUTE_NAMES) / sizeof(const char *) ==
+                  Statistics::NUMBER_OF_DOUBLE_ATTRIBUTES,
+              "Missing double attribute name");
+}  // namespace
+
 Statistics::Statistics() : _timedOut(false) {
-  _unsignedAttributes[NUM_PL_CONSTRAINTS] = 0;
-  _unsignedAttributes[NUM_ACTIVE_PL_CONSTRAINTS] = 0;
-  _unsignedAttributes[NUM_PL_VALID_CONSTRAINTS] = 0;
-  _unsignedAttributes[NUM_PL_SMT_ORIGINATED_SPLITS] = 0;
-  _unsignedAttributes[CURRENT_DECISION_LEVEL] = 0;
-  _unsignedAttributes[MAX_DECISION_LEVEL] = 0;
-  _unsignedAttributes[NUM_VARIABLES] = 0;
-  _unsignedAttributes[NUM_EQUATIONS] = 0;
-  _unsignedAttributes[NUM_SPLITS] = 0;
-  _unsignedAttributes[NUM_POPS] = 0;
-  _unsignedAttributes[NUM_RESTART] = 0;
-  _unsignedAttributes[NUM_REFUTATIONS_BY_SAT_SOLVER] = 0;
-  _unsignedAttributes[NUM_LP_FEASIBILITY_CHECK] = 0;
-  _unsignedAttributes[NUM_REFUTATIONS_BY_THEORY_SOLVER] = 0;
-  _unsignedAttributes[NUM_REFUTATIONS_BY_BOUND_TIGHTENING] = 0;
-  _unsignedAttributes[NUM_VISITED_TREE_STATES] = 1;
-  _unsignedAttributes[PP_NUM_TIGHTENING_ITERATIONS] = 0;
-  _unsignedAttributes[PP_NUM_EQUATIONS_REMOVED] = 0;
-  _unsignedAttributes[PP_NUM_EQUATIONS_REMOVED] = 0;
-  _unsignedAttributes[NUM_BOOLEAN_VARIABLES] = 0;
-  _unsignedAttributes[NUM_FIXED_BOOLEAN_VARIABLES] = 0;
-  _unsignedAttributes[NUM_PROPOSALS_REJECTED_BY_SAT_SOLVER] = 0;
-  _unsignedAttributes[NUM_PHASE_PATTERN_INITIALIZATIONS] = 0;
-  _unsignedAttributes[NUM_INITIALIZATIONS_REJECTED_BY_SAT_SOLVER] = 0;
-  _unsignedAttributes[NUM_SAT_CONSTRAINTS] = 0;
-
-  _longAttributes[PREPROCESSING_TIME_MICRO] = 0;
-  _longAttributes[NUM_MAIN_LOOP_ITERATIONS] = 0;
-  _longAttributes[TIME_MAIN_LOOP_MICRO] = 0;
-  _longAttributes[TIME_LP_FEASIBILITY_CHECK_MICRO] = 0;
-  _longAttributes[TIME_SAT_SOLVING_MICRO] = 0;
-  _longAttributes[TIME_THEORY_EXPLANATION_MICRO] = 0;
-  _longAttributes[TOTAL_TIME_SMT_CORE_MICRO] = 0;
-  _longAttributes[TIME_BOUND_TIGHTENING_MICRO] = 0;
-  _longAttributes[TOTAL_TIME_PERFORMING_VALID_CASE_SPLITS_MICRO] = 0;
-  _longAttributes[TOTAL_TIME_LOCAL_SEARCH_MICRO] = 0;
-  _longAttributes[TOTAL_TIME_HANDLING_STATISTICS_MICRO] = 0;
-  _longAttributes[TOTAL_TIME_UPDATING_SOI_PHASE_PATTERN_MICRO] = 0;
-  _longAttributes[NUM_PROPOSED_PHASE_PATTERN_UPDATE] = 0;
-  _longAttributes[NUM_ACCEPTED_PHASE_PATTERN_UPDATE] = 0;
-  _longAttributes[NUM_PROPOSALS_SINCE_LAST_REINITIALIZATION] = 0;
-  _longAttributes[TOTAL_TIME_GETTING_SOI_PHASE_PATTERN_MICRO] = 0;
-  _longAttributes[TIME_ADDING_CONSTRAINTS_TO_MILP_SOLVER_MICRO] = 0;
-  _longAttributes[NUM_PHASE_PATTERN_CACHE_HITS] = 0;
-  _longAttributes[TOTAL_TIME_MINIMIZING_SOI_COST_WITH_GUROBI_MICRO] = 0;
-  _longAttributes[TOTAL_TIME_OBTAIN_CURRENT_ASSIGNMENT_SOI_MICRO] = 0;
-  _longAttributes[TOTAL_TIME_UPDATING_PSEUDO_IMPACT_MICRO] = 0;
-  _longAttributes[TOTAL_TIME_SAT_SOLVING_SOI_MICRO] = 0;
-
-  _doubleAttributes[COST_OF_CURRENT_PHASE_PATTERN] = FloatUtils::infinity();
-  _doubleAttributes[MIN_COST_OF_PHASE_PATTERN] = FloatUtils::infinity();
+  for (unsigned i = 0; i < NUMBER_OF_UNSIGNED_ATTRIBUTES; ++i)
+    _unsignedAttributes[i].store(0);
+  for (unsigned i = 0; i < NUMBER_OF_LONG_ATTRIBUTES; ++i)
+    _longAttributes[i].store(0);
+  for (unsigned i = 0; i < NUMBER_OF_DOUBLE_ATTRIBUTES; ++i)
+    _doubleAttributes[i].store(0);
+
+  _unsignedAttributes[NUM_VISITED_TREE_STATES].store(1);
+
+  _doubleAttributes[COST_OF_CURRENT_PHASE_PATTERN].store(
+      FloatUtils::infinity());
+  _doubleAttributes[MIN_COST_OF_PHASE_PATTERN].store(FloatUtils::infinity());
+}
+
+const char *Statistics::getAttributeName(StatisticsUnsignedAttribute attr) {
+  return UNSIGNED_ATTRIBUTE_NAMES[attr];
+}
+
+const char *Statistics::getAttributeName(StatisticsLongAttribute attr) {
+  return LONG_ATTRIBUTE_NAMES[attr];
+}
+
+const char *Statistics::getAttributeName(StatisticsDoubleAttribute attr) {
+  return DOUBLE_ATTRIBUTE_NAMES[attr];
+}
+
+void Statistics::snapshot(Snapshot &snapshot) const {
+  for (unsigned i = 0; i < NUMBER_OF_UNSIGNED_ATTRIBUTES; ++i)
+    snapshot._unsignedAttributes[i] =
+        _unsignedAttributes[i].load(std::memory_order_relaxed);
+  for (unsigned i = 0; i < NUMBER_OF_LONG_ATTRIBUTES; ++i)
+    snapshot._longAttributes[i] =
+        _longAttributes[i].load(std::memory_order_relaxed);
+  for (unsigned i = 0; i < NUMBER_OF_DOUBLE_ATTRIBUTES; ++i)
+    snapshot._doubleAttributes[i] =
+        _doubleAttributes[i].load(std::memory_order_relaxed);
+  snapshot._totalTimeMicro = getTotalTimeInMicro();
 }
 
 void Statistics::stampStartingTime() { _startTime = TimeUtils::sampleMicro(); }
@@ -132,6 +213,15 @@ void Statistics::print() {
       printPercents(timeFeasibilityCheckMicro, timeMainLoopMicro),
       timeFeasibilityCheckMicro / 1000,
       printAverage(timeFeasibilityCheckMicro, numFeasibilityChecks) / 1000);
+  unsigned long long timeMILPCheckMicro =
+      getLongAttribute(Statistics::TIME_MILP_CHECK_MICRO);
+  unsigned numMILPChecks = getUnsignedAttribute(Statistics::NUM_MILP_CHECKS);
+  printf(
+      "\t\t[%.2lf%%] MILP feasibility check: %llu milli (checks: %u, "
+      "undecided: %u)\n",
+      printPercents(timeMILPCheckMicro, timeMainLoopMicro),
+      timeMILPCheckMicro / 1000, numMILPChecks,
+      getUnsignedAttribute(Statistics::NUM_MILP_CHECKS_EXPIRED));
   unsigned long long timeTheoryExplanationMicro =
       getLongAttribute(Statistics::TIME_THEORY_EXPLANATION_MICRO);
   printf("\t\t[%.2lf%%] Theory explanation: %llu milli\n",
@@ -176,7 +266,8 @@ void Statistics::print() {
          totalTimeHandlingStatisticsMicro / 1000);
 
   unsigned long long total =
-    timeFeasibilityCheckMicro + timeTheoryExplanationMicro +
+    timeFeasibilityCheckMicro + timeMILPCheckMicro +
+    timeTheoryExplanationMicro +
     timeSatSolvingMicro + timeSmtCoreMicro + timeTighteningMicro +
     totalTimePerformingValidCaseSplitsMicro + totalTimePerformingLocalSearch +
     totalTimeAddingConstraintsToMILPSolver + totalTimeHandlingStatisticsMicro;
@@ -190,11 +281,32 @@ void Statistics::print() {
          getUnsignedAttribute(Statistics::PP_NUM_TIGHTENING_ITERATIONS));
   printf("\tNumber of equations removed due to variable elimination: %u\n",
          getUnsignedAttribute(Statistics::PP_NUM_EQUATIONS_REMOVED));
+  printf(
+      "\tPresolve: removed %u variables, %u equations and %u fixed "
+      "variable occurrences\n",
+      getUnsignedAttribute(Statistics::PRESOLVE_NUM_VARIABLES_REMOVED),
+      getUnsignedAttribute(Statistics::PRESOLVE_NUM_EQUATIONS_REMOVED),
+      getUnsignedAttribute(Statistics::PRESOLVE_NUM_ADDENDS_REMOVED));
+  printf("\tPresolve: condensed %u variables\n",
+         getUnsignedAttribute(Statistics::PRESOLVE_NUM_VARIABLES_CONDENSED));
 
   printf("\t--- Engine Statistics ---\n");
   printf("\tNumber of variables: %u, number of equations: %u\n",
          getUnsignedAttribute(Statistics::NUM_VARIABLES),
          getUnsignedAttribute(Statistics::NUM_EQUATIONS));
+  printf(
+      "\tRoot cuts: %u in %u rounds. Excluded elements: %u. "
+      "Bound improvement: %.4lf. Time: %llu milli\n",
+      getUnsignedAttribute(Statistics::NUM_ROOT_CUTS),
+      getUnsignedAttribute(Statistics::NUM_ROOT_CUT_ROUNDS),
+      getUnsignedAttribute(Statistics::NUM_ROOT_CUT_EXCLUDED_ELEMENTS),
+      getDoubleAttribute(Statistics::ROOT_CUT_BOUND_IMPROVEMENT),
+      getLongAttribute(Statistics::TIME_ROOT_CUTS_MICRO) / 1000);
+  printf("\tHull formulations: %u groups, %u variable copies\n",
+         getUnsignedAttribute(Statistics::HULL_NUM_GROUPS),
+         getUnsignedAttribute(Statistics::HULL_NUM_VARIABLE_COPIES));
+  printf("\tAbs big-M coefficients refreshed from the bounds: %llu\n",
+         getLongAttribute(Statistics::NUM_BIG_M_REFRESHES));
 
   printf("\tNumber of main loop iterations: %llu, number of restarts: %u\n",
          getLongAttribute(Statistics::NUM_MAIN_LOOP_ITERATIONS),
@@ -213,10 +325,12 @@ void Statistics::print() {
   printf(
       "\tNumber of boolean variables: %u,"
       " number of fixed variables: %u,"
-      " number of constraints: %u \n",
+      " number of constraints: %u,"
+      " number of calls: %u\n",
       getUnsignedAttribute(Statistics::NUM_BOOLEAN_VARIABLES),
       getUnsignedAttribute(Statistics::NUM_FIXED_BOOLEAN_VARIABLES),
-      getUnsignedAttribute(Statistics::NUM_SAT_CONSTRAINTS));
+      getUnsignedAttribute(Statistics::NUM_SAT_CONSTRAINTS),
+      getUnsignedAttribute(Statistics::NUM_SAT_SOLVER_CALLS));
 
   printf("\t--- SMT Core Statistics ---\n");
   unsigned numVisitedTreeStates = getUnsignedAttribute(Statistics::NUM_VISITED_TREE_STATES);
@@ -229,6 +343,15 @@ void Statistics::print() {
       getUnsignedAttribute(Statistics::NUM_POPS));
   printf("\tMax stack depth: %u\n",
          getUnsignedAttribute(Statistics::MAX_DECISION_LEVEL));
+  printf("\tVisited states per second: %.2lf\n",
+         timeMainLoopMicro > 0
+             ? numVisitedTreeStates * 1000000.0 / timeMainLoopMicro
+             : 0);
+  printf(
+      "\tArena allocations: %llu. Heap blocks: %llu (%llu bytes reserved)\n",
+      getLongAttribute(Statistics::NUM_ARENA_ALLOCATIONS),
+      getLongAttribute(Statistics::NUM_ARENA_BLOCK_ALLOCATIONS),
+      getLongAttribute(Statistics::ARENA_BYTES_RESERVED));
 
   printf(
       "\tNumber of states refuted by SAT solver: %u\n"
@@ -238,6 +361,21 @@ void Statistics::print() {
       getUnsignedAttribute(Statistics::NUM_REFUTATIONS_BY_BOUND_TIGHTENING),
       getUnsignedAttribute(Statistics::NUM_REFUTATIONS_BY_THEORY_SOLVER));
 
+  unsigned numHintedPhases = getUnsignedAttribute(Statistics::NUM_HINTED_PHASES);
+  if (numHintedPhases > 0) {
+    printf("\t--- Warm start ---\n");
+    printf(
+        "\tHinted phases: %u. Solved by the hint: %s. "
+        "Hinted phases changed in the solution: %u\n"
+        "\tDistance of the hinted values to the solution: %.4lf. "
+        "Time checking the hint: %llu milli\n",
+        numHintedPhases,
+        getUnsignedAttribute(Statistics::HINT_SOLVED_QUERY) ? "yes" : "no",
+        getUnsignedAttribute(Statistics::NUM_HINTED_PHASES_CHANGED),
+        getDoubleAttribute(Statistics::HINT_ASSIGNMENT_DISTANCE),
+        getLongAttribute(Statistics::TIME_CHECKING_HINT_MICRO) / 1000);
+  }
+
   printf("\t--- SoI-based local search ---\n");
   unsigned numPhasePatternInitializations =
       getUnsignedAttribute(Statistics::NUM_PHASE_PATTERN_INITIALIZATIONS);
@@ -332,7 +470,7 @@ bool Statistics::hasTimedOut() const { return _timedOut; }
 
 void Statistics::printStartingIteration(unsigned long long iteration,
                                         String message) {
-  if (_longAttributes[NUM_MAIN_LOOP_ITERATIONS] >= iteration)
+  if (getLongAttribute(NUM_MAIN_LOOP_ITERATIONS) >= iteration)
     printf("DBG_PRINT: %s\n", message.ascii());
 }
 
@@ -16,6 +16,8 @@
 #ifndef __Statistics_h__
 #define __Statistics_h__
 
+#include <atomic>
+
 #include "List.h"
 #include "Map.h"
 #include "TimeUtils.h"
@@ -51,10 +53,18 @@ class Statistics {
     // Total number of search state refuted by SAT solver
     NUM_REFUTATIONS_BY_SAT_SOLVER,
 
+    // Number of LP calls minimizing the SoI cost
+    NUM_SOI_COST_MINIMIZATIONS,
+
     // Total number of search state refuted by theory solver
     NUM_LP_FEASIBILITY_CHECK,
     NUM_REFUTATIONS_BY_THEORY_SOLVER,
 
+    // MILP feasibility checks, and those whose budget ran out, see
+    // MILPCheckScheduler
+    NUM_MILP_CHECKS,
+    NUM_MILP_CHECKS_EXPIRED,
+
     NUM_REFUTATIONS_BY_BOUND_TIGHTENING,
 
     // Total number of states in the search tree visited so far
@@ -64,6 +74,24 @@ class Statistics {
     PP_NUM_TIGHTENING_ITERATIONS,
     PP_NUM_EQUATIONS_REMOVED,
 
+    // Presolver reductions, see Presolver
+    PRESOLVE_NUM_VARIABLES_REMOVED,
+    PRESOLVE_NUM_EQUATIONS_REMOVED,
+    PRESOLVE_NUM_ADDENDS_REMOVED,
+    PRESOLVE_NUM_VARIABLES_CONDENSED,
+
+    // Root cuts, see RootCutGenerator
+    NUM_ROOT_CUTS,
+    NUM_ROOT_CUT_ROUNDS,
+    // The elements of one-hot groups fixed to 0 by root cuts, each a branch
+    // the search no longer visits
+    NUM_ROOT_CUT_EXCLUDED_ELEMENTS,
+
+    // One-hot groups encoded by their convex hull, and the variable copies
+    // this took, see MILPEncoder::encodeHullFormulations()
+    HULL_NUM_GROUPS,
+    HULL_NUM_VARIABLE_COPIES,
+
     // SAT solver
     NUM_BOOLEAN_VARIABLES,
     NUM_FIXED_BOOLEAN_VARIABLES,
@@ -71,6 +99,17 @@ class Statistics {
     NUM_PHASE_PATTERN_INITIALIZATIONS,
     NUM_INITIALIZATIONS_REJECTED_BY_SAT_SOLVER,
     NUM_SAT_CONSTRAINTS,
+    NUM_SAT_SOLVER_CALLS,
+
+    // Warm start: the constraints given a phase by the hint, whether the hint
+    // solved the query with its phases fixed, and the hinted phases that
+    // differ in the solution
+    NUM_HINTED_PHASES,
+    HINT_SOLVED_QUERY,
+    NUM_HINTED_PHASES_CHANGED,
+
+    // The number of attributes above. Not an attribute itself.
+    NUMBER_OF_UNSIGNED_ATTRIBUTES,
   };
 
   enum StatisticsLongAttribute {
@@ -86,6 +125,9 @@ class Statistics {
     // Total time spent on performing simplex steps, in microseconds
     TIME_LP_FEASIBILITY_CHECK_MICRO,
 
+    // Total time spent on MILP feasibility checks
+    TIME_MILP_CHECK_MICRO,
+
     // Total time spent on sat solving
     TIME_THEORY_EXPLANATION_MICRO,
 
@@ -132,14 +174,63 @@ class Statistics {
     TOTAL_TIME_UPDATING_PSEUDO_IMPACT_MICRO,
 
     TOTAL_TIME_SAT_SOLVING_SOI_MICRO,
+
+    // Search-time arenas: objects handed out, heap blocks requested, and the
+    // bytes those blocks hold
+    NUM_ARENA_ALLOCATIONS,
+    NUM_ARENA_BLOCK_ALLOCATIONS,
+    ARENA_BYTES_RESERVED,
+
+    // Total time checking the hint with its phases fixed
+    TIME_CHECKING_HINT_MICRO,
+
+    // Total time generating the root cuts
+    TIME_ROOT_CUTS_MICRO,
+
+    // Big-M coefficients of abs constraints set to those of the current
+    // bounds, see MILPEncoder::refreshAbsoluteValueBigMs()
+    NUM_BIG_M_REFRESHES,
+
+    // The number of attributes above. Not an attribute itself.
+    NUMBER_OF_LONG_ATTRIBUTES,
   };
 
   enum StatisticsDoubleAttribute {
     // How close we are to the minimum of the SoI (0).
     COST_OF_CURRENT_PHASE_PATTERN,
     MIN_COST_OF_PHASE_PATTERN,
+
+    // The sum of the absolute differences between the hinted values and the
+    // solution
+    HINT_ASSIGNMENT_DISTANCE,
+
+    // How much the root cuts shrank the conditional bounds of the variables
+    // of the one-hot groups, see RootCutGenerator
+    ROOT_CUT_BOUND_IMPROVEMENT,
+
+    // The number of attributes above. Not an attribute itself.
+    NUMBER_OF_DOUBLE_ATTRIBUTES,
+  };
+
+  /*
+    A copy of every attribute, taken by snapshot().
+  */
+  struct Snapshot {
+    unsigned _unsignedAttributes[NUMBER_OF_UNSIGNED_ATTRIBUTES];
+    unsigned long long _longAttributes[NUMBER_OF_LONG_ATTRIBUTES];
+    double _doubleAttributes[NUMBER_OF_DOUBLE_ATTRIBUTES];
+
+    // Time since stampStartingTime()
+    unsigned long long _totalTimeMicro;
   };
 
+  /*
+    The attribute names, e.g. "NUM_SPLITS", as used in reports.
+  */
+  static const char *getAttributeName(StatisticsUnsignedAttribute attr);
+  static const char *getAttributeName(StatisticsLongAttribute attr);
+  static const char *getAttributeName(StatisticsDoubleAttribute attr);
+
   /*
     Print the current statistics.
   */
@@ -152,60 +243,72 @@ class Statistics {
   void stampMainLoopStartTime();
 
   /*
-    Setters for unsigned, unsigned long long, and double attributes
+    Setters for unsigned, unsigned long long, and double attributes.
+
+    The attributes are relaxed atomics with a single writer, the thread that
+    owns the Statistics object. Increments are therefore a plain load and
+    store rather than a read-modify-write, and other threads can read the
+    attributes (e.g., through snapshot()) while the owner keeps running.
   */
   inline void setUnsignedAttribute(StatisticsUnsignedAttribute attr,
                                    unsigned value) {
-    _unsignedAttributes[attr] = value;
+    _unsignedAttributes[attr].store(value, std::memory_order_relaxed);
   }
 
   inline void incUnsignedAttribute(StatisticsUnsignedAttribute attr) {
-    ++_unsignedAttributes[attr];
+    incUnsignedAttribute(attr, 1);
   }
 
   inline void incUnsignedAttribute(StatisticsUnsignedAttribute attr,
                                    unsigned value) {
-    _unsignedAttributes[attr] += value;
+    setUnsignedAttribute(attr, getUnsignedAttribute(attr) + value);
   }
 
   inline void setLongAttribute(StatisticsLongAttribute attr,
                                unsigned long long value) {
-    _longAttributes[attr] = value;
+    _longAttributes[attr].store(value, std::memory_order_relaxed);
   }
 
   inline void incLongAttribute(StatisticsLongAttribute attr) {
-    ++_longAttributes[attr];
+    incLongAttribute(attr, 1);
   }
 
   inline void incLongAttribute(StatisticsLongAttribute attr,
                                unsigned long long value) {
-    _longAttributes[attr] += value;
+    setLongAttribute(attr, getLongAttribute(attr) + value);
   }
 
   inline void setDoubleAttribute(StatisticsDoubleAttribute attr, double value) {
-    _doubleAttributes[attr] = value;
+    _doubleAttributes[attr].store(value, std::memory_order_relaxed);
   }
 
   inline void incDoubleAttribute(StatisticsDoubleAttribute attr, double value) {
-    _doubleAttributes[attr] += value;
+    setDoubleAttribute(attr, getDoubleAttribute(attr) + value);
   }
 
   /*
     Getters for unsigned, unsigned long long, and double attributes
   */
   inline unsigned getUnsignedAttribute(StatisticsUnsignedAttribute attr) const {
-    return _unsignedAttributes[attr];
+    return _unsignedAttributes[attr].load(std::memory_order_relaxed);
   }
 
   inline unsigned long long getLongAttribute(
       StatisticsLongAttribute attr) const {
-    return _longAttributes[attr];
+    return _longAttributes[attr].load(std::memory_order_relaxed);
   }
 
   inline double getDoubleAttribute(StatisticsDoubleAttribute attr) const {
-    return _doubleAttributes[attr];
+    return _doubleAttributes[attr].load(std::memory_order_relaxed);
   }
 
+  /*
+    Copy every attribute. Safe to call from any thread while the owner is
+    updating the attributes; each value is read atomically, but the snapshot
+    as a whole is not taken at a single instant.
+  */
+  void snapshot(Snapshot &snapshot) const;
+
   unsigned long long getTotalTimeInMicro() const;
 
   /*
@@ -224,11 +327,11 @@ class Statistics {
   struct timespec _startTime;
   struct timespec _mainLoopStartTime;
 
-  Map<StatisticsUnsignedAttribute, unsigned> _unsignedAttributes;
+  std::atomic<unsigned> _unsignedAttributes[NUMBER_OF_UNSIGNED_ATTRIBUTES];
 
-  Map<StatisticsLongAttribute, unsigned long long> _longAttributes;
+  std::atomic<unsigned long long> _longAttributes[NUMBER_OF_LONG_ATTRIBUTES];
 
-  Map<StatisticsDoubleAttribute, double> _doubleAttributes;
+  std::atomic<double> _doubleAttributes[NUMBER_OF_DOUBLE_ATTRIBUTES];
 
   // Whether the engine quitted with a timeout
   bool _timedOut;
@@ -0,0 +1,210 @@
+/*********************                                                        */
+/*! \file StatisticsAggregator.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** [[ Add lengthier description here ]]
+ **/
+
+#include "StatisticsAggregator.h"
+
+#include <cmath>
+
+#include "CommonError.h"
+#include "Debug.h"
+#include "FloatUtils.h"
+#include "MStringf.h"
+
+void StatisticsAggregator::addWorker(const Statistics *statistics) {
+  ASSERT(statistics);
+  _workers.append(statistics);
+}
+
+void StatisticsAggregator::snapshot() {
+  _snapshots.clear();
+  for (const auto &statistics : _workers) {
+    Statistics::Snapshot snapshot;
+    statistics->snapshot(snapshot);
+    _snapshots.append(snapshot);
+  }
+}
+
+const Statistics::Snapshot &StatisticsAggregator::getWorkerSnapshot(
+    unsigned worker) const {
+  if (worker >= _snapshots.size())
+    throw CommonError(CommonError::VECTOR_OUT_OF_BOUNDS);
+  return _snapshots[worker];
+}
+
+template <class T, class Attribute>
+void StatisticsAggregator::merge(Attribute attr, T &sum, T &min,
+                                 T &max) const {
+  sum = 0;
+  min = 0;
+  max = 0;
+  bool first = true;
+  for (const auto &snapshot : _snapshots) {
+    T value = getValue(snapshot, attr);
+    sum += value;
+    if (first || value < min) min = value;
+    if (first || value > max) max = value;
+    first = false;
+  }
+}
+
+unsigned long long StatisticsAggregator::getSum(
+    Statistics::StatisticsUnsignedAttribute attr) const {
+  unsigned long long sum, min, max;
+  merge(attr, sum, min, max);
+  return sum;
+}
+
+unsigned long long StatisticsAggregator::getMin(
+    Statistics::StatisticsUnsignedAttribute attr) const {
+  unsigned long long sum, min, max;
+  merge(attr, sum, min, max);
+  return min;
+}
+
+unsigned long long StatisticsAggregator::getMax(
+    Statistics::StatisticsUnsignedAttribute attr) const {
+  unsigned long long sum, min, max;
+  merge(attr, sum, min, max);
+  return max;
+}
+
+unsigned long long StatisticsAggregator::getSum(
+    Statistics::StatisticsLongAttribute attr) const {
+  unsigned long long sum, min, max;
+  merge(attr, sum, min, max);
+  return sum;
+}
+
+unsigned long long StatisticsAggregator::getMin(
+    Statistics::StatisticsLongAttribute attr) const {
+  unsigned long long sum, min, max;
+  merge(attr, sum, min, max);
+  return min;
+}
+
+unsigned long long StatisticsAggregator::getMax(
+    Statistics::StatisticsLongAttribute attr) const {
+  unsigned long long sum, min, max;
+  merge(attr, sum, min, max);
+  return max;
+}
+
+double StatisticsAggregator::getSum(
+    Statistics::StatisticsDoubleAttribute attr) const {
+  double sum, min, max;
+  merge(attr, sum, min, max);
+  return sum;
+}
+
+double StatisticsAggregator::getMin(
+    Statistics::StatisticsDoubleAttribute attr) const {
+  double sum, min, max;
+  merge(attr, sum, min, max);
+  return min;
+}
+
+double StatisticsAggregator::getMax(
+    Statistics::StatisticsDoubleAttribute attr) const {
+  double sum, min, max;
+  merge(attr, sum, min, max);
+  return max;
+}
+
+String StatisticsAggregator::toJson(unsigned long long value) {
+  return Stringf("%llu", value);
+}
+
+String StatisticsAggregator::toJson(double value) {
+  // JSON has no representation for infinity or NaN
+  if (!std::isfinite(value) || !FloatUtils::isFinite(value)) return "null";
+  return Stringf("%.17g", value);
+}
+
+template <class Attribute>
+void StatisticsAggregator::appendAttributeReport(Attribute attr,
+                                                 String &report) const {
+  report +=
+      Stringf("    \"%s\": {\"sum\": ", Statistics::getAttributeName(attr));
+  report += toJson(getSum(attr));
+  report += ", \"min\": ";
+  report += toJson(getMin(attr));
+  report += ", \"max\": ";
+  report += toJson(getMax(attr));
+  report += ", \"per_worker\": [";
+  for (unsigned i = 0; i < _snapshots.size(); ++i) {
+    if (i > 0) report += ", ";
+    report += toJson(getValue(_snapshots[i], attr));
+  }
+  report += "]}";
+}
+
+String StatisticsAggregator::getJsonReport() const {
+  String report = "{\n";
+  report += Stringf("  \"num_workers\": %u,\n", _snapshots.size());
+
+  unsigned long long totalTimeMicro = 0;
+  report += "  \"total_time_micro_per_worker\": [";
+  for (unsigned i = 0; i < _snapshots.size(); ++i) {
+    if (i > 0) report += ", ";
+    report += toJson(_snapshots[i]._totalTimeMicro);
+    totalTimeMicro += _snapshots[i]._totalTimeMicro;
+  }
+  report += "],\n";
+
+  report += "  \"attributes\": {\n";
+  bool first = true;
+  for (unsigned i = 0; i < Statistics::NUMBER_OF_UNSIGNED_ATTRIBUTES; ++i) {
+    if (!first) report += ",\n";
+    first = false;
+    appendAttributeReport((Statistics::StatisticsUnsignedAttribute)i, report);
+  }
+  for (unsigned i = 0; i < Statistics::NUMBER_OF_LONG_ATTRIBUTES; ++i) {
+    report += ",\n";
+    appendAttributeReport((Statistics::StatisticsLongAttribute)i, report);
+  }
+  for (unsigned i = 0; i < Statistics::NUMBER_OF_DOUBLE_ATTRIBUTES; ++i) {
+    report += ",\n";
+    appendAttributeReport((Statistics::StatisticsDoubleAttribute)i, report);
+  }
+  report += "\n  },\n";
+
+  // The fraction of the elapsed time spent in each timer, over all workers
+  // and per worker
+  report += "  \"timing_ratios\": {\n";
+  first = true;
+  for (unsigned i = 0; i < Statistics::NUMBER_OF_LONG_ATTRIBUTES; ++i) {
+    auto attr = (Statistics::StatisticsLongAttribute)i;
+    String name = Statistics::getAttributeName(attr);
+    if (!name.contains("_MICRO")) continue;
+
+    if (!first) report += ",\n";
+    first = false;
+    report += Stringf("    \"%s\": {\"aggregate\": ", name.ascii());
+    report += toJson(totalTimeMicro == 0
+                         ? 0.0
+                         : (double)getSum(attr) / totalTimeMicro);
+    report += ", \"per_worker\": [";
+    for (unsigned j = 0; j < _snapshots.size(); ++j) {
+      if (j > 0) report += ", ";
+      unsigned long long workerTime = _snapshots[j]._totalTimeMicro;
+      report += toJson(
+          workerTime == 0
+              ? 0.0
+              : (double)getValue(_snapshots[j], attr) / workerTime);
+    }
+    report += "]}";
+  }
+  report += "\n  }\n";
+
+  report += "}";
+  return report;
+}
@@ -0,0 +1,93 @@
+/*********************                                                        */
+/*! \file StatisticsAggregator.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Merges the Statistics of several workers (e.g., the engines of the DnC
+ ** manager). snapshot() copies every worker's attributes without stopping
+ ** the workers; the getters and the JSON report then work on the copies.
+ **/
+
+#ifndef __StatisticsAggregator_h__
+#define __StatisticsAggregator_h__
+
+#include "MString.h"
+#include "Statistics.h"
+#include "Vector.h"
+
+class StatisticsAggregator {
+ public:
+  /*
+    Register the statistics of a worker. The aggregator does not own them,
+    and they must outlive it.
+  */
+  void addWorker(const Statistics *statistics);
+
+  unsigned getNumberOfWorkers() const { return _workers.size(); }
+
+  /*
+    Copy the attributes of every worker. May be called while the workers are
+    running.
+  */
+  void snapshot();
+
+  /*
+    The values in the last snapshot, merged over the workers
+  */
+  unsigned long long getSum(Statistics::StatisticsUnsignedAttribute attr) const;
+  unsigned long long getMin(Statistics::StatisticsUnsignedAttribute attr) const;
+  unsigned long long getMax(Statistics::StatisticsUnsignedAttribute attr) const;
+
+  unsigned long long getSum(Statistics::StatisticsLongAttribute attr) const;
+  unsigned long long getMin(Statistics::StatisticsLongAttribute attr) const;
+  unsigned long long getMax(Statistics::StatisticsLongAttribute attr) const;
+
+  double getSum(Statistics::StatisticsDoubleAttribute attr) const;
+  double getMin(Statistics::StatisticsDoubleAttribute attr) const;
+  double getMax(Statistics::StatisticsDoubleAttribute attr) const;
+
+  const Statistics::Snapshot &getWorkerSnapshot(unsigned worker) const;
+
+  /*
+    A JSON object with, for every attribute, the sum, min, max and
+    per-worker values; the fraction of each worker's elapsed time spent in
+    each timer (the *_MICRO attributes); and the elapsed time of each worker.
+  */
+  String getJsonReport() const;
+
+ private:
+  Vector<const Statistics *> _workers;
+  Vector<Statistics::Snapshot> _snapshots;
+
+  static unsigned long long getValue(
+      const Statistics::Snapshot &snapshot,
+      Statistics::StatisticsUnsignedAttribute attr) {
+    return snapshot._unsignedAttributes[attr];
+  }
+
+  static unsigned long long getValue(
+      const Statistics::Snapshot &snapshot,
+      Statistics::StatisticsLongAttribute attr) {
+    return snapshot._longAttributes[attr];
+  }
+
+  static double getValue(const Statistics::Snapshot &snapshot,
+                         Statistics::StatisticsDoubleAttribute attr) {
+    return snapshot._doubleAttributes[attr];
+  }
+
+  template <class T, class Attribute>
+  void merge(Attribute attr, T &sum, T &min, T &max) const;
+
+  template <class Attribute>
+  void appendAttributeReport(Attribute attr, String &report) const;
+
+  static String toJson(unsigned long long value);
+  static String toJson(double value);
+};
+
+#endif  // __StatisticsAggregator_h__
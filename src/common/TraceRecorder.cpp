@@ -0,0 +1,158 @@
+/*********************                                                        */
+/*! \file TraceRecorder.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** [[ Add lengthier description here ]]
+ **/
+
+#include "TraceRecorder.h"
+
+#include <string>
+
+#include "File.h"
+#include "FloatUtils.h"
+#include "MStringf.h"
+
+namespace {
+// The name as the contents of a JSON string
+std::string escapeJson(const char *name) {
+  std::string escaped;
+  for (const char *c = name; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      escaped += '\\';
+      escaped += *c;
+    } else if ((unsigned char)*c < 0x20) {
+      escaped += Stringf("\\u%04x", (unsigned char)*c).ascii();
+    } else {
+      escaped += *c;
+    }
+  }
+  return escaped;
+}
+}  // namespace
+
+std::atomic<bool> TraceRecorder::_enabled(false);
+unsigned long long TraceRecorder::_originTicks = 0;
+unsigned TraceRecorder::_maxEventsPerThread =
+    TraceRecorder::DEFAULT_MAX_EVENTS_PER_THREAD;
+std::mutex TraceRecorder::_buffersMutex;
+Vector<TraceRecorder::ThreadBuffer *> TraceRecorder::_buffers;
+
+void TraceRecorder::enable(unsigned maxEventsPerThread) {
+  _originTicks = Profiler::readTicks();
+  _maxEventsPerThread = maxEventsPerThread > 0 ? maxEventsPerThread : 1;
+  _enabled.store(true, std::memory_order_relaxed);
+}
+
+TraceRecorder::ThreadBuffer &TraceRecorder::getThreadBuffer() {
+  // The buffers are never deleted, so that they can be written after their
+  // threads exit
+  thread_local ThreadBuffer *buffer = NULL;
+  if (!buffer) {
+    buffer = new ThreadBuffer;
+    buffer->_next = 0;
+    buffer->_numberOfDroppedEvents = 0;
+    std::lock_guard<std::mutex> lock(_buffersMutex);
+    buffer->_threadId = _buffers.size() + 1;
+    buffer->_threadName = Stringf("thread %u", buffer->_threadId);
+    _buffers.append(buffer);
+  }
+  return *buffer;
+}
+
+void TraceRecorder::append(const Event &event) {
+  ThreadBuffer &buffer = getThreadBuffer();
+  if (buffer._events.size() < _maxEventsPerThread) {
+    buffer._events.append(event);
+    return;
+  }
+
+  buffer._events[buffer._next] = event;
+  buffer._next = (buffer._next + 1) % buffer._events.size();
+  ++buffer._numberOfDroppedEvents;
+}
+
+void TraceRecorder::recordSpan(const char *name, unsigned long long startTicks,
+                               unsigned long long endTicks) {
+  append(Event(name, 'X', startTicks, endTicks - startTicks, 0));
+}
+
+void TraceRecorder::recordCounter(const char *name, double value) {
+  append(Event(name, 'C', Profiler::readTicks(), 0, value));
+}
+
+void TraceRecorder::setThreadName(const String &name) {
+  // Nothing to name when not recording, and a long-running process, e.g.,
+  // the solver daemon, would keep a buffer per worker thread ever started
+  if (!isEnabled()) return;
+  getThreadBuffer()._threadName = name;
+}
+
+String TraceRecorder::getChromeTrace() {
+  double ticksPerMicrosecond = Profiler::getTicksPerMicrosecond();
+
+  // Built in a std::string, which appends in place
+  std::string trace = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  bool first = true;
+
+  std::lock_guard<std::mutex> lock(_buffersMutex);
+  for (const auto &entry : _buffers) {
+    const ThreadBuffer &buffer = *entry;
+
+    if (!first) trace += ",";
+    first = false;
+    std::string threadName = escapeJson(buffer._threadName.ascii());
+    trace += Stringf(
+                 "\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+                 "\"tid\": %u, \"args\": {\"name\": \"%s\"}}",
+                 buffer._threadId, threadName.c_str())
+                 .ascii();
+    if (buffer._numberOfDroppedEvents > 0)
+      trace += Stringf(
+                   ",\n{\"name\": \"dropped_events\", \"ph\": \"M\", "
+                   "\"pid\": 1, \"tid\": %u, \"args\": {\"count\": %llu}}",
+                   buffer._threadId, buffer._numberOfDroppedEvents)
+                   .ascii();
+
+    for (const auto &event : buffer._events) {
+      double timestamp =
+          event._ticks > _originTicks
+              ? (event._ticks - _originTicks) / ticksPerMicrosecond
+              : 0;
+      if (event._phase == 'X') {
+        trace += Stringf(
+                     ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, "
+                     "\"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                     escapeJson(event._name).c_str(), buffer._threadId,
+                     timestamp,
+                     event._durationTicks / ticksPerMicrosecond)
+                     .ascii();
+      } else {
+        // JSON has no infinity, so such samples are left out
+        if (!FloatUtils::isFinite(event._value)) continue;
+        // Counter tracks are per process, so keep the threads apart by name
+        trace += Stringf(
+                     ",\n{\"name\": \"%s (%s)\", \"ph\": \"C\", \"pid\": 1, "
+                     "\"tid\": %u, \"ts\": %.3f, \"args\": {\"value\": "
+                     "%.10g}}",
+                     escapeJson(event._name).c_str(), threadName.c_str(),
+                     buffer._threadId, timestamp, event._value)
+                     .ascii();
+      }
+    }
+  }
+
+  trace += "\n]}\n";
+  return trace;
+}
+
+void TraceRecorder::writeChromeTrace(const String &path) {
+  File file(path);
+  file.open(File::MODE_WRITE_TRUNCATE);
+  file.write(getChromeTrace());
+}
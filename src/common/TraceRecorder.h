@@ -0,0 +1,146 @@
+/*********************                                                        */
+/*! \file TraceRecorder.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Records a timeline of the search in the Chrome trace-event format, which
+ ** chrome://tracing and ui.perfetto.dev open directly. TRACE_SCOPE("name")
+ ** records the block as a span on the track of the calling thread, and
+ ** TRACE_COUNTER("name", value) records a sample of a counter track.
+ **
+ ** Every thread appends to a buffer of its own, so recording takes no lock.
+ ** The buffers are only read by writeChromeTrace(), once the traced threads
+ ** are done. A buffer holds at most the events given to enable(), and then
+ ** keeps the latest ones, so a long run keeps a bounded trace of its end.
+ ** Unless enable() has been called, a scope costs a single relaxed load of
+ ** the enabled flag.
+ **
+ ** PROFILE_TRACE_SCOPE("name") is both PROFILE_SCOPE and TRACE_SCOPE.
+ **/
+
+#ifndef __TraceRecorder_h__
+#define __TraceRecorder_h__
+
+#include <atomic>
+#include <mutex>
+
+#include "MString.h"
+#include "Profiler.h"
+#include "Vector.h"
+
+#define TRACE_SCOPE_CONCAT_INNER(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) \
+  TraceScope TRACE_SCOPE_CONCAT(traceScope, __LINE__)(name)
+#define PROFILE_TRACE_SCOPE(name) \
+  PROFILE_SCOPE(name);            \
+  TRACE_SCOPE(name)
+#define TRACE_COUNTER(name, value)                                 \
+  do {                                                             \
+    if (TraceRecorder::isEnabled())                                \
+      TraceRecorder::recordCounter(name, (double)(value));         \
+  } while (0)
+
+class TraceRecorder {
+ public:
+  enum {
+    // About 10 MB per thread
+    DEFAULT_MAX_EVENTS_PER_THREAD = 1 << 18,
+  };
+
+  /*
+    Start recording. Timestamps in the trace are relative to this call.
+    Beyond maxEventsPerThread events, a thread overwrites its oldest ones.
+  */
+  static void enable(
+      unsigned maxEventsPerThread = DEFAULT_MAX_EVENTS_PER_THREAD);
+
+  static inline bool isEnabled() {
+    return _enabled.load(std::memory_order_relaxed);
+  }
+
+  /*
+    Record events on the track of the calling thread. The names must outlive
+    the recorder, e.g. string literals.
+  */
+  static void recordSpan(const char *name, unsigned long long startTicks,
+                         unsigned long long endTicks);
+  static void recordCounter(const char *name, double value);
+
+  /*
+    Label the track of the calling thread, e.g. "worker 2"
+  */
+  static void setThreadName(const String &name);
+
+  /*
+    The events of all threads as a Chrome trace-event JSON object
+  */
+  static String getChromeTrace();
+
+  static void writeChromeTrace(const String &path);
+
+ private:
+  struct Event {
+    Event(const char *name, char phase, unsigned long long ticks,
+          unsigned long long durationTicks, double value)
+        : _name(name),
+          _phase(phase),
+          _ticks(ticks),
+          _durationTicks(durationTicks),
+          _value(value) {}
+
+    const char *_name;
+    // 'X' for a span, 'C' for a counter sample
+    char _phase;
+    unsigned long long _ticks;
+    unsigned long long _durationTicks;
+    double _value;
+  };
+
+  // A ring of events, whose oldest event is at _next once it is full
+  struct ThreadBuffer {
+    unsigned _threadId;
+    String _threadName;
+    Vector<Event> _events;
+    unsigned _next;
+    unsigned long long _numberOfDroppedEvents;
+  };
+
+  static std::atomic<bool> _enabled;
+  static unsigned long long _originTicks;
+  static unsigned _maxEventsPerThread;
+
+  // The buffers of all threads that ever recorded an event
+  static std::mutex _buffersMutex;
+  static Vector<ThreadBuffer *> _buffers;
+
+  static ThreadBuffer &getThreadBuffer();
+  static void append(const Event &event);
+};
+
+class TraceScope {
+ public:
+  explicit TraceScope(const char *name)
+      : _name(name), _active(TraceRecorder::isEnabled()), _start(0) {
+    if (_active) _start = Profiler::readTicks();
+  }
+
+  ~TraceScope() {
+    if (_active)
+      TraceRecorder::recordSpan(_name, _start, Profiler::readTicks());
+  }
+
+ private:
+  const char *_name;
+  bool _active;
+  unsigned long long _start;
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+};
+
+#endif  // __TraceRecorder_h__
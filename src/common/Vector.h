@@ -168,6 +168,12 @@ class Vector {
     return value;
   }
 
+  void popBack() {
+    if (size() == 0) throw CommonError(CommonError::POPPING_FROM_EMPTY_VECTOR);
+
+    _container.pop_back();
+  }
+
   bool operator==(const Vector<T> &other) const {
     if (size() != other.size()) return false;
 
@@ -0,0 +1,25 @@
+/*********************                                                        */
+/*! \file RealFiles.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief The file system calls of File, for tests that read actual files
+ **/
+
+#ifndef __RealFiles_h__
+#define __RealFiles_h__
+
+#include "T/sys/stat.h"
+#include "T/unistd.h"
+
+class RealFiles : public T::Real_open,
+                  public T::Real_read,
+                  public T::Real_write,
+                  public T::Real_close,
+                  public T::Real_stat {};
+
+#endif  // __RealFiles_h__
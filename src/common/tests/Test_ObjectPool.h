@@ -0,0 +1,81 @@
+/*********************                                                        */
+/*! \file Test_ObjectPool.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Tests for the fixed-size object pool
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include "MockErrno.h"
+#include "ObjectPool.h"
+#include "Statistics.h"
+
+struct PooledPair {
+  PooledPair(int first, double second) : _first(first), _second(second) {}
+
+  int _first;
+  double _second;
+};
+
+class ObjectPoolTestSuite : public CxxTest::TestSuite {
+ public:
+  MockErrno *mockErrno;
+
+  void setUp() { TS_ASSERT(mockErrno = new MockErrno); }
+
+  void tearDown() { TS_ASSERT_THROWS_NOTHING(delete mockErrno); }
+
+  void test_allocate_and_release() {
+    ObjectPool<PooledPair> pool(2);
+
+    PooledPair *a = pool.allocate(1, 1.5);
+    PooledPair *b = pool.allocate(2, 2.5);
+    TS_ASSERT_EQUALS(a->_first, 1);
+    TS_ASSERT_EQUALS(b->_second, 2.5);
+    TS_ASSERT_EQUALS(pool.getNumberOfLiveObjects(), 2u);
+    TS_ASSERT_EQUALS(pool.getNumberOfBlocks(), 1u);
+
+    // A released slot is handed out again before a new block is requested
+    pool.release(a);
+    PooledPair *c = pool.allocate(3, 3.5);
+    TS_ASSERT_EQUALS(c, a);
+    TS_ASSERT_EQUALS(c->_first, 3);
+    TS_ASSERT_EQUALS(pool.getNumberOfBlocks(), 1u);
+
+    pool.allocate(4, 4.5);
+    TS_ASSERT_EQUALS(pool.getNumberOfBlocks(), 2u);
+    TS_ASSERT_EQUALS(pool.getNumberOfLiveObjects(), 3u);
+    TS_ASSERT_EQUALS(pool.getNumberOfAllocations(), 4u);
+  }
+
+  void test_reset_reuses_blocks() {
+    Statistics statistics;
+    ObjectPool<PooledPair> pool(2);
+    pool.setStatistics(&statistics);
+
+    PooledPair *first = pool.allocate(0, 0);
+    for (int i = 1; i < 5; ++i) pool.allocate(i, i);
+    TS_ASSERT_EQUALS(pool.getNumberOfBlocks(), 3u);
+
+    pool.reset();
+    TS_ASSERT_EQUALS(pool.getNumberOfLiveObjects(), 0u);
+    TS_ASSERT_EQUALS(pool.allocate(7, 7), first);
+    for (int i = 1; i < 6; ++i) pool.allocate(i, i);
+    TS_ASSERT_EQUALS(pool.getNumberOfBlocks(), 3u);
+
+    TS_ASSERT_EQUALS(
+        statistics.getLongAttribute(Statistics::NUM_ARENA_ALLOCATIONS), 11u);
+    TS_ASSERT_EQUALS(
+        statistics.getLongAttribute(Statistics::NUM_ARENA_BLOCK_ALLOCATIONS),
+        3u);
+    TS_ASSERT_EQUALS(
+        statistics.getLongAttribute(Statistics::ARENA_BYTES_RESERVED),
+        pool.getBytesReserved());
+  }
+};
@@ -0,0 +1,77 @@
+/*********************                                                        */
+/*! \file Test_Profiler.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Tests for the scoped-timer profiler
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include "MockErrno.h"
+#include "Profiler.h"
+
+class ProfilerTestSuite : public CxxTest::TestSuite {
+ public:
+  MockErrno *mockErrno;
+
+  void setUp() { TS_ASSERT(mockErrno = new MockErrno); }
+
+  void tearDown() { TS_ASSERT_THROWS_NOTHING(delete mockErrno); }
+
+  void busyWait(unsigned iterations) {
+    volatile unsigned sink = 0;
+    for (unsigned i = 0; i < iterations; ++i) sink = sink + i;
+  }
+
+  void test_nested_scopes() {
+    for (unsigned i = 0; i < 3; ++i) {
+      ProfileScope outer("test_outer");
+      busyWait(10000);
+      {
+        ProfileScope inner("test_inner");
+        busyWait(10000);
+      }
+      {
+        ProfileScope inner("test_inner");
+        busyWait(10000);
+      }
+    }
+    {
+      // The same name at the top level is a different node
+      ProfileScope inner("test_inner");
+    }
+
+    Map<String, Profiler::PathSample> samples;
+    Profiler::getThreadProfiler().getPathSamples(samples);
+
+    TS_ASSERT(samples.exists("test_outer"));
+    TS_ASSERT(samples.exists("test_outer;test_inner"));
+    TS_ASSERT(samples.exists("test_inner"));
+
+    const Profiler::PathSample &outer = samples["test_outer"];
+    const Profiler::PathSample &nested = samples["test_outer;test_inner"];
+    TS_ASSERT_EQUALS(outer._calls, 3U);
+    TS_ASSERT_EQUALS(nested._calls, 6U);
+    TS_ASSERT_EQUALS(samples["test_inner"]._calls, 1U);
+
+    TS_ASSERT(outer._inclusiveMicro >= outer._selfMicro);
+    TS_ASSERT(outer._inclusiveMicro >= nested._inclusiveMicro);
+    TS_ASSERT_DELTA(outer._selfMicro,
+                    outer._inclusiveMicro - nested._inclusiveMicro, 1e-6);
+    TS_ASSERT_DELTA(nested._inclusiveMicro, nested._selfMicro, 1e-6);
+  }
+
+  void test_all_path_samples_include_this_thread() {
+    { ProfileScope scope("test_registered"); }
+
+    Map<String, Profiler::PathSample> samples;
+    Profiler::getAllPathSamples(samples);
+    TS_ASSERT(samples.exists("test_registered"));
+    TS_ASSERT(samples["test_registered"]._calls >= 1U);
+  }
+};
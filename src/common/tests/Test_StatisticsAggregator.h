@@ -0,0 +1,104 @@
+/*********************                                                        */
+/*! \file Test_StatisticsAggregator.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Tests for merging the statistics of several workers
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <atomic>
+#include <thread>
+
+#include "MockErrno.h"
+#include "Statistics.h"
+#include "StatisticsAggregator.h"
+
+class StatisticsAggregatorTestSuite : public CxxTest::TestSuite {
+ public:
+  MockErrno *mockErrno;
+
+  void setUp() { TS_ASSERT(mockErrno = new MockErrno); }
+
+  void tearDown() { TS_ASSERT_THROWS_NOTHING(delete mockErrno); }
+
+  void test_merge() {
+    Statistics first;
+    Statistics second;
+    Statistics third;
+    first.setUnsignedAttribute(Statistics::NUM_SPLITS, 3);
+    second.setUnsignedAttribute(Statistics::NUM_SPLITS, 7);
+    third.setUnsignedAttribute(Statistics::NUM_SPLITS, 5);
+    first.incLongAttribute(Statistics::TIME_SAT_SOLVING_MICRO, 100);
+    third.incLongAttribute(Statistics::TIME_SAT_SOLVING_MICRO, 50);
+    second.setDoubleAttribute(Statistics::MIN_COST_OF_PHASE_PATTERN, 0.5);
+
+    StatisticsAggregator aggregator;
+    aggregator.addWorker(&first);
+    aggregator.addWorker(&second);
+    aggregator.addWorker(&third);
+    aggregator.snapshot();
+
+    TS_ASSERT_EQUALS(aggregator.getNumberOfWorkers(), 3u);
+    TS_ASSERT_EQUALS(aggregator.getSum(Statistics::NUM_SPLITS), 15u);
+    TS_ASSERT_EQUALS(aggregator.getMin(Statistics::NUM_SPLITS), 3u);
+    TS_ASSERT_EQUALS(aggregator.getMax(Statistics::NUM_SPLITS), 7u);
+    TS_ASSERT_EQUALS(aggregator.getSum(Statistics::TIME_SAT_SOLVING_MICRO),
+                     150u);
+    TS_ASSERT_EQUALS(aggregator.getMin(Statistics::TIME_SAT_SOLVING_MICRO),
+                     0u);
+    TS_ASSERT_EQUALS(aggregator.getMin(Statistics::MIN_COST_OF_PHASE_PATTERN),
+                     0.5);
+    TS_ASSERT_EQUALS(aggregator.getWorkerSnapshot(1)._unsignedAttributes
+                         [Statistics::NUM_SPLITS],
+                     7u);
+
+    // The snapshot does not follow later updates
+    first.incUnsignedAttribute(Statistics::NUM_SPLITS);
+    TS_ASSERT_EQUALS(aggregator.getSum(Statistics::NUM_SPLITS), 15u);
+    aggregator.snapshot();
+    TS_ASSERT_EQUALS(aggregator.getSum(Statistics::NUM_SPLITS), 16u);
+
+    String report = aggregator.getJsonReport();
+    TS_ASSERT(report.contains(
+        "\"NUM_SPLITS\": {\"sum\": 16, \"min\": 4, \"max\": 7, "
+        "\"per_worker\": [4, 7, 5]}"));
+    TS_ASSERT(report.contains("\"ARENA_BYTES_RESERVED\""));
+    TS_ASSERT(report.contains("\"timing_ratios\""));
+    // The cost is infinite for the first and third worker
+    TS_ASSERT(report.contains("\"per_worker\": [null, 0.5, null]"));
+  }
+
+  void test_snapshot_while_worker_runs() {
+    Statistics statistics;
+    StatisticsAggregator aggregator;
+    aggregator.addWorker(&statistics);
+
+    const unsigned numIterations = 100000;
+    std::atomic_bool done(false);
+    std::thread worker([&]() {
+      for (unsigned i = 0; i < numIterations; ++i)
+        statistics.incLongAttribute(Statistics::NUM_MAIN_LOOP_ITERATIONS);
+      done = true;
+    });
+
+    unsigned long long last = 0;
+    while (!done.load()) {
+      aggregator.snapshot();
+      unsigned long long current =
+          aggregator.getSum(Statistics::NUM_MAIN_LOOP_ITERATIONS);
+      TS_ASSERT(current >= last);
+      last = current;
+    }
+    worker.join();
+
+    aggregator.snapshot();
+    TS_ASSERT_EQUALS(aggregator.getSum(Statistics::NUM_MAIN_LOOP_ITERATIONS),
+                     numIterations);
+  }
+};
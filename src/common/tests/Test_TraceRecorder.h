@@ -0,0 +1,112 @@
+/*********************                                                        */
+/*! \file Test_TraceRecorder.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Tests for the Chrome trace-event recorder
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <cstring>
+#include <thread>
+
+#include "FloatUtils.h"
+#include "MStringf.h"
+#include "MockErrno.h"
+#include "TraceRecorder.h"
+
+class TraceRecorderTestSuite : public CxxTest::TestSuite {
+ public:
+  MockErrno *mockErrno;
+
+  void setUp() { TS_ASSERT(mockErrno = new MockErrno); }
+
+  void tearDown() { TS_ASSERT_THROWS_NOTHING(delete mockErrno); }
+
+  static void recordOnWorker() {
+    TraceRecorder::setThreadName("test worker");
+    TRACE_SCOPE("test_worker_span");
+    TRACE_COUNTER("test_level", 3);
+  }
+
+  static void recordEscapedNames() {
+    TraceRecorder::setThreadName("test \"quoted\" worker");
+    TRACE_SCOPE("test_span \\ with \"quotes\"\n");
+  }
+
+  static void recordRing() {
+    TraceRecorder::setThreadName("test ring");
+    for (unsigned i = 0; i < 10; ++i) TRACE_COUNTER("test_ring", 100 + i);
+  }
+
+  void test_disabled_records_nothing() {
+    TS_ASSERT(!TraceRecorder::isEnabled());
+    { TRACE_SCOPE("test_disabled_span"); }
+    TRACE_COUNTER("test_disabled_counter", 1);
+
+    String trace = TraceRecorder::getChromeTrace();
+    TS_ASSERT(!trace.contains("test_disabled_span"));
+    TS_ASSERT(!trace.contains("test_disabled_counter"));
+  }
+
+  void test_spans_and_counters_per_thread() {
+    TraceRecorder::enable();
+    TraceRecorder::setThreadName("test main");
+
+    { TRACE_SCOPE("test_main_span"); }
+    TRACE_COUNTER("test_cost", 2.5);
+    TRACE_COUNTER("test_cost", FloatUtils::infinity());
+
+    std::thread worker(recordOnWorker);
+    worker.join();
+
+    String trace = TraceRecorder::getChromeTrace();
+    TS_ASSERT(trace.contains("\"traceEvents\""));
+    TS_ASSERT(trace.contains("\"args\": {\"name\": \"test main\"}"));
+    TS_ASSERT(trace.contains("\"args\": {\"name\": \"test worker\"}"));
+    TS_ASSERT(
+        trace.contains("{\"name\": \"test_main_span\", \"ph\": \"X\""));
+    TS_ASSERT(
+        trace.contains("{\"name\": \"test_worker_span\", \"ph\": \"X\""));
+    TS_ASSERT(trace.contains("\"test_cost (test main)\", \"ph\": \"C\""));
+    TS_ASSERT(trace.contains("\"test_level (test worker)\", \"ph\": \"C\""));
+    TS_ASSERT(trace.contains("\"args\": {\"value\": 2.5}"));
+    // The infinite sample is left out
+    unsigned samples = 0;
+    for (const char *p = strstr(trace.ascii(), "test_cost"); p;
+         p = strstr(p + 1, "test_cost"))
+      ++samples;
+    TS_ASSERT_EQUALS(samples, 1U);
+  }
+
+  void test_names_are_escaped() {
+    TraceRecorder::enable();
+    std::thread worker(recordEscapedNames);
+    worker.join();
+
+    String trace = TraceRecorder::getChromeTrace();
+    TS_ASSERT(trace.contains("{\"name\": \"test \\\"quoted\\\" worker\"}"));
+    TS_ASSERT(trace.contains(
+        "{\"name\": \"test_span \\\\ with \\\"quotes\\\"\\u000a\", "
+        "\"ph\": \"X\""));
+  }
+
+  void test_full_buffer_keeps_the_latest_events() {
+    TraceRecorder::enable(4);
+    std::thread worker(recordRing);
+    worker.join();
+    TraceRecorder::enable();
+
+    String trace = TraceRecorder::getChromeTrace();
+    for (unsigned i = 0; i < 10; ++i)
+      TS_ASSERT_EQUALS(
+          trace.contains(Stringf("\"args\": {\"value\": %u}", 100 + i)),
+          i >= 6);
+    TS_ASSERT(trace.contains("\"args\": {\"count\": 6}"));
+  }
+};
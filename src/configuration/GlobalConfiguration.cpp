@@ -35,6 +35,8 @@ const bool GlobalConfiguration::EXTRACT_THEORY_EXPLANATION = true;
 
 const double GlobalConfiguration::SCORE_BUMP_FOR_PL_CONSTRAINTS_NOT_IN_SOI = 5;
 
+const double GlobalConfiguration::DIRECTION_SCORE_OF_HINTED_PHASES = 1;
+
 const double GlobalConfiguration::DEFAULT_EPSILON_FOR_COMPARISONS = 1e-9;
 const double GlobalConfiguration::DEFAULT_EPSILON_FOR_INTEGRAL_COMPARISONS =
     1e-6;
@@ -48,6 +50,21 @@ const bool
         true;
 const double GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD = 0.00001;
 
+const unsigned GlobalConfiguration::INTEGER_ORDER_ENCODING_MAX_DOMAIN = 64;
+const unsigned GlobalConfiguration::HULL_MAX_GROUP_SIZE = 32;
+const double GlobalConfiguration::ABS_BIG_M_REFRESH_TOLERANCE = 0.1;
+
+const double GlobalConfiguration::ROOT_CUT_MIN_VIOLATION = 1e-4;
+const double GlobalConfiguration::ROOT_CUT_STALL_IMPROVEMENT = 0.01;
+
+const unsigned GlobalConfiguration::MILP_CHECK_DEPTH_BUCKETS = 10;
+const unsigned GlobalConfiguration::MILP_CHECK_MIN_SAMPLES = 5;
+const unsigned GlobalConfiguration::MILP_CHECK_EXPLORATION_PERIOD = 16;
+const double GlobalConfiguration::MILP_CHECK_NODE_LIMIT = 1000;
+const double GlobalConfiguration::MILP_CHECK_TIME_LIMIT_FACTOR = 100;
+const double GlobalConfiguration::MILP_CHECK_MIN_TIME_LIMIT = 0.05;
+const double GlobalConfiguration::MILP_CHECK_MAX_TIME_LIMIT = 10;
+
 const double GlobalConfiguration::EXPONENTIAL_MOVING_AVERAGE_ALPHA_BRANCH = 0.9;
 
 const double GlobalConfiguration::EXPONENTIAL_MOVING_AVERAGE_ALPHA_DIRECTION =
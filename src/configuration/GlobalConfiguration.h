@@ -37,6 +37,10 @@ class GlobalConfiguration {
   // order.
   static const double SCORE_BUMP_FOR_PL_CONSTRAINTS_NOT_IN_SOI;
 
+  // The score given to the direction of the phases of a solution hint, which
+  // puts them first in the branching direction.
+  static const double DIRECTION_SCORE_OF_HINTED_PHASES;
+
   // The default epsilon used for comparing doubles
   static const double DEFAULT_EPSILON_FOR_COMPARISONS;
 
@@ -64,6 +68,40 @@ class GlobalConfiguration {
   // than this threshold, the preprocessor will treat it as fixed.
   static const double PREPROCESSOR_ALMOST_FIXED_THRESHOLD;
 
+  // The largest domain of an integer variable given an order encoding in the
+  // SAT solver, see IntegerConstraint::addBooleanStructure()
+  static const unsigned INTEGER_ORDER_ENCODING_MAX_DOMAIN;
+
+  // The largest one-hot group given a hull formulation, see
+  // MILPEncoder::setHullFillIn()
+  static const unsigned HULL_MAX_GROUP_SIZE;
+
+  // A big-M coefficient of an abs constraint is set to that of the current
+  // bounds when this shrinks it by more than this fraction, see
+  // MILPEncoder::refreshAbsoluteValueBigMs()
+  static const double ABS_BIG_M_REFRESH_TOLERANCE;
+
+  // A root cut is added if the LP solution violates it by more than this
+  static const double ROOT_CUT_MIN_VIOLATION;
+
+  // The root cut loop stops when a round shrinks the width of the
+  // conditional bounds by less than this fraction, see RootCutGenerator
+  static const double ROOT_CUT_STALL_IMPROVEMENT;
+
+  // Scheduling of the MILP feasibility checks, see MILPCheckScheduler: the
+  // number of depth buckets, the checks of a kind needed before their record
+  // is used, and how often the check not picked by the records is tried
+  static const unsigned MILP_CHECK_DEPTH_BUCKETS;
+  static const unsigned MILP_CHECK_MIN_SAMPLES;
+  static const unsigned MILP_CHECK_EXPLORATION_PERIOD;
+
+  // The budget of an MILP check: a node limit, and a time limit that is a
+  // multiple of the time of an LP check, within [min, max] seconds
+  static const double MILP_CHECK_NODE_LIMIT;
+  static const double MILP_CHECK_TIME_LIMIT_FACTOR;
+  static const double MILP_CHECK_MIN_TIME_LIMIT;
+  static const double MILP_CHECK_MAX_TIME_LIMIT;
+
   static const double EXPONENTIAL_MOVING_AVERAGE_ALPHA_BRANCH;
 
   static const double EXPONENTIAL_MOVING_AVERAGE_ALPHA_DIRECTION;
@@ -122,7 +122,19 @@ void OptionParser::initialize() {
       boost::program_options::bool_switch(
                                           &(*_boolOptions)[Options::VSIDS])
       ->default_value((*_boolOptions)[Options::VSIDS]),
-      "Use vsids.");
+      "Use vsids.")(
+      "no-presolve",
+      boost::program_options::bool_switch(
+          &(*_boolOptions)[Options::NO_PRESOLVE])
+          ->default_value((*_boolOptions)[Options::NO_PRESOLVE]),
+      "Do not remove fixed variables, redundant rows and unused variables "
+      "before solving.")(
+      "no-big-m-refresh",
+      boost::program_options::bool_switch(
+          &(*_boolOptions)[Options::NO_BIG_M_REFRESH])
+          ->default_value((*_boolOptions)[Options::NO_BIG_M_REFRESH]),
+      "Keep the big-M coefficients of the abs constraints from the "
+      "encoding instead of refreshing them from the bounds.");
 
   // Less common options
   _other.add_options()(
@@ -136,6 +148,55 @@ void OptionParser::initialize() {
       boost::program_options::value<int>(&((*_intOptions)[Options::SEED]))
           ->default_value((*_intOptions)[Options::SEED]),
       "The random seed.")(
+      "daemon",
+      boost::program_options::value<std::string>(
+          &((*_stringOptions)[Options::DAEMON_SOCKET]))
+          ->default_value((*_stringOptions)[Options::DAEMON_SOCKET]),
+      "Instead of solving the input query, serve queries sent to this "
+      "Unix-domain socket until a client sends 'shutdown'.")(
+      "daemon-pool-size",
+      boost::program_options::value<int>(
+          &((*_intOptions)[Options::DAEMON_POOL_SIZE]))
+          ->default_value((*_intOptions)[Options::DAEMON_POOL_SIZE]),
+      "Number of workers shared by the solves of the daemon.")(
+      "batch",
+      boost::program_options::value<std::string>(
+          &((*_stringOptions)[Options::BATCH_PATH]))
+          ->default_value((*_stringOptions)[Options::BATCH_PATH]),
+      "Instead of the input query, solve the .mps files of this directory, "
+      "or the files listed in this manifest, each with --num-workers workers "
+      "and --timeout. The summary file gets a line per query.")(
+      "batch-cores",
+      boost::program_options::value<int>(
+          &((*_intOptions)[Options::BATCH_CORES]))
+          ->default_value((*_intOptions)[Options::BATCH_CORES]),
+      "Number of cores shared by the queries of a batch, 0 for all.")(
+      "pwa-horizon",
+      boost::program_options::value<int>(
+          &((*_intOptions)[Options::PWA_HORIZON]))
+          ->default_value((*_intOptions)[Options::PWA_HORIZON]),
+      "Horizon over which a .pwa input query is expanded, 0 for the horizon "
+      "of the file.")(
+      "condense-fill-in",
+      boost::program_options::value<int>(
+          &((*_intOptions)[Options::CONDENSE_FILL_IN]))
+          ->default_value((*_intOptions)[Options::CONDENSE_FILL_IN]),
+      "Substitute the state-update equalities along the horizon during "
+      "presolve, adding at most this many coefficients per substituted "
+      "variable. 0 turns condensing off.")(
+      "root-cut-rounds",
+      boost::program_options::value<int>(
+          &((*_intOptions)[Options::ROOT_CUT_ROUNDS]))
+          ->default_value((*_intOptions)[Options::ROOT_CUT_ROUNDS]),
+      "Strengthen the relaxation of the one-hot groups with at most this "
+      "many rounds of cuts before the search. 0 turns the cuts off.")(
+      "hull-fill-in",
+      boost::program_options::value<int>(
+          &((*_intOptions)[Options::HULL_FILL_IN]))
+          ->default_value((*_intOptions)[Options::HULL_FILL_IN]),
+      "Encode the rows gated by a one-hot group by its convex hull instead "
+      "of big-M if this takes at most this many variable copies. 0 keeps "
+      "big-M.")(
       "query-dump-file",
       boost::program_options::value<std::string>(
           &(*_stringOptions)[Options::QUERY_DUMP_FILE])
@@ -151,6 +212,25 @@ void OptionParser::initialize() {
                                                   &((*_stringOptions)[Options::SOLUTION_FILE]))
        ->default_value((*_stringOptions)[Options::SOLUTION_FILE]),
        "Write the feasible solution to this file.")(
+      "hint-file",
+      boost::program_options::value<std::string>(
+          &((*_stringOptions)[Options::HINT_FILE]))
+          ->default_value((*_stringOptions)[Options::HINT_FILE]),
+      "Warm start from the solution hint in this file: lines of "
+      "'<variable> <value>', as in the solution file, or "
+      "'mode <step> <index>'.")(
+      "profile-file",
+      boost::program_options::value<std::string>(
+          &((*_stringOptions)[Options::PROFILE_FILE]))
+          ->default_value((*_stringOptions)[Options::PROFILE_FILE]),
+      "Write the profile as folded stacks (flame graph input) to this file. "
+      "Requires a build with ENABLE_PROFILING.")(
+      "trace-file",
+      boost::program_options::value<std::string>(
+          &((*_stringOptions)[Options::TRACE_FILE]))
+          ->default_value((*_stringOptions)[Options::TRACE_FILE]),
+      "Record a timeline of the search and write it to this file in the "
+      "Chrome trace-event format (chrome://tracing, ui.perfetto.dev).")(
       "search-strategy",
       boost::program_options::value<std::string>(
           &((*_stringOptions)[Options::SOI_SEARCH_STRATEGY]))
@@ -188,7 +268,9 @@ void OptionParser::initialize() {
             boost::program_options::value<float>(
                                                &(*_floatOptions)[Options::MILP_SOLVING_THRESHOLD])
             ->default_value((*_floatOptions)[Options::MILP_SOLVING_THRESHOLD]),
-            "When tree depth is larger than this, use milp to solve the node.");
+            "When tree depth is larger than this times the number of "
+            "constraints, use milp to solve the node, until the timings of "
+            "the checks say otherwise.");
 
   _optionDescription.add(_positional).add(_common).add(_other).add(_expert);
 
@@ -45,6 +45,8 @@ void Options::initializeDefaultValues() {
   _boolOptions[NO_BOUND_TIGHTENING] = false;
   _boolOptions[NO_PHASE_CONFLICT] = false;
   _boolOptions[VSIDS] = false;
+  _boolOptions[NO_PRESOLVE] = false;
+  _boolOptions[NO_BIG_M_REFRESH] = false;
 
   /*
     Int options
@@ -59,6 +61,12 @@ void Options::initializeDefaultValues() {
   _intOptions[MAX_LEMMA_LENGTH] = 4;
   _intOptions[MAX_PROPOSALS_PER_STATE] = 50;
   _intOptions[TABU] = 5;
+  _intOptions[DAEMON_POOL_SIZE] = 4;
+  _intOptions[BATCH_CORES] = 0;
+  _intOptions[PWA_HORIZON] = 0;
+  _intOptions[CONDENSE_FILL_IN] = 0;
+  _intOptions[ROOT_CUT_ROUNDS] = 0;
+  _intOptions[HULL_FILL_IN] = 0;
 
   /*
     Float options
@@ -73,10 +81,15 @@ void Options::initializeDefaultValues() {
   _stringOptions[SUMMARY_FILE] = "";
   _stringOptions[QUERY_DUMP_FILE] = "";
   _stringOptions[SOLUTION_FILE] = "";
+  _stringOptions[HINT_FILE] = "";
+  _stringOptions[PROFILE_FILE] = "";
+  _stringOptions[TRACE_FILE] = "";
   _stringOptions[SOI_SEARCH_STRATEGY] = "greedy-sat";
   _stringOptions[SOI_INITIALIZATION_STRATEGY] = "current-assignment-sat";
   _stringOptions[EXPLANATION_STRATEGY] = "none";
   _stringOptions[BRANCHING_HEURISTICS] = "none";
+  _stringOptions[DAEMON_SOCKET] = "";
+  _stringOptions[BATCH_PATH] = "";
 }
 
 void Options::parseOptions(int argc, char **argv) {
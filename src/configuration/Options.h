@@ -50,6 +50,12 @@ class Options {
     NO_PHASE_CONFLICT,
 
     VSIDS,
+
+    // Solve the input query as given, without the Presolver
+    NO_PRESOLVE,
+
+    // Keep the big-M coefficients of the abs constraints from the encoding
+    NO_BIG_M_REFRESH,
   };
 
   enum IntOptions {
@@ -75,6 +81,26 @@ class Options {
     MAX_PROPOSALS_PER_STATE,
 
     TABU,
+
+    // The number of workers shared by the solves of the daemon
+    DAEMON_POOL_SIZE,
+
+    // The cores shared by the queries of a batch, 0 for all
+    BATCH_CORES,
+
+    // The horizon over which a .pwa input is expanded, 0 for the file's
+    PWA_HORIZON,
+
+    // The coefficients the condensing of the presolve may add per state
+    // variable it substitutes, 0 for no condensing
+    CONDENSE_FILL_IN,
+
+    // The rounds of root cuts added to the relaxation, 0 for none
+    ROOT_CUT_ROUNDS,
+
+    // The variable copies allowed for the hull formulation of a one-hot
+    // group, 0 for big-M only
+    HULL_FILL_IN,
   };
 
   enum FloatOptions {
@@ -90,6 +116,17 @@ class Options {
     QUERY_DUMP_FILE,
     SOLUTION_FILE,
 
+    // A guess of the solution to warm start from, see HintParser.h
+    HINT_FILE,
+
+    // Where to write the folded stacks of the scoped-timer profile. Only used
+    // when built with ENABLE_PROFILING.
+    PROFILE_FILE,
+
+    // Where to write the Chrome trace-event timeline of the search. Nothing
+    // is recorded when this is empty.
+    TRACE_FILE,
+
     // The strategy used for soi minimization
     SOI_SEARCH_STRATEGY,
     // The strategy used for initializing the soi
@@ -99,6 +136,12 @@ class Options {
     EXPLANATION_STRATEGY,
 
     BRANCHING_HEURISTICS,
+
+    // Serve queries on this Unix-domain socket, see SolverDaemon.h
+    DAEMON_SOCKET,
+
+    // Solve the queries of this directory or manifest, see BatchSolver.h
+    BATCH_PATH,
   };
 
   /*
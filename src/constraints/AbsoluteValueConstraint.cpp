@@ -15,7 +15,9 @@ AbsoluteValueConstraint::AbsoluteValueConstraint(unsigned b, unsigned f)
       _posAux(0),
       _negAux(0),
       _auxVarsInUse(false),
-      _haveEliminatedVariables(false) {}
+      _haveEliminatedVariables(false) {
+  _participatingVariables = {_b, _f};
+}
 
 void AbsoluteValueConstraint::addBooleanStructure() {}
 
@@ -77,6 +79,7 @@ void AbsoluteValueConstraint::transformToUseAuxVariables(
 
   // Mark that the aux vars are in use
   _auxVarsInUse = true;
+  _participatingVariables = {_b, _f, _posAux, _negAux};
 }
 
 bool AbsoluteValueConstraint::participatingVariable(unsigned variable) const {
@@ -84,11 +87,6 @@ bool AbsoluteValueConstraint::participatingVariable(unsigned variable) const {
          (_auxVarsInUse && (variable == _posAux || variable == _negAux));
 }
 
-List<unsigned> AbsoluteValueConstraint::getParticipatingVariables() const {
-  return _auxVarsInUse ? List<unsigned>({_b, _f, _posAux, _negAux})
-                       : List<unsigned>({_b, _f});
-}
-
 void AbsoluteValueConstraint::fixPhaseIfNeeded() {
   // Option 1: b's range is strictly positive
   if (existsLowerBound(_b) && getLowerBound(_b) >= 0) {
@@ -176,6 +174,21 @@ PiecewiseLinearCaseSplit AbsoluteValueConstraint::getCaseSplit(
     throw SoyError(SoyError::REQUESTED_NONEXISTENT_CASE_SPLIT);
 }
 
+void AbsoluteValueConstraint::applyCaseSplit(
+    PhaseStatus phase, BoundManager &boundManager,
+    Vector<unsigned> &tightenedVariables) const {
+  ASSERT(_auxVarsInUse);
+  // Same tightenings as getNegativeSplit() and getPositiveSplit()
+  if (phase == ABS_PHASE_NEGATIVE) {
+    applyUpperBound(_b, 0.0, boundManager, tightenedVariables);
+    applyUpperBound(_negAux, 0.0, boundManager, tightenedVariables);
+  } else if (phase == ABS_PHASE_POSITIVE) {
+    applyLowerBound(_b, 0.0, boundManager, tightenedVariables);
+    applyUpperBound(_posAux, 0.0, boundManager, tightenedVariables);
+  } else
+    throw SoyError(SoyError::REQUESTED_NONEXISTENT_CASE_SPLIT);
+}
+
 PiecewiseLinearCaseSplit AbsoluteValueConstraint::getNegativeSplit() const {
   ASSERT(_auxVarsInUse);
   // Negative phase: b <= 0, b + f = 0
@@ -316,9 +329,7 @@ bool AbsoluteValueConstraint::satisfied() const {
 
 void AbsoluteValueConstraint::setPhaseStatus(PhaseStatus phase) {
   if (_context) {
-    ASSERT(*_feasiblePhases[phase]);
-    for (const auto &pair : _feasiblePhases)
-      if (pair.first != phase) *pair.second = false;
+    PLConstraint::setPhaseStatus(phase);
   } else {
     _phaseStatus = phase;
   }
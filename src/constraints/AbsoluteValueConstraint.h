@@ -3,7 +3,7 @@
 
 #include "PLConstraint.h"
 
-class AbsoluteValueConstraint : public PLConstraint {
+class AbsoluteValueConstraint final : public PLConstraint {
   /**********************************************************************/
   /*                           CONS/DESTRUCTION METHODS                 */
   /**********************************************************************/
@@ -33,7 +33,6 @@ class AbsoluteValueConstraint : public PLConstraint {
   bool auxVariablesInUse() const { return _auxVarsInUse; };
 
   virtual bool participatingVariable(unsigned variable) const override;
-  virtual List<unsigned> getParticipatingVariables() const override;
 
   virtual bool satisfied() const override;
   virtual void setPhaseStatus(PhaseStatus phase) override;
@@ -41,6 +40,9 @@ class AbsoluteValueConstraint : public PLConstraint {
   virtual List<PhaseStatus> getAllCases() const override;
   virtual PiecewiseLinearCaseSplit getCaseSplit(
       PhaseStatus caseId) const override;
+  virtual void applyCaseSplit(
+      PhaseStatus phase, BoundManager &boundManager,
+      Vector<unsigned> &tightenedVariables) const override;
 
  private:
   unsigned _b, _f;
@@ -21,6 +21,7 @@ DisjunctionConstraint::DisjunctionConstraint(const Set<unsigned> &elements)
     PhaseStatus phase = static_cast<PhaseStatus>(phaseIndex);
     _phaseStatusToElement[phase] = element;
     _elementToPhaseStatus[element] = phase;
+    _participatingVariables.append(element);
     ++phaseIndex;
   }
 }
@@ -39,6 +40,7 @@ void DisjunctionConstraint::addBooleanStructure() {
   List<PhaseStatus> allCases = getAllCases();
   for (const auto &phase : allCases) {
     int index = _satSolver->getFreshVariable();
+    _satSolver->registerToWatchBVariable(this, index);
     _litToPhaseStatus[index] = phase;
     _phaseStatusToLit[phase] = index;
     clause.append(index);
@@ -54,12 +56,6 @@ bool DisjunctionConstraint::participatingVariable(unsigned variable) const {
   return _elements.exists(variable);
 }
 
-List<unsigned> DisjunctionConstraint::getParticipatingVariables() const {
-  List<unsigned> toReturn;
-  for (const auto &element : _elements) toReturn.append(element);
-  return toReturn;
-}
-
 void DisjunctionConstraint::notifyLowerBound(unsigned variable, double value) {
   if (existsLowerBound(variable) &&
       !FloatUtils::gt(value, getLowerBound(variable)))
@@ -68,6 +64,14 @@ void DisjunctionConstraint::notifyLowerBound(unsigned variable, double value) {
   setLowerBound(variable, value);
 
   if (FloatUtils::isPositive(value)) {
+    // The units at level 0 mirror the bound tightenings below, which
+    // exclude the other elements
+    if (_context && _context->getLevel() == 0 && _satSolver) {
+      for (const auto &element : _elements) {
+        int bVar = getLiteralOfPhaseStatus(_elementToPhaseStatus[element]);
+        _satSolver->addConstraint({element == variable ? bVar : -bVar});
+      }
+    }
     List<unsigned> toRemove;
     for (const auto &element : _elements) {
       if (element == variable)
@@ -92,6 +96,10 @@ void DisjunctionConstraint::notifyUpperBound(unsigned variable, double value) {
   setUpperBound(variable, value);
 
   if (FloatUtils::lt(value, 1)) {
+    if (_context && _context->getLevel() == 0 && _satSolver) {
+      int bVar = getLiteralOfPhaseStatus(_elementToPhaseStatus[variable]);
+      _satSolver->addConstraint({-bVar});
+    }
     setUpperBound(variable, 0);
     if (!_context)
       eliminateElement(variable);
@@ -100,6 +108,13 @@ void DisjunctionConstraint::notifyUpperBound(unsigned variable, double value) {
   }
 }
 
+void DisjunctionConstraint::notifyBVariable(int lit, bool value) {
+  if (value)
+    notifyLowerBound(_phaseStatusToElement[_litToPhaseStatus[lit]], 1);
+  else
+    notifyUpperBound(_phaseStatusToElement[_litToPhaseStatus[lit]], 0);
+}
+
 bool DisjunctionConstraint::satisfied() const {
   ASSERT(_assignmentManager);
 
@@ -134,6 +149,18 @@ PiecewiseLinearCaseSplit DisjunctionConstraint::getCaseSplit(
   return split;
 }
 
+void DisjunctionConstraint::applyCaseSplit(
+    PhaseStatus phase, BoundManager &boundManager,
+    Vector<unsigned> &tightenedVariables) const {
+  unsigned selected = _phaseStatusToElement[phase];
+  for (const auto &element : _elements) {
+    if (element == selected)
+      applyLowerBound(element, 1, boundManager, tightenedVariables);
+    else
+      applyUpperBound(element, 0, boundManager, tightenedVariables);
+  }
+}
+
 void DisjunctionConstraint::getEntailedTightenings(
     List<Tightening> &tightening) const {
   ASSERT(!_context);
@@ -147,6 +174,7 @@ void DisjunctionConstraint::eliminateElement(unsigned variable) {
   if (_context)
     throw SoyError(SoyError::ELIMINATE_PHASE_AFTER_PREPROECESSING);
   _elements.erase(variable);
+  _participatingVariables.erase(variable);
 }
 
 void DisjunctionConstraint::getCostFunctionComponent(LinearExpression &cost,
@@ -168,6 +196,20 @@ PhaseStatus DisjunctionConstraint::getPhaseStatusInAssignment() {
   return _elementToPhaseStatus[largestVariable];
 }
 
+bool DisjunctionConstraint::getPhaseStatusInHint(
+    const Map<unsigned, double> &hint, PhaseStatus &phase) const {
+  bool found = false;
+  double largest = 0.5;
+  for (const auto &element : _elements) {
+    if (hint.exists(element) && hint[element] > largest) {
+      largest = hint[element];
+      phase = _elementToPhaseStatus[element];
+      found = true;
+    }
+  }
+  return found;
+}
+
 void DisjunctionConstraint::dump(String &) const {
   // TODO
 }
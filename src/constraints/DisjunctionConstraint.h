@@ -9,7 +9,7 @@
 #include "Map.h"
 #include "PLConstraint.h"
 
-class DisjunctionConstraint : public PLConstraint {
+class DisjunctionConstraint final : public PLConstraint {
  public:
   /**********************************************************************/
   /*                           CONS/DESTRUCTION METHODS                 */
@@ -24,11 +24,10 @@ class DisjunctionConstraint : public PLConstraint {
   /**********************************************************************/
   PiecewiseLinearFunctionType getType() const override;
   bool participatingVariable(unsigned variable) const override;
-  List<unsigned> getParticipatingVariables() const override;
 
   virtual void notifyLowerBound(unsigned variable, double value) override;
   virtual void notifyUpperBound(unsigned variable, double value) override;
-  // virtual void notifyFixedBooleanVariable(int lit) override;
+  virtual void notifyBVariable(int lit, bool value) override;
   virtual bool satisfied() const override;
   const Set<unsigned> &getElements() const { return _elements; };
   PhaseStatus getPhaseOfElement(unsigned variable) const {
@@ -41,6 +40,9 @@ class DisjunctionConstraint : public PLConstraint {
   virtual List<PhaseStatus> getAllCases() const override;
   virtual PiecewiseLinearCaseSplit getCaseSplit(
       PhaseStatus phase) const override;
+  virtual void applyCaseSplit(
+      PhaseStatus phase, BoundManager &boundManager,
+      Vector<unsigned> &tightenedVariables) const override;
   virtual void getEntailedTightenings(
       List<Tightening> &tightenings) const override;
 
@@ -55,6 +57,10 @@ class DisjunctionConstraint : public PLConstraint {
   virtual void getCostFunctionComponent(LinearExpression &cost,
                                         PhaseStatus phase) const override;
   virtual PhaseStatus getPhaseStatusInAssignment() override;
+  // The phase of the element hinted to be true (above 0.5) with the largest
+  // value
+  virtual bool getPhaseStatusInHint(const Map<unsigned, double> &hint,
+                                    PhaseStatus &phase) const override;
 
   /**********************************************************************/
   /*                             DEBUG METHODS                          */
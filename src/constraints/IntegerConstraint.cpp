@@ -3,6 +3,7 @@
 #include <math.h>
 
 #include <algorithm>
+#include <limits>
 
 #include "CadicalWrapper.h"
 #include "Debug.h"
@@ -17,9 +18,18 @@
 #include "Statistics.h"
 
 IntegerConstraint::IntegerConstraint(unsigned variable)
-    : PLConstraint(), _variable(variable) {}
+    : PLConstraint(), _variable(variable), _splitValue(NULL) {
+  _participatingVariables.append(_variable);
+}
 
-IntegerConstraint::~IntegerConstraint() {}
+IntegerConstraint::~IntegerConstraint() {
+  if (_splitValue) _splitValue->deleteSelf();
+}
+
+void IntegerConstraint::initializeCDOs(CVC4::context::Context *context) {
+  PLConstraint::initializeCDOs(context);
+  _splitValue = new (true) CVC4::context::CDO<double>(_context, 0);
+}
 
 PLConstraint *IntegerConstraint::duplicateConstraint() const {
   IntegerConstraint *clone = new IntegerConstraint(_variable);
@@ -27,7 +37,26 @@ PLConstraint *IntegerConstraint::duplicateConstraint() const {
   return clone;
 }
 
-void IntegerConstraint::addBooleanStructure() {}
+void IntegerConstraint::addBooleanStructure() {
+  double lb = getLowerBound(_variable);
+  double ub = getUpperBound(_variable);
+  if (!FloatUtils::isFinite(lb) || !FloatUtils::isFinite(ub)) return;
+  lb = FloatUtils::roundUp(lb);
+  ub = FloatUtils::roundDown(ub);
+  if (!FloatUtils::lt(lb, ub) ||
+      ub - lb > GlobalConfiguration::INTEGER_ORDER_ENCODING_MAX_DOMAIN)
+    return;
+
+  int previous = 0;
+  for (int value = (int)lb + 1; value <= (int)ub; ++value) {
+    int lit = _satSolver->getFreshVariable();
+    _satSolver->registerToWatchBVariable(this, lit);
+    _valueToLiteral[value] = lit;
+    _literalToValue[lit] = value;
+    if (previous != 0) _satSolver->addConstraint({-lit, previous});
+    previous = lit;
+  }
+}
 
 PiecewiseLinearFunctionType IntegerConstraint::getType() const {
   return PiecewiseLinearFunctionType::INTEGER;
@@ -37,16 +66,17 @@ bool IntegerConstraint::participatingVariable(unsigned variable) const {
   return variable == _variable;
 }
 
-List<unsigned> IntegerConstraint::getParticipatingVariables() const {
-  return {_variable};
-}
-
 void IntegerConstraint::notifyLowerBound(unsigned variable, double value) {
   if (existsLowerBound(variable) &&
       !FloatUtils::gt(value, getLowerBound(variable)))
     return;
 
-  setLowerBound(variable, FloatUtils::roundUp(value));
+  value = FloatUtils::roundUp(value);
+  setLowerBound(variable, value);
+  int lit = getOrderLiteral(value);
+  if (lit != 0 && _context && _context->getLevel() == 0 && _satSolver)
+    _satSolver->addConstraint({lit});
+  if (_stateTracker && phaseFixed()) _stateTracker->notifyPhaseFixed(this);
 }
 
 void IntegerConstraint::notifyUpperBound(unsigned variable, double value) {
@@ -54,13 +84,112 @@ void IntegerConstraint::notifyUpperBound(unsigned variable, double value) {
       !FloatUtils::lt(value, getUpperBound(variable)))
     return;
 
-  setUpperBound(variable, FloatUtils::roundDown(value));
+  value = FloatUtils::roundDown(value);
+  setUpperBound(variable, value);
+  int lit = getOrderLiteral(value + 1);
+  if (lit != 0 && _context && _context->getLevel() == 0 && _satSolver)
+    _satSolver->addConstraint({-lit});
+  if (_stateTracker && phaseFixed()) _stateTracker->notifyPhaseFixed(this);
+}
+
+int IntegerConstraint::getOrderLiteral(double value) const {
+  if (_valueToLiteral.empty() || value < _valueToLiteral.begin()->first ||
+      value > _valueToLiteral.rbegin()->first)
+    return 0;
+  return _valueToLiteral.get((int)value);
+}
+
+void IntegerConstraint::notifyBVariable(int lit, bool value) {
+  int bound = _literalToValue.get(lit);
+  if (value)
+    notifyLowerBound(_variable, bound);
+  else
+    notifyUpperBound(_variable, bound - 1);
 }
 
 bool IntegerConstraint::satisfied() const {
   return FloatUtils::isInteger(getAssignment(_variable));
 }
 
+bool IntegerConstraint::hasFeasiblePhases() const {
+  ASSERT(_boundManager);
+  double lb = _boundManager->getLowerBound(_variable);
+  double ub = _boundManager->getUpperBound(_variable);
+  if (!FloatUtils::lte(FloatUtils::roundUp(lb), FloatUtils::roundDown(ub)))
+    return false;
+  if (_feasiblePhases.empty()) return true;
+  return *_feasiblePhases[INTEGER_PHASE_BELOW] ||
+         *_feasiblePhases[INTEGER_PHASE_ABOVE];
+}
+
+unsigned IntegerConstraint::numberOfFeasiblePhases() const {
+  ASSERT(_boundManager);
+  double lb = FloatUtils::roundUp(_boundManager->getLowerBound(_variable));
+  double ub = FloatUtils::roundDown(_boundManager->getUpperBound(_variable));
+  if (FloatUtils::lt(ub, lb)) return 0;
+
+  // Before the cast, which is undefined out of the range of unsigned
+  const unsigned saturated = std::numeric_limits<unsigned>::max();
+  if (!FloatUtils::isFinite(lb) || !FloatUtils::isFinite(ub) ||
+      ub - lb + 1 >= saturated)
+    return saturated;
+  return (unsigned)(ub - lb + 1);
+}
+
+void IntegerConstraint::prepareCaseSplit() {
+  ASSERT(_context);
+  double lb = FloatUtils::roundUp(getLowerBound(_variable));
+  double ub = FloatUtils::roundDown(getUpperBound(_variable));
+  ASSERT(FloatUtils::lt(lb, ub));
+
+  // Keep both sides non-empty, also when the assignment is integral or out
+  // of the domain
+  double value = FloatUtils::roundDown(getAssignment(_variable));
+  if (value > ub - 1) value = ub - 1;
+  if (value < lb) value = lb;
+  *_splitValue = value;
+
+  // Both sides of the new split are open, also when a side of an earlier
+  // split of the constraint was ruled out at this level
+  for (const auto &pair : _feasiblePhases) *pair.second = true;
+  *_numberOfFeasiblePhases = _feasiblePhases.size();
+}
+
+void IntegerConstraint::markInfeasiblePhase(PhaseStatus phase) {
+  if (!*_feasiblePhases[phase]) return;
+  *_feasiblePhases[phase] = false;
+  *_numberOfFeasiblePhases = *_numberOfFeasiblePhases - 1;
+}
+
+double IntegerConstraint::getSplitValue() const {
+  ASSERT(_splitValue);
+  return *_splitValue;
+}
+
+PiecewiseLinearCaseSplit IntegerConstraint::getCaseSplit(
+    PhaseStatus phase) const {
+  PiecewiseLinearCaseSplit split;
+  if (phase == INTEGER_PHASE_BELOW)
+    split.storeBoundTightening(
+        Tightening(_variable, getSplitValue(), Tightening::UB));
+  else
+    split.storeBoundTightening(
+        Tightening(_variable, getSplitValue() + 1, Tightening::LB));
+  return split;
+}
+
+void IntegerConstraint::applyCaseSplit(
+    PhaseStatus phase, BoundManager &boundManager,
+    Vector<unsigned> &tightenedVariables) const {
+  // Same tightenings as getCaseSplit()
+  if (phase == INTEGER_PHASE_BELOW)
+    applyUpperBound(_variable, getSplitValue(), boundManager,
+                    tightenedVariables);
+  else
+    applyLowerBound(_variable, getSplitValue() + 1, boundManager,
+                    tightenedVariables);
+}
+
 PiecewiseLinearCaseSplit IntegerConstraint::getCaseSplitForInt(
     int value) const {
   PiecewiseLinearCaseSplit split;
@@ -80,6 +209,27 @@ void IntegerConstraint::getEntailedTightenings(
     tightening.append(Tightening(pair.first, pair.second, Tightening::UB));
 }
 
+void IntegerConstraint::getCostFunctionComponent(LinearExpression &cost,
+                                                 PhaseStatus phase) const {
+  double value = getAssignment(_variable);
+  if (!cost._addends.exists(_variable)) cost._addends[_variable] = 0;
+  if (phase == INTEGER_PHASE_BELOW) {
+    cost._addends[_variable] += 1;
+    cost._constant -= FloatUtils::roundDown(value);
+  } else {
+    cost._addends[_variable] -= 1;
+    cost._constant += FloatUtils::roundUp(value);
+  }
+}
+
+PhaseStatus IntegerConstraint::getPhaseStatusInAssignment() {
+  double value = getAssignment(_variable);
+  return value - FloatUtils::roundDown(value) <=
+                 FloatUtils::roundUp(value) - value
+             ? INTEGER_PHASE_BELOW
+             : INTEGER_PHASE_ABOVE;
+}
+
 void IntegerConstraint::dump(String &) const {
   // TODO
 }
@@ -5,13 +5,19 @@
 #include "Map.h"
 #include "PLConstraint.h"
 
-class IntegerConstraint : public PLConstraint {
+class IntegerConstraint final : public PLConstraint {
  public:
   /**********************************************************************/
   /*                           CONS/DESTRUCTION METHODS                 */
   /**********************************************************************/
   IntegerConstraint(unsigned variable);
   ~IntegerConstraint();
+  /*
+    Order encoding of the domain [l, u] of the variable: a literal per value
+    v in (l, u], true iff x >= v, with the clauses (x >= v + 1) -> (x >= v).
+    Not added if the domain is unbounded or larger than
+    GlobalConfiguration::INTEGER_ORDER_ENCODING_MAX_DOMAIN.
+  */
   virtual void addBooleanStructure() override;
   PLConstraint *duplicateConstraint() const override;
 
@@ -20,47 +26,53 @@ class IntegerConstraint : public PLConstraint {
   /**********************************************************************/
   PiecewiseLinearFunctionType getType() const override;
   bool participatingVariable(unsigned variable) const override;
-  List<unsigned> getParticipatingVariables() const override;
 
   unsigned getVariable() const;
 
   virtual bool satisfied() const override;
-  virtual bool supportCaseSplit() const { return false; };
+
+  /*
+    The value of the LP assignment, rounded down, splits the domain:
+    INTEGER_PHASE_BELOW is x <= v and INTEGER_PHASE_ABOVE is x >= v + 1.
+    The split value is kept in the context, and the constraint stays active
+    after a split, so a split deeper in the search can split the remaining
+    domain again.
+  */
+  virtual void initializeCDOs(CVC4::context::Context *context) override;
+  virtual void prepareCaseSplit() override;
 
   void setPhaseStatus(PhaseStatus) {
     throw SoyError(SoyError::FEATURE_NOT_YET_SUPPORTED,
                        "Trying to set phase status of IntegerConstraint");
   }
 
-  virtual bool hasFeasiblePhases() const {
-    ASSERT(_boundManager);
-    double lb = _boundManager->getLowerBound(_variable);
-    double ub = _boundManager->getUpperBound(_variable);
-    return FloatUtils::lte(FloatUtils::roundUp(lb), FloatUtils::roundDown(ub));
-  }
-
-  virtual bool isFeasible(PhaseStatus) const override {
-    throw SoyError(SoyError::FEATURE_NOT_YET_SUPPORTED,
-                       "Trying to check phase status of IntegerConstraint");
-  }
-
-  unsigned numberOfFeasiblePhases() const override {
-    double lb = _boundManager->getLowerBound(_variable);
-    double ub = _boundManager->getUpperBound(_variable);
-    if (FloatUtils::lt(ub, lb))
-      return 0;
-    else
-      return (unsigned)(FloatUtils::roundDown(ub) - FloatUtils::roundUp(lb) +
-                        1);
-  }
-
-  virtual void markInfeasiblePhase(PhaseStatus) {
-    throw SoyError(SoyError::FEATURE_NOT_YET_SUPPORTED,
-                       "Trying to mark phase status of IntegerConstraint");
-  }
+  /*
+    The domain is not empty, and a side of the current split is left
+  */
+  virtual bool hasFeasiblePhases() const override;
+
+  /*
+    The number of integers in the domain, saturated at the largest unsigned
+    for an unbounded or too large domain
+  */
+  unsigned numberOfFeasiblePhases() const override;
+
+  /*
+    Rule out a side of the current split. Unlike the other constraints,
+    whether the phase is fixed only depends on the size of the domain, so
+    ruling out a side does not notify the state tracker: the tracker learns
+    of a fixed domain through ConstraintStateTracker::notifyBoundTightened().
+  */
+  virtual void markInfeasiblePhase(PhaseStatus phase) override;
 
   PiecewiseLinearCaseSplit getCaseSplitForInt(int value) const;
 
+  virtual PiecewiseLinearCaseSplit getCaseSplit(
+      PhaseStatus phase) const override;
+  virtual void applyCaseSplit(
+      PhaseStatus phase, BoundManager &boundManager,
+      Vector<unsigned> &tightenedVariables) const override;
+
   virtual PiecewiseLinearCaseSplit getValidCaseSplit() const override {
     ASSERT(_context);
     double lb = FloatUtils::roundUp(_boundManager->getLowerBound(_variable));
@@ -74,15 +86,44 @@ class IntegerConstraint : public PLConstraint {
                          "No feasible case split left.");
   }
 
+  virtual void applyValidCaseSplit(
+      BoundManager &boundManager,
+      Vector<unsigned> &tightenedVariables) const override {
+    ASSERT(_context);
+    double lb = FloatUtils::roundUp(_boundManager->getLowerBound(_variable));
+    double ub = FloatUtils::roundDown(_boundManager->getUpperBound(_variable));
+    if (FloatUtils::areEqual(lb, ub)) {
+      // Same tightenings as getCaseSplitForInt()
+      int value = lb;
+      applyLowerBound(_variable, value, boundManager, tightenedVariables);
+      applyUpperBound(_variable, value, boundManager, tightenedVariables);
+    } else if (!FloatUtils::lt(lb, ub))
+      throw SoyError(SoyError::REQUESTED_NONEXISTENT_CASE_SPLIT,
+                         "No feasible case split left.");
+  }
+
   virtual List<PhaseStatus> getAllCases() const override {
-    return List<PhaseStatus>();
+    return {INTEGER_PHASE_BELOW, INTEGER_PHASE_ABOVE};
   };
 
+  double getSplitValue() const;
+
   /**********************************************************************/
   /*                             SoI METHODS                            */
   /**********************************************************************/
+  /*
+    The terms are relative to the integers around the current value v of x:
+    INTEGER_PHASE_BELOW costs x - floor(v) and INTEGER_PHASE_ABOVE costs
+    ceil(v) - x. At v, they are the distances to the nearest integer below
+    and above, both zero when v is integral. The phase in the assignment is
+    the nearer integer. The terms are rebuilt from the assignment each time
+    the phase pattern is evaluated, so they follow x to the next integers.
+  */
  public:
-  virtual inline bool supportSoI() const override { return false; }
+  virtual inline bool supportSoI() const override { return true; }
+  virtual void getCostFunctionComponent(LinearExpression &cost,
+                                        PhaseStatus phase) const override;
+  virtual PhaseStatus getPhaseStatusInAssignment() override;
 
   /**********************************************************************/
   /*                         BOUND WRAPPER METHODS                      */
@@ -92,6 +133,7 @@ class IntegerConstraint : public PLConstraint {
  public:
   virtual void notifyLowerBound(unsigned variable, double bound) override;
   virtual void notifyUpperBound(unsigned variable, double bound) override;
+  virtual void notifyBVariable(int lit, bool value) override;
   virtual void getEntailedTightenings(
       List<Tightening> &tightenings) const override;
 
@@ -102,6 +144,16 @@ class IntegerConstraint : public PLConstraint {
 
  private:
   unsigned _variable;
+
+  // The order encoding: the literal of x >= v, and back
+  Map<int, int> _valueToLiteral;
+  Map<int, int> _literalToValue;
+
+  // The literal of x >= value, or 0 if the value is out of the encoding
+  int getOrderLiteral(double value) const;
+
+  // The largest value of the lower side of the current split
+  CVC4::context::CDO<double> *_splitValue;
 };
 
 #endif  // __IntegerConstraint_h__
@@ -15,12 +15,13 @@
 #include "Statistics.h"
 
 OneHotConstraint::OneHotConstraint(const Set<unsigned> &elements)
-    : PLConstraint(), _elements(elements) {
+    : PLConstraint(), _elements(elements), _groupStore(NULL), _groupIndex(0) {
   unsigned phaseIndex = 0;
   for (const auto &element : elements) {
     PhaseStatus phase = static_cast<PhaseStatus>(phaseIndex);
     _phaseStatusToElement[phase] = element;
     _elementToPhaseStatus[element] = phase;
+    _participatingVariables.append(element);
     ++phaseIndex;
   }
 }
@@ -55,6 +56,12 @@ void OneHotConstraint::addBooleanStructure() {
   }
 }
 
+void OneHotConstraint::registerGroupStore(OneHotGroupStore *store) {
+  ASSERT(_context);
+  _groupStore = store;
+  _groupIndex = store->addGroup(_elements);
+}
+
 PiecewiseLinearFunctionType OneHotConstraint::getType() const {
   return PiecewiseLinearFunctionType::ONE_HOT;
 }
@@ -63,12 +70,6 @@ bool OneHotConstraint::participatingVariable(unsigned variable) const {
   return _elements.exists(variable);
 }
 
-List<unsigned> OneHotConstraint::getParticipatingVariables() const {
-  List<unsigned> toReturn;
-  for (const auto &element : _elements) toReturn.append(element);
-  return toReturn;
-}
-
 void OneHotConstraint::notifyLowerBound(unsigned variable, double value) {
   ASSERT(participatingVariable(variable));
 
@@ -131,6 +132,10 @@ void OneHotConstraint::notifyBVariable(int lit, bool value) {
 
 bool OneHotConstraint::satisfied() const {
   ASSERT(_assignmentManager);
+  if (_groupStore)
+    return _groupStore->groupSatisfied(_groupIndex,
+                                       _assignmentManager->getAssignments());
+
   bool oneFound = false;
   for (const auto &element : _elements) {
     double currentValue = getAssignment(element);
@@ -179,10 +184,22 @@ PiecewiseLinearCaseSplit OneHotConstraint::getCaseSplit(
   return split;
 }
 
+void OneHotConstraint::applyCaseSplit(
+    PhaseStatus phase, BoundManager &boundManager,
+    Vector<unsigned> &tightenedVariables) const {
+  unsigned selected = _phaseStatusToElement[phase];
+  for (const auto &element : _elements) {
+    if (element == selected)
+      applyLowerBound(element, 1, boundManager, tightenedVariables);
+    else
+      applyUpperBound(element, 0, boundManager, tightenedVariables);
+  }
+}
+
 void OneHotConstraint::getEntailedTightenings(
     List<Tightening> &tightening) const {
   if (_boundManager) {
-    for (const auto &variable : getParticipatingVariables()) {
+    for (const auto &variable : getParticipatingVariableSpan()) {
       tightening.append(Tightening(
           variable, _boundManager->getLowerBound(variable), Tightening::LB));
       tightening.append(Tightening(
@@ -200,6 +217,7 @@ void OneHotConstraint::eliminateElement(unsigned variable) {
   if (_context)
     throw SoyError(SoyError::ELIMINATE_PHASE_AFTER_PREPROECESSING);
   _elements.erase(variable);
+  _participatingVariables.erase(variable);
 }
 
 void OneHotConstraint::getCostFunctionComponent(LinearExpression &cost,
@@ -221,6 +239,20 @@ PhaseStatus OneHotConstraint::getPhaseStatusInAssignment() {
   return _elementToPhaseStatus[largestVariable];
 }
 
+bool OneHotConstraint::getPhaseStatusInHint(const Map<unsigned, double> &hint,
+                                            PhaseStatus &phase) const {
+  bool found = false;
+  double largest = 0.5;
+  for (const auto &element : _elements) {
+    if (hint.exists(element) && hint[element] > largest) {
+      largest = hint[element];
+      phase = _elementToPhaseStatus[element];
+      found = true;
+    }
+  }
+  return found;
+}
+
 void OneHotConstraint::dump(String &s) const {
   s += "Feasible phase: ";
   for (const auto &pair : _feasiblePhases) {
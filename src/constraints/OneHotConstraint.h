@@ -3,9 +3,10 @@
 
 #include "LinearExpression.h"
 #include "Map.h"
+#include "OneHotGroupStore.h"
 #include "PLConstraint.h"
 
-class OneHotConstraint : public PLConstraint {
+class OneHotConstraint final : public PLConstraint {
  public:
   /**********************************************************************/
   /*                           CONS/DESTRUCTION METHODS                 */
@@ -15,12 +16,18 @@ class OneHotConstraint : public PLConstraint {
   PLConstraint *duplicateConstraint() const override;
   virtual void addBooleanStructure() override;
 
+  /*
+    Add the elements as a group of the store. From then on, the satisfaction
+    check reads the group from the store.
+  */
+  void registerGroupStore(OneHotGroupStore *store);
+  unsigned getGroupIndex() const { return _groupIndex; }
+
   /**********************************************************************/
   /*                           GENERAL METHODS                          */
   /**********************************************************************/
   PiecewiseLinearFunctionType getType() const override;
   bool participatingVariable(unsigned variable) const override;
-  List<unsigned> getParticipatingVariables() const override;
 
   virtual void notifyLowerBound(unsigned variable, double value) override;
   virtual void notifyUpperBound(unsigned variable, double value) override;
@@ -38,6 +45,9 @@ class OneHotConstraint : public PLConstraint {
   virtual List<PhaseStatus> getAllCases() const override;
   virtual PiecewiseLinearCaseSplit getCaseSplit(
       PhaseStatus phase) const override;
+  virtual void applyCaseSplit(
+      PhaseStatus phase, BoundManager &boundManager,
+      Vector<unsigned> &tightenedVariables) const override;
   virtual void getEntailedTightenings(
       List<Tightening> &tightenings) const override;
 
@@ -52,6 +62,10 @@ class OneHotConstraint : public PLConstraint {
   virtual void getCostFunctionComponent(LinearExpression &cost,
                                         PhaseStatus phase) const override;
   virtual PhaseStatus getPhaseStatusInAssignment() override;
+  // The phase of the element hinted to be true (above 0.5) with the largest
+  // value
+  virtual bool getPhaseStatusInHint(const Map<unsigned, double> &hint,
+                                    PhaseStatus &phase) const override;
 
   /**********************************************************************/
   /*                             DEBUG METHODS                          */
@@ -62,6 +76,9 @@ class OneHotConstraint : public PLConstraint {
   Set<unsigned> _elements;
   Map<unsigned, PhaseStatus> _elementToPhaseStatus;
   Map<PhaseStatus, unsigned> _phaseStatusToElement;
+
+  OneHotGroupStore *_groupStore;
+  unsigned _groupIndex;
 };
 
 #endif  // __OneHotConstraint_h__
@@ -0,0 +1,97 @@
+#include "OneHotGroupStore.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "GlobalConfiguration.h"
+
+OneHotGroupStore::OneHotGroupStore() { _offsets.append(0); }
+
+unsigned OneHotGroupStore::addGroup(const Set<unsigned> &elements) {
+  unsigned group = getNumberOfGroups();
+  for (const auto &element : elements) _elements.append(element);
+  _offsets.append(_elements.size());
+
+  _gathered += Vector<double>(elements.size(), 0);
+  _isOne += Vector<uint8_t>(elements.size(), 0);
+  _isNonIntegral += Vector<uint8_t>(elements.size(), 0);
+  if (group % 64 == 0) _violated.append(0);
+  return group;
+}
+
+void OneHotGroupStore::clear() {
+  _offsets.clear();
+  _offsets.append(0);
+  _elements.clear();
+  _gathered.clear();
+  _isOne.clear();
+  _isNonIntegral.clear();
+  _violated.clear();
+}
+
+void OneHotGroupStore::computeViolatedGroups(
+    const Vector<double> &assignment) {
+  const double epsilon =
+      GlobalConfiguration::DEFAULT_EPSILON_FOR_INTEGRAL_COMPARISONS;
+  const unsigned numberOfElements = _elements.size();
+  const unsigned *elements = _elements.data();
+  const double *values = assignment.data();
+  double *gathered = _gathered.data();
+  uint8_t *isOne = _isOne.data();
+  uint8_t *isNonIntegral = _isNonIntegral.data();
+
+  for (unsigned i = 0; i < numberOfElements; ++i)
+    gathered[i] = values[elements[i]];
+
+  // Branch-free so that the compiler can vectorize it. For values near 0 and
+  // 1 this is equivalent to FloatUtils::areEqualInt.
+  for (unsigned i = 0; i < numberOfElements; ++i) {
+    uint8_t one = std::fabs(gathered[i] - 1) <= epsilon;
+    uint8_t zero = std::fabs(gathered[i]) <= epsilon;
+    isOne[i] = one;
+    isNonIntegral[i] = 1 - (one | zero);
+  }
+
+  const unsigned numberOfGroups = getNumberOfGroups();
+  const unsigned *offsets = _offsets.data();
+  for (unsigned word = 0; word < _violated.size(); ++word) {
+    uint64_t bits = 0;
+    unsigned end = std::min((word + 1) * 64, numberOfGroups);
+    for (unsigned group = word * 64; group < end; ++group) {
+      unsigned ones = 0;
+      unsigned nonIntegral = 0;
+      for (unsigned i = offsets[group]; i < offsets[group + 1]; ++i) {
+        ones += isOne[i];
+        nonIntegral += isNonIntegral[i];
+      }
+      uint64_t violated = (ones != 1) | (nonIntegral != 0);
+      bits |= violated << (group % 64);
+    }
+    _violated[word] = bits;
+  }
+}
+
+unsigned OneHotGroupStore::getNumberOfViolatedGroups() const {
+  unsigned count = 0;
+  for (unsigned group = 0; group < getNumberOfGroups(); ++group)
+    if (isViolated(group)) ++count;
+  return count;
+}
+
+bool OneHotGroupStore::groupSatisfied(unsigned group,
+                                      const Vector<double> &assignment) const {
+  ASSERT(group < getNumberOfGroups());
+  const double epsilon =
+      GlobalConfiguration::DEFAULT_EPSILON_FOR_INTEGRAL_COMPARISONS;
+  bool oneFound = false;
+  for (unsigned i = _offsets[group]; i < _offsets[group + 1]; ++i) {
+    double value = assignment[_elements[i]];
+    if (std::fabs(value) <= epsilon)
+      continue;
+    else if (std::fabs(value - 1) <= epsilon && !oneFound)
+      oneFound = true;
+    else
+      return false;
+  }
+  return oneFound;
+}
@@ -0,0 +1,75 @@
+#ifndef __OneHotGroupStore_h__
+#define __OneHotGroupStore_h__
+
+#include <cstdint>
+
+#include "Debug.h"
+#include "Set.h"
+#include "Vector.h"
+
+/*
+  Structure-of-arrays storage for all one-hot groups of a query. Group g owns
+  the elements _elements[_offsets[g]] ... _elements[_offsets[g + 1] - 1], in
+  the same (ascending) order as the phases of the corresponding
+  OneHotConstraint.
+
+  The satisfaction check of all groups is done in one pass over a gathered
+  copy of the assignment, and the result is kept as a bitmap of violated
+  groups. OneHotConstraints registered with the store become thin views over
+  their group.
+*/
+class OneHotGroupStore {
+ public:
+  OneHotGroupStore();
+
+  /*
+    Add a group and return its index.
+  */
+  unsigned addGroup(const Set<unsigned> &elements);
+
+  void clear();
+
+  unsigned getNumberOfGroups() const { return _offsets.size() - 1; }
+  unsigned getGroupSize(unsigned group) const {
+    ASSERT(group < getNumberOfGroups());
+    return _offsets[group + 1] - _offsets[group];
+  }
+  unsigned getElement(unsigned group, unsigned position) const {
+    ASSERT(position < getGroupSize(group));
+    return _elements[_offsets[group] + position];
+  }
+
+  /*
+    Check all groups against the assignment (indexed by variable) and
+    record which ones are violated. A group is satisfied iff all its elements
+    are integral 0/1 values and exactly one of them is 1.
+  */
+  void computeViolatedGroups(const Vector<double> &assignment);
+
+  /*
+    Result of the last call to computeViolatedGroups().
+  */
+  bool isViolated(unsigned group) const {
+    ASSERT(group < getNumberOfGroups());
+    return (_violated[group / 64] >> (group % 64)) & 1;
+  }
+  unsigned getNumberOfViolatedGroups() const;
+
+  /*
+    Check a single group against the assignment.
+  */
+  bool groupSatisfied(unsigned group, const Vector<double> &assignment) const;
+
+ private:
+  Vector<unsigned> _offsets;
+  Vector<unsigned> _elements;
+
+  // Scratch space for computeViolatedGroups(), one entry per element
+  Vector<double> _gathered;
+  Vector<uint8_t> _isOne;
+  Vector<uint8_t> _isNonIntegral;
+
+  Vector<uint64_t> _violated;
+};
+
+#endif  // __OneHotGroupStore_h__
@@ -4,6 +4,7 @@
 #include "AssignmentManager.h"
 #include "BoundManager.h"
 #include "CadicalWrapper.h"
+#include "ConstraintStateTracker.h"
 #include "GlobalConfiguration.h"
 #include "GurobiWrapper.h"
 #include "LinearExpression.h"
@@ -12,8 +13,10 @@
 #include "SoyError.h"
 #include "PiecewiseLinearCaseSplit.h"
 #include "PiecewiseLinearFunctionType.h"
+#include "Span.h"
 #include "Statistics.h"
 #include "Tightening.h"
+#include "Vector.h"
 #include "Watcher.h"
 #include "context/cdlist.h"
 #include "context/cdo.h"
@@ -28,6 +31,10 @@ enum PhaseStatus : unsigned {
   ABS_PHASE_POSITIVE = 1,
   ABS_PHASE_NEGATIVE = 2,
 
+  // The lower and upper side of the domain of an IntegerConstraint
+  INTEGER_PHASE_BELOW = 3,
+  INTEGER_PHASE_ABOVE = 4,
+
   PHASE_MAX = 1000000,
 };
 
@@ -59,11 +66,14 @@ class PLConstraint : public Watchee {
         _boundManager(nullptr),
         _satSolver(NULL),
         _statistics(NULL),
+        _stateTracker(NULL),
         _constraintActive(NULL),
+        _numberOfFeasiblePhases(NULL),
         _phaseStatus(PHASE_NOT_FIXED) {}
 
   virtual ~PLConstraint() {
     if (_constraintActive) _constraintActive->deleteSelf();
+    if (_numberOfFeasiblePhases) _numberOfFeasiblePhases->deleteSelf();
     for (const auto pair : _feasiblePhases) pair.second->deleteSelf();
   }
 
@@ -77,18 +87,26 @@ class PLConstraint : public Watchee {
   }
   void registerSatSolver(CadicalWrapper *solver) { _satSolver = solver; }
   void setStatistics(Statistics *statistics) { _statistics = statistics; }
+  void registerStateTracker(ConstraintStateTracker *tracker) {
+    _stateTracker = tracker;
+  }
 
   virtual void addBooleanStructure() = 0;
 
-  void initializeCDOs(CVC4::context::Context *context) {
+  virtual void initializeCDOs(CVC4::context::Context *context) {
     ASSERT(_context == NULL);
     ASSERT(_constraintActive == NULL);
     ASSERT(_feasiblePhases.size() == 0);
     _context = context;
     _constraintActive = new (true) CVC4::context::CDO<bool>(_context, true);
-    for (const auto &phase : getAllCases())
+    for (const auto &phase : getAllCases()) {
       _feasiblePhases[phase] =
           new (true) CVC4::context::CDO<bool>(_context, true);
+      _cases.append(phase);
+      _caseFeasibility.append(_feasiblePhases[phase]);
+    }
+    _numberOfFeasiblePhases = new (true)
+        CVC4::context::CDO<unsigned>(_context, _feasiblePhases.size());
     initializeDirectionHeuristic();
   }
 
@@ -103,14 +121,29 @@ class PLConstraint : public Watchee {
   virtual PiecewiseLinearFunctionType getType() const = 0;
 
   virtual bool participatingVariable(unsigned variable) const = 0;
-  virtual List<unsigned> getParticipatingVariables() const = 0;
+  virtual List<unsigned> getParticipatingVariables() const {
+    return List<unsigned>(_participatingVariables.begin(),
+                          _participatingVariables.end());
+  }
+
+  /*
+    The participating variables, without copying them. The span is
+    invalidated when the variables of the constraint change (e.g., in
+    transformToUseAuxVariables or when an element is eliminated).
+  */
+  Span<unsigned> getParticipatingVariableSpan() const {
+    return Span<unsigned>(_participatingVariables);
+  }
 
   virtual bool satisfied() const = 0;
   virtual bool satisfied(const Map<unsigned, double> &) const { return false; }
 
-  virtual bool supporCaseSplit() const { return true; };
+  virtual bool supportCaseSplit() const { return true; };
 
-  void setActive(bool active) { *_constraintActive = active; }
+  void setActive(bool active) {
+    *_constraintActive = active;
+    if (_stateTracker) _stateTracker->notifyActivityChanged(this, active);
+  }
   bool isActive() const {
     if (_constraintActive)
       return *_constraintActive;
@@ -118,16 +151,26 @@ class PLConstraint : public Watchee {
       return true;
   }
 
+  /*
+    Make all phases feasible and the constraint active again. Only valid at
+    decision level 0, e.g., when the engine solves the same query again from
+    new bounds.
+  */
+  void resetPhases() {
+    ASSERT(_context && _context->getLevel() == 0);
+    for (const auto &pair : _feasiblePhases) *pair.second = true;
+    *_numberOfFeasiblePhases = _feasiblePhases.size();
+    setActive(true);
+  }
+
   virtual void setPhaseStatus(PhaseStatus phase) {
     ASSERT(*_feasiblePhases[phase]);
     for (const auto &pair : _feasiblePhases)
-      if (pair.first != phase) *pair.second = false;
+      if (pair.first != phase) PLConstraint::markInfeasiblePhase(pair.first);
   }
 
   virtual bool hasFeasiblePhases() const {
-    for (const auto &pair : _feasiblePhases)
-      if (*pair.second) return true;
-    return false;
+    return numberOfFeasiblePhases() > 0;
   }
 
   virtual bool isFeasible(PhaseStatus phase) const {
@@ -135,14 +178,16 @@ class PLConstraint : public Watchee {
   }
 
   virtual unsigned numberOfFeasiblePhases() const {
-    unsigned numPhases = 0;
-    for (const auto &pair : _feasiblePhases)
-      if (*pair.second) ++numPhases;
-    return numPhases;
+    return _numberOfFeasiblePhases ? _numberOfFeasiblePhases->get() : 0;
   }
 
   virtual void markInfeasiblePhase(PhaseStatus phase) {
+    if (!*_feasiblePhases[phase]) return;
     *_feasiblePhases[phase] = false;
+    *_numberOfFeasiblePhases = *_numberOfFeasiblePhases - 1;
+    // Let the engine know the moment the last alternative is ruled out
+    if (_stateTracker && *_numberOfFeasiblePhases == 1)
+      _stateTracker->notifyPhaseFixed(this);
   }
 
   virtual bool phaseFixed() const { return numberOfFeasiblePhases() == 1; };
@@ -156,6 +201,47 @@ class PLConstraint : public Watchee {
     return phases;
   }
 
+  /*
+    All cases, in the order of getAllCases(), without copying them. Only
+    available once the CDOs are initialized.
+  */
+  Span<PhaseStatus> getCaseSpan() const {
+    ASSERT(_context);
+    return Span<PhaseStatus>(_cases);
+  }
+
+  /*
+    The feasible cases other than the given phase, enumerated in the order of
+    getCaseSpan(). These replace erasing the phase from getAllFeasibleCases()
+    and indexing into the result.
+  */
+  unsigned numberOfFeasibleAlternatives(PhaseStatus phase) const {
+    ASSERT(_context);
+    unsigned count = 0;
+    for (unsigned i = 0; i < _cases.size(); ++i)
+      if (_cases[i] != phase && *_caseFeasibility[i]) ++count;
+    return count;
+  }
+
+  PhaseStatus getFeasibleAlternative(PhaseStatus phase, unsigned index) const {
+    ASSERT(_context);
+    for (unsigned i = 0; i < _cases.size(); ++i) {
+      if (_cases[i] != phase && *_caseFeasibility[i]) {
+        if (index == 0) return _cases[i];
+        --index;
+      }
+    }
+    throw SoyError(SoyError::REQUESTED_NONEXISTENT_CASE_SPLIT,
+                   "No such feasible case");
+  }
+
+  /*
+    Called at the decision level of a split on the constraint, before the
+    context is pushed. Lets a constraint whose cases depend on the current
+    assignment, e.g., IntegerConstraint, fix them for both sides of the split.
+  */
+  virtual void prepareCaseSplit() {}
+
   PhaseStatus getNextFeasibleCase() const {
     ASSERT(_context);
     return topUnfixed();
@@ -186,6 +272,51 @@ class PLConstraint : public Watchee {
                          "No feasible case split left.");
   }
 
+  /*
+    Apply the case split of the phase directly to the bound manager, without
+    materializing a PiecewiseLinearCaseSplit. Variables whose bounds became
+    tighter are appended to tightenedVariables. The default implementation
+    goes through getCaseSplit().
+  */
+  virtual void applyCaseSplit(PhaseStatus phase, BoundManager &boundManager,
+                              Vector<unsigned> &tightenedVariables) const {
+    for (const auto &bound : getCaseSplit(phase).getBoundTightenings()) {
+      if (bound._type == Tightening::LB)
+        applyLowerBound(bound._variable, bound._value, boundManager,
+                        tightenedVariables);
+      else
+        applyUpperBound(bound._variable, bound._value, boundManager,
+                        tightenedVariables);
+    }
+  }
+
+  /*
+    In-place counterpart of getValidCaseSplit(): does nothing if more than
+    one phase is still feasible.
+  */
+  virtual void applyValidCaseSplit(BoundManager &boundManager,
+                                   Vector<unsigned> &tightenedVariables) const {
+    ASSERT(_context);
+    bool seenFeasiblePhase = false;
+    PhaseStatus validPhase;
+    for (unsigned i = 0; i < _cases.size(); ++i) {
+      if (*_caseFeasibility[i]) {
+        if (seenFeasiblePhase)
+          return;
+        else {
+          seenFeasiblePhase = true;
+          validPhase = _cases[i];
+        }
+      }
+    }
+
+    if (seenFeasiblePhase)
+      applyCaseSplit(validPhase, boundManager, tightenedVariables);
+    else
+      throw SoyError(SoyError::REQUESTED_NONEXISTENT_CASE_SPLIT,
+                         "No feasible case split left.");
+  }
+
   int getLiteralOfPhaseStatus(PhaseStatus phase) const {
     return _phaseStatusToLit[phase];
   }
@@ -202,13 +333,41 @@ class PLConstraint : public Watchee {
   BoundManager *_boundManager;
   CadicalWrapper *_satSolver;
   Statistics *_statistics;
+  ConstraintStateTracker *_stateTracker;
 
   CVC4::context::CDO<bool> *_constraintActive;
   Map<PhaseStatus, CVC4::context::CDO<bool> *> _feasiblePhases;
+  CVC4::context::CDO<unsigned> *_numberOfFeasiblePhases;
 
   Map<int, PhaseStatus> _litToPhaseStatus;
   Map<PhaseStatus, int> _phaseStatusToLit;
 
+  /*
+    Maintained by the subclasses, backs getParticipatingVariables()
+  */
+  Vector<unsigned> _participatingVariables;
+
+  /*
+    The cases and their feasibility flags, in the order of getAllCases().
+    Set in initializeCDOs(); the flags are owned by _feasiblePhases.
+  */
+  Vector<PhaseStatus> _cases;
+  Vector<CVC4::context::CDO<bool> *> _caseFeasibility;
+
+  static void applyLowerBound(unsigned variable, double value,
+                              BoundManager &boundManager,
+                              Vector<unsigned> &tightenedVariables) {
+    if (boundManager.tightenLowerBound(variable, value))
+      tightenedVariables.append(variable);
+  }
+
+  static void applyUpperBound(unsigned variable, double value,
+                              BoundManager &boundManager,
+                              Vector<unsigned> &tightenedVariables) {
+    if (boundManager.tightenUpperBound(variable, value))
+      tightenedVariables.append(variable);
+  }
+
   /*
     Used only in preprocessing
   */
@@ -233,7 +392,7 @@ class PLConstraint : public Watchee {
   }
 
   void decayScores() {
-    for (const auto &phase : getAllCases()) {
+    for (const auto &phase : getCaseSpan()) {
       double oldScore = _phaseToScore[phase];
       double newScore = oldScore / 10;
       _scores.erase(PhaseScoreEntry(phase, oldScore));
@@ -243,7 +402,7 @@ class PLConstraint : public Watchee {
   }
 
   void initializeDirectionHeuristic() {
-    for (const auto &phase : getAllCases()) {
+    for (const auto &phase : _cases) {
       _scores.insert({phase, 0});
       _phaseToScore[phase] = 0;
     }
@@ -276,6 +435,15 @@ class PLConstraint : public Watchee {
     throw SoyError(SoyError::FEATURE_NOT_YET_SUPPORTED);
   }
 
+  /*
+    The phase that the given values of some of the variables point to, as in
+    getPhaseStatusInAssignment(). Return false if they do not determine one.
+  */
+  virtual bool getPhaseStatusInHint(const Map<unsigned, double> & /* hint */,
+                                    PhaseStatus & /* phase */) const {
+    return false;
+  }
+
   /**********************************************************************/
   /*                         BOUND WRAPPER METHODS                      */
   /**********************************************************************/
@@ -0,0 +1,133 @@
+#ifndef __TypedPLConstraints_h__
+#define __TypedPLConstraints_h__
+
+#include "AbsoluteValueConstraint.h"
+#include "DisjunctionConstraint.h"
+#include "IntegerConstraint.h"
+#include "List.h"
+#include "OneHotConstraint.h"
+#include "PLConstraint.h"
+#include "Vector.h"
+
+/*
+  The concrete piecewise-linear constraint types, as
+  F(PiecewiseLinearFunctionType, class, member of TypedPLConstraints).
+
+  This is the single registration point for type-specialized dispatch: a new
+  constraint type added here is picked up by dispatchPLConstraint() and by
+  TypedPLConstraints. The classes are final, so calls through a pointer to
+  the concrete class are resolved statically.
+*/
+#define SOY_FOR_EACH_PL_CONSTRAINT_TYPE(F)                               \
+  F(ABSOLUTE_VALUE, AbsoluteValueConstraint, _absoluteValueConstraints) \
+  F(DISJUNCT, DisjunctionConstraint, _disjunctionConstraints)           \
+  F(INTEGER, IntegerConstraint, _integerConstraints)                    \
+  F(ONE_HOT, OneHotConstraint, _oneHotConstraints)
+
+/*
+  Call kernel(static_cast<T *>(constraint)) with T the concrete class of the
+  constraint. Constraints of a type that is not registered (e.g., mocks) are
+  passed as PLConstraint *, so the kernel must provide that overload too.
+*/
+template <class Kernel>
+void dispatchPLConstraint(PLConstraint *constraint, Kernel &kernel) {
+  switch (constraint->getType()) {
+#define SOY_DISPATCH_CASE(type, Class, member) \
+  case PiecewiseLinearFunctionType::type:      \
+    kernel(static_cast<Class *>(constraint));  \
+    return;
+    SOY_FOR_EACH_PL_CONSTRAINT_TYPE(SOY_DISPATCH_CASE)
+#undef SOY_DISPATCH_CASE
+    default:
+      kernel(constraint);
+  }
+}
+
+/*
+  The constraints of a query split into one homogeneous vector per type, so
+  that a hot loop can run a kernel over each vector without a virtual call
+  per constraint. The kernel is a functor with one operator() per concrete
+  class (typically a single template) and one for PLConstraint *, which
+  receives the constraints of unregistered types.
+
+  forEach() visits the constraints type by type; code that depends on the
+  original order of the constraints should use dispatchPLConstraint() over
+  the original list instead.
+*/
+class TypedPLConstraints {
+ public:
+  TypedPLConstraints() {}
+
+  explicit TypedPLConstraints(const List<PLConstraint *> &constraints) {
+    initialize(constraints);
+  }
+
+  void initialize(const List<PLConstraint *> &constraints) {
+    clear();
+    for (const auto &constraint : constraints) add(constraint);
+  }
+
+  void add(PLConstraint *constraint) {
+    Appender appender(*this);
+    dispatchPLConstraint(constraint, appender);
+  }
+
+  void clear() {
+#define SOY_CLEAR(type, Class, member) member.clear();
+    SOY_FOR_EACH_PL_CONSTRAINT_TYPE(SOY_CLEAR)
+#undef SOY_CLEAR
+    _otherConstraints.clear();
+  }
+
+  unsigned size() const {
+    unsigned size = _otherConstraints.size();
+#define SOY_ADD_SIZE(type, Class, member) size += member.size();
+    SOY_FOR_EACH_PL_CONSTRAINT_TYPE(SOY_ADD_SIZE)
+#undef SOY_ADD_SIZE
+    return size;
+  }
+
+  template <class Kernel>
+  void forEach(Kernel &kernel) const {
+#define SOY_RUN_KERNEL(type, Class, member) \
+  for (unsigned i = 0; i < member.size(); ++i) kernel(member[i]);
+    SOY_FOR_EACH_PL_CONSTRAINT_TYPE(SOY_RUN_KERNEL)
+#undef SOY_RUN_KERNEL
+    for (unsigned i = 0; i < _otherConstraints.size(); ++i)
+      kernel(_otherConstraints[i]);
+  }
+
+#define SOY_GETTER(type, Class, member) \
+  const Vector<Class *> &get##Class##s() const { return member; }
+  SOY_FOR_EACH_PL_CONSTRAINT_TYPE(SOY_GETTER)
+#undef SOY_GETTER
+
+  const Vector<PLConstraint *> &getOtherConstraints() const {
+    return _otherConstraints;
+  }
+
+ private:
+#define SOY_MEMBER(type, Class, member) Vector<Class *> member;
+  SOY_FOR_EACH_PL_CONSTRAINT_TYPE(SOY_MEMBER)
+#undef SOY_MEMBER
+
+  // Constraints of unregistered types
+  Vector<PLConstraint *> _otherConstraints;
+
+  struct Appender {
+    explicit Appender(TypedPLConstraints &target) : _target(target) {}
+
+#define SOY_APPEND(type, Class, member) \
+  void operator()(Class *constraint) { _target.member.append(constraint); }
+    SOY_FOR_EACH_PL_CONSTRAINT_TYPE(SOY_APPEND)
+#undef SOY_APPEND
+
+    void operator()(PLConstraint *constraint) {
+      _target._otherConstraints.append(constraint);
+    }
+
+    TypedPLConstraints &_target;
+  };
+};
+
+#endif  // __TypedPLConstraints_h__
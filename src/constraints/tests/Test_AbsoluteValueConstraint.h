@@ -1205,6 +1205,53 @@ class AbsoluteConstraintTestSuite : public CxxTest::TestSuite {
     delete abs;
   }
 
+  void test_in_place_case_splits() {
+    unsigned b = 1;
+    unsigned f = 4;
+    AbsoluteValueConstraint *abs = new AbsoluteValueConstraint(b, f);
+    TS_ASSERT_EQUALS(abs->getParticipatingVariableSpan().size(), 2u);
+
+    InputQuery ipq;
+    ipq.setNumberOfVariables(5);
+    TS_ASSERT_THROWS_NOTHING(abs->transformToUseAuxVariables(ipq));
+    List<unsigned> vars;
+    for (const auto &var : abs->getParticipatingVariableSpan())
+      vars.append(var);
+    TS_ASSERT_EQUALS(vars, List<unsigned>({1, 4, 5, 6}));
+    TS_ASSERT_EQUALS(vars, abs->getParticipatingVariables());
+
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    bm.initialize(7);
+    for (unsigned i = 0; i < 7; ++i) {
+      bm.setLowerBound(i, -10);
+      bm.setUpperBound(i, 10);
+    }
+    abs->initializeCDOs(&context);
+
+    context.push();
+    Vector<unsigned> tightened;
+    abs->applyCaseSplit(ABS_PHASE_NEGATIVE, bm, tightened);
+    TS_ASSERT_EQUALS(tightened, Vector<unsigned>({1, 6}));
+    TS_ASSERT_EQUALS(bm.getUpperBound(1), 0);
+    TS_ASSERT_EQUALS(bm.getUpperBound(6), 0);
+    context.pop();
+
+    context.push();
+    abs->setPhaseStatus(ABS_PHASE_POSITIVE);
+    tightened.clear();
+    abs->applyValidCaseSplit(bm, tightened);
+    TS_ASSERT_EQUALS(tightened, Vector<unsigned>({1, 5}));
+    TS_ASSERT_EQUALS(bm.getLowerBound(1), 0);
+    TS_ASSERT_EQUALS(bm.getUpperBound(5), 0);
+    context.pop();
+
+    TS_ASSERT_EQUALS(bm.getLowerBound(1), -10);
+    TS_ASSERT_EQUALS(bm.getUpperBound(5), 10);
+
+    delete abs;
+  }
+
   void test_satisfied() {
     CVC4::context::Context context;
     BoundManager bm(context);
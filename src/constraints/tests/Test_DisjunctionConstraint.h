@@ -90,6 +90,50 @@ class DisjunctionConstraintTestSuite : public CxxTest::TestSuite {
     delete cadical;
   }
 
+  void test_channeling() {
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    bm.initialize(6);
+    for (unsigned i = 0; i < 6; ++i) {
+      bm.setLowerBound(i, 0);
+      bm.setUpperBound(i, 1);
+    }
+    Set<unsigned> elements = {0, 1, 3, 5};
+    DisjunctionConstraint *disj = new DisjunctionConstraint(elements);
+    disj->initializeCDOs(&context);
+    disj->registerBoundManager(&bm);
+    CadicalWrapper *cadical = new CadicalWrapper();
+    disj->registerSatSolver(cadical);
+    disj->addBooleanStructure();
+
+    // SAT to bounds
+    cadical->addConstraint({-disj->getLiteralOfPhaseStatus(phase1)});
+    TS_ASSERT_THROWS_NOTHING(cadical->preprocess());
+    cadical->retrieveAndUpdateWatcherOfFixedBVariable();
+    TS_ASSERT_EQUALS(bm.getUpperBound(0), 0);
+    TS_ASSERT_EQUALS(bm.getUpperBound(1), 1);
+    TS_ASSERT(!disj->isFeasible(phase1));
+
+    // Bounds to SAT, at level 0
+    disj->notifyUpperBound(1, 0);
+    TS_ASSERT_THROWS_NOTHING(cadical->preprocess());
+    TS_ASSERT_EQUALS(
+        cadical->getLiteralStatus(disj->getLiteralOfPhaseStatus(phase2)),
+        FALSE);
+
+    disj->notifyLowerBound(5, 1);
+    TS_ASSERT_THROWS_NOTHING(cadical->preprocess());
+    TS_ASSERT_EQUALS(
+        cadical->getLiteralStatus(disj->getLiteralOfPhaseStatus(phase3)),
+        FALSE);
+    TS_ASSERT_EQUALS(
+        cadical->getLiteralStatus(disj->getLiteralOfPhaseStatus(phase4)),
+        TRUE);
+
+    delete disj;
+    delete cadical;
+  }
+
   void test_duplicate_constraint() {
     Set<unsigned> elements = {0, 1, 3, 5};
     DisjunctionConstraint *disj = new DisjunctionConstraint(elements);
@@ -16,6 +16,8 @@
 
 #include <cxxtest/TestSuite.h>
 
+#include <limits>
+
 #include "AssignmentManager.h"
 #include "BoundManager.h"
 #include "CadicalWrapper.h"
@@ -45,7 +47,56 @@ class IntegerConstraintTestSuite : public CxxTest::TestSuite {
     delete integer;
   }
 
-  void test_add_boolean_structure() {}
+  void test_add_boolean_structure() {
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    bm.initialize(4);
+    bm.setLowerBound(3, -1.5);
+    bm.setUpperBound(3, 2);
+    IntegerConstraint *integer = new IntegerConstraint(3);
+    integer->initializeCDOs(&context);
+    integer->registerBoundManager(&bm);
+    CadicalWrapper *cadical = new CadicalWrapper();
+    integer->registerSatSolver(cadical);
+
+    // x >= 0, x >= 1, x >= 2 over the domain [-1, 2]
+    TS_ASSERT_THROWS_NOTHING(integer->addBooleanStructure());
+    TS_ASSERT_EQUALS(cadical->getNumberOfVariables(), 3u);
+
+    // Bounds to SAT, at level 0: x >= 1 makes x >= 0 true
+    integer->notifyLowerBound(3, 0.5);
+    TS_ASSERT_THROWS_NOTHING(cadical->preprocess());
+    TS_ASSERT_EQUALS(cadical->getLiteralStatus(1), TRUE);
+    TS_ASSERT_EQUALS(cadical->getLiteralStatus(2), TRUE);
+    TS_ASSERT_EQUALS(cadical->getLiteralStatus(3), UNFIXED);
+
+    // SAT to bounds: not x >= 2
+    cadical->addConstraint({-3});
+    TS_ASSERT_THROWS_NOTHING(cadical->preprocess());
+    cadical->retrieveAndUpdateWatcherOfFixedBVariable();
+    TS_ASSERT_EQUALS(bm.getLowerBound(3), 1);
+    TS_ASSERT_EQUALS(bm.getUpperBound(3), 1);
+
+    delete integer;
+    delete cadical;
+  }
+
+  void test_add_boolean_structure_unbounded() {
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    bm.initialize(4);
+    bm.setLowerBound(3, 0);
+    IntegerConstraint *integer = new IntegerConstraint(3);
+    integer->registerBoundManager(&bm);
+    CadicalWrapper *cadical = new CadicalWrapper();
+    integer->registerSatSolver(cadical);
+
+    TS_ASSERT_THROWS_NOTHING(integer->addBooleanStructure());
+    TS_ASSERT_EQUALS(cadical->getNumberOfVariables(), 0u);
+
+    delete integer;
+    delete cadical;
+  }
 
   void test_duplicate_constraint() {
     IntegerConstraint *integer = new IntegerConstraint(3);
@@ -176,9 +227,92 @@ class IntegerConstraintTestSuite : public CxxTest::TestSuite {
     }
   }
 
+  void test_number_of_feasible_phases_of_large_domains() {
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    bm.initialize(4);
+
+    IntegerConstraint *integer = new IntegerConstraint(3);
+    integer->initializeCDOs(&context);
+    integer->registerBoundManager(&bm);
+
+    // Unbounded, and then wider than an unsigned can count
+    const unsigned saturated = std::numeric_limits<unsigned>::max();
+    TS_ASSERT_EQUALS(integer->numberOfFeasiblePhases(), saturated);
+    TS_ASSERT(!integer->phaseFixed());
+    bm.setLowerBound(3, 0);
+    TS_ASSERT_EQUALS(integer->numberOfFeasiblePhases(), saturated);
+    bm.setUpperBound(3, 1e10);
+    TS_ASSERT_EQUALS(integer->numberOfFeasiblePhases(), saturated);
+    TS_ASSERT(!integer->phaseFixed());
+    TS_ASSERT(integer->hasFeasiblePhases());
+
+    bm.setUpperBound(3, 4.5);
+    TS_ASSERT_EQUALS(integer->numberOfFeasiblePhases(), 5u);
+
+    delete integer;
+  }
+
   void test_case_splits() {
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    AssignmentManager am(bm);
+    bm.initialize(4);
+    am.initialize();
+    bm.setLowerBound(3, 0);
+    bm.setUpperBound(3, 5);
+
     IntegerConstraint *integer = new IntegerConstraint(3);
-    TS_ASSERT(!integer->supportCaseSplit());
+    TS_ASSERT(integer->supportCaseSplit());
+    integer->initializeCDOs(&context);
+    integer->registerBoundManager(&bm);
+    integer->registerAssignmentManager(&am);
+
+    List<PhaseStatus> cases = {INTEGER_PHASE_BELOW, INTEGER_PHASE_ABOVE};
+    TS_ASSERT_EQUALS(integer->getAllCases(), cases);
+
+    // x <= 2 or x >= 3
+    am.setAssignment(3, 2.4);
+    TS_ASSERT_THROWS_NOTHING(integer->prepareCaseSplit());
+    TS_ASSERT_EQUALS(integer->getSplitValue(), 2);
+
+    PiecewiseLinearCaseSplit below;
+    below.storeBoundTightening(Tightening(3, 2, Tightening::UB));
+    TS_ASSERT_EQUALS(integer->getCaseSplit(INTEGER_PHASE_BELOW), below);
+    PiecewiseLinearCaseSplit above;
+    above.storeBoundTightening(Tightening(3, 3, Tightening::LB));
+    TS_ASSERT_EQUALS(integer->getCaseSplit(INTEGER_PHASE_ABOVE), above);
+
+    context.push();
+    Vector<unsigned> tightened;
+    integer->applyCaseSplit(INTEGER_PHASE_ABOVE, bm, tightened);
+    TS_ASSERT_EQUALS(bm.getLowerBound(3), 3);
+    TS_ASSERT_EQUALS(tightened.size(), 1u);
+    TS_ASSERT_EQUALS(integer->numberOfFeasiblePhases(), 3u);
+
+    // Split the remaining domain again: x <= 4 or x >= 5, also when the
+    // assignment is out of the domain
+    am.setAssignment(3, 5);
+    TS_ASSERT_THROWS_NOTHING(integer->prepareCaseSplit());
+    TS_ASSERT_EQUALS(integer->getSplitValue(), 4);
+
+    context.push();
+    integer->markInfeasiblePhase(INTEGER_PHASE_ABOVE);
+    integer->markInfeasiblePhase(INTEGER_PHASE_ABOVE);
+    TS_ASSERT(integer->hasFeasiblePhases());
+    TS_ASSERT_EQUALS(integer->getNextFeasibleCase(), INTEGER_PHASE_BELOW);
+    integer->markInfeasiblePhase(INTEGER_PHASE_BELOW);
+    TS_ASSERT(!integer->hasFeasiblePhases());
+
+    // The first split is restored on pop
+    context.pop();
+    context.pop();
+    TS_ASSERT_EQUALS(integer->getSplitValue(), 2);
+    TS_ASSERT_EQUALS(bm.getLowerBound(3), 0);
+    integer->markInfeasiblePhase(INTEGER_PHASE_ABOVE);
+    TS_ASSERT(integer->hasFeasiblePhases());
+    TS_ASSERT_EQUALS(integer->getNextFeasibleCase(), INTEGER_PHASE_BELOW);
+
     delete integer;
   }
 
@@ -205,8 +339,55 @@ class IntegerConstraintTestSuite : public CxxTest::TestSuite {
   }
 
   void test_soi() {
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    AssignmentManager am(bm);
+    bm.initialize(4);
+    am.initialize();
+    bm.setLowerBound(3, -10);
+    bm.setUpperBound(3, 10);
+
     IntegerConstraint *integer = new IntegerConstraint(3);
-    TS_ASSERT(!integer->supportSoI());
+    TS_ASSERT(integer->supportSoI());
+    integer->initializeCDOs(&context);
+    integer->registerBoundManager(&bm);
+    integer->registerAssignmentManager(&am);
+
+    am.setAssignment(3, 2.3);
+    TS_ASSERT_EQUALS(integer->getPhaseStatusInAssignment(),
+                     INTEGER_PHASE_BELOW);
+
+    // x - 2, whose value is the distance 0.3 to 2
+    LinearExpression below;
+    integer->getCostFunctionComponent(below, INTEGER_PHASE_BELOW);
+    TS_ASSERT_EQUALS(below._addends.size(), 1u);
+    TS_ASSERT_EQUALS(below._addends[3], 1);
+    TS_ASSERT_EQUALS(below._constant, -2);
+    TS_ASSERT(FloatUtils::areEqual(below.evaluate(am.getAssignments()), 0.3));
+
+    // 3 - x, whose value is the distance 0.7 to 3
+    LinearExpression above;
+    integer->getCostFunctionComponent(above, INTEGER_PHASE_ABOVE);
+    TS_ASSERT_EQUALS(above._addends[3], -1);
+    TS_ASSERT_EQUALS(above._constant, 3);
+    TS_ASSERT(FloatUtils::areEqual(above.evaluate(am.getAssignments()), 0.7));
+
+    // The terms follow the value, also between negative integers
+    am.setAssignment(3, -4.2);
+    TS_ASSERT_EQUALS(integer->getPhaseStatusInAssignment(),
+                     INTEGER_PHASE_ABOVE);
+    LinearExpression nearer;
+    integer->getCostFunctionComponent(nearer, INTEGER_PHASE_ABOVE);
+    TS_ASSERT_EQUALS(nearer._constant, -4);
+    TS_ASSERT(FloatUtils::areEqual(nearer.evaluate(am.getAssignments()), 0.2));
+
+    // Both terms are zero at an integer
+    am.setAssignment(3, 5);
+    for (const auto &phase : integer->getAllCases()) {
+      LinearExpression cost;
+      integer->getCostFunctionComponent(cost, phase);
+      TS_ASSERT(FloatUtils::isZero(cost.evaluate(am.getAssignments())));
+    }
 
     delete integer;
   }
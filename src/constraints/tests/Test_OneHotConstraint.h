@@ -351,6 +351,46 @@ class OneHotConstraintTestSuite : public CxxTest::TestSuite {
     }
   }
 
+  void test_reset_phases() {
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    bm.initialize(6);
+    for (unsigned i = 0; i < 6; ++i) {
+      bm.setLowerBound(i, 0);
+      bm.setUpperBound(i, 1);
+    }
+    Set<unsigned> elements = {0, 1, 3, 5};
+    OneHotConstraint *oneHot = new OneHotConstraint(elements);
+    oneHot->initializeCDOs(&context);
+    oneHot->registerBoundManager(&bm);
+
+    // Fixed at level 0, which backtracking does not undo
+    oneHot->notifyLowerBound(3, 1);
+    oneHot->setActive(false);
+    TS_ASSERT(oneHot->phaseFixed());
+    TS_ASSERT(!oneHot->isFeasible(phase1));
+    TS_ASSERT_EQUALS(bm.getUpperBound(0), 0);
+
+    for (unsigned i = 0; i < 6; ++i) bm.resetBounds(i, 0, 1);
+    TS_ASSERT_THROWS_NOTHING(oneHot->resetPhases());
+
+    TS_ASSERT(oneHot->isActive());
+    TS_ASSERT_EQUALS(oneHot->numberOfFeasiblePhases(), 4u);
+    TS_ASSERT(!oneHot->phaseFixed());
+    TS_ASSERT(oneHot->isFeasible(phase1));
+    TS_ASSERT_EQUALS(bm.getUpperBound(0), 1);
+    TS_ASSERT_EQUALS(bm.getLowerBound(3), 0);
+
+    // The phases are context dependent again
+    context.push();
+    oneHot->notifyUpperBound(0, 0);
+    TS_ASSERT_EQUALS(oneHot->numberOfFeasiblePhases(), 3u);
+    context.pop();
+    TS_ASSERT_EQUALS(oneHot->numberOfFeasiblePhases(), 4u);
+
+    delete oneHot;
+  }
+
   void test_case_splits() {
     Set<unsigned> elements = {0, 1, 3, 5};
     OneHotConstraint *oneHot = new OneHotConstraint(elements);
@@ -377,6 +417,62 @@ class OneHotConstraintTestSuite : public CxxTest::TestSuite {
     delete oneHot;
   }
 
+  void test_spans_and_in_place_case_splits() {
+    Set<unsigned> elements = {0, 1, 3, 5};
+    OneHotConstraint *oneHot = new OneHotConstraint(elements);
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    bm.initialize(6);
+    for (unsigned i = 0; i < 6; ++i) {
+      bm.setLowerBound(i, 0);
+      bm.setUpperBound(i, 1);
+    }
+    oneHot->initializeCDOs(&context);
+
+    List<unsigned> vars;
+    for (const auto &var : oneHot->getParticipatingVariableSpan())
+      vars.append(var);
+    TS_ASSERT_EQUALS(vars, oneHot->getParticipatingVariables());
+
+    List<PhaseStatus> cases;
+    for (const auto &phase : oneHot->getCaseSpan()) cases.append(phase);
+    TS_ASSERT_EQUALS(cases, oneHot->getAllCases());
+
+    // Alternatives to phase2 are phase1, phase3 and phase4, in this order
+    TS_ASSERT_EQUALS(oneHot->numberOfFeasibleAlternatives(phase2), 3u);
+    TS_ASSERT_EQUALS(oneHot->getFeasibleAlternative(phase2, 1), phase3);
+    context.push();
+    oneHot->markInfeasiblePhase(phase3);
+    TS_ASSERT_EQUALS(oneHot->numberOfFeasibleAlternatives(phase2), 2u);
+    TS_ASSERT_EQUALS(oneHot->getFeasibleAlternative(phase2, 1), phase4);
+    TS_ASSERT_THROWS_ANYTHING(oneHot->getFeasibleAlternative(phase2, 2));
+    context.pop();
+
+    // Applying the split in place has the effect of the materialized split
+    context.push();
+    Vector<unsigned> tightened;
+    oneHot->applyCaseSplit(phase3, bm, tightened);
+    TS_ASSERT_EQUALS(tightened, Vector<unsigned>({0, 1, 3, 5}));
+    TS_ASSERT_EQUALS(bm.getUpperBound(0), 0);
+    TS_ASSERT_EQUALS(bm.getUpperBound(1), 0);
+    TS_ASSERT_EQUALS(bm.getLowerBound(3), 1);
+    TS_ASSERT_EQUALS(bm.getUpperBound(5), 0);
+
+    // Nothing left to tighten
+    tightened.clear();
+    oneHot->applyCaseSplit(phase3, bm, tightened);
+    TS_ASSERT(tightened.empty());
+    context.pop();
+
+    // No valid split while several phases are feasible
+    Vector<unsigned> tightenedByValidSplit;
+    oneHot->applyValidCaseSplit(bm, tightenedByValidSplit);
+    TS_ASSERT(tightenedByValidSplit.empty());
+    TS_ASSERT_EQUALS(bm.getUpperBound(0), 1);
+
+    delete oneHot;
+  }
+
   void test_satisfied() {
     CVC4::context::Context context;
     BoundManager bm(context);
@@ -480,4 +576,29 @@ class OneHotConstraintTestSuite : public CxxTest::TestSuite {
 
     delete oneHot;
   }
+
+  void test_phase_status_in_hint() {
+    Set<unsigned> elements = {0, 1, 3, 5};
+    OneHotConstraint *oneHot = new OneHotConstraint(elements);
+
+    PhaseStatus phase = phase1;
+    Map<unsigned, double> hint;
+    TS_ASSERT(!oneHot->getPhaseStatusInHint(hint, phase));
+
+    // Elements hinted to be false and other variables do not determine it
+    hint[0] = 0;
+    hint[2] = 1;
+    hint[3] = 0.4;
+    TS_ASSERT(!oneHot->getPhaseStatusInHint(hint, phase));
+
+    hint[5] = 1;
+    TS_ASSERT(oneHot->getPhaseStatusInHint(hint, phase));
+    TS_ASSERT_EQUALS(phase, phase4);
+
+    hint[1] = 1.2;
+    TS_ASSERT(oneHot->getPhaseStatusInHint(hint, phase));
+    TS_ASSERT_EQUALS(phase, phase2);
+
+    delete oneHot;
+  }
 };
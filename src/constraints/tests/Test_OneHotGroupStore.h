@@ -0,0 +1,89 @@
+/*********************                                                        */
+/*! \file Test_OneHotGroupStore.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Haoze Wu
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief [[ Add one-line brief description here ]]
+ **
+ ** [[ Add lengthier description here ]]
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include "MockErrno.h"
+#include "OneHotGroupStore.h"
+
+class OneHotGroupStoreTestSuite : public CxxTest::TestSuite {
+ public:
+  MockErrno *mockErrno;
+
+  void setUp() { TS_ASSERT(mockErrno = new MockErrno); }
+
+  void tearDown() { TS_ASSERT_THROWS_NOTHING(delete mockErrno); }
+
+  void test_add_groups() {
+    OneHotGroupStore store;
+    TS_ASSERT_EQUALS(store.getNumberOfGroups(), 0u);
+    TS_ASSERT_EQUALS(store.addGroup({3, 1, 2}), 0u);
+    TS_ASSERT_EQUALS(store.addGroup({5, 4}), 1u);
+    TS_ASSERT_EQUALS(store.getNumberOfGroups(), 2u);
+    TS_ASSERT_EQUALS(store.getGroupSize(0), 3u);
+    TS_ASSERT_EQUALS(store.getGroupSize(1), 2u);
+    // Elements are stored in phase order
+    TS_ASSERT_EQUALS(store.getElement(0, 0), 1u);
+    TS_ASSERT_EQUALS(store.getElement(0, 2), 3u);
+    TS_ASSERT_EQUALS(store.getElement(1, 0), 4u);
+
+    store.clear();
+    TS_ASSERT_EQUALS(store.getNumberOfGroups(), 0u);
+  }
+
+  void test_compute_violated_groups() {
+    OneHotGroupStore store;
+    store.addGroup({0, 1, 2});
+    store.addGroup({3, 4});
+    store.addGroup({5, 6});
+    store.addGroup({7, 8});
+
+    //                     x0 x1 x2 x3 x4   x5  x6   x7 x8
+    Vector<double> assignment{0, 1, 0, 1, 1, 0.5, 0.5, 0, 1 - 1e-9};
+    store.computeViolatedGroups(assignment);
+    TS_ASSERT(!store.isViolated(0));
+    // Two elements set to 1
+    TS_ASSERT(store.isViolated(1));
+    // Fractional values that sum to 1
+    TS_ASSERT(store.isViolated(2));
+    TS_ASSERT(!store.isViolated(3));
+    TS_ASSERT_EQUALS(store.getNumberOfViolatedGroups(), 2u);
+
+    for (unsigned group = 0; group < store.getNumberOfGroups(); ++group)
+      TS_ASSERT_EQUALS(store.groupSatisfied(group, assignment),
+                       !store.isViolated(group));
+
+    // All zeros
+    assignment[8] = 0;
+    store.computeViolatedGroups(assignment);
+    TS_ASSERT(store.isViolated(3));
+    TS_ASSERT(!store.groupSatisfied(3, assignment));
+  }
+
+  void test_many_groups() {
+    OneHotGroupStore store;
+    Vector<double> assignment;
+    for (unsigned group = 0; group < 150; ++group) {
+      store.addGroup({2 * group, 2 * group + 1});
+      assignment.append(group % 3 == 0 ? 0 : 1);
+      assignment.append(0);
+    }
+    store.computeViolatedGroups(assignment);
+    for (unsigned group = 0; group < 150; ++group)
+      TS_ASSERT_EQUALS(store.isViolated(group), group % 3 == 0);
+    TS_ASSERT_EQUALS(store.getNumberOfViolatedGroups(), 50u);
+  }
+};
@@ -32,7 +32,7 @@ AssignmentManager::AssignmentManager(const BoundManager &bm)
 
 void AssignmentManager::initialize() {
   _numberOfVariables = _boundManager.getNumberOfVariables();
-  for (unsigned i = 0; i < _numberOfVariables; ++i)
+  for (unsigned i = _assignment.size(); i < _numberOfVariables; ++i)
     _assignment.append(_boundManager.getLowerBound(i));
 }
 
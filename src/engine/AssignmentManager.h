@@ -27,6 +27,10 @@ class AssignmentManager {
  public:
   AssignmentManager(const BoundManager &bm);
 
+  /*
+    Assign its lower bound to each variable of the bound manager that does
+    not have an assignment yet, e.g., after new variables were registered.
+  */
   void initialize();
 
   void setAssignment(unsigned variable, double value);
@@ -94,6 +94,16 @@ bool BoundManager::setUpperBound(unsigned variable, double value) {
   return false;
 }
 
+void BoundManager::resetBounds(unsigned variable, double lowerBound,
+                               double upperBound) {
+  ASSERT(variable < _size);
+  ASSERT(_context.getLevel() == 0);
+  *_lowerBounds[variable] = lowerBound;
+  *_upperBounds[variable] = upperBound;
+  *_levelOfLastLowerBoundUpdate[variable] = 0;
+  *_levelOfLastUpperBoundUpdate[variable] = 0;
+}
+
 bool BoundManager::boundValid(unsigned variable) {
   ASSERT(variable < _size);
   return FloatUtils::gte(getUpperBound(variable), getLowerBound(variable));
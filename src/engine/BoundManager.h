@@ -44,6 +44,13 @@ class BoundManager {
   bool setLowerBound(unsigned variable, double value);
   bool setUpperBound(unsigned variable, double value);
 
+  /*
+    Overwrite the bounds of a variable, even if they are looser than the
+    current ones. Only valid at decision level 0, e.g., to solve the same
+    query again from new bounds.
+  */
+  void resetBounds(unsigned variable, double lowerBound, double upperBound);
+
   /*
     Returns true if the bounds for the variable is valid
   */
@@ -14,7 +14,7 @@ CadicalWrapper::CadicalWrapper(const CadicalWrapper &other)
     : _satSolver(nullptr),
       _numberOfBooleanVariables(other._numberOfBooleanVariables),
       _statistics(nullptr) {
-  _constraints = other._constraints;
+  _clauseLiterals = other._clauseLiterals;
   _assumptions = other._assumptions;
 }
 
@@ -35,16 +35,58 @@ unsigned CadicalWrapper::getFreshVariable() {
 }
 
 void CadicalWrapper::addConstraint(const List<int> &constraint) {
-  _constraints.append(constraint);
-  DEBUG({
-    String s;
-    for (const auto &lit : constraint) s += Stringf("%d ", lit);
-  });
+  for (const auto &lit : constraint) appendLiteral(lit);
+  endClause();
+}
+
+void CadicalWrapper::addClause(Span<int> clause) {
+  for (const auto &lit : clause) appendLiteral(lit);
+  endClause();
+}
+
+void CadicalWrapper::appendLiteral(int lit) {
+  ASSERT(lit != 0);
+  _clauseLiterals.append(lit);
+}
+
+void CadicalWrapper::endClause() {
+  _clauseLiterals.append(0);
 
   if (_statistics)
     _statistics->incUnsignedAttribute(Statistics::NUM_SAT_CONSTRAINTS);
 }
 
+void CadicalWrapper::addClausesToSolver() {
+  for (const auto &lit : _clauseLiterals) {
+    ASSERT(std::abs(lit) <= (int)_numberOfBooleanVariables);
+    _satSolver->add(lit);
+  }
+}
+
+void CadicalWrapper::backtrackClauses(unsigned mark) {
+  ASSERT(mark <= _clauseLiterals.size());
+  ASSERT(mark == 0 || _clauseLiterals[mark - 1] == 0);
+  while (_clauseLiterals.size() > mark) _clauseLiterals.popBack();
+}
+
+void CadicalWrapper::backtrackClauses(unsigned mark, Vector<int> &dropped) {
+  ASSERT(mark <= _clauseLiterals.size());
+  ASSERT(mark == 0 || _clauseLiterals[mark - 1] == 0);
+  for (unsigned i = mark; i < _clauseLiterals.size(); ++i)
+    dropped.append(_clauseLiterals[i]);
+  backtrackClauses(mark);
+}
+
+void CadicalWrapper::addClauses(const Vector<int> &clauses) {
+  ASSERT(clauses.empty() || clauses.last() == 0);
+  for (const auto &lit : clauses) {
+    if (lit == 0)
+      endClause();
+    else
+      appendLiteral(lit);
+  }
+}
+
 void CadicalWrapper::assumeLiteral(int lit) { _assumptions.append(lit); }
 
 void CadicalWrapper::clearAssumptions() { _assumptions.clear(); }
@@ -66,13 +108,7 @@ unsigned CadicalWrapper::directionAwareSolve() {
   if (_satSolver != nullptr) delete _satSolver;
   _satSolver = getCadicalInstance();
 
-  for (const auto &constraint : _constraints) {
-    for (const auto &lit : constraint) {
-      ASSERT(std::abs(lit) <= _numberOfBooleanVariables);
-      _satSolver->add(lit);
-    }
-    _satSolver->add(0);
-  }
+  addClausesToSolver();
 
   for (const auto &lit : _assumptions) {
     _satSolver->add(lit);
@@ -86,7 +122,7 @@ unsigned CadicalWrapper::directionAwareSolve() {
     for (const auto &l : phase) {
       _satSolver->assume(l);
     }
-    _satSolver->solve();
+    solveAndCount();
     if (_satSolver->status() == 20) {
       // Remove one from the _phase and try again
       for (const auto &l : phase) {
@@ -103,7 +139,7 @@ unsigned CadicalWrapper::directionAwareSolve() {
   } while (!phase.empty());
 
   if (infeasible())
-    _satSolver->solve();
+    solveAndCount();
   return numRejected;
 }
 
@@ -111,13 +147,7 @@ void CadicalWrapper::solve() {
   if (_satSolver != nullptr) delete _satSolver;
   _satSolver = getCadicalInstance();
 
-  for (const auto &constraint : _constraints) {
-    for (const auto &lit : constraint) {
-      ASSERT(std::abs(lit) <= _numberOfBooleanVariables);
-      _satSolver->add(lit);
-    }
-    _satSolver->add(0);
-  }
+  addClausesToSolver();
 
   for (const auto &lit : _assumptions) {
     _satSolver->add(lit);
@@ -126,6 +156,12 @@ void CadicalWrapper::solve() {
 
   for (const auto &lit : _phase) _satSolver->phase(lit);
 
+  solveAndCount();
+}
+
+void CadicalWrapper::solveAndCount() {
+  if (_statistics)
+    _statistics->incUnsignedAttribute(Statistics::NUM_SAT_SOLVER_CALLS);
   _satSolver->solve();
 }
 
@@ -133,13 +169,7 @@ void CadicalWrapper::preprocess() {
   if (_satSolver != nullptr) delete _satSolver;
   _satSolver = getCadicalInstance();
 
-  for (const auto &constraint : _constraints) {
-    for (const auto &lit : constraint) {
-      ASSERT(std::abs(lit) <= _numberOfBooleanVariables);
-      _satSolver->add(lit);
-    }
-    _satSolver->add(0);
-  }
+  addClausesToSolver();
 
   for (const auto &lit : _assumptions) {
     _satSolver->add(lit);
@@ -5,6 +5,8 @@
 #include "List.h"
 #include "MStringf.h"
 #include "Map.h"
+#include "Span.h"
+#include "Vector.h"
 #include "Watcher.h"
 #include "cadical.hpp"
 
@@ -31,10 +33,21 @@ class CadicalWrapper : public Watcher {
   // ------------------------- Methods for adding constraints ---------------//
   unsigned getFreshVariable();
   void addConstraint(const List<int> &constraint);
+  // Same as addConstraint(), for callers that keep a reusable clause buffer
+  void addClause(Span<int> clause);
   void assumeLiteral(int constraint);
   void clearAssumptions();
   bool haveAssumptions() const { return _assumptions.size() > 0; };
 
+  // The position of the next clause, to go back to with backtrackClauses()
+  unsigned getClauseMark() const { return _clauseLiterals.size(); }
+  // Drop the clauses added since the mark was taken
+  void backtrackClauses(unsigned mark);
+  // Same, appending the dropped clauses in DIMACS form to dropped
+  void backtrackClauses(unsigned mark, Vector<int> &dropped);
+  // Add clauses in DIMACS form, e.g., ones dropped by backtrackClauses()
+  void addClauses(const Vector<int> &clauses);
+
   // ----------------------- Methods for solving ----------------------------//
   void setDirection(int lit);
   void resetDirection(unsigned bVariable);
@@ -57,11 +70,19 @@ class CadicalWrapper : public Watcher {
  private:
   CaDiCaL::Solver *_satSolver;
   unsigned _numberOfBooleanVariables;
-  List<List<int>> _constraints;
+  // The clauses, back to back in DIMACS form: the literals of each clause
+  // followed by a 0. Adding a clause only appends to this buffer.
+  Vector<int> _clauseLiterals;
   List<int> _assumptions;
   List<int> _phase;
 
   Statistics *_statistics;
+
+  void appendLiteral(int lit);
+  void endClause();
+  void addClausesToSolver();
+  // Run the current solver instance, counting the call
+  void solveAndCount();
 };
 
 #endif  // __CadicalWrapper_h__
@@ -1,28 +1,49 @@
 #ifndef __Conflict_h__
 #define __Conflict_h__
 
+#include <utility>
+
 #include "Debug.h"
-#include "Map.h"
+#include "HashSet.h"
 #include "SoyError.h"
 #include "PLConstraint.h"
 #include "Vector.h"
 
-// Struct representing a Conflict, which is a map from PLConstraint to phase.
-// We require different phases of the same PLConstraint to be mutually exclusive
-// so a conflict never contains two phases of the same PLConstraint.
+// Struct representing a Conflict, which is a list of (PLConstraint, phase)
+// literals. We require different phases of the same PLConstraint to be
+// mutually exclusive so a conflict never contains two phases of the same
+// PLConstraint.
+// The SmtCore keeps a single Conflict and clears it before each analysis, so
+// the storage is reused from one conflict to the next.
+// A phase without a literal, e.g., a side of a split on an IntegerConstraint,
+// is left out, and the conflict cannot be learned as a clause then.
 struct Conflict {
-  Conflict() {}
+  typedef std::pair<PLConstraint *, PhaseStatus> Literal;
+
+  Conflict() : _learnable(true) {}
 
   void addLiteral(PLConstraint *constraint, PhaseStatus phase) {
-    if (_literals.exists(constraint))
+    if (!constraint->phaseStatusHasLiteral(phase)) {
+      _learnable = false;
+      return;
+    }
+    if (_constraints.exists(constraint))
       throw SoyError(
           SoyError::CONFLICT_HAS_PHASES_OF_SAME_PLCONSTRAINT);
-    _literals[constraint] = phase;
-    _constraints.append(constraint);
+    _literals.append(Literal(constraint, phase));
+    _constraints.insert(constraint);
+  }
+
+  void clear() {
+    _literals.clear();
+    _constraints.clear();
+    _learnable = true;
   }
 
-  Map<PLConstraint *, PhaseStatus> _literals;
-  Vector<PLConstraint *> _constraints;
+  Vector<Literal> _literals;
+  // The constraints of _literals, to reject a second phase of one of them
+  HashSet<PLConstraint *> _constraints;
+  bool _learnable;
 };
 
 #endif  // __Conflict_h__
@@ -0,0 +1,95 @@
+#include "ConstraintStateTracker.h"
+
+#include "PLConstraint.h"
+
+ConstraintStateTracker::ConstraintStateTracker(
+    CVC4::context::Context &context)
+    : _context(context),
+      _newlyFixed(&context),
+      _numberOfActiveConstraints(&context, 0) {}
+
+void ConstraintStateTracker::initialize(
+    const List<PLConstraint *> &plConstraints) {
+  ASSERT(_context.getLevel() == 0);
+  _activeConstraints.clear();
+  _positionInActiveConstraints.clear();
+  _variableToConstraints.clear();
+  for (const auto &constraint : plConstraints) {
+    ASSERT(constraint->isActive());
+    _positionInActiveConstraints[constraint] = _activeConstraints.size();
+    _activeConstraints.append(constraint);
+    for (const auto &variable : constraint->getParticipatingVariableSpan())
+      _variableToConstraints[variable].append(constraint);
+  }
+  _numberOfActiveConstraints = _activeConstraints.size();
+
+  enqueueAllFixedConstraints();
+}
+
+void ConstraintStateTracker::addConstraint(PLConstraint *constraint) {
+  ASSERT(_context.getLevel() == 0);
+  ASSERT(constraint->isActive());
+  ASSERT(!_positionInActiveConstraints.exists(constraint));
+  unsigned numberOfActive = _numberOfActiveConstraints;
+  _positionInActiveConstraints[constraint] = _activeConstraints.size();
+  _activeConstraints.append(constraint);
+  swap(numberOfActive, _activeConstraints.size() - 1);
+  _numberOfActiveConstraints = numberOfActive + 1;
+  for (const auto &variable : constraint->getParticipatingVariableSpan())
+    _variableToConstraints[variable].append(constraint);
+
+  if (constraint->phaseFixed()) _newlyFixed.enqueue(constraint);
+}
+
+void ConstraintStateTracker::notifyPhaseFixed(PLConstraint *constraint) {
+  _newlyFixed.enqueue(constraint);
+}
+
+void ConstraintStateTracker::notifyBoundTightened(unsigned variable) {
+  if (!_variableToConstraints.exists(variable)) return;
+  for (const auto &constraint : _variableToConstraints[variable])
+    if (constraint->isActive() && constraint->phaseFixed())
+      _newlyFixed.enqueue(constraint);
+}
+
+void ConstraintStateTracker::notifyActivityChanged(PLConstraint *constraint,
+                                                   bool active) {
+  if (!_positionInActiveConstraints.exists(constraint)) return;
+
+  unsigned position = _positionInActiveConstraints[constraint];
+  unsigned numberOfActive = _numberOfActiveConstraints;
+  if (active && position >= numberOfActive) {
+    // See the class comment: restoring the prefix length on backtrack is only
+    // sound if re-activation never happens above level 0.
+    ASSERT(_context.getLevel() == 0);
+    swap(position, numberOfActive);
+    _numberOfActiveConstraints = numberOfActive + 1;
+  } else if (!active && position < numberOfActive) {
+    swap(position, numberOfActive - 1);
+    _numberOfActiveConstraints = numberOfActive - 1;
+  }
+}
+
+void ConstraintStateTracker::enqueueAllFixedConstraints() {
+  for (unsigned i = 0; i < _numberOfActiveConstraints; ++i) {
+    PLConstraint *constraint = _activeConstraints[i];
+    if (constraint->phaseFixed()) _newlyFixed.enqueue(constraint);
+  }
+}
+
+PLConstraint *ConstraintStateTracker::popNewlyFixedConstraint() {
+  ASSERT(hasNewlyFixedConstraint());
+  PLConstraint *constraint = _newlyFixed.front();
+  _newlyFixed.dequeue();
+  return constraint;
+}
+
+void ConstraintStateTracker::swap(unsigned i, unsigned j) {
+  if (i == j) return;
+  PLConstraint *first = _activeConstraints[i];
+  PLConstraint *second = _activeConstraints[j];
+  _activeConstraints[i] = second;
+  _activeConstraints[j] = first;
+  _positionInActiveConstraints[second] = i;
+  _positionInActiveConstraints[first] = j;
+}
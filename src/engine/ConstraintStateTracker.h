@@ -0,0 +1,96 @@
+#ifndef __ConstraintStateTracker_h__
+#define __ConstraintStateTracker_h__
+
+#include "Debug.h"
+#include "HashMap.h"
+#include "List.h"
+#include "Vector.h"
+#include "context/cdo.h"
+#include "context/cdtrail_queue.h"
+#include "context/context.h"
+
+class PLConstraint;
+
+/*
+  Keeps track of which piecewise-linear constraints are active and which have
+  had their phase fixed since the last time the engine looked, so that the
+  main loop does not have to scan every constraint at every iteration.
+
+  Both pieces of state are context-dependent:
+
+  - Constraints whose phase becomes fixed are pushed onto a trail queue. The
+    queue (and its read head) are restored on backtrack, so a constraint fixed
+    at a popped level is forgotten together with the fixing itself.
+
+  - Active constraints are kept as a prefix of _activeConstraints whose length
+    is a CDO. Deactivation swaps the constraint to the end of the prefix and
+    shrinks it, so restoring the length on backtrack re-activates exactly the
+    constraints deactivated since. This relies on constraints only being
+    re-activated at decision level 0 (i.e., on restart).
+*/
+class ConstraintStateTracker {
+ public:
+  ConstraintStateTracker(CVC4::context::Context &context);
+
+  /*
+    Register the constraints to track. All of them must be active.
+    Constraints whose phase is already fixed are enqueued.
+  */
+  void initialize(const List<PLConstraint *> &plConstraints);
+
+  /*
+    Register one more constraint, which must be active, at decision level 0.
+    It is enqueued if its phase is already fixed.
+  */
+  void addConstraint(PLConstraint *constraint);
+
+  /*
+    Called by a constraint when its phase has become fixed.
+  */
+  void notifyPhaseFixed(PLConstraint *constraint);
+
+  /*
+    Called by the engine when the bound of a variable is tightened outside of
+    the constraints' own notification methods (e.g., when applying a split).
+    Enqueues the active constraints over that variable that are now fixed;
+    this covers constraints whose phase is a function of the bounds only.
+  */
+  void notifyBoundTightened(unsigned variable);
+
+  /*
+    Called by a constraint when it is set (in)active.
+  */
+  void notifyActivityChanged(PLConstraint *constraint, bool active);
+
+  /*
+    Enqueue every active constraint whose phase is fixed. Used after
+    constraints have been re-activated in bulk, e.g., on restart.
+  */
+  void enqueueAllFixedConstraints();
+
+  bool hasNewlyFixedConstraint() const { return !_newlyFixed.empty(); }
+  PLConstraint *popNewlyFixedConstraint();
+
+  unsigned getNumberOfActiveConstraints() const {
+    return _numberOfActiveConstraints;
+  }
+  PLConstraint *getActiveConstraint(unsigned index) const {
+    ASSERT(index < _numberOfActiveConstraints);
+    return _activeConstraints[index];
+  }
+
+ private:
+  CVC4::context::Context &_context;
+
+  CVC4::context::CDTrailQueue<PLConstraint *> _newlyFixed;
+
+  Vector<PLConstraint *> _activeConstraints;
+  HashMap<PLConstraint *, unsigned> _positionInActiveConstraints;
+  CVC4::context::CDO<unsigned> _numberOfActiveConstraints;
+
+  HashMap<unsigned, List<PLConstraint *>> _variableToConstraints;
+
+  void swap(unsigned i, unsigned j);
+};
+
+#endif  // __ConstraintStateTracker_h__
@@ -11,12 +11,20 @@
 #include "SoyError.h"
 #include "PLConstraint.h"
 #include "Preprocessor.h"
+#include "Profiler.h"
+#include "RootCutGenerator.h"
 #include "TimeUtils.h"
+#include "TraceRecorder.h"
 #include "Vector.h"
 
 Engine::Engine()
-    : _context(),
+    : _solveInitialized(false),
+      _lpEncoded(false),
+      _milpModelEncoded(false),
+      _clauseMark(0),
+      _context(),
       _boundManager(_context),
+      _constraintStateTracker(_context),
       _preprocessedQuery(nullptr),
       _smtCore(this),
       _quitRequested(false),
@@ -32,12 +40,16 @@ Engine::Engine()
       _lpBasedTightener(nullptr),
       _milpEncoder(nullptr),
       _gurobi(nullptr),
+      _milpModelEncoder(nullptr),
+      _milpModel(nullptr),
       _cadical(nullptr),
       _soiManager(nullptr),
       _assignmentManager(nullptr),
       _maxLemmaLength(Options::get()->getInt(Options::MAX_LEMMA_LENGTH)),
       _maxNumberOfProposals(Options::get()->getInt(Options::MAX_PROPOSALS_PER_STATE)),
-      _milpSolvingThreshold(
+      _rootCutRounds(Options::get()->getInt(Options::ROOT_CUT_ROUNDS)),
+      _rootCutsAdded(false),
+      _milpCheckScheduler(
           Options::get()->getFloat(Options::MILP_SOLVING_THRESHOLD)),
       _cachePhasePattern(GlobalConfiguration::CACHE_PHASE_PATTERN &&
                          Options::get()->getSoISearchStrategy() !=
@@ -50,7 +62,7 @@ Engine::Engine()
   setRandomSeed(Options::get()->getInt(Options::SEED));
 }
 
-Engine::~Engine() {}
+Engine::~Engine() { SignalHandler::getInstance()->unregisterClient(this); }
 
 void Engine::computeInitialPattern(const InputQuery &inputQuery) {
   std::cout << "computing initial pattern" << std::endl;
@@ -74,23 +86,26 @@ void Engine::computeInitialPattern(const InputQuery &inputQuery) {
             << TimeUtils::timePassed(start, end) / 1000 / 1000 << std::endl;
 }
 
-void Engine::addAllLemmasToSatSolver(){
+void Engine::addAllLemmasToSatSolver(unsigned firstConstraint){
   Vector<PLConstraint *> plConstraintsV;
   for (const auto &p : _plConstraints) plConstraintsV.append(p);
 
   // Add the top level lemmas to SAT solver
   for (unsigned i = 0; i < plConstraintsV.size(); ++i) {
     for (const auto &lemma : _lemmas) {
-      if (i + lemma.size() > plConstraintsV.size())
+      if (i + lemma.size() > plConstraintsV.size() ||
+          i + lemma.size() <= firstConstraint)
         continue;
-      List<int> clause;
+      _clauseBuffer.clear();
       unsigned j = i;
       for (const auto &phase : lemma) {
         if (plConstraintsV[j]->phaseStatusHasLiteral(phase))
-          clause.append(-plConstraintsV[j]->getLiteralOfPhaseStatus(phase));
+          _clauseBuffer.append(
+              -plConstraintsV[j]->getLiteralOfPhaseStatus(phase));
         ++j;
       }
-      if (clause.size() == lemma.size()) _cadical->addConstraint(clause);
+      if (_clauseBuffer.size() == lemma.size())
+        _cadical->addClause(_clauseBuffer);
     }
   }
 }
@@ -111,6 +126,7 @@ bool Engine::processInputQuery(InputQuery &inputQuery, bool preprocess) {
     invokePreprocessor(inputQuery, preprocess);
 
     _plConstraints = _preprocessedQuery->getPLConstraints();
+    _typedPlConstraints.initialize(_plConstraints);
     if (GlobalConfiguration::
             PL_CONSTRAINTS_ADD_AUX_EQUATIONS_AFTER_PREPROCESSING)
       for (auto &plConstraint : _plConstraints)
@@ -125,7 +141,17 @@ bool Engine::processInputQuery(InputQuery &inputQuery, bool preprocess) {
 
     _milpEncoder = std::unique_ptr<MILPEncoder>(new MILPEncoder(_boundManager));
     _milpEncoder->setStatistics(&_statistics);
+    _milpEncoder->setHullFillIn(Options::get()->getInt(Options::HULL_FILL_IN));
+    _milpEncoder->setBigMRefresh(
+        !Options::get()->getBool(Options::NO_BIG_M_REFRESH));
     _gurobi = std::unique_ptr<GurobiWrapper>(new GurobiWrapper());
+    _milpModelEncoder =
+        std::unique_ptr<MILPEncoder>(new MILPEncoder(_boundManager));
+    _milpModelEncoder->setHullFillIn(
+        Options::get()->getInt(Options::HULL_FILL_IN));
+    _milpModelEncoder->setBigMRefresh(
+        !Options::get()->getBool(Options::NO_BIG_M_REFRESH));
+    _milpModel = std::unique_ptr<GurobiWrapper>(new GurobiWrapper());
 
     _cadical = std::unique_ptr<CadicalWrapper>(new CadicalWrapper());
     _cadical->setStatistics(&_statistics);
@@ -133,7 +159,7 @@ bool Engine::processInputQuery(InputQuery &inputQuery, bool preprocess) {
     _assignmentManager = std::unique_ptr<AssignmentManager>(
         new AssignmentManager(_boundManager));
     for (const auto &plConstraint : _plConstraints)
-      for (const auto &var : plConstraint->getParticipatingVariables())
+      for (const auto &var : plConstraint->getParticipatingVariableSpan())
         _variablesParticipatingInPLConstraints.insert(var);
 
     _soiManager =
@@ -190,18 +216,12 @@ void Engine::performLPBasedBoundTightening() {
 }
 
 void Engine::informConstraintsOfInitialBounds(InputQuery &inputQuery) const {
-  for (const auto &plConstraint : inputQuery.getPLConstraints()) {
-    List<unsigned> variables = plConstraint->getParticipatingVariables();
-    for (unsigned variable : variables) {
-      plConstraint->notifyLowerBound(variable,
-                                     inputQuery.getLowerBound(variable));
-      plConstraint->notifyUpperBound(variable,
-                                     inputQuery.getUpperBound(variable));
-    }
-  }
+  InitialBoundNotifier notifier(inputQuery);
+  TypedPLConstraints(inputQuery.getPLConstraints()).forEach(notifier);
 }
 
 void Engine::invokePreprocessor(InputQuery &inputQuery, bool preprocess) {
+  PROFILE_SCOPE("preprocess");
   if (_verbosity > 0)
     printf(
         "Engine::processInputQuery: Input query (before preprocessing): "
@@ -246,7 +266,7 @@ void Engine::decideBranchingHeuristics() {
     _smtCore.initializeScoreTrackerIfNeeded(_plConstraints);
 }
 
-bool Engine::solve(unsigned timeoutInSeconds) {
+void Engine::initializeSolve() {
   SignalHandler::getInstance()->initialize();
   SignalHandler::getInstance()->registerClient(this);
 
@@ -257,11 +277,17 @@ bool Engine::solve(unsigned timeoutInSeconds) {
     plConstraint->registerAssignmentManager(&(*_assignmentManager));
     plConstraint->registerBoundManager(&_boundManager);
     plConstraint->registerSatSolver(&(*_cadical));
+    plConstraint->registerStateTracker(&_constraintStateTracker);
     plConstraint->addBooleanStructure();
     plConstraint->setStatistics(&_statistics);
   }
+  for (const auto &oneHot : _typedPlConstraints.getOneHotConstraints())
+    oneHot->registerGroupStore(&_oneHotGroupStore);
+  _constraintStateTracker.initialize(_plConstraints);
+  _milpCheckScheduler.initialize(_plConstraints.size());
 
   addAllLemmasToSatSolver();
+  _clauseMark = _cadical->getClauseMark();
 
   DEBUG({
     _cadical->solve();
@@ -275,11 +301,31 @@ bool Engine::solve(unsigned timeoutInSeconds) {
     }
   });
 
-  if (_solveWithMILP) return solveWithMILPEncoding(timeoutInSeconds);
+  _solveInitialized = true;
+}
+
+bool Engine::solve(unsigned timeoutInSeconds) {
+  if (!_solveInitialized) initializeSolve();
+
+  if (_solveWithMILP) {
+    _hint.clear();
+    return solveWithMILPEncoding(timeoutInSeconds);
+  }
 
-  ENGINE_LOG("Encoding convex relaxation into Gurobi...");
-  _milpEncoder->encodeInputQuery(*_gurobi, *_preprocessedQuery, true);
-  ENGINE_LOG("Encoding convex relaxation into Gurobi - done");
+  if (!_lpEncoded) {
+    if (!addRootCuts()) {
+      if (_verbosity > 0) {
+        printf("\nEngine::solve: unsat query\n");
+        _statistics.print();
+      }
+      _exitCode = Engine::UNSAT;
+      return false;
+    }
+    ENGINE_LOG("Encoding convex relaxation into Gurobi...");
+    _milpEncoder->encodeInputQuery(*_gurobi, *_preprocessedQuery, true);
+    _lpEncoded = true;
+    ENGINE_LOG("Encoding convex relaxation into Gurobi - done");
+  }
 
   _statistics.stampMainLoopStartTime();
 
@@ -290,6 +336,17 @@ bool Engine::solve(unsigned timeoutInSeconds) {
     printf("\n---\n");
   }
 
+  if (applyHint(timeoutInSeconds)) {
+    if (_verbosity > 0) {
+      printf("\nEngine::solve: sat assignment found by the hint\n");
+      _statistics.print();
+    }
+    checkSolutionCompliance();
+    _exitCode = Engine::SAT;
+    return true;
+  }
+
+  PROFILE_SCOPE("main_loop");
   bool splitJustPerformed = true;
   while (true) {
     if (shouldExitDueToTimeout(timeoutInSeconds)) {
@@ -362,12 +419,15 @@ bool Engine::solve(unsigned timeoutInSeconds) {
 
       // Perform any restart
       if (_smtCore.needToRestart()) {
+        PROFILE_TRACE_SCOPE("restart");
         if (_verbosity > 1) printf("Restarting...\n");
         _smtCore.restart();
         struct timespec start = TimeUtils::sampleMicro();
         _gurobi->resetModel();
         _milpEncoder->reset();
         _milpEncoder->encodeInputQuery(*_gurobi, *_preprocessedQuery, true);
+        // Encoded again at the next MILP check, under the new root bounds
+        discardMILPModel();
         struct timespec end = TimeUtils::sampleMicro();
         _statistics.incLongAttribute(
                                      Statistics::TIME_ADDING_CONSTRAINTS_TO_MILP_SOLVER_MICRO,
@@ -377,6 +437,7 @@ bool Engine::solve(unsigned timeoutInSeconds) {
           c->setActive(true);
           c->decayScores();
         }
+        _constraintStateTracker.enqueueAllFixedConstraints();
         splitJustPerformed = true;
         continue;
       }
@@ -393,6 +454,7 @@ bool Engine::solve(unsigned timeoutInSeconds) {
           }
           _assignmentManager->extractAssignmentFromGurobi(*_gurobi);
           checkSolutionCompliance();
+          recordDistanceFromHint();
           _exitCode = Engine::SAT;
           return true;
         } else {
@@ -401,7 +463,16 @@ bool Engine::solve(unsigned timeoutInSeconds) {
         }
       }
       //DEBUG(checkConsistencyBetweenParties());
-      checkFeasibilityWithGurobi();
+      if (checkFeasibilityWithGurobi()) {
+        if (_verbosity > 0) {
+          printf("\nEngine::solve: sat assignment found by the MILP check\n");
+          _statistics.print();
+        }
+        checkSolutionCompliance();
+        recordDistanceFromHint();
+        _exitCode = Engine::SAT;
+        return true;
+      }
     } catch (const InfeasibleQueryException &) {
       // The current query is unsat, and we need to pop.
       // If we're at level 0, the whole query is unsat.
@@ -432,6 +503,399 @@ double Engine::getAssignment(unsigned variable) {
   return _assignmentManager->getAssignment(variable);
 }
 
+void Engine::resetBounds(const Map<unsigned, double> &lowerBounds,
+                         const Map<unsigned, double> &upperBounds) {
+  ENGINE_LOG("Resetting bounds...");
+  for (const auto &pair : lowerBounds) {
+    _preprocessedQuery->setLowerBound(pair.first, pair.second);
+    _initialPreprocessedInputQuery.setLowerBound(pair.first, pair.second);
+  }
+  for (const auto &pair : upperBounds) {
+    _preprocessedQuery->setUpperBound(pair.first, pair.second);
+    _initialPreprocessedInputQuery.setUpperBound(pair.first, pair.second);
+  }
+
+  _exitCode = Engine::NOT_DONE;
+  // The time limit of solve() applies to each solve
+  _statistics.stampStartingTime();
+
+  if (_solveInitialized) {
+    _smtCore.reset();
+
+    // Drop the conflict clauses
+    _cadical->backtrackClauses(_clauseMark);
+    _cadical->clearAssumptions();
+    _cadical->resetAllDirections();
+  }
+
+  // Drop the theory lemmas added to the LP, and the root cuts, which were
+  // computed under the previous bounds
+  if (_solveWithMILP || _preprocessedQuery->getEquations().size() !=
+                            _initialPreprocessedInputQuery.getEquations()
+                                .size()) {
+    _preprocessedQuery->getEquations() =
+        _initialPreprocessedInputQuery.getEquations();
+    discardEncodings();
+  }
+  _rootCutsAdded = false;
+
+  for (unsigned i = 0; i < _preprocessedQuery->getNumberOfVariables(); ++i)
+    _boundManager.resetBounds(i, _preprocessedQuery->getLowerBound(i),
+                              _preprocessedQuery->getUpperBound(i));
+
+  // The encoding is redone if it holds under the old bounds only, e.g.,
+  // the hull formulations
+  if (_lpEncoded && !_milpEncoder->encodingHoldsUnderCurrentBounds())
+    discardEncodings();
+
+  if (_solveInitialized) {
+    for (const auto &plConstraint : _plConstraints)
+      plConstraint->resetPhases();
+    _constraintStateTracker.enqueueAllFixedConstraints();
+  }
+  ENGINE_LOG("Resetting bounds - done");
+}
+
+bool Engine::extendQuery(const InputQuery &extension) {
+  ENGINE_LOG("Extending the query...");
+  unsigned numberOfVariables = _preprocessedQuery->getNumberOfVariables();
+  unsigned newNumberOfVariables = extension.getNumberOfVariables();
+  if (newNumberOfVariables < numberOfVariables)
+    throw SoyError(SoyError::VARIABLE_INDEX_OUT_OF_RANGE,
+                   Stringf("Extension has %u variables, the query has %u",
+                           newNumberOfVariables, numberOfVariables)
+                       .ascii());
+
+  List<PLConstraint *> newPLConstraints;
+  for (const auto &plConstraint : extension.getPLConstraints()) {
+    for (unsigned variable : plConstraint->getParticipatingVariableSpan()) {
+      if (variable >= numberOfVariables) {
+        newPLConstraints.append(plConstraint->duplicateConstraint());
+        break;
+      }
+    }
+  }
+
+  try {
+    InitialBoundNotifier notifier(extension);
+    TypedPLConstraints(newPLConstraints).forEach(notifier);
+  } catch (const InfeasibleQueryException &) {
+    ENGINE_LOG("Extending the query done with exception");
+    for (const auto &plConstraint : newPLConstraints) delete plConstraint;
+    _exitCode = Engine::UNSAT;
+    return false;
+  }
+
+  // What was learned stays valid as long as no bound is loosened
+  bool loosened = false;
+  for (unsigned i = 0; i < numberOfVariables; ++i)
+    if (FloatUtils::lt(extension.getLowerBound(i),
+                       _preprocessedQuery->getLowerBound(i)) ||
+        FloatUtils::gt(extension.getUpperBound(i),
+                       _preprocessedQuery->getUpperBound(i)))
+      loosened = true;
+
+  _exitCode = Engine::NOT_DONE;
+  _statistics.stampStartingTime();
+
+  Vector<int> learnedClauses;
+  if (_solveInitialized) {
+    _smtCore.reset();
+
+    // Take the learned clauses out, to add the new Boolean structure before
+    // the mark
+    if (loosened)
+      _cadical->backtrackClauses(_clauseMark);
+    else
+      _cadical->backtrackClauses(_clauseMark, learnedClauses);
+    _cadical->clearAssumptions();
+    _cadical->resetAllDirections();
+
+    bool hasTheoryLemmas = _preprocessedQuery->getEquations().size() !=
+                           _initialPreprocessedInputQuery.getEquations().size();
+    if (_solveWithMILP || (loosened && hasTheoryLemmas)) {
+      _preprocessedQuery->getEquations() =
+          _initialPreprocessedInputQuery.getEquations();
+      _rootCutsAdded = false;
+      discardEncodings();
+    }
+  }
+
+  // Variables
+  _preprocessedQuery->setNumberOfVariables(newNumberOfVariables);
+  for (unsigned i = numberOfVariables; i < newNumberOfVariables; ++i) {
+    _boundManager.registerNewVariable();
+    if (extension.variableHasStep(i))
+      _preprocessedQuery->markVariableToStep(i, extension.getStepOfVariable(i));
+  }
+  for (unsigned i = 0; i < newNumberOfVariables; ++i) {
+    _preprocessedQuery->setLowerBound(i, extension.getLowerBound(i));
+    _preprocessedQuery->setUpperBound(i, extension.getUpperBound(i));
+    _boundManager.resetBounds(i, extension.getLowerBound(i),
+                              extension.getUpperBound(i));
+  }
+  _assignmentManager->initialize();
+
+  // The encoding is redone if it holds under the old bounds only, e.g.,
+  // the hull formulations. The theory lemmas were dropped above if needed.
+  if (_lpEncoded && !_milpEncoder->encodingHoldsUnderCurrentBounds())
+    discardEncodings();
+
+  // Equations. The new ones involve new variables, so they cannot be
+  // duplicates of existing ones.
+  unsigned numberOfEquations = _preprocessedQuery->getEquations().size();
+  for (const auto &equation : extension.getEquations()) {
+    for (const auto &addend : equation._addends) {
+      if (addend._variable >= numberOfVariables) {
+        _preprocessedQuery->getEquations().append(equation);
+        break;
+      }
+    }
+  }
+
+  // Constraints
+  unsigned firstNewConstraint = _plConstraints.size();
+  for (const auto &plConstraint : newPLConstraints) {
+    _preprocessedQuery->addPLConstraint(plConstraint);
+    _plConstraints.append(plConstraint);
+    _typedPlConstraints.add(plConstraint);
+    if (GlobalConfiguration::
+            PL_CONSTRAINTS_ADD_AUX_EQUATIONS_AFTER_PREPROCESSING)
+      plConstraint->addAuxiliaryEquationsAfterPreprocessing(
+          *_preprocessedQuery);
+    for (const auto &var : plConstraint->getParticipatingVariableSpan())
+      _variablesParticipatingInPLConstraints.insert(var);
+    _smtCore.addPLConstraintToScoreTracker(plConstraint);
+  }
+
+  List<Equation> newEquations;
+  unsigned index = 0;
+  for (const auto &equation : _preprocessedQuery->getEquations())
+    if (index++ >= numberOfEquations) newEquations.append(equation);
+
+  if (_solveInitialized) {
+    _initialPreprocessedInputQuery.setNumberOfVariables(newNumberOfVariables);
+    for (unsigned i = numberOfVariables; i < newNumberOfVariables; ++i)
+      if (extension.variableHasStep(i))
+        _initialPreprocessedInputQuery.markVariableToStep(
+            i, extension.getStepOfVariable(i));
+    for (unsigned i = 0; i < newNumberOfVariables; ++i) {
+      _initialPreprocessedInputQuery.setLowerBound(i,
+                                                   extension.getLowerBound(i));
+      _initialPreprocessedInputQuery.setUpperBound(i,
+                                                   extension.getUpperBound(i));
+    }
+    for (const auto &equation : newEquations)
+      _initialPreprocessedInputQuery.getEquations().append(equation);
+    for (const auto &plConstraint : newPLConstraints)
+      _initialPreprocessedInputQuery.addPLConstraint(
+          plConstraint->duplicateConstraint());
+
+    unsigned position = 0;
+    for (const auto &plConstraint : _plConstraints)
+      if (position++ < firstNewConstraint) plConstraint->resetPhases();
+
+    for (auto &plConstraint : newPLConstraints) {
+      plConstraint->initializeCDOs(&_context);
+      plConstraint->registerAssignmentManager(&(*_assignmentManager));
+      plConstraint->registerBoundManager(&_boundManager);
+      plConstraint->registerSatSolver(&(*_cadical));
+      plConstraint->registerStateTracker(&_constraintStateTracker);
+      plConstraint->addBooleanStructure();
+      plConstraint->setStatistics(&_statistics);
+      _constraintStateTracker.addConstraint(plConstraint);
+    }
+    TypedPLConstraints newTypedPlConstraints(newPLConstraints);
+    for (const auto &oneHot : newTypedPlConstraints.getOneHotConstraints())
+      oneHot->registerGroupStore(&_oneHotGroupStore);
+    _constraintStateTracker.enqueueAllFixedConstraints();
+
+    addAllLemmasToSatSolver(firstNewConstraint);
+    _clauseMark = _cadical->getClauseMark();
+    _cadical->addClauses(learnedClauses);
+
+    if (_lpEncoded)
+      _milpEncoder->encodeQueryExtension(*_gurobi, *_preprocessedQuery,
+                                         numberOfVariables, newEquations,
+                                         newPLConstraints, true);
+    if (_milpModelEncoded)
+      _milpModelEncoder->encodeQueryExtension(
+          *_milpModel, *_preprocessedQuery, numberOfVariables, newEquations,
+          newPLConstraints, false);
+    _milpCheckScheduler.setNumberOfConstraints(_plConstraints.size());
+  }
+
+  _statistics.setUnsignedAttribute(Statistics::NUM_VARIABLES,
+                                   newNumberOfVariables);
+  _statistics.setUnsignedAttribute(Statistics::NUM_EQUATIONS,
+                                   _preprocessedQuery->getEquations().size());
+  _statistics.setUnsignedAttribute(Statistics::NUM_PL_CONSTRAINTS,
+                                   _plConstraints.size());
+  ENGINE_LOG("Extending the query - done");
+  return true;
+}
+
+void Engine::setInitialPhasePattern(
+    const Map<PLConstraint *, PhaseStatus> &pattern) {
+  _soiManager->setInitialPhasePattern(pattern);
+}
+
+void Engine::getPhasePatternOfAssignment(
+    Map<PLConstraint *, PhaseStatus> &pattern) const {
+  pattern.clear();
+  for (const auto &plConstraint : _plConstraints)
+    if (plConstraint->supportSoI())
+      pattern[plConstraint] = plConstraint->getPhaseStatusInAssignment();
+}
+
+void Engine::setHint(const SolutionHint &hint) { _hint = hint; }
+
+bool Engine::applyHint(unsigned timeoutInSeconds) {
+  _hintedPhasePattern.clear();
+  _hintedAssignment = _hint.getAssignment();
+  if (_hint.empty()) return false;
+
+  computeHintedPhasePattern();
+  _hint.clear();
+  _statistics.setUnsignedAttribute(Statistics::NUM_HINTED_PHASES,
+                                   _hintedPhasePattern.size());
+  _statistics.setUnsignedAttribute(Statistics::HINT_SOLVED_QUERY, 0);
+  if (_hintedPhasePattern.empty()) return false;
+
+  if (checkHintWithGurobi(timeoutInSeconds)) {
+    _statistics.setUnsignedAttribute(Statistics::HINT_SOLVED_QUERY, 1);
+    recordDistanceFromHint();
+    return true;
+  }
+
+  seedSearchWithHint();
+  return false;
+}
+
+void Engine::computeHintedPhasePattern() {
+  Map<unsigned, Vector<PLConstraint *>> constraintsOfStep;
+  if (!_hint.getModes().empty())
+    _preprocessedQuery->getPLConstraintsOfSingleSteps(constraintsOfStep);
+  for (const auto &pair : _hint.getModes()) {
+    if (!constraintsOfStep.exists(pair.first)) continue;
+    for (const auto &plConstraint : constraintsOfStep[pair.first]) {
+      Span<PhaseStatus> cases = plConstraint->getCaseSpan();
+      if (plConstraint->supportSoI() && pair.second < cases.size())
+        _hintedPhasePattern[plConstraint] = cases[pair.second];
+    }
+  }
+
+  // Hinted values take precedence over hinted modes
+  PhaseStatus phase;
+  for (const auto &plConstraint : _plConstraints)
+    if (plConstraint->getPhaseStatusInHint(_hintedAssignment, phase))
+      _hintedPhasePattern[plConstraint] = phase;
+}
+
+bool Engine::checkHintWithGurobi(unsigned timeoutInSeconds) {
+  double timeLimit = getRemainingTime(timeoutInSeconds);
+  if (timeLimit <= 0) return false;
+
+  PROFILE_TRACE_SCOPE("hint_check");
+  ENGINE_LOG("Checking the hint with Gurobi...");
+  struct timespec start = TimeUtils::sampleMicro();
+
+  // The hinted phases are applied as bounds one level up, and undone by
+  // popping it
+  bool solved = false;
+  _context.push();
+  try {
+    for (const auto &pair : _hintedPhasePattern) {
+      _tightenedVariables.clear();
+      pair.first->applyCaseSplit(pair.second, _boundManager,
+                                 _tightenedVariables);
+    }
+    informLPSolverOfBounds();
+
+    LinearExpression dontCare;
+    _milpEncoder->encodeCostFunction(*_gurobi, dontCare);
+    _gurobi->setTimeLimit(timeLimit);
+    _gurobi->setMethod(-1);
+    _gurobi->solve();
+
+    if (_gurobi->haveFeasibleSolution()) {
+      _assignmentManager->extractAssignmentFromGurobi(*_gurobi);
+      collectViolatedPlConstraints();
+      solved = allPlConstraintsHold();
+    }
+  } catch (const InfeasibleQueryException &) {
+    // The hinted phases contradict the bounds
+  }
+  _context.pop();
+  informLPSolverOfBounds();
+
+  struct timespec end = TimeUtils::sampleMicro();
+  _statistics.incLongAttribute(Statistics::TIME_CHECKING_HINT_MICRO,
+                               TimeUtils::timePassed(start, end));
+  ENGINE_LOG(Stringf("Checking the hint with Gurobi - %s",
+                     solved ? "solved" : "not solved")
+                 .ascii());
+  return solved;
+}
+
+bool Engine::addRootCuts() {
+  if (_solveWithMILP || _rootCutRounds == 0 || _rootCutsAdded) return true;
+
+  PROFILE_SCOPE("root_cuts");
+  ENGINE_LOG("Generating root cuts...");
+  RootCutGenerator generator(_boundManager, *_preprocessedQuery);
+  generator.setStatistics(&_statistics);
+  generator.addLemmas(_lemmas);
+
+  List<Equation> cuts;
+  try {
+    generator.generateCuts(_rootCutRounds, cuts);
+  } catch (const InfeasibleQueryException &) {
+    return false;
+  }
+  for (const auto &cut : cuts) _preprocessedQuery->addEquation(cut);
+  _rootCutsAdded = true;
+
+  _statistics.setUnsignedAttribute(Statistics::NUM_EQUATIONS,
+                                   _preprocessedQuery->getEquations().size());
+  ENGINE_LOG(Stringf("Generating root cuts - %u cuts in %u rounds",
+                     cuts.size(), generator.getNumberOfRounds())
+                 .ascii());
+  return true;
+}
+
+void Engine::seedSearchWithHint() {
+  for (const auto &pair : _hintedPhasePattern) {
+    PLConstraint *plConstraint = pair.first;
+    plConstraint->updatePhaseStatusScore(
+        pair.second, GlobalConfiguration::DIRECTION_SCORE_OF_HINTED_PHASES);
+    if (plConstraint->phaseStatusHasLiteral(pair.second))
+      _cadical->setDirection(
+          plConstraint->getLiteralOfPhaseStatus(pair.second));
+  }
+  _soiManager->setInitialPhasePattern(_hintedPhasePattern);
+}
+
+void Engine::recordDistanceFromHint() {
+  if (_hintedPhasePattern.empty() && _hintedAssignment.empty()) return;
+
+  unsigned numberOfChangedPhases = 0;
+  for (const auto &pair : _hintedPhasePattern)
+    if (pair.first->getPhaseStatusInAssignment() != pair.second)
+      ++numberOfChangedPhases;
+
+  double distance = 0;
+  for (const auto &pair : _hintedAssignment)
+    if (pair.first < _preprocessedQuery->getNumberOfVariables())
+      distance +=
+          fabs(_assignmentManager->getAssignment(pair.first) - pair.second);
+
+  _statistics.setUnsignedAttribute(Statistics::NUM_HINTED_PHASES_CHANGED,
+                                   numberOfChangedPhases);
+  _statistics.setDoubleAttribute(Statistics::HINT_ASSIGNMENT_DISTANCE,
+                                 distance);
+}
+
 bool Engine::solveWithMILPEncoding(unsigned timeoutInSeconds) {
   try {
     ENGINE_LOG("Encoding the input query with Gurobi...\n");
@@ -584,6 +1048,7 @@ void Engine::informSatSolverOfDecisions() {
 }
 
 bool Engine::checkBooleanLevelFeasibility() {
+  PROFILE_TRACE_SCOPE("sat_solve");
   ENGINE_LOG("Checking Boolean level feasibility...");
   _cadical->solve();
   if (_cadical->infeasible()) {
@@ -615,6 +1080,7 @@ bool Engine::adjustAssignmentToSatisfyNonLinearConstraints() {
 }
 
 bool Engine::performDeepSoILocalSearch() {
+  PROFILE_TRACE_SCOPE("deep_soi");
   ENGINE_LOG("Performing local search...");
   struct timespec start = TimeUtils::sampleMicro();
   ASSERT(_gurobi->haveFeasibleSolution());
@@ -637,6 +1103,7 @@ bool Engine::performDeepSoILocalSearch() {
       // Always accept the first phase pattern.
       _soiManager->acceptCurrentPhasePattern();
       double costOfLastAcceptedPhasePattern = _gurobi->getObjectiveValue();
+      TRACE_COUNTER("soi_cost", costOfLastAcceptedPhasePattern);
 
       if (_cachePhasePattern)
         _soiManager->cacheCurrentPhasePattern(costOfLastAcceptedPhasePattern);
@@ -646,6 +1113,7 @@ bool Engine::performDeepSoILocalSearch() {
 
       bool solutionFound = false;
       while (!_smtCore.needToSplit()) {
+        PROFILE_SCOPE("proposal");
         if (lastProposalAccepted) {
           /*
             Check whether the optimal solution to the last accepted phase
@@ -718,6 +1186,7 @@ bool Engine::performDeepSoILocalSearch() {
               Statistics::NUM_ACCEPTED_PHASE_PATTERN_UPDATE);
           costOfLastAcceptedPhasePattern = costOfProposedPhasePattern;
           lastProposalAccepted = true;
+          TRACE_COUNTER("soi_cost", costOfLastAcceptedPhasePattern);
         } else {
           _smtCore.reportRejectedPhasePatternProposal();
           lastProposalAccepted = false;
@@ -752,6 +1221,7 @@ double Engine::computeHeuristicCost(const LinearExpression &heuristicCost) {
 
 void Engine::updatePseudoImpactWithSoICosts(
     double costOfLastAcceptedPhasePattern, double costOfProposedPhasePattern) {
+  PROFILE_SCOPE("pseudo_impact");
   struct timespec start = TimeUtils::sampleMicro();
   ASSERT(_soiManager);
 
@@ -777,22 +1247,21 @@ void Engine::updatePseudoImpactWithSoICosts(
 
 void Engine::bumpUpPseudoImpactOfPLConstraintsNotInSoI() {
   ASSERT(_soiManager);
-  for (const auto &plConstraint : _plConstraints) {
-    if (plConstraint->isActive() && !plConstraint->supportSoI() &&
-        !plConstraint->phaseFixed() && !plConstraint->satisfied())
-      _smtCore.updatePLConstraintScore(
-          plConstraint,
-          GlobalConfiguration::SCORE_BUMP_FOR_PL_CONSTRAINTS_NOT_IN_SOI);
-  }
+  NotInSoIScoreBumper bumper(_smtCore);
+  _typedPlConstraints.forEach(bumper);
 }
 
 bool Engine::checkFeasibilityWithGurobi() {
+  unsigned depth = _smtCore.getTrailLength();
+  if (_milpCheckScheduler.decideToSolveMILP(depth) &&
+      checkFeasibilityWithMILP(depth))
+    return true;
+
+  PROFILE_TRACE_SCOPE("lp_feasibility");
   ASSERT(_gurobi && _milpEncoder);
   ENGINE_LOG("Checking LP feasibility with Gurobi...");
   DEBUG({ checkGurobiBoundConsistency(); });
   struct timespec simplexStart = TimeUtils::sampleMicro();
-  bool isMILP = _smtCore.getTrailLength() > _milpSolvingThreshold * _plConstraints.size();
-  if (isMILP) _milpEncoder->enforceIntegralConstraint(*_gurobi);
 
   LinearExpression dontCare;
   _milpEncoder->encodeCostFunction(*_gurobi, dontCare);
@@ -800,33 +1269,29 @@ bool Engine::checkFeasibilityWithGurobi() {
   _gurobi->setTimeLimit(FloatUtils::infinity());
   _gurobi->setNumberOfThreads(1);
   //Use dual simplex method for feasibility because the explanation is faster
-  if (isMILP) {
-    _gurobi->setMethod(-1);
-  }
-  else {
-    _gurobi->setMethod(3);
-  }
+  _gurobi->setMethod(3);
   _gurobi->solve();
   DEBUG(_gurobi->dumpModel("lp_model.lp"));
 
   struct timespec simplexEnd = TimeUtils::sampleMicro();
+  unsigned long long timePassed =
+      TimeUtils::timePassed(simplexStart, simplexEnd);
   _statistics.incLongAttribute(Statistics::TIME_LP_FEASIBILITY_CHECK_MICRO,
-                               TimeUtils::timePassed(simplexStart, simplexEnd));
+                               timePassed);
   _statistics.incUnsignedAttribute(Statistics::NUM_LP_FEASIBILITY_CHECK);
+  _milpCheckScheduler.recordLPCheck(depth, timePassed, _gurobi->infeasible());
 
   if (_gurobi->infeasible()) {
     _statistics.incUnsignedAttribute(
         Statistics::NUM_REFUTATIONS_BY_THEORY_SOLVER);
 
     if (_cdcl && GlobalConfiguration::EXTRACT_THEORY_EXPLANATION)
-      extractTheoryExplanation(isMILP);
-    if (isMILP) _milpEncoder->relaxIntegralConstraint(*_gurobi);
+      extractTheoryExplanation(false);
     throw InfeasibleQueryException();
   } else if (_gurobi->haveFeasibleSolution()) {
-    if (isMILP) _milpEncoder->relaxIntegralConstraint(*_gurobi);
     _assignmentManager->extractAssignmentFromGurobi
       (*_gurobi, _variablesParticipatingInPLConstraints);
-    return true;
+    return false;
   } else
     throw CommonError(
         CommonError::UNEXPECTED_GUROBI_STATUS,
@@ -835,10 +1300,84 @@ bool Engine::checkFeasibilityWithGurobi() {
   return false;
 }
 
+bool Engine::checkFeasibilityWithMILP(unsigned depth) {
+  PROFILE_TRACE_SCOPE("milp_check");
+  ASSERT(_milpModel && _milpModelEncoder);
+  ENGINE_LOG("Checking MILP feasibility with Gurobi...");
+  prepareMILPModel();
+  struct timespec start = TimeUtils::sampleMicro();
+
+  _milpModel->setNodeLimit(GlobalConfiguration::MILP_CHECK_NODE_LIMIT);
+  _milpModel->setTimeLimit(_milpCheckScheduler.getMILPTimeLimit(depth));
+  _milpModel->setNumberOfThreads(1);
+  _milpModel->setMethod(-1);
+  _milpModel->solve();
+
+  bool solved = false;
+  if (_milpModel->haveFeasibleSolution()) {
+    // The MILP is exact up to the tolerances of Gurobi, check the solution
+    _assignmentManager->extractAssignmentFromGurobi(*_milpModel);
+    collectViolatedPlConstraints();
+    solved = allPlConstraintsHold();
+  }
+
+  struct timespec end = TimeUtils::sampleMicro();
+  unsigned long long timePassed = TimeUtils::timePassed(start, end);
+  _statistics.incLongAttribute(Statistics::TIME_MILP_CHECK_MICRO, timePassed);
+  _statistics.incUnsignedAttribute(Statistics::NUM_MILP_CHECKS);
+  bool decided = solved || _milpModel->infeasible();
+  _milpCheckScheduler.recordMILPCheck(depth, timePassed, decided);
+
+  if (_milpModel->infeasible()) {
+    _statistics.incUnsignedAttribute(
+        Statistics::NUM_REFUTATIONS_BY_THEORY_SOLVER);
+    // The IIS of an MILP is too expensive, the whole trail is the conflict
+    if (_cdcl && GlobalConfiguration::EXTRACT_THEORY_EXPLANATION)
+      extractTheoryExplanation(true);
+    throw InfeasibleQueryException();
+  }
+
+  if (!decided) {
+    _statistics.incUnsignedAttribute(Statistics::NUM_MILP_CHECKS_EXPIRED);
+    ENGINE_LOG("Checking MILP feasibility with Gurobi - undecided");
+  }
+  return solved;
+}
+
+void Engine::prepareMILPModel() {
+  struct timespec start = TimeUtils::sampleMicro();
+  if (_milpModelEncoded &&
+      !_milpModelEncoder->encodingHoldsUnderCurrentBounds())
+    discardMILPModel();
+  if (!_milpModelEncoded) {
+    _milpModelEncoder->encodeInputQuery(*_milpModel, *_preprocessedQuery,
+                                        false);
+    LinearExpression dontCare;
+    _milpModelEncoder->encodeCostFunction(*_milpModel, dontCare);
+    _milpModelEncoded = true;
+  }
+
+  for (unsigned i = 0; i < _preprocessedQuery->getNumberOfVariables(); ++i) {
+    String variableName = _milpModelEncoder->getVariableNameFromVariable(i);
+    _milpModel->setLowerBound(variableName, _boundManager.getLowerBound(i));
+    _milpModel->setUpperBound(variableName, _boundManager.getUpperBound(i));
+  }
+  _milpModel->updateModel();
+  _statistics.incLongAttribute(
+      Statistics::NUM_BIG_M_REFRESHES,
+      _milpModelEncoder->refreshAbsoluteValueBigMs(*_milpModel));
+  struct timespec end = TimeUtils::sampleMicro();
+  _statistics.incLongAttribute(
+      Statistics::TIME_ADDING_CONSTRAINTS_TO_MILP_SOLVER_MICRO,
+      TimeUtils::timePassed(start, end));
+}
+
 bool Engine::minimizeCostWithGurobi(const LinearExpression &costFunction) {
+  PROFILE_TRACE_SCOPE("lp_reopt");
   ASSERT(_gurobi && _milpEncoder);
   struct timespec start = TimeUtils::sampleMicro();
   ENGINE_LOG("Optimizing w.r.t. the current heuristic cost...");
+  _statistics.incUnsignedAttribute(Statistics::NUM_SOI_COST_MINIMIZATIONS);
   _milpEncoder->encodeCostFunction(*_gurobi, costFunction);
   _gurobi->setTimeLimit(FloatUtils::infinity());
   _gurobi->setMethod(2); // Use barrier method for optimization
@@ -876,10 +1415,14 @@ bool Engine::minimizeCostWithGurobi(const LinearExpression &costFunction) {
 void Engine::clearViolatedPLConstraints() { _violatedPlConstraints.clear(); }
 
 bool Engine::applyAllValidConstraintCaseSplits() {
+  PROFILE_SCOPE("valid_splits");
   struct timespec start = TimeUtils::sampleMicro();
   bool appliedSplit = false;
-  for (auto &constraint : _plConstraints)
-    if (applyValidConstraintCaseSplit(constraint)) appliedSplit = true;
+  // Applying a split may fix further constraints, which are then enqueued
+  while (_constraintStateTracker.hasNewlyFixedConstraint())
+    if (applyValidConstraintCaseSplit(
+            _constraintStateTracker.popNewlyFixedConstraint()))
+      appliedSplit = true;
 
   struct timespec end = TimeUtils::sampleMicro();
   _statistics.incLongAttribute(
@@ -898,8 +1441,9 @@ bool Engine::applyValidConstraintCaseSplit(PLConstraint *constraint) {
                    .ascii());
 
     constraint->setActive(false);
-    PiecewiseLinearCaseSplit validSplit = constraint->getValidCaseSplit();
-    applySplit(validSplit);
+    _tightenedVariables.clear();
+    constraint->applyValidCaseSplit(_boundManager, _tightenedVariables);
+    notifyTightenedVariables();
     _soiManager->removeCostComponentFromHeuristicCost(constraint);
 
     return true;
@@ -909,11 +1453,18 @@ bool Engine::applyValidConstraintCaseSplit(PLConstraint *constraint) {
 }
 
 void Engine::collectViolatedPlConstraints() {
+  PROFILE_SCOPE("collect_violated");
   _violatedPlConstraints.clear();
-  for (const auto &constraint : _plConstraints) {
-    if (constraint->isActive() && !constraint->satisfied())
-      _violatedPlConstraints.append(constraint);
-  }
+  // All one-hot groups are checked in one pass
+  _oneHotGroupStore.computeViolatedGroups(_assignmentManager->getAssignments());
+
+  ViolatedConstraintCollector collector(_oneHotGroupStore,
+                                        _violatedPlConstraints);
+  unsigned numberOfActive =
+      _constraintStateTracker.getNumberOfActiveConstraints();
+  for (unsigned i = 0; i < numberOfActive; ++i)
+    dispatchPLConstraint(_constraintStateTracker.getActiveConstraint(i),
+                         collector);
 }
 
 bool Engine::allPlConstraintsHold() const { return _violatedPlConstraints.empty(); }
@@ -926,7 +1477,21 @@ void Engine::dumpConstraintsStatus() const {
   printf("%s", s.ascii());
 }
 
+void Engine::discardEncodings() {
+  _gurobi->resetModel();
+  _milpEncoder->reset();
+  _lpEncoded = false;
+  discardMILPModel();
+}
+
+void Engine::discardMILPModel() {
+  _milpModel->resetModel();
+  _milpModelEncoder->reset();
+  _milpModelEncoded = false;
+}
+
 void Engine::informLPSolverOfBounds() {
+  PROFILE_SCOPE("inform_lp_bounds");
   struct timespec start = TimeUtils::sampleMicro();
   for (unsigned i = 0; i < _preprocessedQuery->getNumberOfVariables(); ++i) {
     String variableName = _milpEncoder->getVariableNameFromVariable(i);
@@ -934,6 +1499,9 @@ void Engine::informLPSolverOfBounds() {
     _gurobi->setUpperBound(variableName, _boundManager.getUpperBound(i));
   }
   _gurobi->updateModel();
+  _statistics.incLongAttribute(
+      Statistics::NUM_BIG_M_REFRESHES,
+      _milpEncoder->refreshAbsoluteValueBigMs(*_gurobi));
   struct timespec end = TimeUtils::sampleMicro();
   _statistics.incLongAttribute(
       Statistics::TIME_ADDING_CONSTRAINTS_TO_MILP_SOLVER_MICRO,
@@ -980,18 +1548,36 @@ void Engine::applySplit(const PiecewiseLinearCaseSplit &split) {
       ENGINE_LOG(
           Stringf("x%u: lower bound set to %.3lf", variable, bound._value)
               .ascii());
-      _boundManager.tightenLowerBound(variable, bound._value);
+      if (_boundManager.tightenLowerBound(variable, bound._value))
+        _constraintStateTracker.notifyBoundTightened(variable);
     } else {
       ENGINE_LOG(
           Stringf("x%u: upper bound set to %.3lf", variable, bound._value)
               .ascii());
-      _boundManager.tightenUpperBound(variable, bound._value);
+      if (_boundManager.tightenUpperBound(variable, bound._value))
+        _constraintStateTracker.notifyBoundTightened(variable);
     }
   }
 
   ENGINE_LOG("Done with split\n");
 }
 
+void Engine::applyCaseSplit(PLConstraint *constraint, PhaseStatus phase) {
+  ENGINE_LOG("");
+  ENGINE_LOG("Applying a case split in place. ");
+
+  _tightenedVariables.clear();
+  constraint->applyCaseSplit(phase, _boundManager, _tightenedVariables);
+  notifyTightenedVariables();
+
+  ENGINE_LOG("Done with split\n");
+}
+
+void Engine::notifyTightenedVariables() {
+  for (unsigned variable : _tightenedVariables)
+    _constraintStateTracker.notifyBoundTightened(variable);
+}
+
 PLConstraint *Engine::pickSplitPLConstraint(DivideStrategy strategy) {
   ENGINE_LOG(Stringf("Picking a split PLConstraint...").ascii());
 
@@ -1018,6 +1604,7 @@ void Engine::preContextPushHook() {}
 void Engine::postContextPopHook() {}
 
 void Engine::extractTheoryExplanation(bool naive) {
+  PROFILE_TRACE_SCOPE("theory_explanation");
   struct timespec start = TimeUtils::sampleMicro();
 
   if (_context.getLevel() == 0) return;
@@ -1030,36 +1617,45 @@ void Engine::extractTheoryExplanation(bool naive) {
     ENGINE_LOG("Extracting theory explanation...");
     _gurobi->computeIIS();
 
+    // The rows whose big-M coefficients were tightened hold under the
+    // bounds they were computed with
     Map<String, GurobiWrapper::IISBoundType> bounds;
-    List<String> dontCare;
-    List<String> names;
-    _gurobi->extractIIS(bounds, dontCare, names);
+    List<String> tightenedRows;
+    _milpEncoder->getTightenedAbsoluteValueRows(tightenedRows);
+    List<String> tightenedRowsInIIS;
+    _gurobi->extractIIS(bounds, tightenedRowsInIIS, tightenedRows);
+    _milpEncoder->explainTightenedAbsoluteValueRows(tightenedRowsInIIS,
+                                                    bounds);
     _smtCore.extractConflict(bounds, _boundManager);
   }
 
   _smtCore.incrementConflictCount();
 
-  // Add to sat solver
-  List<int> clause;
-  for (auto const &pair : _smtCore.getCurrentConflict()._literals)
-    clause.append(-pair.first->getLiteralOfPhaseStatus(pair.second));
-  _cadical->addConstraint(clause);
-
-  DEBUG(checkTheoryLemmaCorrectness());
-
-  // Add to theory solver
-  if (_smtCore.getCurrentConflict()._literals.size() <=
-      GlobalConfiguration::THEORY_LEMMA_LENGTH_THRESHOLD) {
-    Equation eq(Equation::LE);
-    for (auto const &pair : _smtCore.getCurrentConflict()._literals) {
-      OneHotConstraint *c = (OneHotConstraint *)pair.first;
-      eq.addAddend(1, c->getElementOfPhase(pair.second));
-      eq._scalar += 1;
+  // A conflict that depends on a split on an integer is only backtracked
+  if (_smtCore.getCurrentConflict()._learnable) {
+    // Add to sat solver
+    _clauseBuffer.clear();
+    for (auto const &pair : _smtCore.getCurrentConflict()._literals)
+      _clauseBuffer.append(-pair.first->getLiteralOfPhaseStatus(pair.second));
+    _cadical->addClause(_clauseBuffer);
+
+    DEBUG(checkTheoryLemmaCorrectness());
+
+    // Add to theory solver
+    if (_smtCore.getCurrentConflict()._literals.size() <=
+        GlobalConfiguration::THEORY_LEMMA_LENGTH_THRESHOLD) {
+      Equation eq(Equation::LE);
+      for (auto const &pair : _smtCore.getCurrentConflict()._literals) {
+        OneHotConstraint *c = (OneHotConstraint *)pair.first;
+        eq.addAddend(1, c->getElementOfPhase(pair.second));
+        eq._scalar += 1;
+      }
+      eq._scalar -= 1;
+      _preprocessedQuery->addEquation(eq);
+      _milpEncoder->encodeEquation(*_gurobi, eq);
+      if (_milpModelEncoded) _milpModelEncoder->encodeEquation(*_milpModel, eq);
+      _statistics.incUnsignedAttribute(Statistics::NUM_EQUATIONS);
     }
-    eq._scalar -= 1;
-    _preprocessedQuery->addEquation(eq);
-    _milpEncoder->encodeEquation(*_gurobi, eq);
-    _statistics.incUnsignedAttribute(Statistics::NUM_EQUATIONS);
   }
 
   // VSIDS
@@ -1087,14 +1683,14 @@ void Engine::extractSolution(InputQuery &inputQuery) {
 void Engine::quitSignal() { _quitRequested = true; }
 
 void Engine::mainLoopStatistics() {
+  PROFILE_SCOPE("statistics");
   struct timespec start = TimeUtils::sampleMicro();
 
-  unsigned activeConstraints = 0;
-  for (const auto &constraint : _plConstraints)
-    if (constraint->isActive()) ++activeConstraints;
-
+  unsigned numberOfActiveConstraints =
+      _constraintStateTracker.getNumberOfActiveConstraints();
   _statistics.setUnsignedAttribute(Statistics::NUM_ACTIVE_PL_CONSTRAINTS,
-                                   activeConstraints);
+                                   numberOfActiveConstraints);
+  TRACE_COUNTER("active_constraints", numberOfActiveConstraints);
 
   _statistics.incLongAttribute(Statistics::NUM_MAIN_LOOP_ITERATIONS);
 
@@ -1110,6 +1706,13 @@ bool Engine::shouldExitDueToTimeout(unsigned timeout) const {
   return _statistics.getTotalTimeInMicro() / MICROSECONDS_TO_SECONDS > timeout;
 }
 
+double Engine::getRemainingTime(unsigned timeout) const {
+  if (timeout == 0) return FloatUtils::infinity();
+
+  return timeout - (double)_statistics.getTotalTimeInMicro() /
+                       MICROSECONDS_TO_SECONDS;
+}
+
 void Engine::setVerbosity(unsigned verbosity) { _verbosity = verbosity; }
 
 void Engine::setRandomSeed(unsigned seed) { srand(seed); }
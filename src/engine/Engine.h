@@ -9,19 +9,24 @@
 #include "BoundManager.h"
 #include "CadicalWrapper.h"
 #include "Conflict.h"
+#include "ConstraintStateTracker.h"
 #include "DivideStrategy.h"
 #include "GlobalConfiguration.h"
 #include "GurobiWrapper.h"
 #include "InputQuery.h"
 #include "LinearExpression.h"
+#include "MILPCheckScheduler.h"
 #include "MILPEncoder.h"
 #include "Map.h"
+#include "OneHotGroupStore.h"
 #include "Options.h"
 #include "Preprocessor.h"
 #include "SignalHandler.h"
 #include "SmtCore.h"
 #include "SoIManager.h"
+#include "SolutionHint.h"
 #include "Statistics.h"
+#include "TypedPLConstraints.h"
 
 #ifdef _WIN32
 #undef ERROR
@@ -78,19 +83,126 @@ class Engine : public SignalHandler::Signalable {
   bool solve(unsigned timeoutInSeconds = 0);
   double getAssignment(unsigned variable);
 
+  /*
+    Return to decision level 0 with new bounds on the given variables, the
+    other variables getting back their bounds in the query, so that solve()
+    can be called again, e.g., from a new initial state. The Boolean
+    structure, the lemmas of computeInitialPattern(), the scores of the
+    branching heuristic, and the encoded LP, unless it depends on bounds
+    that were loosened (see MILPEncoder::encodingHoldsUnderCurrentBounds()),
+    are kept. What was learned under the previous
+    bounds (conflict clauses, theory lemmas, fixed phases and tightened
+    bounds) is dropped. The query must have been processed without
+    preprocessing, which bakes the bounds into the constraints.
+  */
+  void resetBounds(const Map<unsigned, double> &lowerBounds,
+                   const Map<unsigned, double> &upperBounds);
+
+  /*
+    Return to decision level 0 and add to the query the variables, and the
+    equations and piecewise-linear constraints that involve them, of a
+    larger query over the same first variables, e.g., a step-indexed model
+    over a longer horizon. All variables get their bounds in the extension.
+    The equations and constraints of the extension over the existing
+    variables only are ignored; they must be those of the query. The new
+    parts are appended to the encoded LP, unless it depends on bounds that
+    are loosened and is encoded again, and to the SAT solver, the lemmas of
+    computeInitialPattern() being applied to the new windows of constraints.
+    The conflict clauses and theory lemmas learned so far are kept, unless
+    the bounds of existing variables are loosened. Return false if the new
+    constraints are infeasible under their bounds, in which case the query
+    is left unchanged.
+  */
+  bool extendQuery(const InputQuery &extension);
+
+  /*
+    Start the local search of the next solve() from the given phase pattern,
+    see SoIManager::setInitialPhasePattern().
+  */
+  void setInitialPhasePattern(const Map<PLConstraint *, PhaseStatus> &pattern);
+
+  /*
+    The phase of each constraint in the current assignment, e.g., that of
+    the solution once solve() returned true.
+  */
+  void getPhasePatternOfAssignment(
+      Map<PLConstraint *, PhaseStatus> &pattern) const;
+
+  /*
+    Warm start the next solve() from a guess of the solution. Each
+    constraint of a step with a hinted mode takes the phase of that index,
+    and each other constraint the phase its hinted values point to, see
+    PLConstraint::getPhaseStatusInHint(). The query is first solved by one LP
+    with these phases fixed, and solve() returns right away if the LP
+    solution satisfies all constraints. Otherwise, the phases seed the local
+    search, the phases of the SAT solver and the branching directions. The
+    hint is ignored when solving with the MILP encoding.
+  */
+  void setHint(const SolutionHint &hint);
+
+  /*
+    Strengthen the relaxation with the cuts of RootCutGenerator, appended to
+    the equations of the query, unless the query has them already. Done by
+    solve() before the relaxation is encoded, or before, e.g., to copy the
+    query with its cuts to other engines. The cuts are dropped with the
+    equations when the bounds are reset. Return false if the relaxation is
+    infeasible.
+  */
+  bool addRootCuts();
+
+  /*
+    The query given to processInputQuery() holds its root cuts, e.g., copied
+    from an engine that called addRootCuts()
+  */
+  void setRootCutsAdded() { _rootCutsAdded = true; }
+
  private:
+  // Set up the constraints and the SAT solver, on the first solve()
+  void initializeSolve();
   bool solveWithMILPEncoding(unsigned timeoutInSeconds);
   void checkSolutionCompliance() const;
   void checkConsistencyBetweenParties() const;
   void checkTheoryLemmaCorrectness() const;
 
+  // Set by setHint(), consumed by the next solve()
+  SolutionHint _hint;
+  // The phases and the values of the hint of the current solve
+  Map<PLConstraint *, PhaseStatus> _hintedPhasePattern;
+  Map<unsigned, double> _hintedAssignment;
+
+  /*
+    Consume _hint. Return true if its phases solve the query, in which case
+    the assignment is the solution. The check of the phases takes at most
+    the time left of the timeout of solve(), 0 meaning no time limit.
+  */
+  bool applyHint(unsigned timeoutInSeconds);
+  void computeHintedPhasePattern();
+  bool checkHintWithGurobi(unsigned timeoutInSeconds);
+  void seedSearchWithHint();
+
+  // Record in the statistics how far the hint is from the solution
+  void recordDistanceFromHint();
+
   InputQuery _initialPreprocessedInputQuery;
 
+  bool _solveInitialized;
+  // Whether the convex relaxation is encoded in _gurobi
+  bool _lpEncoded;
+  // Whether the query is encoded in _milpModel, kept alongside _gurobi so
+  // that the MILP checks do not change the types of the variables. Encoded
+  // at the first MILP check, see prepareMILPModel().
+  bool _milpModelEncoded;
+  // The end of the clauses of the Boolean structure and the lemmas in
+  // _cadical; the clauses after it were learned under the current bounds
+  unsigned _clauseMark;
+
   /******************************* SAT related *******************************/
  private:
   void informSatSolverOfDecisions();
   bool checkBooleanLevelFeasibility();
-  void addAllLemmasToSatSolver();
+  // Add the lemmas over the windows of constraints that end at or after the
+  // firstConstraint-th constraint
+  void addAllLemmasToSatSolver(unsigned firstConstraint = 0);
 
   /******************************* SoI related *******************************/
  private:
@@ -102,7 +214,31 @@ class Engine : public SignalHandler::Signalable {
                                       double costOfProposedPhasePattern);
 
   void bumpUpPseudoImpactOfPLConstraintsNotInSoI();
+  /*
+    Check the feasibility of the current state with the LP relaxation, or
+    with the MILP when _milpCheckScheduler says so. Return true if the MILP
+    check found a solution to the query, which is then in the assignment
+    manager. Throw InfeasibleQueryException if the state is infeasible.
+  */
   bool checkFeasibilityWithGurobi();
+  /*
+    Solve the MILP within the budget given by _milpCheckScheduler. Return
+    false, for the LP check to follow, if the budget runs out before the
+    state is decided.
+  */
+  bool checkFeasibilityWithMILP(unsigned depth);
+  /*
+    Set the bounds of _milpModel to the current ones. The model is encoded
+    under the current bounds first if it is not, or if its encoding no
+    longer holds, e.g., after backtracking above the level it was made at.
+  */
+  void prepareMILPModel();
+  /*
+    Drop the encodings in _gurobi and _milpModel, for solve() and
+    prepareMILPModel() to redo them
+  */
+  void discardEncodings();
+  void discardMILPModel();
   bool minimizeCostWithGurobi(const LinearExpression &costFunction);
 
   /******************************* Constraints *******************************/
@@ -115,6 +251,62 @@ class Engine : public SignalHandler::Signalable {
   bool allPlConstraintsHold() const;
   void dumpConstraintsStatus() const;
 
+  /*
+    Kernels run over the constraints without virtual dispatch on the concrete
+    type, see TypedPLConstraints.h.
+  */
+  struct InitialBoundNotifier {
+    explicit InitialBoundNotifier(const InputQuery &inputQuery)
+        : _inputQuery(inputQuery) {}
+
+    template <class T>
+    void operator()(T *constraint) {
+      for (unsigned variable : constraint->getParticipatingVariableSpan()) {
+        constraint->notifyLowerBound(variable,
+                                     _inputQuery.getLowerBound(variable));
+        constraint->notifyUpperBound(variable,
+                                     _inputQuery.getUpperBound(variable));
+      }
+    }
+
+    const InputQuery &_inputQuery;
+  };
+
+  struct ViolatedConstraintCollector {
+    ViolatedConstraintCollector(const OneHotGroupStore &oneHotGroupStore,
+                                List<PLConstraint *> &violated)
+        : _oneHotGroupStore(oneHotGroupStore), _violated(violated) {}
+
+    template <class T>
+    void operator()(T *constraint) {
+      if (!constraint->satisfied()) _violated.append(constraint);
+    }
+
+    // One-hot groups are checked in batch beforehand
+    void operator()(OneHotConstraint *constraint) {
+      if (_oneHotGroupStore.isViolated(constraint->getGroupIndex()))
+        _violated.append(constraint);
+    }
+
+    const OneHotGroupStore &_oneHotGroupStore;
+    List<PLConstraint *> &_violated;
+  };
+
+  struct NotInSoIScoreBumper {
+    explicit NotInSoIScoreBumper(SmtCore &smtCore) : _smtCore(smtCore) {}
+
+    template <class T>
+    void operator()(T *constraint) {
+      if (constraint->isActive() && !constraint->supportSoI() &&
+          !constraint->phaseFixed() && !constraint->satisfied())
+        _smtCore.updatePLConstraintScore(
+            constraint,
+            GlobalConfiguration::SCORE_BUMP_FOR_PL_CONSTRAINTS_NOT_IN_SOI);
+    }
+
+    SmtCore &_smtCore;
+  };
+
 
   /****************************** Bounds *************************************/
  private:
@@ -125,6 +317,12 @@ class Engine : public SignalHandler::Signalable {
  public:
   virtual void applySplit(const PiecewiseLinearCaseSplit &split);
 
+  /*
+    Apply the case split of a phase of a constraint directly to the bound
+    manager, without materializing it.
+  */
+  virtual void applyCaseSplit(PLConstraint *constraint, PhaseStatus phase);
+
   virtual PLConstraint *pickSplitPLConstraint(DivideStrategy strategy);
 
   virtual void postContextPopHook();
@@ -132,6 +330,13 @@ class Engine : public SignalHandler::Signalable {
 
  private:
   void extractTheoryExplanation(bool isMILP);
+  void notifyTightenedVariables();
+
+  // Scratch buffer for the variables tightened by an in-place case split
+  Vector<unsigned> _tightenedVariables;
+
+  // Scratch buffer for the clause learned from a conflict
+  Vector<int> _clauseBuffer;
 
   /**************************** Solution *************************************/
  public:
@@ -145,6 +350,8 @@ class Engine : public SignalHandler::Signalable {
  private:
   void mainLoopStatistics();
   bool shouldExitDueToTimeout(unsigned timeout) const;
+  // The seconds left before the timeout, infinite if there is none
+  double getRemainingTime(unsigned timeout) const;
 
   /************************** Getters/Setters ********************************/
  public:
@@ -152,6 +359,7 @@ class Engine : public SignalHandler::Signalable {
   void setRandomSeed(unsigned seed);
   Context &getContext() { return _context; }
   const Statistics *getStatistics() const;
+  Statistics *getStatistics() { return &_statistics; }
   InputQuery *getInputQuery();
   SmtCore *getSmtCore();
 
@@ -162,6 +370,13 @@ class Engine : public SignalHandler::Signalable {
   BoundManager _boundManager;
   Statistics _statistics;
   List<PLConstraint *> _plConstraints;
+  // _plConstraints grouped by type
+  TypedPLConstraints _typedPlConstraints;
+  // Active constraints and constraints whose phase became fixed, maintained
+  // incrementally so that the main loop does not scan _plConstraints.
+  ConstraintStateTracker _constraintStateTracker;
+  // Flat storage of the one-hot constraints for batched satisfaction checks
+  OneHotGroupStore _oneHotGroupStore;
   List<PLConstraint *> _violatedPlConstraints;
   std::unique_ptr<InputQuery> _preprocessedQuery;
   SmtCore _smtCore;
@@ -179,13 +394,17 @@ class Engine : public SignalHandler::Signalable {
   std::unique_ptr<LPBasedTightener> _lpBasedTightener;
   std::unique_ptr<MILPEncoder> _milpEncoder;
   std::unique_ptr<GurobiWrapper> _gurobi;
+  std::unique_ptr<MILPEncoder> _milpModelEncoder;
+  std::unique_ptr<GurobiWrapper> _milpModel;
   std::unique_ptr<CadicalWrapper> _cadical;
   std::unique_ptr<SoIManager> _soiManager;
   std::unique_ptr<AssignmentManager> _assignmentManager;
 
   unsigned _maxLemmaLength;
   unsigned _maxNumberOfProposals;
-  double _milpSolvingThreshold;
+  unsigned _rootCutRounds;
+  bool _rootCutsAdded;
+  MILPCheckScheduler _milpCheckScheduler;
   bool _cachePhasePattern;
 
   // Top-level Lemmas
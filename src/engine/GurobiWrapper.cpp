@@ -18,6 +18,7 @@
 #include "GurobiWrapper.h"
 
 #include <iostream>
+#include <mutex>
 
 #include "Debug.h"
 #include "FloatUtils.h"
@@ -28,9 +29,16 @@
 
 using namespace std;
 
+namespace {
+// The environments kept by setReuseEnvironments()
+std::mutex environmentsMutex;
+bool reuseEnvironments = false;
+List<GRBEnv *> idleEnvironments;
+}  // namespace
+
 // -------------------Methods for cons/destructing models -----------------//
 GurobiWrapper::GurobiWrapper() : _environment(NULL), _model(NULL) {
-  _environment = new GRBEnv;
+  _environment = acquireEnvironment();
   resetModel();
 }
 
@@ -64,11 +72,53 @@ void GurobiWrapper::freeMemoryIfNeeded() {
   freeModelIfNeeded();
 
   if (_environment) {
-    delete _environment;
+    releaseEnvironment(_environment);
     _environment = NULL;
   }
 }
 
+void GurobiWrapper::setReuseEnvironments(bool reuse) {
+  List<GRBEnv *> environments;
+  {
+    std::lock_guard<std::mutex> lock(environmentsMutex);
+    reuseEnvironments = reuse;
+    if (!reuse) {
+      environments = idleEnvironments;
+      idleEnvironments.clear();
+    }
+  }
+  for (const auto &environment : environments) delete environment;
+}
+
+unsigned GurobiWrapper::getNumberOfIdleEnvironments() {
+  std::lock_guard<std::mutex> lock(environmentsMutex);
+  return idleEnvironments.size();
+}
+
+GRBEnv *GurobiWrapper::acquireEnvironment() {
+  {
+    std::lock_guard<std::mutex> lock(environmentsMutex);
+    if (!idleEnvironments.empty()) {
+      GRBEnv *environment = idleEnvironments.back();
+      idleEnvironments.popBack();
+      return environment;
+    }
+  }
+  // Created outside the lock, as this is the slow part
+  return new GRBEnv;
+}
+
+void GurobiWrapper::releaseEnvironment(GRBEnv *environment) {
+  {
+    std::lock_guard<std::mutex> lock(environmentsMutex);
+    if (reuseEnvironments) {
+      idleEnvironments.append(environment);
+      return;
+    }
+  }
+  delete environment;
+}
+
 // ------------------------- Methods for adding constraints ---------------//
 void GurobiWrapper::addVariable(const String &name, double lb, double ub,
                                 VariableType type) {
@@ -169,6 +219,19 @@ void GurobiWrapper::removeConstraintByName(const String &name) {
   _model->remove(_model->getConstrByName(name.ascii()));
 }
 
+void GurobiWrapper::setCoefficient(const String &constraint,
+                                   const String &variable,
+                                   double coefficient) {
+  ASSERT(_nameToVariable.exists(variable));
+  _model->chgCoeff(_model->getConstrByName(constraint.ascii()),
+                   *_nameToVariable[variable], coefficient);
+}
+
+void GurobiWrapper::setRightHandSide(const String &constraint,
+                                     double scalar) {
+  _model->getConstrByName(constraint.ascii()).set(GRB_DoubleAttr_RHS, scalar);
+}
+
 void GurobiWrapper::setCost(const List<Term> &terms, double constant) {
   try {
     GRBLinExpr cost;
@@ -37,10 +37,24 @@ class GurobiWrapper {
   void resetModel();
   void resetToUnsolvedState();
 
+  /*
+    Keep the environments of destroyed wrappers and hand them to the next
+    ones, instead of creating an environment, which checks the license, per
+    wrapper, e.g., in a long-running server. An environment is used by one
+    wrapper at a time. Turning it off frees the kept environments.
+  */
+  static void setReuseEnvironments(bool reuse);
+
+  // The environments kept for reuse
+  static unsigned getNumberOfIdleEnvironments();
+
  private:
   void freeModelIfNeeded();
   void freeMemoryIfNeeded();
 
+  static GRBEnv *acquireEnvironment();
+  static void releaseEnvironment(GRBEnv *environment);
+
   // ------------------------- Methods for adding constraints ---------------//
  public:
   void addVariable(const String &name, double lb, double ub,
@@ -60,6 +74,10 @@ class GurobiWrapper {
   void addConstraint(const List<Term> &terms, double scalar, char sense,
                      String name = "");
   void removeConstraintByName(const String &name);
+  // Change a named constraint, which must have been added by updateModel()
+  void setCoefficient(const String &constraint, const String &variable,
+                      double coefficient);
+  void setRightHandSide(const String &constraint, double scalar);
   void setCost(const List<Term> &terms, double constant = 0);
   void setObjective(const List<Term> &terms, double constant = 0);
   void updateModel();
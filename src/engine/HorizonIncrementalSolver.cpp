@@ -0,0 +1,226 @@
+/*********************                                                        */
+/*! \file HorizonIncrementalSolver.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#include "HorizonIncrementalSolver.h"
+
+#include "DisjunctionConstraint.h"
+#include "InputQuery.h"
+#include "IntegerConstraint.h"
+#include "MStringf.h"
+#include "OneHotConstraint.h"
+#include "Options.h"
+#include "PLConstraint.h"
+#include "SoyError.h"
+#include "TimeUtils.h"
+
+/*
+  The name of each variable of the query. Throws if a variable has none.
+*/
+static void getNamesOfVariables(const InputQuery &inputQuery,
+                                const Map<String, unsigned> &variableNames,
+                                Vector<String> &names) {
+  Set<unsigned> named;
+  names = Vector<String>(inputQuery.getNumberOfVariables());
+  for (const auto &pair : variableNames) {
+    if (pair.second >= inputQuery.getNumberOfVariables()) continue;
+    names[pair.second] = pair.first;
+    named.insert(pair.second);
+  }
+
+  for (unsigned i = 0; i < inputQuery.getNumberOfVariables(); ++i)
+    if (!named.exists(i))
+      throw SoyError(SoyError::UNNAMED_VARIABLE_IN_INCREMENTAL_QUERY,
+                     Stringf("x%u has no name", i).ascii());
+}
+
+HorizonIncrementalSolver::HorizonIncrementalSolver()
+    : _verbosity(Options::get()->getInt(Options::VERBOSITY)) {}
+
+Engine::ExitCode HorizonIncrementalSolver::solve(
+    InputQuery &inputQuery, const Map<String, unsigned> &variableNames,
+    unsigned timeoutInSeconds) {
+  struct timespec start = TimeUtils::sampleMicro();
+
+  bool extended = _engine != nullptr;
+  bool processed = extended ? extendQuery(inputQuery, variableNames)
+                            : processFirstQuery(inputQuery, variableNames);
+
+  Engine::ExitCode exitCode = Engine::UNSAT;
+  if (processed) {
+    _engine->solve(timeoutInSeconds);
+    exitCode = _engine->getExitCode();
+  }
+
+  struct timespec end = TimeUtils::sampleMicro();
+  _solveTimesMicro.append(TimeUtils::timePassed(start, end));
+
+  if (_verbosity > 0)
+    printf("HorizonIncrementalSolver: solve %u (%s): %s in %.3f ms\n",
+           _solveTimesMicro.size(), extended ? "extended" : "processed",
+           exitCode == Engine::SAT     ? "sat"
+           : exitCode == Engine::UNSAT ? "unsat"
+                                       : "unknown",
+           _solveTimesMicro.last() / 1000.0);
+  return exitCode;
+}
+
+bool HorizonIncrementalSolver::processFirstQuery(
+    InputQuery &inputQuery, const Map<String, unsigned> &variableNames) {
+  Vector<String> names;
+  getNamesOfVariables(inputQuery, variableNames, names);
+
+  _engine = std::unique_ptr<Engine>(new Engine());
+  if (!_engine->processInputQuery(inputQuery, false)) {
+    _engine = nullptr;
+    return false;
+  }
+
+  _variableOfName.clear();
+  for (unsigned i = 0; i < names.size(); ++i) _variableOfName[names[i]] = i;
+  return true;
+}
+
+bool HorizonIncrementalSolver::extendQuery(
+    const InputQuery &inputQuery, const Map<String, unsigned> &variableNames) {
+  InputQuery extension;
+  Map<String, unsigned> variableOfName;
+  translateQuery(inputQuery, variableNames, extension, variableOfName);
+
+  // The phases in the last assignment of the previous solve, and the
+  // constraints of its last step
+  Map<PLConstraint *, PhaseStatus> pattern;
+  _engine->getPhasePatternOfAssignment(pattern);
+  Map<unsigned, Vector<PLConstraint *>> constraintsOfStep;
+  _engine->getInputQuery()->getPLConstraintsOfSingleSteps(constraintsOfStep);
+  bool hasSteps = !constraintsOfStep.empty();
+  unsigned lastStep = 0;
+  Vector<PLConstraint *> constraintsOfLastStep;
+  if (hasSteps) {
+    lastStep = constraintsOfStep.rbegin()->first;
+    constraintsOfLastStep = constraintsOfStep[lastStep];
+  }
+
+  if (!_engine->extendQuery(extension)) return false;
+  _variableOfName = variableOfName;
+
+  if (hasSteps) {
+    _engine->getInputQuery()->getPLConstraintsOfSingleSteps(constraintsOfStep);
+    for (const auto &pair : constraintsOfStep) {
+      if (pair.first <= lastStep) continue;
+      const Vector<PLConstraint *> &constraints = pair.second;
+      for (unsigned i = 0;
+           i < constraints.size() && i < constraintsOfLastStep.size(); ++i)
+        if (pattern.exists(constraintsOfLastStep[i]))
+          pattern[constraints[i]] = pattern[constraintsOfLastStep[i]];
+    }
+  }
+  _engine->setInitialPhasePattern(pattern);
+  return true;
+}
+
+void HorizonIncrementalSolver::translateQuery(
+    const InputQuery &inputQuery, const Map<String, unsigned> &variableNames,
+    InputQuery &extension, Map<String, unsigned> &variableOfName) const {
+  Vector<String> names;
+  getNamesOfVariables(inputQuery, variableNames, names);
+
+  const InputQuery &query = *_engine->getInputQuery();
+  unsigned numberOfVariables = query.getNumberOfVariables();
+
+  // Number the new variables after the existing ones, in their order in the
+  // query
+  variableOfName = _variableOfName;
+  Vector<unsigned> variableMap(inputQuery.getNumberOfVariables());
+  unsigned next = numberOfVariables;
+  for (unsigned i = 0; i < inputQuery.getNumberOfVariables(); ++i) {
+    if (!variableOfName.exists(names[i])) variableOfName[names[i]] = next++;
+    variableMap[i] = variableOfName[names[i]];
+  }
+
+  // Existing variables missing from the query keep their bounds
+  extension.setNumberOfVariables(next);
+  for (unsigned i = 0; i < numberOfVariables; ++i) {
+    extension.setLowerBound(i, query.getLowerBound(i));
+    extension.setUpperBound(i, query.getUpperBound(i));
+  }
+  for (unsigned i = 0; i < inputQuery.getNumberOfVariables(); ++i) {
+    extension.setLowerBound(variableMap[i], inputQuery.getLowerBound(i));
+    extension.setUpperBound(variableMap[i], inputQuery.getUpperBound(i));
+    if (inputQuery.variableHasStep(i))
+      extension.markVariableToStep(variableMap[i],
+                                   inputQuery.getStepOfVariable(i));
+  }
+
+  // The query has no duplicate equations, and the new ones cannot equal
+  // existing ones: skip the check of addEquation()
+  for (const auto &equation : inputQuery.getEquations()) {
+    Equation translated(equation._type);
+    translated.setScalar(equation._scalar);
+    bool isNew = false;
+    for (const auto &addend : equation._addends) {
+      unsigned variable = variableMap[addend._variable];
+      translated.addAddend(addend._coefficient, variable);
+      if (variable >= numberOfVariables) isNew = true;
+    }
+    if (isNew) extension.getEquations().append(translated);
+  }
+
+  for (const auto &plConstraint : inputQuery.getPLConstraints()) {
+    for (unsigned variable : plConstraint->getParticipatingVariableSpan()) {
+      if (variableMap[variable] >= numberOfVariables) {
+        extension.addPLConstraint(
+            translateConstraint(plConstraint, variableMap));
+        break;
+      }
+    }
+  }
+}
+
+PLConstraint *HorizonIncrementalSolver::translateConstraint(
+    const PLConstraint *plConstraint, const Vector<unsigned> &variableMap) {
+  Set<unsigned> variables;
+  for (unsigned variable : plConstraint->getParticipatingVariableSpan())
+    variables.insert(variableMap[variable]);
+
+  switch (plConstraint->getType()) {
+    case PiecewiseLinearFunctionType::ONE_HOT:
+      return new OneHotConstraint(variables);
+    case PiecewiseLinearFunctionType::DISJUNCT:
+      return new DisjunctionConstraint(variables);
+    case PiecewiseLinearFunctionType::INTEGER:
+      return new IntegerConstraint(*variables.begin());
+    default:
+      throw SoyError(SoyError::UNSUPPORTED_PIECEWISE_LINEAR_CONSTRAINT,
+                     "Only one-hot, disjunction and integer constraints can "
+                     "be added incrementally");
+  }
+}
+
+double HorizonIncrementalSolver::getAssignment(const String &name) {
+  return _engine->getAssignment(_variableOfName[name]);
+}
+
+unsigned long long HorizonIncrementalSolver::getLastSolveTimeMicro() const {
+  return _solveTimesMicro.empty() ? 0 : _solveTimesMicro.last();
+}
+
+void HorizonIncrementalSolver::printStatistics() const {
+  unsigned long long total = 0;
+  unsigned long long maximum = 0;
+  for (const auto &time : _solveTimesMicro) {
+    total += time;
+    if (time > maximum) maximum = time;
+  }
+
+  printf("HorizonIncrementalSolver: %u solves\n", _solveTimesMicro.size());
+  if (!_solveTimesMicro.empty())
+    printf("\tTime: total %.3f ms, max %.3f ms\n", total / 1000.0,
+           maximum / 1000.0);
+}
@@ -0,0 +1,119 @@
+/*********************                                                        */
+/*! \file HorizonIncrementalSolver.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Solves a sequence of step-indexed queries over growing horizons, e.g., a
+ ** bounded reachability query unrolled for more and more steps until it is
+ ** satisfiable, with a single engine. Each query is matched to the previous
+ ** ones by variable name, since a model over a longer horizon need not number
+ ** the variables of the shorter one the same way, and only what it adds is
+ ** added to the engine, see Engine::extendQuery():
+ **
+ **   - the first query is processed, and its LP encoded, as usual,
+ **   - the variables, equations and constraints of the new steps are appended
+ **     to the engine, its LP and its SAT solver,
+ **   - the Boolean structure and the lemmas of the earlier steps stay in the
+ **     SAT solver, with the conflict clauses unless the bounds of earlier
+ **     variables were loosened (e.g., those of the previous final state),
+ **   - the scores of the pseudo-impact branching heuristic carry over, and
+ **   - the local search starts from the phase pattern of the last assignment
+ **     of the previous solve, each constraint of a new step taking the phase
+ **     of the constraint at the same position of the last earlier step.
+ **
+ ** The queries are processed without preprocessing, which would bake the
+ ** bounds of the final state of the first horizon into the constraints.
+ **/
+
+#ifndef __HorizonIncrementalSolver_h__
+#define __HorizonIncrementalSolver_h__
+
+#include <memory>
+
+#include "Engine.h"
+#include "MString.h"
+#include "Map.h"
+#include "Vector.h"
+
+class InputQuery;
+class PLConstraint;
+
+class HorizonIncrementalSolver {
+ public:
+  HorizonIncrementalSolver();
+
+  /*
+    Solve the query, whose variables are named as given, e.g., by
+    MpsParser::getVariableNameToVariableIndex(). The variables of the
+    previous queries are matched by name; the other variables, and the
+    equations and constraints that involve them, are added to the engine.
+    The equations and constraints over previous variables only must be those
+    of the previous queries. Throws a SoyError if a variable has no name.
+  */
+  Engine::ExitCode solve(InputQuery &inputQuery,
+                         const Map<String, unsigned> &variableNames,
+                         unsigned timeoutInSeconds = 0);
+
+  // The assignment of a variable of the last query, by name
+  double getAssignment(const String &name);
+
+  unsigned getNumberOfSolves() const { return _solveTimesMicro.size(); }
+
+  // The wall time of each call to solve(), in order
+  const Vector<unsigned long long> &getSolveTimesMicro() const {
+    return _solveTimesMicro;
+  }
+
+  unsigned long long getLastSolveTimeMicro() const;
+
+  // The number of solves, and the total and maximal time
+  void printStatistics() const;
+
+  // NULL before the first solve()
+  Engine *getEngine() { return _engine.get(); }
+
+ private:
+  // Replaced if a query is found infeasible while processing it
+  std::unique_ptr<Engine> _engine;
+  unsigned _verbosity;
+
+  // The variables of the engine, by name
+  Map<String, unsigned> _variableOfName;
+
+  Vector<unsigned long long> _solveTimesMicro;
+
+  /*
+    Process the query into a new engine. Return false if it is infeasible.
+  */
+  bool processFirstQuery(InputQuery &inputQuery,
+                         const Map<String, unsigned> &variableNames);
+
+  /*
+    Add the query to the engine, seeding the local search. Return false if
+    its new constraints are infeasible, in which case the engine is left
+    unchanged.
+  */
+  bool extendQuery(const InputQuery &inputQuery,
+                   const Map<String, unsigned> &variableNames);
+
+  /*
+    Build the extension of the engine's query by the given query: all the
+    variables, renumbered into the engine's numbering, and the equations and
+    constraints that involve new variables. The name map of the extension is
+    returned in variableOfName.
+  */
+  void translateQuery(const InputQuery &inputQuery,
+                      const Map<String, unsigned> &variableNames,
+                      InputQuery &extension,
+                      Map<String, unsigned> &variableOfName) const;
+
+  // A copy of the constraint over the renumbered variables
+  static PLConstraint *translateConstraint(
+      const PLConstraint *plConstraint, const Vector<unsigned> &variableMap);
+};
+
+#endif  // __HorizonIncrementalSolver_h__
@@ -108,6 +108,10 @@ void InputQuery::markVariableToStep(unsigned variable, unsigned step) {
   _variableToStep[variable] = step;
 }
 
+bool InputQuery::variableHasStep(unsigned variable) const {
+  return _variableToStep.exists(variable);
+}
+
 unsigned InputQuery::getStepOfVariable(unsigned variable) const {
   return _variableToStep[variable];
 }
@@ -119,10 +123,25 @@ Set<unsigned> InputQuery::getVariablesOfStep(unsigned step) const {
     return Set<unsigned>();
 }
 
+void InputQuery::getPLConstraintsOfSingleSteps(
+    Map<unsigned, Vector<PLConstraint *>> &constraintsOfStep) const {
+  constraintsOfStep.clear();
+  for (const auto &plConstraint : _plConstraints) {
+    bool hasSteps = true;
+    for (unsigned variable : plConstraint->getParticipatingVariableSpan())
+      if (!variableHasStep(variable)) hasSteps = false;
+    if (!hasSteps) continue;
+
+    List<unsigned> steps = getStepsOfPLConstraint(plConstraint);
+    if (steps.size() == 1)
+      constraintsOfStep[*steps.begin()].append(plConstraint);
+  }
+}
+
 List<unsigned> InputQuery::getStepsOfPLConstraint(
     const PLConstraint *constraint) const {
   Set<unsigned> steps;
-  for (const auto &var : constraint->getParticipatingVariables())
+  for (const auto &var : constraint->getParticipatingVariableSpan())
     steps.insert(getStepOfVariable(var));
   List<unsigned> stepsList;
   for (const auto &step : steps) stepsList.append(step);
@@ -162,10 +181,9 @@ bool InputQuery::equationBelongsToStep(const Equation &equation,
 
 bool InputQuery::constraintBelongsToStep(const PLConstraint *constraint,
                                          const List<unsigned> &steps) const {
-  const auto &vars = constraint->getParticipatingVariables();
   for (const auto &step : steps)
     for (const auto &var : getVariablesOfStep(step))
-      if (vars.exists(var)) return true;
+      if (constraint->participatingVariable(var)) return true;
   return false;
 }
 
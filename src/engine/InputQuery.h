@@ -8,6 +8,7 @@
 #include "MString.h"
 #include "Map.h"
 #include "PLConstraint.h"
+#include "Vector.h"
 
 class InputQuery {
  public:
@@ -49,9 +50,14 @@ class InputQuery {
   List<PLConstraint *> &getPLConstraints();
 
   void markVariableToStep(unsigned variable, unsigned step);
+  bool variableHasStep(unsigned variable) const;
   unsigned getStepOfVariable(unsigned variable) const;
   Set<unsigned> getVariablesOfStep(unsigned step) const;
   List<unsigned> getStepsOfPLConstraint(const PLConstraint *constraint) const;
+  // The constraints whose variables all belong to the same step, by step, in
+  // the order of the query
+  void getPLConstraintsOfSingleSteps(
+      Map<unsigned, Vector<PLConstraint *>> &constraintsOfStep) const;
 
   /*
     Methods for setting and getting the solution.
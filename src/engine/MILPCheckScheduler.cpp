@@ -0,0 +1,108 @@
+/*********************                                                        */
+/*! \file MILPCheckScheduler.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** [[ Add lengthier description here ]]
+ **/
+
+#include "MILPCheckScheduler.h"
+
+#include "Debug.h"
+#include "GlobalConfiguration.h"
+
+MILPCheckScheduler::MILPCheckScheduler(double threshold)
+    : _threshold(threshold), _numberOfConstraints(0) {
+  initialize(0);
+}
+
+void MILPCheckScheduler::initialize(unsigned numberOfConstraints) {
+  _numberOfConstraints = numberOfConstraints;
+  unsigned numberOfBuckets = GlobalConfiguration::MILP_CHECK_DEPTH_BUCKETS;
+  _lpRecords.assign(numberOfBuckets, Record());
+  _milpRecords.assign(numberOfBuckets, Record());
+  _numberOfDecisions.assign(numberOfBuckets, 0);
+  _lpRecord = Record();
+  _milpRecord = Record();
+}
+
+bool MILPCheckScheduler::decideToSolveMILP(unsigned depth) {
+  unsigned bucket = getBucket(depth);
+  unsigned decision = _numberOfDecisions[bucket]++;
+
+  const Record *lp = getRecord(_lpRecords, _lpRecord, bucket);
+  const Record *milp = getRecord(_milpRecords, _milpRecord, bucket);
+  bool solveMILP;
+  if (lp && milp)
+    solveMILP = getRate(*milp) > getRate(*lp);
+  else
+    solveMILP = depth > _threshold * _numberOfConstraints;
+
+  // Explore the other check now and then
+  unsigned period = GlobalConfiguration::MILP_CHECK_EXPLORATION_PERIOD;
+  if (period > 0 && decision % period == period - 1) solveMILP = !solveMILP;
+  return solveMILP;
+}
+
+double MILPCheckScheduler::getMILPTimeLimit(unsigned depth) const {
+  double limit = GlobalConfiguration::MILP_CHECK_MIN_TIME_LIMIT;
+  const Record *lp = getRecord(_lpRecords, _lpRecord, getBucket(depth));
+  if (lp) {
+    double lpTime = (double)lp->_timeMicro / lp->_checks / 1000000;
+    double scaled = lpTime * GlobalConfiguration::MILP_CHECK_TIME_LIMIT_FACTOR;
+    if (scaled > limit) limit = scaled;
+  }
+  if (limit > GlobalConfiguration::MILP_CHECK_MAX_TIME_LIMIT)
+    limit = GlobalConfiguration::MILP_CHECK_MAX_TIME_LIMIT;
+  return limit;
+}
+
+void MILPCheckScheduler::recordLPCheck(unsigned depth,
+                                       unsigned long long timeMicro,
+                                       bool decided) {
+  for (Record *record : {&_lpRecords[getBucket(depth)], &_lpRecord}) {
+    ++record->_checks;
+    record->_decided += decided;
+    record->_timeMicro += timeMicro;
+  }
+}
+
+void MILPCheckScheduler::recordMILPCheck(unsigned depth,
+                                         unsigned long long timeMicro,
+                                         bool decided) {
+  for (Record *record : {&_milpRecords[getBucket(depth)], &_milpRecord}) {
+    ++record->_checks;
+    record->_decided += decided;
+    record->_timeMicro += timeMicro;
+  }
+}
+
+unsigned MILPCheckScheduler::getBucket(unsigned depth) const {
+  unsigned numberOfBuckets = GlobalConfiguration::MILP_CHECK_DEPTH_BUCKETS;
+  if (_numberOfConstraints == 0) return numberOfBuckets - 1;
+  unsigned long long bucket =
+      (unsigned long long)depth * numberOfBuckets / _numberOfConstraints;
+  return bucket < numberOfBuckets ? bucket : numberOfBuckets - 1;
+}
+
+const MILPCheckScheduler::Record *MILPCheckScheduler::getRecord(
+    const Vector<Record> &records, const Record &total,
+    unsigned bucket) const {
+  unsigned minimum = GlobalConfiguration::MILP_CHECK_MIN_SAMPLES;
+  if (records[bucket]._checks >= minimum) return &records[bucket];
+  if (total._checks >= minimum) return &total;
+  return NULL;
+}
+
+double MILPCheckScheduler::getRate(const Record &record) {
+  ASSERT(record._checks > 0);
+  double probability = (record._decided + 1.0) / (record._checks + 2.0);
+  // At least a microsecond per check
+  double time = (double)record._timeMicro / record._checks;
+  if (time < 1) time = 1;
+  return probability / time;
+}
@@ -0,0 +1,102 @@
+/*********************                                                        */
+/*! \file MILPCheckScheduler.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Decides whether the feasibility check of a search state solves the LP
+ ** relaxation or the MILP, see Engine::checkFeasibilityWithGurobi().
+ **
+ ** The search depth, relative to the number of constraints, is divided into
+ ** buckets. For each bucket and each kind of check, the scheduler records
+ ** the number of checks, their time, and how many decided the state: an
+ ** infeasible LP or MILP, or an MILP solution. The check with the higher
+ ** rate of decisions per unit of time is picked, with the rates smoothed
+ ** towards 1/2. A bucket with too few checks of a kind uses the checks of
+ ** that kind at all depths, and without enough checks at all the fixed
+ ** threshold decides, as it did before. Every so often the other check is
+ ** picked, so that its record stays current.
+ **
+ ** The time limit of an MILP check is a multiple of the time of an LP check
+ ** at the same depth.
+ **/
+
+#ifndef __MILPCheckScheduler_h__
+#define __MILPCheckScheduler_h__
+
+#include "Vector.h"
+
+class MILPCheckScheduler {
+ public:
+  /*
+    The MILP is solved below depth threshold * #constraints until the
+    records say otherwise.
+  */
+  MILPCheckScheduler(double threshold);
+
+  /*
+    Forget the records, e.g., when the query changes
+  */
+  void initialize(unsigned numberOfConstraints);
+
+  /*
+    Keep the records, with the depths now relative to the given number of
+    constraints, e.g., when constraints are added to the query
+  */
+  void setNumberOfConstraints(unsigned numberOfConstraints) {
+    _numberOfConstraints = numberOfConstraints;
+  }
+
+  /*
+    Whether to solve the MILP at the given depth. Counts the decision.
+  */
+  bool decideToSolveMILP(unsigned depth);
+
+  /*
+    The time limit of an MILP check at the given depth, in seconds
+  */
+  double getMILPTimeLimit(unsigned depth) const;
+
+  void recordLPCheck(unsigned depth, unsigned long long timeMicro,
+                     bool decided);
+  void recordMILPCheck(unsigned depth, unsigned long long timeMicro,
+                       bool decided);
+
+ private:
+  struct Record {
+    Record() : _checks(0), _decided(0), _timeMicro(0) {}
+
+    unsigned _checks;
+    unsigned _decided;
+    unsigned long long _timeMicro;
+  };
+
+  double _threshold;
+  unsigned _numberOfConstraints;
+
+  // By depth bucket
+  Vector<Record> _lpRecords;
+  Vector<Record> _milpRecords;
+  Vector<unsigned> _numberOfDecisions;
+
+  // Over all depths
+  Record _lpRecord;
+  Record _milpRecord;
+
+  unsigned getBucket(unsigned depth) const;
+
+  /*
+    The record of the bucket, or the one over all depths if the bucket has
+    too few checks. NULL if neither has enough.
+  */
+  const Record *getRecord(const Vector<Record> &records, const Record &total,
+                          unsigned bucket) const;
+
+  // Decided checks per second, smoothed
+  static double getRate(const Record &record);
+};
+
+#endif  // __MILPCheckScheduler_h__
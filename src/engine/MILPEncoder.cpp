@@ -17,6 +17,7 @@
 #include "MILPEncoder.h"
 
 #include "FloatUtils.h"
+#include "GlobalConfiguration.h"
 #include "GurobiWrapper.h"
 #include "TimeUtils.h"
 
@@ -25,49 +26,63 @@ MILPEncoder::MILPEncoder(const BoundManager &boundManager)
 
 void MILPEncoder::reset(){
   _binVarIndex = 0;
+  _hullVarIndex = 0;
   _binaryVariables.clear();
+  _integerVariables.clear();
+  _encodingDependsOnBounds = false;
+  _absoluteValueRows.clear();
+  _absoluteValueRowIndex.clear();
 }
 
 void MILPEncoder::encodeInputQuery(GurobiWrapper &gurobi,
                                    const InputQuery &inputQuery, bool relax) {
   // Add variables
-  for (unsigned var = 0; var < inputQuery.getNumberOfVariables(); var++) {
-    double lb = _boundManager.getLowerBound(var);
-    double ub = _boundManager.getUpperBound(var);
-    String varName = Stringf("x%u", var);
-    gurobi.addVariable(varName, lb, ub);
+  _encodedLowerBounds.clear();
+  _encodedUpperBounds.clear();
+  for (unsigned var = 0; var < inputQuery.getNumberOfVariables(); var++)
+    addVariable(gurobi, var);
+
+  // Add the hull formulations, and the equations they do not replace
+  Set<const Equation *> replacedEquations;
+  if (_hullFillIn > 0)
+    encodeHullFormulations(gurobi, inputQuery, replacedEquations);
+  for (const auto &equation : inputQuery.getEquations()) {
+    if (!replacedEquations.exists(&equation)) encodeEquation(gurobi, equation);
   }
+  gurobi.updateModel();
+
+  // Add Piecewise-linear Constraints
+  ConstraintEncoder encoder(*this, gurobi, relax);
+  for (const auto &plConstraint : inputQuery.getPLConstraints())
+    dispatchPLConstraint(plConstraint, encoder);
+}
+
+void MILPEncoder::encodeQueryExtension(
+    GurobiWrapper &gurobi, const InputQuery &inputQuery,
+    unsigned firstNewVariable, const List<Equation> &newEquations,
+    const List<PLConstraint *> &newPLConstraints, bool relax) {
+  struct timespec start = TimeUtils::sampleMicro();
+
+  // Add variables
+  for (unsigned var = firstNewVariable; var < inputQuery.getNumberOfVariables();
+       var++)
+    addVariable(gurobi, var);
 
   // Add equations
-  for (const auto &equation : inputQuery.getEquations()) {
-    encodeEquation(gurobi, equation);
-  }
+  for (const auto &equation : newEquations) encodeEquation(gurobi, equation);
   gurobi.updateModel();
 
   // Add Piecewise-linear Constraints
-  for (const auto &plConstraint : inputQuery.getPLConstraints()) {
-    switch (plConstraint->getType()) {
-      case PiecewiseLinearFunctionType::ONE_HOT:
-        encodeOneHotConstraint(gurobi, (OneHotConstraint *)plConstraint, relax);
-        break;
-      case PiecewiseLinearFunctionType::INTEGER:
-        encodeIntegerConstraint(gurobi, (IntegerConstraint *)plConstraint,
-                                relax);
-        break;
-      case PiecewiseLinearFunctionType::ABSOLUTE_VALUE:
-        encodeAbsoluteValueConstraint(
-            gurobi, (AbsoluteValueConstraint *)plConstraint, relax);
-        break;
-      case PiecewiseLinearFunctionType::DISJUNCT:
-        encodeDisjunctionConstraint(
-            gurobi, (DisjunctionConstraint *)plConstraint, relax);
-        break;
-      default:
-        throw SoyError(
-            SoyError::UNSUPPORTED_PIECEWISE_LINEAR_CONSTRAINT,
-            "GurobiWrapper::encodeInputQuery: "
-            "Unsupported piecewise-linear constraints\n");
-    }
+  ConstraintEncoder encoder(*this, gurobi, relax);
+  for (const auto &plConstraint : newPLConstraints)
+    dispatchPLConstraint(plConstraint, encoder);
+  gurobi.updateModel();
+
+  if (_statistics) {
+    struct timespec end = TimeUtils::sampleMicro();
+    _statistics->incLongAttribute(
+        Statistics::TIME_ADDING_CONSTRAINTS_TO_MILP_SOLVER_MICRO,
+        TimeUtils::timePassed(start, end));
   }
 }
 
@@ -78,12 +93,10 @@ void MILPEncoder::encodeInputQueryForSteps(GurobiWrapper &gurobi,
   struct timespec start = TimeUtils::sampleMicro();
 
   // Add variables
-  for (unsigned var = 0; var < inputQuery.getNumberOfVariables(); var++) {
-    double lb = _boundManager.getLowerBound(var);
-    double ub = _boundManager.getUpperBound(var);
-    String varName = Stringf("x%u", var);
-    gurobi.addVariable(varName, lb, ub);
-  }
+  _encodedLowerBounds.clear();
+  _encodedUpperBounds.clear();
+  for (unsigned var = 0; var < inputQuery.getNumberOfVariables(); var++)
+    addVariable(gurobi, var);
 
   // Add equations
   for (const auto &equation : inputQuery.getEquations()) {
@@ -94,30 +107,10 @@ void MILPEncoder::encodeInputQueryForSteps(GurobiWrapper &gurobi,
   gurobi.updateModel();
 
   // Add Piecewise-linear Constraints
+  ConstraintEncoder encoder(*this, gurobi, relax);
   for (const auto &plConstraint : inputQuery.getPLConstraints()) {
     if (!inputQuery.constraintBelongsToStep(plConstraint, steps)) continue;
-    switch (plConstraint->getType()) {
-      case PiecewiseLinearFunctionType::ONE_HOT:
-        encodeOneHotConstraint(gurobi, (OneHotConstraint *)plConstraint, relax);
-        break;
-      case PiecewiseLinearFunctionType::INTEGER:
-        encodeIntegerConstraint(gurobi, (IntegerConstraint *)plConstraint,
-                                relax);
-        break;
-      case PiecewiseLinearFunctionType::ABSOLUTE_VALUE:
-        encodeAbsoluteValueConstraint(
-            gurobi, (AbsoluteValueConstraint *)plConstraint, relax);
-        break;
-      case PiecewiseLinearFunctionType::DISJUNCT:
-        encodeDisjunctionConstraint(
-            gurobi, (DisjunctionConstraint *)plConstraint, relax);
-        break;
-      default:
-        throw SoyError(
-            SoyError::UNSUPPORTED_PIECEWISE_LINEAR_CONSTRAINT,
-            "GurobiWrapper::encodeInputQuery: "
-            "Unsupported piecewise-linear constraints\n");
-    }
+    dispatchPLConstraint(plConstraint, encoder);
   }
   gurobi.updateModel();
 
@@ -129,6 +122,41 @@ void MILPEncoder::encodeInputQueryForSteps(GurobiWrapper &gurobi,
   }
 }
 
+void MILPEncoder::addVariable(GurobiWrapper &gurobi, unsigned variable) {
+  double lb = _boundManager.getLowerBound(variable);
+  double ub = _boundManager.getUpperBound(variable);
+  gurobi.addVariable(Stringf("x%u", variable), lb, ub);
+  _encodedLowerBounds.append(lb);
+  _encodedUpperBounds.append(ub);
+}
+
+bool MILPEncoder::encodingHoldsUnderCurrentBounds() const {
+  // The big-M rows of the abs constraints follow the bounds, see
+  // refreshAbsoluteValueBigMs(), as long as these stay finite
+  for (const auto &rows : _absoluteValueRows)
+    if ((FloatUtils::isFinite(rows._encodedPositiveM) ||
+         FloatUtils::isFinite(rows._encodedNegativeM)) &&
+        (!FloatUtils::isFinite(_boundManager.getLowerBound(rows._source)) ||
+         !FloatUtils::isFinite(_boundManager.getUpperBound(rows._source)) ||
+         !FloatUtils::isFinite(_boundManager.getUpperBound(rows._target))))
+      return false;
+
+  if (!_encodingDependsOnBounds) return true;
+  for (unsigned i = 0; i < _encodedLowerBounds.size(); ++i)
+    if (FloatUtils::lt(_boundManager.getLowerBound(i),
+                       _encodedLowerBounds[i]) ||
+        FloatUtils::gt(_boundManager.getUpperBound(i),
+                       _encodedUpperBounds[i]))
+      return false;
+  return true;
+}
+
+void MILPEncoder::ConstraintEncoder::operator()(PLConstraint *) {
+  throw SoyError(SoyError::UNSUPPORTED_PIECEWISE_LINEAR_CONSTRAINT,
+                 "GurobiWrapper::encodeInputQuery: "
+                 "Unsupported piecewise-linear constraints\n");
+}
+
 String MILPEncoder::getVariableNameFromVariable(unsigned variable) {
   return Stringf("x%u", variable);
 }
@@ -158,11 +186,159 @@ void MILPEncoder::encodeEquation(GurobiWrapper &gurobi,
 void MILPEncoder::enforceIntegralConstraint(GurobiWrapper &gurobi) {
   for (const auto &var : _binaryVariables)
     gurobi.setVariableType(Stringf("x%u", var), 'B');
+  for (const auto &var : _integerVariables)
+    gurobi.setVariableType(Stringf("x%u", var), 'I');
 }
 
 void MILPEncoder::relaxIntegralConstraint(GurobiWrapper &gurobi) {
   for (const auto &var : _binaryVariables)
     gurobi.setVariableType(Stringf("x%u", var), 'C');
+  for (const auto &var : _integerVariables)
+    gurobi.setVariableType(Stringf("x%u", var), 'C');
+}
+
+bool MILPEncoder::isGatedRow(const Equation &equation,
+                             const Set<unsigned> &elements,
+                             GatedRow &row) const {
+  if (equation._type == Equation::EQ) return false;
+
+  bool foundElement = false;
+  double coefficient = 0;
+  // The extremum of the row over the bounds, without the element
+  double extremum = 0;
+  for (const auto &addend : equation._addends) {
+    if (elements.exists(addend._variable)) {
+      if (foundElement) return false;
+      foundElement = true;
+      row._element = addend._variable;
+      coefficient = addend._coefficient;
+      continue;
+    }
+
+    double lb = _boundManager.getLowerBound(addend._variable);
+    double ub = _boundManager.getUpperBound(addend._variable);
+    if (!FloatUtils::isFinite(lb) || !FloatUtils::isFinite(ub)) return false;
+    bool useUpper = (equation._type == Equation::LE) ==
+                    FloatUtils::isPositive(addend._coefficient);
+    extremum += addend._coefficient * (useUpper ? ub : lb);
+  }
+  if (!foundElement || FloatUtils::isZero(coefficient)) return false;
+
+  // With the element 0, the row must be implied by the bounds
+  if (equation._type == Equation::LE ? FloatUtils::gt(extremum, equation._scalar)
+                                     : FloatUtils::lt(extremum, equation._scalar))
+    return false;
+
+  row._equation = &equation;
+  row._scalar = equation._scalar - coefficient;
+  return true;
+}
+
+void MILPEncoder::encodeHullFormulations(
+    GurobiWrapper &gurobi, const InputQuery &inputQuery,
+    Set<const Equation *> &replacedEquations) {
+  Set<unsigned> elements;
+  List<const OneHotConstraint *> oneHots;
+  for (const auto &plConstraint : inputQuery.getPLConstraints()) {
+    if (plConstraint->getType() != PiecewiseLinearFunctionType::ONE_HOT)
+      continue;
+    const auto *oneHot = static_cast<const OneHotConstraint *>(plConstraint);
+    oneHots.append(oneHot);
+    for (const auto &element : oneHot->getElements()) elements.insert(element);
+  }
+
+  Map<unsigned, List<GatedRow>> gatedRows;
+  for (const auto &equation : inputQuery.getEquations()) {
+    GatedRow row;
+    if (isGatedRow(equation, elements, row))
+      gatedRows[row._element].append(row);
+  }
+
+  unsigned numberOfGroups = 0;
+  unsigned numberOfCopies = 0;
+  for (const auto &oneHot : oneHots) {
+    // The elements that can be 1, and the variables of their gated rows
+    Vector<unsigned> activeElements;
+    Set<unsigned> variables;
+    for (const auto &element : oneHot->getElements()) {
+      if (!FloatUtils::isPositive(_boundManager.getUpperBound(element)))
+        continue;
+      activeElements.append(element);
+      if (!gatedRows.exists(element)) continue;
+      for (const auto &row : gatedRows[element])
+        for (const auto &addend : row._equation->_addends)
+          if (addend._variable != element) variables.insert(addend._variable);
+    }
+
+    if (variables.empty() || activeElements.size() < 2 ||
+        activeElements.size() > GlobalConfiguration::HULL_MAX_GROUP_SIZE ||
+        activeElements.size() * variables.size() > _hullFillIn)
+      continue;
+
+    // The copies have no bounds of their own, their bounds are rows over the
+    // element, so that they never appear among the bounds of an IIS.
+    Map<unsigned, List<GurobiWrapper::Term>> sums;
+    for (const auto &variable : variables)
+      sums[variable].append(
+          GurobiWrapper::Term(1, Stringf("x%u", variable)));
+
+    for (const auto &element : activeElements) {
+      String elementName = Stringf("x%u", element);
+      Map<unsigned, String> copies;
+      for (const auto &variable : variables) {
+        String copy = Stringf("h%u", _hullVarIndex++);
+        gurobi.addVariable(copy, FloatUtils::negativeInfinity(),
+                           FloatUtils::infinity());
+        copies[variable] = copy;
+        sums[variable].append(GurobiWrapper::Term(-1, copy));
+
+        List<GurobiWrapper::Term> terms;
+        terms.append(GurobiWrapper::Term(1, copy));
+        terms.append(GurobiWrapper::Term(
+            -_boundManager.getLowerBound(variable), elementName));
+        gurobi.addGeqConstraint(terms, 0);
+        terms.clear();
+        terms.append(GurobiWrapper::Term(1, copy));
+        terms.append(GurobiWrapper::Term(
+            -_boundManager.getUpperBound(variable), elementName));
+        gurobi.addLeqConstraint(terms, 0);
+      }
+
+      if (!gatedRows.exists(element)) continue;
+      for (const auto &row : gatedRows[element]) {
+        List<GurobiWrapper::Term> terms;
+        for (const auto &addend : row._equation->_addends)
+          if (addend._variable != element)
+            terms.append(GurobiWrapper::Term(addend._coefficient,
+                                             copies[addend._variable]));
+        terms.append(GurobiWrapper::Term(-row._scalar, elementName));
+        if (row._equation->_type == Equation::LE)
+          gurobi.addLeqConstraint(terms, 0);
+        else
+          gurobi.addGeqConstraint(terms, 0);
+      }
+    }
+
+    for (const auto &pair : sums) gurobi.addEqConstraint(pair.second, 0);
+
+    // The rows of the elements that cannot be 1 are implied by the bounds
+    for (const auto &element : oneHot->getElements())
+      if (gatedRows.exists(element))
+        for (const auto &row : gatedRows[element])
+          replacedEquations.insert(row._equation);
+
+    ++numberOfGroups;
+    numberOfCopies += activeElements.size() * variables.size();
+    // The copies and the gated rows hold under the current bounds only
+    _encodingDependsOnBounds = true;
+  }
+
+  if (_statistics) {
+    _statistics->setUnsignedAttribute(Statistics::HULL_NUM_GROUPS,
+                                      numberOfGroups);
+    _statistics->setUnsignedAttribute(Statistics::HULL_NUM_VARIABLE_COPIES,
+                                      numberOfCopies);
+  }
 }
 
 void MILPEncoder::encodeAbsoluteValueConstraint(GurobiWrapper &gurobi,
@@ -176,6 +352,9 @@ void MILPEncoder::encodeAbsoluteValueConstraint(GurobiWrapper &gurobi,
          FloatUtils::lte(_boundManager.getUpperBound(abs->getPosAux()), 0)) ||
         (FloatUtils::lte(_boundManager.getUpperBound(abs->getB()), 0) &&
          FloatUtils::lte(_boundManager.getUpperBound(abs->getNegAux()), 0)));
+    // The phase is left to the bounds of the aux variables, the big-M rows
+    // are needed once these are loosened
+    _encodingDependsOnBounds = true;
     return;
   }
 
@@ -196,23 +375,111 @@ void MILPEncoder::encodeAbsoluteValueConstraint(GurobiWrapper &gurobi,
     When a = 0, the constriants become:
     f - b <= ub_f - lb_b, f + b <= 0
   */
-  gurobi.addVariable(Stringf("a%u", _binVarIndex), 0, 1,
+  AbsoluteValueRows rows;
+  rows._source = sourceVariable;
+  rows._target = targetVariable;
+  rows._binary = Stringf("a%u", _binVarIndex);
+  rows._positiveRow = Stringf("a%u_pos", _binVarIndex);
+  rows._negativeRow = Stringf("a%u_neg", _binVarIndex);
+  rows._encodedPositiveM = rows._positiveM = targetUb - sourceLb;
+  rows._encodedNegativeM = rows._negativeM = targetUb + sourceUb;
+
+  gurobi.addVariable(rows._binary, 0, 1,
                      relax ? GurobiWrapper::CONTINUOUS : GurobiWrapper::BINARY);
 
   List<GurobiWrapper::Term> terms;
   terms.append(GurobiWrapper::Term(1, Stringf("x%u", targetVariable)));
   terms.append(GurobiWrapper::Term(-1, Stringf("x%u", sourceVariable)));
-  terms.append(
-      GurobiWrapper::Term(targetUb - sourceLb, Stringf("a%u", _binVarIndex)));
-  gurobi.addLeqConstraint(terms, targetUb - sourceLb);
+  terms.append(GurobiWrapper::Term(rows._positiveM, rows._binary));
+  gurobi.addLeqConstraint(terms, rows._positiveM, rows._positiveRow);
 
   terms.clear();
   terms.append(GurobiWrapper::Term(1, Stringf("x%u", targetVariable)));
   terms.append(GurobiWrapper::Term(1, Stringf("x%u", sourceVariable)));
-  terms.append(GurobiWrapper::Term(-(targetUb + sourceUb),
-                                   Stringf("a%u", _binVarIndex)));
-  gurobi.addLeqConstraint(terms, 0);
+  terms.append(GurobiWrapper::Term(-rows._negativeM, rows._binary));
+  gurobi.addLeqConstraint(terms, 0, rows._negativeRow);
   ++_binVarIndex;
+
+  _absoluteValueRowIndex[rows._positiveRow] = _absoluteValueRows.size();
+  _absoluteValueRowIndex[rows._negativeRow] = _absoluteValueRows.size();
+  _absoluteValueRows.append(rows);
+
+  // Without the refresh, the coefficients do not follow a loosened bound
+  if (!_bigMRefresh) _encodingDependsOnBounds = true;
+}
+
+unsigned MILPEncoder::refreshAbsoluteValueBigMs(GurobiWrapper &gurobi) {
+  if (!_bigMRefresh) return 0;
+
+  unsigned numberOfChanges = 0;
+  for (auto &rows : _absoluteValueRows) {
+    double sourceLb = _boundManager.getLowerBound(rows._source);
+    double sourceUb = _boundManager.getUpperBound(rows._source);
+    double targetUb = _boundManager.getUpperBound(rows._target);
+
+    // Either row is valid for any bounds, with a fixing the phase it gates.
+    // An infinite coefficient is not set: the one of the encoding is
+    // restored, and the model is to be re-encoded, see
+    // encodingHoldsUnderCurrentBounds()
+    double positiveM =
+        FloatUtils::isFinite(targetUb) && FloatUtils::isFinite(sourceLb)
+            ? targetUb - sourceLb
+            : rows._encodedPositiveM;
+    if (needsRefresh(rows._positiveM, positiveM)) {
+      gurobi.setCoefficient(rows._positiveRow, rows._binary, positiveM);
+      gurobi.setRightHandSide(rows._positiveRow, positiveM);
+      rows._positiveM = positiveM;
+      ++numberOfChanges;
+    }
+
+    double negativeM =
+        FloatUtils::isFinite(targetUb) && FloatUtils::isFinite(sourceUb)
+            ? targetUb + sourceUb
+            : rows._encodedNegativeM;
+    if (needsRefresh(rows._negativeM, negativeM)) {
+      gurobi.setCoefficient(rows._negativeRow, rows._binary, -negativeM);
+      rows._negativeM = negativeM;
+      ++numberOfChanges;
+    }
+  }
+  return numberOfChanges;
+}
+
+void MILPEncoder::getTightenedAbsoluteValueRows(List<String> &rows) const {
+  for (const auto &absRows : _absoluteValueRows) {
+    if (FloatUtils::lt(absRows._positiveM, absRows._encodedPositiveM))
+      rows.append(absRows._positiveRow);
+    if (FloatUtils::lt(absRows._negativeM, absRows._encodedNegativeM))
+      rows.append(absRows._negativeRow);
+  }
+}
+
+void MILPEncoder::explainTightenedAbsoluteValueRows(
+    const List<String> &rows,
+    Map<String, GurobiWrapper::IISBoundType> &bounds) const {
+  auto addBound = [&bounds](const String &variable,
+                            GurobiWrapper::IISBoundType type) {
+    if (!bounds.exists(variable))
+      bounds[variable] = type;
+    else if (bounds[variable] != type)
+      bounds[variable] = GurobiWrapper::IIS_BOTH;
+  };
+
+  for (const auto &row : rows) {
+    const AbsoluteValueRows &absRows =
+        _absoluteValueRows[_absoluteValueRowIndex.at(row)];
+    addBound(Stringf("x%u", absRows._target), GurobiWrapper::IIS_UB);
+    addBound(Stringf("x%u", absRows._source),
+             row == absRows._positiveRow ? GurobiWrapper::IIS_LB
+                                         : GurobiWrapper::IIS_UB);
+  }
+}
+
+bool MILPEncoder::needsRefresh(double current, double refreshed) {
+  return FloatUtils::gt(refreshed, current) ||
+         FloatUtils::lt(refreshed,
+                        current * (1 - GlobalConfiguration::
+                                           ABS_BIG_M_REFRESH_TOLERANCE));
 }
 
 void MILPEncoder::encodeOneHotConstraint(GurobiWrapper &gurobi,
@@ -238,12 +505,14 @@ void MILPEncoder::encodeDisjunctionConstraint(GurobiWrapper &gurobi,
 }
 
 void MILPEncoder::encodeIntegerConstraint(GurobiWrapper &gurobi,
-                                          IntegerConstraint *integer, bool) {
+                                          IntegerConstraint *integer,
+                                          bool relax) {
   // if (!integer->isActive()) return;
 
-  // Do not relax for now.
-  gurobi.setVariableType(
-      Stringf("x%u", *(integer->getParticipatingVariables().begin())), 'I');
+  // Integrality is left to the splits of the constraint in the relaxation
+  unsigned variable = integer->getVariable();
+  gurobi.setVariableType(Stringf("x%u", variable), relax ? 'C' : 'I');
+  _integerVariables.insert(variable);
 }
 
 void MILPEncoder::encodeCostFunction(GurobiWrapper &gurobi,
@@ -27,6 +27,8 @@
 #include "Map.h"
 #include "OneHotConstraint.h"
 #include "Statistics.h"
+#include "TypedPLConstraints.h"
+#include "Vector.h"
 
 class MILPEncoder {
  public:
@@ -41,6 +43,18 @@ class MILPEncoder {
   void encodeInputQuery(GurobiWrapper &gurobi, const InputQuery &inputQuery,
                         bool relax = false);
 
+  /*
+    Encode the part of the input query that was added since it was encoded:
+    the variables from firstNewVariable on, and the given equations and
+    piecewise-linear constraints.
+  */
+  void encodeQueryExtension(GurobiWrapper &gurobi,
+                            const InputQuery &inputQuery,
+                            unsigned firstNewVariable,
+                            const List<Equation> &newEquations,
+                            const List<PLConstraint *> &newPLConstraints,
+                            bool relax = false);
+
   void encodeInputQueryForSteps(GurobiWrapper &gurobi,
                                 const InputQuery &inputQuery,
                                 const List<unsigned> &steps,
@@ -69,6 +83,57 @@ class MILPEncoder {
 
   void relaxIntegralConstraint(GurobiWrapper &gurobi);
 
+  /*
+    Have encodeInputQuery() encode the rows gated by the elements of a
+    one-hot group, e.g., the big-M rows of the modes of a PWA system, by the
+    convex hull of the group instead, see encodeHullFormulations(). A group
+    is reformulated if it needs at most maxFillIn variable copies; 0 keeps
+    the big-M rows.
+  */
+  inline void setHullFillIn(unsigned maxFillIn) { _hullFillIn = maxFillIn; }
+
+  /*
+    Whether refreshAbsoluteValueBigMs() sets the big-M coefficients of the
+    abs constraints from the bounds. If not, they keep those of the encoding,
+    which then only holds under the bounds it was made with.
+  */
+  inline void setBigMRefresh(bool refresh) { _bigMRefresh = refresh; }
+
+  /*
+    Whether the encoding still holds under the bounds in the bound manager.
+    It does not when it took more from the bounds at the time than the
+    bounds of the variables, which are updated in place, e.g., the hull
+    formulations, and a bound was loosened since, or when a big-M coefficient
+    of an abs constraint would now be infinite. It must then be redone.
+  */
+  bool encodingHoldsUnderCurrentBounds() const;
+
+  /*
+    Set the big-M coefficients of the rows of the abs constraints, computed
+    from the bounds at their encoding, to those of the current bounds: when
+    this shrinks them by more than GlobalConfiguration::
+    ABS_BIG_M_REFRESH_TOLERANCE, and whenever it grows them, e.g., after
+    backtracking, as the rows must hold under the current bounds. A
+    coefficient from an infinite bound goes back to that of the encoding.
+    The rows must have been added by updateModel(). Return the number of
+    coefficients changed.
+  */
+  unsigned refreshAbsoluteValueBigMs(GurobiWrapper &gurobi);
+
+  /*
+    The rows whose big-M coefficients are tighter than at their encoding,
+    which hold under the current bounds of their variables only
+  */
+  void getTightenedAbsoluteValueRows(List<String> &rows) const;
+
+  /*
+    Add the bounds that the given tightened rows in an IIS depend on to its
+    bounds, for the conflict to include the splits that implied them
+  */
+  void explainTightenedAbsoluteValueRows(
+      const List<String> &rows,
+      Map<String, GurobiWrapper::IISBoundType> &bounds) const;
+
  private:
   /*
     BoundManager has the latest bound
@@ -87,6 +152,93 @@ class MILPEncoder {
 
   Set<unsigned> _binaryVariables;
 
+  /*
+    The variables of the IntegerConstraints, continuous in the relaxation
+  */
+  Set<unsigned> _integerVariables;
+
+  unsigned _hullFillIn = 0;
+  bool _bigMRefresh = true;
+
+  /*
+    Whether the encoding depends on the bounds it was made with, stored by
+    variable
+  */
+  bool _encodingDependsOnBounds = false;
+  Vector<double> _encodedLowerBounds;
+  Vector<double> _encodedUpperBounds;
+
+  void addVariable(GurobiWrapper &gurobi, unsigned variable);
+
+  /*
+    Index for the variable copies of the hull formulations
+  */
+  unsigned _hullVarIndex = 0;
+
+  /*
+    The big-M rows of an abs constraint f = Abs(b) with binary a:
+
+      f - b + M_pos a <= M_pos, with M_pos = ub_f - lb_b, and
+      f + b - M_neg a <= 0, with M_neg = ub_f + ub_b
+  */
+  struct AbsoluteValueRows {
+    unsigned _source;
+    unsigned _target;
+    String _binary;
+    String _positiveRow;
+    String _negativeRow;
+
+    // At the encoding, and in the model now
+    double _encodedPositiveM;
+    double _encodedNegativeM;
+    double _positiveM;
+    double _negativeM;
+  };
+
+  Vector<AbsoluteValueRows> _absoluteValueRows;
+
+  // The index in _absoluteValueRows of each row
+  Map<String, unsigned> _absoluteValueRowIndex;
+
+  /*
+    Whether a big-M coefficient is to be changed from current to that of
+    the current bounds
+  */
+  static bool needsRefresh(double current, double refreshed);
+
+  /*
+    A row gated by an element d of a one-hot group: with d = 0 the bounds
+    imply it, and with d = 1 it is sum_i a_i x_i (type) _scalar over the
+    other variables of the row.
+  */
+  struct GatedRow {
+    const Equation *_equation;
+    unsigned _element;
+    double _scalar;
+  };
+
+  /*
+    Whether the (in)equality is gated by an element, which is then its only
+    variable among the elements.
+  */
+  bool isGatedRow(const Equation &equation, const Set<unsigned> &elements,
+                  GatedRow &row) const;
+
+  /*
+    Encode each one-hot group d_1, ..., d_K with gated rows, at most
+    GlobalConfiguration::HULL_MAX_GROUP_SIZE elements that can be 1 and
+    finite bounds [L, U] on the variables x of the rows, by its convex hull:
+    a copy x^k of each variable per element, with
+
+      x = sum_k x^k,  L d_k <= x^k <= U d_k,  sum_i a_i x_i^k (type) b d_k
+
+    for each row gated by d_k. The rows replaced are added to
+    replacedEquations.
+  */
+  void encodeHullFormulations(GurobiWrapper &gurobi,
+                              const InputQuery &inputQuery,
+                              Set<const Equation *> &replacedEquations);
+
   /*
     Encode an abs constraint f = Abs(b) into Gurobi
   */
@@ -101,6 +253,33 @@ class MILPEncoder {
 
   void encodeIntegerConstraint(GurobiWrapper &gurobi,
                                IntegerConstraint *integer, bool relax);
+
+  /*
+    Kernel for dispatchPLConstraint: encode a constraint of any supported
+    type, and throw on the others.
+  */
+  struct ConstraintEncoder {
+    ConstraintEncoder(MILPEncoder &encoder, GurobiWrapper &gurobi, bool relax)
+        : _encoder(encoder), _gurobi(gurobi), _relax(relax) {}
+
+    void operator()(AbsoluteValueConstraint *abs) {
+      _encoder.encodeAbsoluteValueConstraint(_gurobi, abs, _relax);
+    }
+    void operator()(DisjunctionConstraint *disj) {
+      _encoder.encodeDisjunctionConstraint(_gurobi, disj, _relax);
+    }
+    void operator()(IntegerConstraint *integer) {
+      _encoder.encodeIntegerConstraint(_gurobi, integer, _relax);
+    }
+    void operator()(OneHotConstraint *oneHot) {
+      _encoder.encodeOneHotConstraint(_gurobi, oneHot, _relax);
+    }
+    void operator()(PLConstraint *constraint);
+
+    MILPEncoder &_encoder;
+    GurobiWrapper &_gurobi;
+    bool _relax;
+  };
 };
 
 #endif  // __MILPEncoder_h__
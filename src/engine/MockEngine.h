@@ -13,6 +13,11 @@ class MockEngine : public Engine {
     _lastSplitApplied = split;
   }
 
+  virtual void applyCaseSplit(PLConstraint *constraint,
+                              PhaseStatus phase) override {
+    _lastSplitApplied = constraint->getCaseSplit(phase);
+  }
+
   PLConstraint *_constraintToSplit;
   virtual PLConstraint *pickSplitPLConstraint(
       DivideStrategy /*strategy*/) override {
@@ -0,0 +1,158 @@
+/*********************                                                        */
+/*! \file ModelBuilder.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#include "ModelBuilder.h"
+
+#include <map>
+
+#include "DisjunctionConstraint.h"
+#include "DnCManager.h"
+#include "InputQuery.h"
+#include "IntegerConstraint.h"
+#include "MStringf.h"
+#include "OneHotConstraint.h"
+#include "SoyError.h"
+
+unsigned ModelBuilder::addVariable(double lowerBound, double upperBound,
+                                   bool isInteger, int step) {
+  unsigned variable = _lowerBounds.size();
+  _lowerBounds.append(lowerBound);
+  _upperBounds.append(upperBound);
+  _steps.append(step);
+  if (isInteger) _integerVariables.insert(variable);
+  return variable;
+}
+
+unsigned ModelBuilder::addVariables(unsigned count, const double *lowerBounds,
+                                    const double *upperBounds,
+                                    const int *steps, const bool *isInteger) {
+  unsigned first = _lowerBounds.size();
+  for (unsigned i = 0; i < count; ++i)
+    addVariable(lowerBounds[i], upperBounds[i], isInteger && isInteger[i],
+                steps ? steps[i] : -1);
+  return first;
+}
+
+void ModelBuilder::addRow(unsigned numberOfEntries, const int *indices,
+                          const double *values, Equation::EquationType type,
+                          double scalar) {
+  for (unsigned k = 0; k < numberOfEntries; ++k) checkVariable(indices[k]);
+
+  _rowStarts.append(_columns.size());
+  for (unsigned k = 0; k < numberOfEntries; ++k) {
+    _columns.append(indices[k]);
+    _values.append(values[k]);
+  }
+  _rowTypes.append(type);
+  _scalars.append(scalar);
+}
+
+void ModelBuilder::addRows(unsigned numberOfRows, const int *rowStarts,
+                           const int *indices, const double *values,
+                           const int *types, const double *scalars) {
+  for (unsigned i = 0; i < numberOfRows; ++i) {
+    if (types[i] != Equation::EQ && types[i] != Equation::GE &&
+        types[i] != Equation::LE)
+      throw SoyError(SoyError::INVALID_EQUATION_TYPE,
+                     Stringf("Row %u has type %d", i, types[i]).ascii());
+    addRow(rowStarts[i + 1] - rowStarts[i], indices + rowStarts[i],
+           values + rowStarts[i], (Equation::EquationType)types[i],
+           scalars[i]);
+  }
+}
+
+void ModelBuilder::addOneHot(unsigned count, const int *variables) {
+  _oneHots.append(addGroup(count, variables));
+}
+
+void ModelBuilder::addDisjunction(unsigned count, const int *variables) {
+  _disjunctions.append(addGroup(count, variables));
+}
+
+Set<unsigned> ModelBuilder::addGroup(unsigned count, const int *variables) {
+  Set<unsigned> group;
+  for (unsigned i = 0; i < count; ++i) {
+    checkVariable(variables[i]);
+    unsigned variable = variables[i];
+    group.insert(variable);
+
+    // Integrality is enforced by the group, as for the groups of an MPS file
+    _integerVariables.erase(variable);
+    if (_lowerBounds[variable] < 0) _lowerBounds[variable] = 0;
+    if (_upperBounds[variable] > 1) _upperBounds[variable] = 1;
+  }
+  return group;
+}
+
+void ModelBuilder::checkVariable(int variable) const {
+  if (variable < 0 || (unsigned)variable >= _lowerBounds.size())
+    throw SoyError(SoyError::VARIABLE_INDEX_OUT_OF_RANGE,
+                   Stringf("Variable = %d, number of variables = %u",
+                           variable, _lowerBounds.size())
+                       .ascii());
+}
+
+void ModelBuilder::generateQuery(InputQuery &inputQuery) const {
+  unsigned numberOfVariables = getNumberOfVariables();
+  inputQuery.setNumberOfVariables(numberOfVariables);
+  for (unsigned i = 0; i < numberOfVariables; ++i) {
+    inputQuery.setLowerBound(i, _lowerBounds[i]);
+    inputQuery.setUpperBound(i, _upperBounds[i]);
+    if (_steps[i] >= 0) inputQuery.markVariableToStep(i, _steps[i]);
+  }
+
+  // Appended without the duplicate check of addEquation(), which is linear
+  // in the number of equations
+  List<Equation> &equations = inputQuery.getEquations();
+  for (unsigned row = 0; row < getNumberOfRows(); ++row) {
+    unsigned end =
+        row + 1 < getNumberOfRows() ? _rowStarts[row + 1] : _columns.size();
+    Equation equation(_rowTypes[row]);
+    for (unsigned k = _rowStarts[row]; k < end; ++k)
+      equation.addAddend(_values[k], _columns[k]);
+    equation.setScalar(_scalars[row]);
+    equations.append(equation);
+  }
+
+  for (const auto &group : _oneHots) {
+    Equation equation(Equation::EQ);
+    for (const auto &variable : group) equation.addAddend(1, variable);
+    equation.setScalar(1);
+    equations.append(equation);
+    inputQuery.addPLConstraint(new OneHotConstraint(group));
+  }
+
+  for (const auto &group : _disjunctions) {
+    Equation equation(Equation::GE);
+    for (const auto &variable : group) equation.addAddend(1, variable);
+    equation.setScalar(1);
+    equations.append(equation);
+    inputQuery.addPLConstraint(new DisjunctionConstraint(group));
+  }
+
+  for (const auto &variable : _integerVariables)
+    inputQuery.addPLConstraint(new IntegerConstraint(variable));
+}
+
+String ModelBuilder::solve(unsigned timeoutInSeconds, unsigned numWorkers,
+                           double *solution) const {
+  InputQuery inputQuery;
+  generateQuery(inputQuery);
+
+  DnCManager dncManager(&inputQuery);
+  dncManager.solve(timeoutInSeconds, numWorkers);
+
+  if (dncManager.getExitCode() == DnCManager::SAT) {
+    std::map<int, double> values;
+    dncManager.getSolution(values, inputQuery);
+    for (const auto &pair : values) solution[pair.first] = pair.second;
+  }
+  return dncManager.getResultString();
+}
@@ -0,0 +1,116 @@
+/*********************                                                        */
+/*! \file ModelBuilder.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Builds a query in memory from numeric arrays, e.g., those of a Python
+ ** model predictive control stack, instead of writing an MPS file for
+ ** MpsParser to read back. The model is the one of the MPS dialect:
+ **
+ **   - variables with bounds, optionally integer, and optionally tagged with
+ **     the step they belong to (the @<step> suffix of an MPS name),
+ **   - linear rows, given one at a time or as a CSR matrix, and
+ **   - one-hot groups (binaries summing to 1) and disjunction groups
+ **     (binaries summing to at least 1).
+ **
+ ** The arrays are read as they are added; nothing keeps a reference to them.
+ **/
+
+#ifndef __ModelBuilder_h__
+#define __ModelBuilder_h__
+
+#include "Equation.h"
+#include "MString.h"
+#include "Set.h"
+#include "Vector.h"
+
+class InputQuery;
+
+class ModelBuilder {
+ public:
+  /*
+    Add a variable and return its index. A negative step means that the
+    variable belongs to no step.
+  */
+  unsigned addVariable(double lowerBound, double upperBound,
+                       bool isInteger = false, int step = -1);
+
+  /*
+    Add count variables and return the index of the first one. The steps and
+    the integrality flags may be NULL, for no steps and continuous variables.
+  */
+  unsigned addVariables(unsigned count, const double *lowerBounds,
+                        const double *upperBounds, const int *steps = NULL,
+                        const bool *isInteger = NULL);
+
+  /*
+    Add the row sum_k values[k] * x_indices[k] (type) scalar. Throws a
+    SoyError if a variable does not exist.
+  */
+  void addRow(unsigned numberOfEntries, const int *indices,
+              const double *values, Equation::EquationType type,
+              double scalar);
+
+  /*
+    Add the rows of a CSR matrix: row i has the entries rowStarts[i] to
+    rowStarts[i + 1] - 1 of indices and values, its type types[i] and its
+    right-hand side scalars[i].
+  */
+  void addRows(unsigned numberOfRows, const int *rowStarts, const int *indices,
+               const double *values, const int *types, const double *scalars);
+
+  /*
+    Exactly one of the variables is 1, and the others 0. The variables are
+    made binary.
+  */
+  void addOneHot(unsigned count, const int *variables);
+
+  /*
+    At least one of the variables is 1. The variables are made binary.
+  */
+  void addDisjunction(unsigned count, const int *variables);
+
+  unsigned getNumberOfVariables() const { return _lowerBounds.size(); }
+  unsigned getNumberOfRows() const { return _rowTypes.size(); }
+
+  /*
+    Extract an input query from the model
+  */
+  void generateQuery(InputQuery &inputQuery) const;
+
+  /*
+    Solve the model with the DnCManager and return the result, as
+    DnCManager::getResultString(). If it is "sat", the value of every
+    variable is written to solution, which must have room for
+    getNumberOfVariables() values.
+  */
+  String solve(unsigned timeoutInSeconds, unsigned numWorkers,
+               double *solution) const;
+
+ private:
+  Vector<double> _lowerBounds;
+  Vector<double> _upperBounds;
+  Vector<int> _steps;
+  Set<unsigned> _integerVariables;
+
+  // The rows, in CSR form
+  Vector<unsigned> _rowStarts;
+  Vector<unsigned> _columns;
+  Vector<double> _values;
+  Vector<Equation::EquationType> _rowTypes;
+  Vector<double> _scalars;
+
+  Vector<Set<unsigned>> _oneHots;
+  Vector<Set<unsigned>> _disjunctions;
+
+  void checkVariable(int variable) const;
+
+  // The variables of a one-hot or disjunction group, made binary
+  Set<unsigned> addGroup(unsigned count, const int *variables);
+};
+
+#endif  // __ModelBuilder_h__
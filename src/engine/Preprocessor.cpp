@@ -26,6 +26,7 @@
 #include "PiecewiseLinearFunctionType.h"
 #include "Statistics.h"
 #include "Tightening.h"
+#include "TraceRecorder.h"
 
 #ifdef _WIN32
 #undef INFINITE
@@ -35,7 +36,8 @@ Preprocessor::Preprocessor()
     : _preprocessed(nullptr),
       _statistics(NULL),
       _lowerBounds(NULL),
-      _upperBounds(NULL) {}
+      _upperBounds(NULL),
+      _numberOfStoredBounds(0) {}
 
 Preprocessor::~Preprocessor() { freeMemoryIfNeeded(); }
 
@@ -48,6 +50,7 @@ void Preprocessor::freeMemoryIfNeeded() {
     delete[] _upperBounds;
     _upperBounds = NULL;
   }
+  _numberOfStoredBounds = 0;
 }
 
 void Preprocessor::preprocess(InputQuery &query) {
@@ -69,8 +72,10 @@ void Preprocessor::preprocess(InputQuery &query) {
   /*
     Store the bounds locally for more efficient access.
   */
-  _lowerBounds = new double[_preprocessed->getNumberOfVariables()];
-  _upperBounds = new double[_preprocessed->getNumberOfVariables()];
+  freeMemoryIfNeeded();
+  _numberOfStoredBounds = _preprocessed->getNumberOfVariables();
+  _lowerBounds = new double[_numberOfStoredBounds];
+  _upperBounds = new double[_numberOfStoredBounds];
 
   for (unsigned i = 0; i < _preprocessed->getNumberOfVariables(); ++i) {
     _lowerBounds[i] = _preprocessed->getLowerBound(i);
@@ -84,6 +89,8 @@ void Preprocessor::preprocess(InputQuery &query) {
       1. Tighten bounds using equations
       2. Tighten bounds using pl constraints
   */
+  _typedConstraints.initialize(_preprocessed->getPLConstraints());
+
   bool continueTightening = true && GlobalConfiguration::PERFORM_PREPROCESSING;
   while (continueTightening) {
     continueTightening = processEquations();
@@ -113,12 +120,16 @@ void Preprocessor::preprocess(InputQuery &query) {
 
 bool Preprocessor::preprocessLite(InputQuery &query, BoundManager &bm,
                                   bool updateCDObjects) {
+  PROFILE_TRACE_SCOPE("propagation");
   _preprocessed = &query;
 
-  if (!_lowerBounds)
-      _lowerBounds = new double[_preprocessed->getNumberOfVariables()];
-  if (!_upperBounds)
-      _upperBounds = new double[_preprocessed->getNumberOfVariables()];
+  // The query may have grown since the last call
+  if (_numberOfStoredBounds < _preprocessed->getNumberOfVariables()) {
+      freeMemoryIfNeeded();
+      _numberOfStoredBounds = _preprocessed->getNumberOfVariables();
+      _lowerBounds = new double[_numberOfStoredBounds];
+      _upperBounds = new double[_numberOfStoredBounds];
+  }
 
   for (unsigned i = 0; i < _preprocessed->getNumberOfVariables(); ++i) {
       _lowerBounds[i] = bm.getLowerBound(i);
@@ -411,51 +422,12 @@ bool Preprocessor::processEquationsLite() {
 }
 
 bool Preprocessor::processConstraintsLite() {
+  // Runs at every search node over a list that may hold copies, see
+  // preprocessLite(): grouping the constraints by type each time costs more
+  // than the virtual calls it saves
   bool tighterBoundFound = false;
-
-  for (auto &constraint : _preprocessed->getPLConstraints()) {
-      auto vars = constraint->getParticipatingVariables();
-      for (unsigned variable : vars) {
-          if (constraint->participatingVariable(variable)){
-              constraint->notifyLowerBound(variable, getLowerBound(variable));
-              constraint->notifyUpperBound(variable, getUpperBound(variable));
-          }
-      }
-
-    List<Tightening> tightenings;
-    constraint->getEntailedTightenings(tightenings);
-
-    for (const auto &tightening : tightenings) {
-      if ((tightening._type == Tightening::LB) &&
-          (FloatUtils::gt(tightening._value,
-                          getLowerBound(tightening._variable)))) {
-        tighterBoundFound = true;
-        setLowerBound(tightening._variable, tightening._value);
-      }
-
-      else if ((tightening._type == Tightening::UB) &&
-               (FloatUtils::lt(tightening._value,
-                               getUpperBound(tightening._variable)))) {
-        tighterBoundFound = true;
-        setUpperBound(tightening._variable, tightening._value);
-      }
-
-      if (FloatUtils::areEqual(
-              getLowerBound(tightening._variable),
-              getUpperBound(tightening._variable),
-              GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD))
-        setUpperBound(tightening._variable,
-                      getLowerBound(tightening._variable));
-
-      if (FloatUtils::gt(
-              getLowerBound(tightening._variable),
-              getUpperBound(tightening._variable),
-              GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD)) {
-        throw InfeasibleQueryException();
-      }
-    }
-  }
-
+  for (const auto &constraint : _preprocessed->getPLConstraints())
+    if (processConstraint(constraint)) tighterBoundFound = true;
   return tighterBoundFound;
 }
 
@@ -684,48 +656,52 @@ bool Preprocessor::processEquations() {
 }
 
 bool Preprocessor::processConstraints() {
-  bool tighterBoundFound = false;
+  ConstraintProcessor processor(*this);
+  _typedConstraints.forEach(processor);
+  return processor._tighterBoundFound;
+}
 
-  for (auto &constraint : _preprocessed->getPLConstraints()) {
-      auto vars = constraint->getParticipatingVariables();
-      for (unsigned variable : vars) {
-          if (constraint->participatingVariable(variable)){
-              constraint->notifyLowerBound(variable, getLowerBound(variable));
-              constraint->notifyUpperBound(variable, getUpperBound(variable));
-          }
-      }
+template <class T>
+bool Preprocessor::processConstraint(T *constraint) {
+  bool tighterBoundFound = false;
 
-    List<Tightening> tightenings;
-    constraint->getEntailedTightenings(tightenings);
+  for (unsigned variable : constraint->getParticipatingVariableSpan()) {
+    if (constraint->participatingVariable(variable)) {
+      constraint->notifyLowerBound(variable, getLowerBound(variable));
+      constraint->notifyUpperBound(variable, getUpperBound(variable));
+    }
+  }
 
-    for (const auto &tightening : tightenings) {
-      if ((tightening._type == Tightening::LB) &&
-          (FloatUtils::gt(tightening._value,
-                          getLowerBound(tightening._variable)))) {
-        tighterBoundFound = true;
-        setLowerBound(tightening._variable, tightening._value);
-      }
+  List<Tightening> tightenings;
+  constraint->getEntailedTightenings(tightenings);
 
-      else if ((tightening._type == Tightening::UB) &&
-               (FloatUtils::lt(tightening._value,
-                               getUpperBound(tightening._variable)))) {
-        tighterBoundFound = true;
-        setUpperBound(tightening._variable, tightening._value);
-      }
+  for (const auto &tightening : tightenings) {
+    if ((tightening._type == Tightening::LB) &&
+        (FloatUtils::gt(tightening._value,
+                        getLowerBound(tightening._variable)))) {
+      tighterBoundFound = true;
+      setLowerBound(tightening._variable, tightening._value);
+    }
 
-      if (FloatUtils::areEqual(
-              getLowerBound(tightening._variable),
-              getUpperBound(tightening._variable),
-              GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD))
-        setUpperBound(tightening._variable,
-                      getLowerBound(tightening._variable));
+    else if ((tightening._type == Tightening::UB) &&
+             (FloatUtils::lt(tightening._value,
+                             getUpperBound(tightening._variable)))) {
+      tighterBoundFound = true;
+      setUpperBound(tightening._variable, tightening._value);
+    }
 
-      if (FloatUtils::gt(
-              getLowerBound(tightening._variable),
-              getUpperBound(tightening._variable),
-              GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD)) {
-        throw InfeasibleQueryException();
-      }
+    if (FloatUtils::areEqual(
+            getLowerBound(tightening._variable),
+            getUpperBound(tightening._variable),
+            GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD))
+      setUpperBound(tightening._variable,
+                    getLowerBound(tightening._variable));
+
+    if (FloatUtils::gt(
+            getLowerBound(tightening._variable),
+            getUpperBound(tightening._variable),
+            GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD)) {
+      throw InfeasibleQueryException();
     }
   }
 
@@ -8,6 +8,7 @@
 #include "Map.h"
 #include "PLConstraint.h"
 #include "Set.h"
+#include "TypedPLConstraints.h"
 
 class Preprocessor {
  public:
@@ -85,6 +86,27 @@ class Preprocessor {
   */
   bool processConstraints();
 
+  /*
+    Notify a constraint of the current bounds and apply the tightenings it
+    entails. Instantiated for each concrete constraint type.
+  */
+  template <class T>
+  bool processConstraint(T *constraint);
+
+  struct ConstraintProcessor {
+    explicit ConstraintProcessor(Preprocessor &preprocessor)
+        : _preprocessor(preprocessor), _tighterBoundFound(false) {}
+
+    template <class T>
+    void operator()(T *constraint) {
+      if (_preprocessor.processConstraint(constraint))
+        _tighterBoundFound = true;
+    }
+
+    Preprocessor &_preprocessor;
+    bool _tighterBoundFound;
+  };
+
   /*
     All input/output variables
   */
@@ -95,6 +117,11 @@ class Preprocessor {
   */
   InputQuery *_preprocessed;
 
+  /*
+    The constraints of the preprocessed query, grouped by type
+  */
+  TypedPLConstraints _typedConstraints;
+
   /*
     Statistics collection
   */
@@ -105,6 +132,7 @@ class Preprocessor {
   */
   double *_lowerBounds;
   double *_upperBounds;
+  unsigned _numberOfStoredBounds;
 
   /*
     For debugging only
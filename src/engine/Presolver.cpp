@@ -0,0 +1,596 @@
+/*********************                                                        */
+/*! \file Presolver.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#include "Presolver.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "FloatUtils.h"
+#include "GlobalConfiguration.h"
+#include "InfeasibleQueryException.h"
+#include "InputQuery.h"
+#include "MStringf.h"
+#include "Map.h"
+#include "SolutionHint.h"
+#include "SoyError.h"
+#include "Statistics.h"
+#include "TypedPLConstraints.h"
+
+namespace {
+// Coefficients below this are not divided by to turn a row into a bound
+const double MIN_SINGLETON_COEFFICIENT = 1e-9;
+
+// A condensed variable has at least this fraction of the largest coefficient
+// of its equality
+const double MIN_RELATIVE_PIVOT = 0.01;
+
+// Subtract factor times the row from the equation
+void subtractRow(Equation &equation, const Equation &row, double factor) {
+  for (const auto &addend : row._addends) {
+    bool found = false;
+    for (auto &existing : equation._addends) {
+      if (existing._variable == addend._variable) {
+        existing._coefficient -= factor * addend._coefficient;
+        found = true;
+        break;
+      }
+    }
+    if (!found)
+      equation.addAddend(-factor * addend._coefficient, addend._variable);
+  }
+  equation._scalar -= factor * row._scalar;
+}
+
+// The copy of a constraint over renumbered variables
+struct ConstraintRenumberer {
+  explicit ConstraintRenumberer(const Vector<int> &newIndex)
+      : _newIndex(newIndex), _renumbered(NULL) {}
+
+  Set<unsigned> renumber(const Set<unsigned> &variables) const {
+    Set<unsigned> renumbered;
+    for (const auto &variable : variables)
+      renumbered.insert(_newIndex[variable]);
+    return renumbered;
+  }
+
+  void operator()(AbsoluteValueConstraint *constraint) {
+    _renumbered = new AbsoluteValueConstraint(_newIndex[constraint->getB()],
+                                              _newIndex[constraint->getF()]);
+  }
+
+  void operator()(DisjunctionConstraint *constraint) {
+    _renumbered = new DisjunctionConstraint(renumber(constraint->getElements()));
+  }
+
+  void operator()(IntegerConstraint *constraint) {
+    _renumbered = new IntegerConstraint(_newIndex[constraint->getVariable()]);
+  }
+
+  void operator()(OneHotConstraint *constraint) {
+    _renumbered = new OneHotConstraint(renumber(constraint->getElements()));
+  }
+
+  void operator()(PLConstraint *) {
+    throw SoyError(SoyError::UNSUPPORTED_PIECEWISE_LINEAR_CONSTRAINT,
+                   "Presolver: unknown constraint type");
+  }
+
+  const Vector<int> &_newIndex;
+  PLConstraint *_renumbered;
+};
+}  // namespace
+
+Presolver::Presolver()
+    : _statistics(NULL),
+      _maxFillIn(0),
+      _numberOfAddendsRemoved(0),
+      _numberOfVariablesCondensed(0) {}
+
+void Presolver::setMaxFillIn(unsigned maxFillIn) { _maxFillIn = maxFillIn; }
+
+void Presolver::setStatistics(Statistics *statistics) {
+  _statistics = statistics;
+}
+
+bool Presolver::isFixed(unsigned variable) const {
+  return FloatUtils::areEqual(
+      _lowerBounds[variable], _upperBounds[variable],
+      GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD);
+}
+
+bool Presolver::tightenLowerBound(unsigned variable, double bound) {
+  if (!FloatUtils::gt(bound, _lowerBounds[variable])) return false;
+  _lowerBounds[variable] = bound;
+  if (FloatUtils::gt(_lowerBounds[variable], _upperBounds[variable],
+                     GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD))
+    throw InfeasibleQueryException();
+  if (isFixed(variable)) _upperBounds[variable] = _lowerBounds[variable];
+  return true;
+}
+
+bool Presolver::tightenUpperBound(unsigned variable, double bound) {
+  if (!FloatUtils::lt(bound, _upperBounds[variable])) return false;
+  _upperBounds[variable] = bound;
+  if (FloatUtils::gt(_lowerBounds[variable], _upperBounds[variable],
+                     GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD))
+    throw InfeasibleQueryException();
+  if (isFixed(variable)) _upperBounds[variable] = _lowerBounds[variable];
+  return true;
+}
+
+bool Presolver::reduceRow(unsigned row) {
+  Equation &equation = _rows[row];
+
+  for (auto it = equation._addends.begin(); it != equation._addends.end();) {
+    if (FloatUtils::isZero(it->_coefficient)) {
+      it = equation._addends.erase(it);
+    } else if (isFixed(it->_variable)) {
+      equation._scalar -= it->_coefficient * _lowerBounds[it->_variable];
+      it = equation._addends.erase(it);
+      ++_numberOfAddendsRemoved;
+    } else {
+      ++it;
+    }
+  }
+
+  double threshold = GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD;
+  Equation::EquationType type = equation._type;
+  double scalar = equation._scalar;
+
+  if (equation._addends.empty()) {
+    if ((type != Equation::GE && FloatUtils::lt(scalar, 0, threshold)) ||
+        (type != Equation::LE && FloatUtils::gt(scalar, 0, threshold)))
+      throw InfeasibleQueryException();
+    _removedRows.insert(row);
+    return false;
+  }
+
+  const Equation::Addend &first = equation._addends.front();
+  if (equation._addends.size() == 1 &&
+      std::fabs(first._coefficient) >= MIN_SINGLETON_COEFFICIENT) {
+    // c x (type) b, that is, x (type) b / c with the type flipped if c < 0
+    unsigned variable = first._variable;
+    double bound = scalar / first._coefficient;
+    bool isLower = type == Equation::GE;
+    if (first._coefficient < 0) isLower = !isLower;
+
+    bool tightened = false;
+    if (type == Equation::EQ || isLower)
+      tightened = tightenLowerBound(variable, bound);
+    if (type == Equation::EQ || !isLower)
+      tightened = tightenUpperBound(variable, bound) || tightened;
+    _removedRows.insert(row);
+    return tightened;
+  }
+
+  // The range of the left-hand side over the bounds
+  double minimum = 0;
+  double maximum = 0;
+  bool minimumIsFinite = true;
+  bool maximumIsFinite = true;
+  for (const auto &addend : equation._addends) {
+    double coefficient = addend._coefficient;
+    double lower = _lowerBounds[addend._variable];
+    double upper = _upperBounds[addend._variable];
+    double low = coefficient > 0 ? lower : upper;
+    double high = coefficient > 0 ? upper : lower;
+
+    if (FloatUtils::isFinite(low))
+      minimum += coefficient * low;
+    else
+      minimumIsFinite = false;
+    if (FloatUtils::isFinite(high))
+      maximum += coefficient * high;
+    else
+      maximumIsFinite = false;
+  }
+
+  if ((type != Equation::LE && maximumIsFinite &&
+       FloatUtils::lt(maximum, scalar, threshold)) ||
+      (type != Equation::GE && minimumIsFinite &&
+       FloatUtils::gt(minimum, scalar, threshold)))
+    throw InfeasibleQueryException();
+
+  // Implied by the bounds
+  if ((type == Equation::LE && maximumIsFinite &&
+       FloatUtils::lte(maximum, scalar)) ||
+      (type == Equation::GE && minimumIsFinite &&
+       FloatUtils::gte(minimum, scalar)))
+    _removedRows.insert(row);
+
+  return false;
+}
+
+bool Presolver::mergeDuplicateRows() {
+  // The rows are normalized so that their first coefficient is 1, and
+  // grouped by their normalized left-hand side. Each group gets the
+  // intersection of the ranges [low, high] of its rows.
+  struct Group {
+    unsigned _firstRow;
+    unsigned _numberOfRows;
+    Equation _normalized;
+    double _low;
+    double _high;
+  };
+  Map<String, unsigned> groupOfKey;
+  Vector<Group> groups;
+  bool merged = false;
+  unsigned numberOfRemovedRows = _removedRows.size();
+
+  unsigned numberOfRows = _rows.size();
+  for (unsigned row = 0; row < numberOfRows; ++row) {
+    if (_removedRows.exists(row)) continue;
+    const Equation &equation = _rows[row];
+
+    Vector<std::pair<unsigned, double>> addends;
+    for (const auto &addend : equation._addends)
+      addends.append(std::make_pair(addend._variable, addend._coefficient));
+    addends.sort();
+
+    double scale = addends[0].second;
+    Equation normalized(Equation::EQ);
+    String key;
+    for (const auto &addend : addends) {
+      normalized.addAddend(addend.second / scale, addend.first);
+      key += Stringf("%u:%.12g ", addend.first, addend.second / scale);
+    }
+
+    double scalar = equation._scalar / scale;
+    Equation::EquationType type = equation._type;
+    if (scale < 0 && type != Equation::EQ)
+      type = type == Equation::GE ? Equation::LE : Equation::GE;
+    double low = type == Equation::LE ? FloatUtils::negativeInfinity() : scalar;
+    double high = type == Equation::GE ? FloatUtils::infinity() : scalar;
+
+    if (!groupOfKey.exists(key)) {
+      groupOfKey[key] = groups.size();
+      Group group;
+      group._firstRow = row;
+      group._numberOfRows = 1;
+      group._normalized = normalized;
+      group._low = low;
+      group._high = high;
+      groups.append(group);
+      continue;
+    }
+
+    Group &group = groups[groupOfKey[key]];
+    ++group._numberOfRows;
+    group._low = std::max(group._low, low);
+    group._high = std::min(group._high, high);
+    _removedRows.insert(row);
+    merged = true;
+  }
+
+  if (!merged) return false;
+
+  unsigned numberOfRangeRows = 0;
+
+  // Rewrite the first row of each merged group
+  for (const auto &group : groups) {
+    if (group._numberOfRows == 1) continue;
+    if (FloatUtils::gt(group._low, group._high,
+                       GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD))
+      throw InfeasibleQueryException();
+
+    Equation &equation = _rows[group._firstRow];
+    equation = group._normalized;
+    if (FloatUtils::areEqual(group._low, group._high)) {
+      equation._type = Equation::EQ;
+      equation.setScalar(group._low);
+      continue;
+    }
+
+    bool hasLow = FloatUtils::isFinite(group._low);
+    bool hasHigh = FloatUtils::isFinite(group._high);
+    equation._type = hasLow ? Equation::GE : Equation::LE;
+    equation.setScalar(hasLow ? group._low : group._high);
+    if (hasLow && hasHigh) {
+      Equation upper = group._normalized;
+      upper._type = Equation::LE;
+      upper.setScalar(group._high);
+      _rows.append(upper);
+      ++numberOfRangeRows;
+    }
+  }
+
+  // A range row is split again into two rows, which is not a reduction
+  return _removedRows.size() > numberOfRemovedRows + numberOfRangeRows;
+}
+
+void Presolver::reduceRows() {
+  bool reduced = true;
+  while (reduced) {
+    reduced = false;
+    for (unsigned row = 0; row < _rows.size(); ++row)
+      if (!_removedRows.exists(row) && reduceRow(row)) reduced = true;
+    if (!reduced) reduced = mergeDuplicateRows();
+  }
+}
+
+int Presolver::choosePivot(const InputQuery &query, unsigned row) const {
+  const Equation &equation = _rows[row];
+  double largest = 0;
+  for (const auto &addend : equation._addends)
+    largest = std::max(largest, std::fabs(addend._coefficient));
+
+  int pivot = -1;
+  unsigned pivotStep = 0;
+  double pivotCoefficient = 0;
+  for (const auto &addend : equation._addends) {
+    unsigned variable = addend._variable;
+    double coefficient = std::fabs(addend._coefficient);
+    if (_plVariables.exists(variable) || !query.variableHasStep(variable) ||
+        coefficient < MIN_RELATIVE_PIVOT * largest)
+      continue;
+    unsigned step = query.getStepOfVariable(variable);
+    if (pivot < 0 || step > pivotStep ||
+        (step == pivotStep && coefficient > pivotCoefficient)) {
+      pivot = variable;
+      pivotStep = step;
+      pivotCoefficient = coefficient;
+    }
+  }
+  return pivot;
+}
+
+bool Presolver::condense(const InputQuery &query) {
+  Vector<Set<unsigned>> rowsOfVariable(_lowerBounds.size());
+  Vector<std::pair<unsigned, unsigned>> equalities;
+  for (unsigned row = 0; row < _rows.size(); ++row) {
+    if (_removedRows.exists(row)) continue;
+    for (const auto &addend : _rows[row]._addends)
+      rowsOfVariable[addend._variable].insert(row);
+    if (_rows[row]._type != Equation::EQ) continue;
+    int pivot = choosePivot(query, row);
+    if (pivot >= 0)
+      equalities.append(std::make_pair(query.getStepOfVariable(pivot), row));
+  }
+
+  // The equalities of the earliest steps first, so that the later ones are
+  // substituted into the condensed earlier ones
+  equalities.sort();
+
+  bool condensed = false;
+  for (const auto &equality : equalities) {
+    unsigned row = equality.second;
+    if (_removedRows.exists(row)) continue;
+    int pivot = choosePivot(query, row);
+    if (pivot < 0) continue;
+
+    Equation definition = _rows[row];
+    double pivotCoefficient = definition.getCoefficient(pivot);
+    unsigned numberOfTerms = definition._addends.size() - 1;
+
+    List<unsigned> otherRows;
+    for (const auto &other : rowsOfVariable[pivot])
+      if (other != row && !_removedRows.exists(other)) otherRows.append(other);
+    bool hasLowerBound = FloatUtils::isFinite(_lowerBounds[pivot]);
+    bool hasUpperBound = FloatUtils::isFinite(_upperBounds[pivot]);
+    unsigned fillIn = (otherRows.size() + hasLowerBound + hasUpperBound) *
+                      numberOfTerms;
+    if (fillIn > _maxFillIn) continue;
+
+    for (const auto &other : otherRows) {
+      Equation &equation = _rows[other];
+      subtractRow(equation, definition,
+                  equation.getCoefficient(pivot) / pivotCoefficient);
+      for (auto it = equation._addends.begin();
+           it != equation._addends.end();) {
+        if (it->_variable == (unsigned)pivot ||
+            FloatUtils::isZero(it->_coefficient))
+          it = equation._addends.erase(it);
+        else
+          ++it;
+      }
+      for (const auto &addend : definition._addends)
+        rowsOfVariable[addend._variable].insert(other);
+    }
+
+    // The bounds of the pivot, over the other variables of its equality:
+    // pivotCoefficient * pivot = scalar - terms
+    Equation terms(Equation::EQ);
+    for (const auto &addend : definition._addends)
+      if (addend._variable != (unsigned)pivot)
+        terms.addAddend(addend._coefficient, addend._variable);
+    List<Equation> boundRows;
+    if (hasLowerBound) {
+      Equation bound = terms;
+      bound._type = pivotCoefficient > 0 ? Equation::LE : Equation::GE;
+      bound.setScalar(definition._scalar -
+                      pivotCoefficient * _lowerBounds[pivot]);
+      boundRows.append(bound);
+    }
+    if (hasUpperBound) {
+      Equation bound = terms;
+      bound._type = pivotCoefficient > 0 ? Equation::GE : Equation::LE;
+      bound.setScalar(definition._scalar -
+                      pivotCoefficient * _upperBounds[pivot]);
+      boundRows.append(bound);
+    }
+    for (const auto &bound : boundRows) {
+      for (const auto &addend : bound._addends)
+        rowsOfVariable[addend._variable].insert(_rows.size());
+      _rows.append(bound);
+    }
+
+    Substitution substitution;
+    substitution._variable = pivot;
+    substitution._definition = definition;
+    _substitutions.append(substitution);
+
+    _removedRows.insert(row);
+    rowsOfVariable[pivot].clear();
+    _lowerBounds[pivot] = FloatUtils::negativeInfinity();
+    _upperBounds[pivot] = FloatUtils::infinity();
+    ++_numberOfVariablesCondensed;
+    condensed = true;
+  }
+
+  return condensed;
+}
+
+void Presolver::presolve(const InputQuery &query, InputQuery &presolved) {
+  unsigned numberOfVariables = query.getNumberOfVariables();
+  _lowerBounds.clear();
+  _upperBounds.clear();
+  for (unsigned i = 0; i < numberOfVariables; ++i) {
+    _lowerBounds.append(query.getLowerBounds().exists(i)
+                            ? query.getLowerBound(i)
+                            : FloatUtils::negativeInfinity());
+    _upperBounds.append(query.getUpperBounds().exists(i)
+                            ? query.getUpperBound(i)
+                            : FloatUtils::infinity());
+    if (FloatUtils::gt(_lowerBounds[i], _upperBounds[i],
+                       GlobalConfiguration::PREPROCESSOR_ALMOST_FIXED_THRESHOLD))
+      throw InfeasibleQueryException();
+    if (isFixed(i)) _upperBounds[i] = _lowerBounds[i];
+  }
+
+  // The rows, with the repeated variables of an equation merged
+  _rows.clear();
+  _removedRows.clear();
+  _substitutions.clear();
+  _numberOfAddendsRemoved = 0;
+  _numberOfVariablesCondensed = 0;
+  for (const auto &equation : query.getEquations()) {
+    Map<unsigned, double> coefficients;
+    Equation row(equation._type);
+    for (const auto &addend : equation._addends) {
+      if (!coefficients.exists(addend._variable))
+        row.addAddend(0, addend._variable);
+      coefficients[addend._variable] += addend._coefficient;
+    }
+    for (auto &addend : row._addends)
+      addend._coefficient = coefficients[addend._variable];
+    row.setScalar(equation._scalar);
+    _rows.append(row);
+  }
+  unsigned numberOfOriginalRows = _rows.size();
+
+  _plVariables.clear();
+  for (const auto &constraint : query.getPLConstraints())
+    for (const auto &variable : constraint->getParticipatingVariables())
+      _plVariables.insert(variable);
+
+  reduceRows();
+  if (_maxFillIn > 0 && condense(query)) reduceRows();
+
+  // The variables left in a row or a constraint are kept, in their order
+  Vector<char> isKept(numberOfVariables, 0);
+  for (unsigned row = 0; row < _rows.size(); ++row)
+    if (!_removedRows.exists(row))
+      for (const auto &addend : _rows[row]._addends)
+        isKept[addend._variable] = 1;
+  for (const auto &variable : _plVariables) isKept[variable] = 1;
+
+  _newIndex.clear();
+  _eliminatedValue.clear();
+  unsigned numberOfKeptVariables = 0;
+  for (unsigned i = 0; i < numberOfVariables; ++i) {
+    if (isKept[i]) {
+      _newIndex.append(numberOfKeptVariables++);
+      _eliminatedValue.append(0);
+    } else {
+      // Fixed, or in no row: any value in the bounds
+      _newIndex.append(-1);
+      double value = 0;
+      if (FloatUtils::isFinite(_lowerBounds[i]) && value < _lowerBounds[i])
+        value = _lowerBounds[i];
+      if (FloatUtils::isFinite(_upperBounds[i]) && value > _upperBounds[i])
+        value = _upperBounds[i];
+      _eliminatedValue.append(value);
+    }
+  }
+
+  presolved.setNumberOfVariables(numberOfKeptVariables);
+  for (unsigned i = 0; i < numberOfVariables; ++i) {
+    if (_newIndex[i] < 0) continue;
+    unsigned variable = _newIndex[i];
+    if (FloatUtils::isFinite(_lowerBounds[i]))
+      presolved.setLowerBound(variable, _lowerBounds[i]);
+    if (FloatUtils::isFinite(_upperBounds[i]))
+      presolved.setUpperBound(variable, _upperBounds[i]);
+    if (query.variableHasStep(i))
+      presolved.markVariableToStep(variable, query.getStepOfVariable(i));
+  }
+
+  List<Equation> &equations = presolved.getEquations();
+  unsigned numberOfRows = 0;
+  for (unsigned row = 0; row < _rows.size(); ++row) {
+    if (_removedRows.exists(row)) continue;
+    Equation equation(_rows[row]._type);
+    for (const auto &addend : _rows[row]._addends)
+      equation.addAddend(addend._coefficient, _newIndex[addend._variable]);
+    equation.setScalar(_rows[row]._scalar);
+    equations.append(equation);
+    ++numberOfRows;
+  }
+
+  for (const auto &constraint : query.getPLConstraints())
+    presolved.addPLConstraint(renumberConstraint(constraint));
+
+  if (_statistics) {
+    _statistics->setUnsignedAttribute(
+        Statistics::PRESOLVE_NUM_VARIABLES_REMOVED,
+        numberOfVariables - numberOfKeptVariables);
+    _statistics->setUnsignedAttribute(
+        Statistics::PRESOLVE_NUM_EQUATIONS_REMOVED,
+        numberOfOriginalRows > numberOfRows ? numberOfOriginalRows - numberOfRows
+                                            : 0);
+    _statistics->setUnsignedAttribute(
+        Statistics::PRESOLVE_NUM_ADDENDS_REMOVED, _numberOfAddendsRemoved);
+    _statistics->setUnsignedAttribute(
+        Statistics::PRESOLVE_NUM_VARIABLES_CONDENSED,
+        _numberOfVariablesCondensed);
+  }
+
+  _rows.clear();
+  _removedRows.clear();
+}
+
+PLConstraint *Presolver::renumberConstraint(PLConstraint *constraint) const {
+  ConstraintRenumberer renumberer(_newIndex);
+  dispatchPLConstraint(constraint, renumberer);
+  return renumberer._renumbered;
+}
+
+void Presolver::postsolve(const Vector<double> &presolvedAssignment,
+                          Vector<double> &assignment) const {
+  assignment.clear();
+  for (unsigned i = 0; i < _newIndex.size(); ++i)
+    assignment.append(isEliminated(i) ? _eliminatedValue[i]
+                                      : presolvedAssignment[_newIndex[i]]);
+
+  // A definition is over variables kept or condensed after it
+  for (unsigned i = _substitutions.size(); i-- > 0;) {
+    const Substitution &substitution = _substitutions[i];
+    double value = substitution._definition._scalar;
+    double pivotCoefficient = 0;
+    for (const auto &addend : substitution._definition._addends) {
+      if (addend._variable == substitution._variable)
+        pivotCoefficient = addend._coefficient;
+      else
+        value -= addend._coefficient * assignment[addend._variable];
+    }
+    assignment[substitution._variable] = value / pivotCoefficient;
+  }
+}
+
+void Presolver::presolveHint(const SolutionHint &hint,
+                             SolutionHint &presolved) const {
+  presolved.clear();
+  for (const auto &pair : hint.getAssignment())
+    if (pair.first < _newIndex.size() && !isEliminated(pair.first))
+      presolved.setValue(getPresolvedVariable(pair.first), pair.second);
+  for (const auto &pair : hint.getModes())
+    presolved.setMode(pair.first, pair.second);
+}
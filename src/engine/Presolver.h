@@ -0,0 +1,162 @@
+/*********************                                                        */
+/*! \file Presolver.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Reduces a query before it is handed to the engines, which encode every
+ ** row into Gurobi and propagate it at every node. Until nothing changes:
+ **
+ **   - fixed variables are substituted into the rows,
+ **   - rows with a single variable become bounds,
+ **   - rows implied by the bounds of their variables are dropped, and
+ **   - duplicate rows, equal up to a scaling factor, are merged.
+ **
+ ** Optionally, the equalities are then condensed: each defines its variable
+ ** of the latest step, such as x[t+1] in a state update, which is
+ ** substituted into the other rows, with its bounds turned into rows. Taking
+ ** the equalities by step expresses the states in terms of the initial state
+ ** and the earlier inputs. A substitution is skipped if it would add more
+ ** coefficients than a limit, so long horizons are only partly condensed.
+ ** The variables of piecewise-linear constraints are never substituted, and
+ ** keep controlling their rows.
+ **
+ ** The variables left in no row and no piecewise-linear constraint are then
+ ** eliminated, and the others renumbered in their original order, with
+ ** their steps. The Preprocessor still tightens the bounds of the result.
+ **
+ ** The presolver keeps the map back to the original variables, and the
+ ** substituted equalities, to report solutions over them and to translate
+ ** hints.
+ **/
+
+#ifndef __Presolver_h__
+#define __Presolver_h__
+
+#include "Equation.h"
+#include "Set.h"
+#include "Vector.h"
+
+class InputQuery;
+class PLConstraint;
+class SolutionHint;
+class Statistics;
+
+class Presolver {
+ public:
+  Presolver();
+
+  /*
+    Reduce the query into presolved. Throws an InfeasibleQueryException if
+    the reductions show that the query has no solution.
+  */
+  void presolve(const InputQuery &query, InputQuery &presolved);
+
+  /*
+    Condense the equalities, adding at most maxFillIn coefficients to the
+    other rows per substituted variable. 0, the default, turns it off.
+  */
+  void setMaxFillIn(unsigned maxFillIn);
+
+  unsigned getNumberOfOriginalVariables() const { return _newIndex.size(); }
+
+  bool isEliminated(unsigned variable) const { return _newIndex[variable] < 0; }
+
+  /*
+    The index of a variable that is not eliminated, in the presolved query
+  */
+  unsigned getPresolvedVariable(unsigned variable) const {
+    return _newIndex[variable];
+  }
+
+  /*
+    The assignment of the original variables from an assignment of the
+    presolved ones. Fixed variables get their value, those in no row a value
+    in their bounds, and substituted ones the value of their equality.
+  */
+  void postsolve(const Vector<double> &presolvedAssignment,
+                 Vector<double> &assignment) const;
+
+  /*
+    The hint over the variables of the presolved query. The values of
+    eliminated variables are dropped.
+  */
+  void presolveHint(const SolutionHint &hint, SolutionHint &presolved) const;
+
+  /*
+    Have the presolver report its reductions
+  */
+  void setStatistics(Statistics *statistics);
+
+ private:
+  // A condensed variable and the equality defining it
+  struct Substitution {
+    unsigned _variable;
+    Equation _definition;
+  };
+
+  Statistics *_statistics;
+  unsigned _maxFillIn;
+
+  Vector<double> _lowerBounds;
+  Vector<double> _upperBounds;
+  Vector<Equation> _rows;
+  Set<unsigned> _removedRows;
+  Set<unsigned> _plVariables;
+  Vector<Substitution> _substitutions;
+
+  // By original variable: the presolved index, or -1 if eliminated
+  Vector<int> _newIndex;
+  Vector<double> _eliminatedValue;
+
+  unsigned _numberOfAddendsRemoved;
+  unsigned _numberOfVariablesCondensed;
+
+  bool isFixed(unsigned variable) const;
+
+  /*
+    Tighten the bounds of a variable, returning true if they changed.
+    Throws an InfeasibleQueryException if they cross.
+  */
+  bool tightenLowerBound(unsigned variable, double bound);
+  bool tightenUpperBound(unsigned variable, double bound);
+
+  /*
+    Substitute the fixed variables of the row, turn it into bounds if it has
+    at most one variable left, and drop it if it is implied by the bounds.
+    Returns true if a bound changed.
+  */
+  bool reduceRow(unsigned row);
+
+  /*
+    Merge the rows with the same variables and proportional coefficients.
+    Returns true if this removed rows.
+  */
+  bool mergeDuplicateRows();
+
+  /*
+    Reduce and merge the rows until nothing changes
+  */
+  void reduceRows();
+
+  /*
+    The variable of the latest step that the equality can define, or -1
+  */
+  int choosePivot(const InputQuery &query, unsigned row) const;
+
+  /*
+    Substitute the equalities along the horizon. Returns true if this
+    substituted any variable.
+  */
+  bool condense(const InputQuery &query);
+
+  /*
+    The presolved copy of a constraint, over the new variable indices
+  */
+  PLConstraint *renumberConstraint(PLConstraint *constraint) const;
+};
+
+#endif  // __Presolver_h__
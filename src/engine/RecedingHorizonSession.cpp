@@ -0,0 +1,115 @@
+/*********************                                                        */
+/*! \file RecedingHorizonSession.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#include "RecedingHorizonSession.h"
+
+#include "InputQuery.h"
+#include "MStringf.h"
+#include "Options.h"
+#include "PLConstraint.h"
+#include "SoyError.h"
+#include "TimeUtils.h"
+
+RecedingHorizonSession::RecedingHorizonSession(
+    InputQuery &inputQuery, const List<unsigned> &stateVariables)
+    : _processed(false),
+      _verbosity(Options::get()->getInt(Options::VERBOSITY)) {
+  for (const auto &variable : stateVariables) {
+    _stateVariables.insert(variable);
+    _lowerBounds[variable] = inputQuery.getLowerBound(variable);
+    _upperBounds[variable] = inputQuery.getUpperBound(variable);
+  }
+
+  _processed = _engine.processInputQuery(inputQuery, false);
+  if (_processed)
+    _engine.getInputQuery()->getPLConstraintsOfSingleSteps(_constraintsOfStep);
+}
+
+void RecedingHorizonSession::updateBounds(unsigned variable, double lowerBound,
+                                          double upperBound) {
+  if (!_stateVariables.exists(variable))
+    throw SoyError(SoyError::UPDATING_BOUNDS_OF_NON_STATE_VARIABLE,
+                   Stringf("x%u is not a state variable", variable).ascii());
+  _lowerBounds[variable] = lowerBound;
+  _upperBounds[variable] = upperBound;
+}
+
+Engine::ExitCode RecedingHorizonSession::solve(unsigned timeoutInSeconds) {
+  struct timespec start = TimeUtils::sampleMicro();
+
+  Engine::ExitCode exitCode = Engine::UNSAT;
+  if (_processed) {
+    _engine.resetBounds(_lowerBounds, _upperBounds);
+    // An empty pattern leaves the initialization to the configured strategy
+    _engine.setInitialPhasePattern(_shiftedPhasePattern);
+
+    if (_engine.solve(timeoutInSeconds))
+      shiftPhasePatternOfSolution();
+    else
+      _shiftedPhasePattern.clear();
+    exitCode = _engine.getExitCode();
+  }
+
+  struct timespec end = TimeUtils::sampleMicro();
+  _solveTimesMicro.append(TimeUtils::timePassed(start, end));
+
+  if (_verbosity > 0)
+    printf("RecedingHorizonSession: solve %u: %s in %.3f ms\n",
+           _solveTimesMicro.size(),
+           exitCode == Engine::SAT     ? "sat"
+           : exitCode == Engine::UNSAT ? "unsat"
+                                       : "unknown",
+           _solveTimesMicro.last() / 1000.0);
+  return exitCode;
+}
+
+double RecedingHorizonSession::getAssignment(unsigned variable) {
+  return _engine.getAssignment(variable);
+}
+
+void RecedingHorizonSession::extractSolution(InputQuery &inputQuery) {
+  _engine.extractSolution(inputQuery);
+}
+
+unsigned long long RecedingHorizonSession::getLastSolveTimeMicro() const {
+  return _solveTimesMicro.empty() ? 0 : _solveTimesMicro.last();
+}
+
+void RecedingHorizonSession::printStatistics() const {
+  unsigned long long total = 0;
+  unsigned long long maximum = 0;
+  for (const auto &time : _solveTimesMicro) {
+    total += time;
+    if (time > maximum) maximum = time;
+  }
+
+  printf("RecedingHorizonSession: %u solves\n", _solveTimesMicro.size());
+  if (!_solveTimesMicro.empty())
+    printf("\tLatency: mean %.3f ms, max %.3f ms\n",
+           total / 1000.0 / _solveTimesMicro.size(), maximum / 1000.0);
+}
+
+void RecedingHorizonSession::shiftPhasePatternOfSolution() {
+  Map<PLConstraint *, PhaseStatus> solution;
+  _engine.getPhasePatternOfAssignment(solution);
+
+  _shiftedPhasePattern.clear();
+  for (const auto &pair : _constraintsOfStep) {
+    const Vector<PLConstraint *> &constraints = pair.second;
+    const Vector<PLConstraint *> &next =
+        _constraintsOfStep.exists(pair.first + 1)
+            ? _constraintsOfStep[pair.first + 1]
+            : constraints;
+
+    for (unsigned i = 0; i < constraints.size() && i < next.size(); ++i)
+      if (solution.exists(next[i]))
+        _shiftedPhasePattern[constraints[i]] = solution[next[i]];
+  }
+}
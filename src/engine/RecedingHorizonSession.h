@@ -0,0 +1,113 @@
+/*********************                                                        */
+/*! \file RecedingHorizonSession.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Solves the same query again and again as the bounds of a designated set of
+ ** variables change, e.g., the initial state of a model predictive control
+ ** problem over PWA dynamics solved at every control period. One engine is
+ ** kept warm between the solves, see Engine::resetBounds():
+ **
+ **   - the query is parsed and processed once, and its LP encoded once,
+ **   - the Boolean structure and the lemmas of Engine::computeInitialPattern(),
+ **     which do not depend on the initial state, stay in the SAT solver,
+ **   - the scores of the pseudo-impact branching heuristic carry over, and
+ **   - the local search starts from the phase pattern of the previous
+ **     solution shifted by one step: each constraint of step t takes the
+ **     phase of the matching constraint of step t + 1, as the horizon
+ **     recedes by one step between control periods.
+ **
+ ** The query is processed without preprocessing, which would bake the bounds
+ ** of the initial state into the constraints.
+ **/
+
+#ifndef __RecedingHorizonSession_h__
+#define __RecedingHorizonSession_h__
+
+#include "Engine.h"
+#include "List.h"
+#include "Map.h"
+#include "Set.h"
+#include "Vector.h"
+
+class InputQuery;
+class PLConstraint;
+
+class RecedingHorizonSession {
+ public:
+  /*
+    Process the query into a new engine. Only the bounds of the state
+    variables can be updated between solves.
+  */
+  RecedingHorizonSession(InputQuery &inputQuery,
+                         const List<unsigned> &stateVariables);
+
+  /*
+    Set the bounds of a state variable for the next solves. Throws a SoyError
+    if the variable is not a state variable.
+  */
+  void updateBounds(unsigned variable, double lowerBound, double upperBound);
+
+  /*
+    Solve the query from the current bounds of the state variables, warm
+    starting from the previous solves.
+  */
+  Engine::ExitCode solve(unsigned timeoutInSeconds = 0);
+
+  double getAssignment(unsigned variable);
+  void extractSolution(InputQuery &inputQuery);
+
+  unsigned getNumberOfSolves() const { return _solveTimesMicro.size(); }
+
+  // The wall time of each call to solve(), in order
+  const Vector<unsigned long long> &getSolveTimesMicro() const {
+    return _solveTimesMicro;
+  }
+
+  unsigned long long getLastSolveTimeMicro() const;
+
+  // The number of solves, and the mean and maximal latency
+  void printStatistics() const;
+
+  Engine &getEngine() { return _engine; }
+
+  // The initial phase pattern of the next solve, empty after a solve that
+  // found no solution
+  const Map<PLConstraint *, PhaseStatus> &getShiftedPhasePattern() const {
+    return _shiftedPhasePattern;
+  }
+
+ private:
+  Engine _engine;
+  // False if the query was found infeasible while processing it
+  bool _processed;
+  unsigned _verbosity;
+
+  Set<unsigned> _stateVariables;
+  // The bounds to solve from, set by updateBounds()
+  Map<unsigned, double> _lowerBounds;
+  Map<unsigned, double> _upperBounds;
+
+  // The constraints of the engine that belong to a single step, by step, in
+  // the order of the query
+  Map<unsigned, Vector<PLConstraint *>> _constraintsOfStep;
+
+  // The initial phase pattern of the next solve
+  Map<PLConstraint *, PhaseStatus> _shiftedPhasePattern;
+
+  Vector<unsigned long long> _solveTimesMicro;
+
+  /*
+    Set _shiftedPhasePattern to the phase pattern of the solution, with each
+    constraint of step t taking the phase of the constraint at the same
+    position of step t + 1. The constraints of the last step keep their own
+    phase.
+  */
+  void shiftPhasePatternOfSolution();
+};
+
+#endif  // __RecedingHorizonSession_h__
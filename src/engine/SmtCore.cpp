@@ -10,6 +10,7 @@
 #include "SoyError.h"
 #include "Options.h"
 #include "PseudoImpactTracker.h"
+#include "TraceRecorder.h"
 
 SmtCore::SmtCore(Engine *engine)
     : _engine(engine),
@@ -37,8 +38,8 @@ SmtCore::SmtCore(Engine *engine)
 SmtCore::~SmtCore() { freeMemory(); }
 
 void SmtCore::freeMemory() {
-  for (const auto &entry : _trail) delete entry;
   _trail.clear();
+  _trailEntryPool.reset();
 }
 
 void SmtCore::initializeScoreTrackerIfNeeded(
@@ -88,14 +89,26 @@ void SmtCore::restart() {
   }
 
   _context.popto(0);
+  TRACE_COUNTER("decision_level", 0);
   struct timespec end = TimeUtils::sampleMicro();
   _statistics->incLongAttribute(Statistics::TOTAL_TIME_SMT_CORE_MICRO,
                                 TimeUtils::timePassed(start, end));
 }
 
+void SmtCore::reset() {
+  freeMemory();
+  resetSplitConditions();
+  _constraintForSplitting = NULL;
+  _numberOfConflict = 0;
+
+  _context.popto(0);
+  TRACE_COUNTER("decision_level", 0);
+}
+
 bool SmtCore::needToSplit() const { return _needToSplit; }
 
 void SmtCore::performSplit() {
+  PROFILE_TRACE_SCOPE("split");
   ASSERT(_needToSplit);
 
   // Maybe the constraint has already become inactive - if so, ignore
@@ -119,13 +132,19 @@ void SmtCore::performSplit() {
 
   ++_stateId;
   _engine->preContextPushHook();
-  _constraintForSplitting->setActive(false);
+  _constraintForSplitting->prepareCaseSplit();
+  // A split on an integer leaves a smaller domain, which may be split again.
+  // The constraint is left active rather than re-activated in the child, see
+  // ConstraintStateTracker.
+  if (_constraintForSplitting->getType() !=
+      PiecewiseLinearFunctionType::INTEGER)
+    _constraintForSplitting->setActive(false);
   _context.push();
 
   PhaseStatus phase = _constraintForSplitting->getNextFeasibleCase();
-  _trail.append(new TrailEntry(_constraintForSplitting, phase));
-  PiecewiseLinearCaseSplit split = _constraintForSplitting->getCaseSplit(phase);
-  _engine->applySplit(split);
+  _trail.append(_trailEntryPool.allocate(_constraintForSplitting, phase));
+  _engine->applyCaseSplit(_constraintForSplitting, phase);
+  TRACE_COUNTER("decision_level", getTrailLength());
 
   if (_statistics) {
     unsigned level = getTrailLength();
@@ -146,6 +165,7 @@ void SmtCore::performSplit() {
 }
 
 bool SmtCore::popSplit() {
+  PROFILE_TRACE_SCOPE("pop");
   SMT_LOG("Performing a pop");
 
   resetSplitConditions();
@@ -164,28 +184,28 @@ bool SmtCore::popSplit() {
   do {
     _context.pop();
     // Remove any entries that have no alternatives
-    TrailEntry *trailEntry = _trail.back();
+    TrailEntry *trailEntry = _trail.last();
     PLConstraint *constraint = trailEntry->_constraint;
     PhaseStatus phase = trailEntry->_phase;
     constraint->markInfeasiblePhase(phase);
 
     if (!constraint->hasFeasiblePhases()) {
-      delete trailEntry;
+      _trailEntryPool.release(trailEntry);
       _trail.popBack();
       if (_trail.empty()) return false;
     } else
       break;
   } while (true);
 
-  TrailEntry *trailEntry = _trail.back();
+  TrailEntry *trailEntry = _trail.last();
   PLConstraint *constraint = trailEntry->_constraint;
   PhaseStatus phase = constraint->getNextFeasibleCase();
   trailEntry->_phase = phase;
-  auto split = constraint->getCaseSplit(phase);
 
   _engine->preContextPushHook();
   _context.push();
-  _engine->applySplit(split);
+  _engine->applyCaseSplit(constraint, phase);
+  TRACE_COUNTER("decision_level", getTrailLength());
 
   if (_statistics) {
     unsigned level = getTrailLength();
@@ -208,8 +228,9 @@ bool SmtCore::popSplit() {
 void SmtCore::informSatSolverOfDecisions(CadicalWrapper *cadical) {
   cadical->clearAssumptions();
   for (const auto &trailEntry : _trail)
-    cadical->assumeLiteral(
-        trailEntry->_constraint->getLiteralOfPhaseStatus(trailEntry->_phase));
+    if (trailEntry->_constraint->phaseStatusHasLiteral(trailEntry->_phase))
+      cadical->assumeLiteral(trailEntry->_constraint->getLiteralOfPhaseStatus(
+          trailEntry->_phase));
 }
 
 void SmtCore::extractConflict(
@@ -217,7 +238,7 @@ void SmtCore::extractConflict(
     const BoundManager &boundManager) {
   SMT_LOG("Performing conflict analysis...");
 
-  _currentConflict = Conflict();
+  _currentConflict.clear();
   Set<unsigned> levels;
   for (const auto &pair : explanation) {
     unsigned variable = variableNameToVariable(pair.first);
@@ -250,7 +271,7 @@ void SmtCore::extractConflict(
 void SmtCore::extractNaiveConflict() {
   SMT_LOG("Performing conflict analysis...");
 
-  _currentConflict = Conflict();
+  _currentConflict.clear();
 
   for (const auto &trailEntry : _trail) {
     _currentConflict.addLiteral(trailEntry->_constraint, trailEntry->_phase);
@@ -263,6 +284,7 @@ void SmtCore::extractNaiveConflict() {
 
 void SmtCore::setStatistics(Statistics *statistics) {
   _statistics = statistics;
+  _trailEntryPool.setStatistics(statistics);
 }
 
 unsigned SmtCore::getTrailLength() const {
@@ -6,6 +6,7 @@
 #include "Conflict.h"
 #include "DivideStrategy.h"
 #include "MStringf.h"
+#include "ObjectPool.h"
 #include "PLConstraint.h"
 #include "PLConstraintScoreTracker.h"
 #include "PiecewiseLinearCaseSplit.h"
@@ -32,7 +33,10 @@ class SmtCore {
   void freeMemory();
 
  private:
-  List<TrailEntry *> _trail;
+  // One entry per decision level. The entries come from the pool, which hands
+  // a popped level's slot to the next split and is reset on restart.
+  Vector<TrailEntry *> _trail;
+  ObjectPool<TrailEntry> _trailEntryPool;
 
   Engine *_engine;
   Context &_context;
@@ -42,6 +46,10 @@ class SmtCore {
   void initializeScoreTrackerIfNeeded(
       const List<PLConstraint *> &plConstraints);
 
+  inline void addPLConstraintToScoreTracker(PLConstraint *constraint) {
+    if (_scoreTracker) _scoreTracker->addConstraint(constraint);
+  }
+
   void reportRejectedPhasePatternProposal();
 
   inline void updatePLConstraintScore(PLConstraint *constraint, double score) {
@@ -91,6 +99,13 @@ class SmtCore {
 public:
   bool needToRestart() const;
   void restart();
+
+  /*
+    Backtrack to decision level 0 and forget the search, but not the scores
+    of the branching heuristic, to solve the query again from new bounds.
+  */
+  void reset();
+
   static unsigned luby(unsigned i) {
     for (unsigned k = 1; k < 32; ++k)
       if (i == (1u << k) - 1) return 1u << (k - 1);
@@ -0,0 +1,45 @@
+/*********************                                                        */
+/*! \file SolutionHint.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** A guess of a solution to warm start the engine from, e.g., the trajectory
+ ** of the previous control period or the mode sequence of a heuristic
+ ** controller, see Engine::setHint(). It consists of values of some or all
+ ** variables and of the mode of some steps, the index of a phase of the
+ ** constraints of that step.
+ **/
+
+#ifndef __SolutionHint_h__
+#define __SolutionHint_h__
+
+#include "Map.h"
+
+class SolutionHint {
+ public:
+  void setValue(unsigned variable, double value) {
+    _assignment[variable] = value;
+  }
+
+  void setMode(unsigned step, unsigned mode) { _modeOfStep[step] = mode; }
+
+  const Map<unsigned, double> &getAssignment() const { return _assignment; }
+  const Map<unsigned, unsigned> &getModes() const { return _modeOfStep; }
+
+  bool empty() const { return _assignment.empty() && _modeOfStep.empty(); }
+
+  void clear() {
+    _assignment.clear();
+    _modeOfStep.clear();
+  }
+
+ private:
+  Map<unsigned, double> _assignment;
+  Map<unsigned, unsigned> _modeOfStep;
+};
+
+#endif  // __SolutionHint_h__
@@ -19,11 +19,15 @@
 #include "DnCManager.h"
 #include "File.h"
 #include "GurobiWrapper.h"
+#include "HintParser.h"
 #include "Map.h"
 #include "MStringf.h"
 #include "SoyError.h"
 #include "MpsParser.h"
 #include "Options.h"
+#include "PwaParser.h"
+#include "Profiler.h"
+#include "TraceRecorder.h"
 
 
 Soy::Soy() : _dncManager(nullptr), _inputQuery(InputQuery()) {}
@@ -31,6 +35,8 @@ Soy::Soy() : _dncManager(nullptr), _inputQuery(InputQuery()) {}
 void Soy::run() {
   String inputQueryFilePath =
       Options::get()->getString(Options::INPUT_QUERY_FILE_PATH);
+  String traceFilePath = Options::get()->getString(Options::TRACE_FILE);
+  if (traceFilePath != "") TraceRecorder::enable();
 
   if (Options::get()->getBool(Options::SOLVE_WITH_MILP)){
     struct timespec start = TimeUtils::sampleMicro();
@@ -61,9 +67,9 @@ void Soy::run() {
 
       unsigned long long totalElapsed = TimeUtils::timePassed(start, end);
       // Field #2: total elapsed time
-      summaryFile.write(Stringf(" %u ", totalElapsed / 1000000));
+      summaryFile.write(Stringf(" %llu ", totalElapsed / 1000000));
 
-      // Field #3: average time per soi check
+      // Field #3: number of visited search tree nodes
       summaryFile.write(Stringf(" %u ", gurobi.getNumberOfNodes()));
 
       // Field #4: average number of proposals per deep soi call
@@ -83,14 +89,35 @@ void Soy::run() {
     }
 
     printf("InputQuery: %s\n", inputQueryFilePath.ascii());
-    auto mpsParser = MpsParser(inputQueryFilePath);
-    mpsParser.generateQuery(_inputQuery);
+    // A .pwa file describes the system once and is expanded over the horizon
+    Map<String, unsigned> variableNames;
+    if (inputQueryFilePath.length() > 4 &&
+        inputQueryFilePath.substring(inputQueryFilePath.length() - 4, 4) ==
+            ".pwa") {
+      PwaParser pwaParser(inputQueryFilePath);
+      pwaParser.generateQuery(_inputQuery,
+                              Options::get()->getInt(Options::PWA_HORIZON));
+      variableNames = pwaParser.getVariableNameToVariableIndex();
+    } else {
+      MpsParser mpsParser(inputQueryFilePath);
+      mpsParser.generateQuery(_inputQuery);
+      variableNames = mpsParser.getVariableNameToVariableIndex();
+    }
 
     /*
       Step 2: initialize the DNC core
     */
     _dncManager = std::unique_ptr<DnCManager>(new DnCManager(&_inputQuery));
 
+    String hintFilePath = Options::get()->getString(Options::HINT_FILE);
+    if (hintFilePath != "") {
+      printf("Hint: %s\n", hintFilePath.ascii());
+      SolutionHint hint;
+      HintParser(hintFilePath)
+          .generateHint(variableNames, hint);
+      _dncManager->setHint(hint);
+    }
+
     struct timespec start = TimeUtils::sampleMicro();
 
     _dncManager->solve();
@@ -99,7 +126,7 @@ void Soy::run() {
       String solutionFilePath = Options::get()->getString(Options::SOLUTION_FILE);
       if (solutionFilePath != "") {
         Map<String, double> solution;
-        _dncManager->extractSolution(mpsParser, solution);
+        _dncManager->extractSolution(variableNames, solution);
         File solutionFile(solutionFilePath);
         solutionFile.open(File::MODE_WRITE_TRUNCATE);
 
@@ -114,6 +141,15 @@ void Soy::run() {
     unsigned long long totalElapsed = TimeUtils::timePassed(start, end);
     displayResults(totalElapsed);
   }
+
+  // The workers have been joined, so their buffers can be flushed
+  if (traceFilePath != "") TraceRecorder::writeChromeTrace(traceFilePath);
+
+#ifdef ENABLE_PROFILING
+  Profiler::printReport();
+  String profileFilePath = Options::get()->getString(Options::PROFILE_FILE);
+  if (profileFilePath != "") Profiler::writeFoldedStacks(profileFilePath);
+#endif
 }
 
 void Soy::displayResults(unsigned long long microSecondsElapsed) const {
@@ -129,14 +165,24 @@ void Soy::displayResults(unsigned long long microSecondsElapsed) const {
     summaryFile.write(resultString);
 
     // Field #2: total elapsed time
-    summaryFile.write(Stringf(" %u ", microSecondsElapsed / 1000000));
+    summaryFile.write(Stringf(" %llu ", microSecondsElapsed / 1000000));
 
-    // Field #3: average time per soi check
-    summaryFile.write(Stringf("%u ", _dncManager->getAverageTimePerSoICheck()));
+    // Field #3: number of visited search tree states, over all workers
+    summaryFile.write(
+        Stringf("%llu ", _dncManager->getNumberOfVisitedTreeStates()));
 
     // Field #4: average number of proposals per deep soi call
     summaryFile.write(Stringf("%.2f", _dncManager->getAverageProposalPerDeepSoI()));
 
     summaryFile.write("\n");
+
+    // The full statistics of every worker, next to the summary file
+    File jsonFile(summaryFilePath + ".json");
+    jsonFile.open(File::MODE_WRITE_TRUNCATE);
+    jsonFile.write(Stringf("{\n\"result\": \"%s\",\n", resultString.ascii()));
+    jsonFile.write(Stringf("\"total_time_micro\": %llu,\n\"statistics\": ",
+                           microSecondsElapsed));
+    jsonFile.write(_dncManager->getStatisticsAggregator().getJsonReport());
+    jsonFile.write("\n}\n");
   }
 }
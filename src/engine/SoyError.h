@@ -34,6 +34,8 @@ class SoyError : public Error {
     UNABLE_TO_PICK_SPLIT_PLCONSTRAINT = 25,
     CONFLICT_HAS_PHASES_OF_SAME_PLCONSTRAINT = 26,
     INFEASIBILITY_DURING_OPTIMIZATION = 27,
+    UPDATING_BOUNDS_OF_NON_STATE_VARIABLE = 28,
+    UNNAMED_VARIABLE_IN_INCREMENTAL_QUERY = 29,
 
     // Error codes for Query Loader
     FILE_DOES_NOT_EXIST = 100,
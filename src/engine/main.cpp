@@ -1,6 +1,8 @@
+#include "BatchSolver.h"
 #include "Error.h"
 #include "Soy.h"
 #include "Options.h"
+#include "SolverDaemon.h"
 
 static std::string getCompiler() {
   std::stringstream ss;
@@ -46,7 +48,26 @@ int main(int argc, char **argv) {
       return 0;
     };
 
-    Soy().run();
+    String daemonSocketPath = options->getString(Options::DAEMON_SOCKET);
+    String batchPath = options->getString(Options::BATCH_PATH);
+    if (daemonSocketPath != "") {
+      SolverDaemon(daemonSocketPath,
+                   options->getInt(Options::DAEMON_POOL_SIZE))
+          .run();
+    } else if (batchPath != "") {
+      Vector<String> queryPaths;
+      BatchSolver::collectQueryPaths(batchPath, queryPaths);
+      BatchSolver batchSolver(queryPaths, options->getInt(Options::BATCH_CORES),
+                              options->getInt(Options::NUM_WORKERS),
+                              options->getInt(Options::TIMEOUT));
+      batchSolver.run();
+      batchSolver.printStatistics();
+
+      String summaryFilePath = options->getString(Options::SUMMARY_FILE);
+      if (summaryFilePath != "") batchSolver.writeSummaryFile(summaryFilePath);
+    } else {
+      Soy().run();
+    }
   } catch (const Error &e) {
     printf("Caught a %s error. Code: %u, Errno: %i, Message: %s.\n",
            e.getErrorClass(), e.getCode(), e.getErrno(), e.getUserMessage());
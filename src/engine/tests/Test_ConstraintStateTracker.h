@@ -0,0 +1,155 @@
+#include <cxxtest/TestSuite.h>
+
+#include "ConstraintStateTracker.h"
+#include "MockConstraint.h"
+#include "context/context.h"
+
+class ConstraintStateTrackerTestSuite : public CxxTest::TestSuite {
+ public:
+  void test_newly_fixed_constraints() {
+    CVC4::context::Context context;
+    ConstraintStateTracker tracker(context);
+
+    MockConstraint *constraint1 = new MockConstraint(3);
+    MockConstraint *constraint2 = new MockConstraint(2);
+    constraint1->initializeCDOs(&context);
+    constraint2->initializeCDOs(&context);
+    constraint1->registerStateTracker(&tracker);
+    constraint2->registerStateTracker(&tracker);
+    TS_ASSERT_THROWS_NOTHING(tracker.initialize({constraint1, constraint2}));
+    TS_ASSERT(!tracker.hasNewlyFixedConstraint());
+
+    context.push();
+    constraint1->markInfeasiblePhase(static_cast<PhaseStatus>(0));
+    TS_ASSERT(!tracker.hasNewlyFixedConstraint());
+    constraint1->markInfeasiblePhase(static_cast<PhaseStatus>(1));
+    TS_ASSERT(tracker.hasNewlyFixedConstraint());
+    TS_ASSERT_EQUALS(tracker.popNewlyFixedConstraint(), constraint1);
+    TS_ASSERT(!tracker.hasNewlyFixedConstraint());
+
+    context.push();
+    constraint2->setPhaseStatus(static_cast<PhaseStatus>(1));
+    TS_ASSERT_EQUALS(tracker.popNewlyFixedConstraint(), constraint2);
+    TS_ASSERT(!tracker.hasNewlyFixedConstraint());
+
+    // The fixing of constraint2 is undone, constraint1 stays consumed
+    context.pop();
+    TS_ASSERT(!tracker.hasNewlyFixedConstraint());
+    TS_ASSERT(!constraint2->phaseFixed());
+
+    // Both the fixing and its consumption of constraint1 are undone
+    context.pop();
+    TS_ASSERT(!tracker.hasNewlyFixedConstraint());
+    TS_ASSERT(!constraint1->phaseFixed());
+
+    delete constraint1;
+    delete constraint2;
+  }
+
+  void test_consumption_undone_on_backtrack() {
+    CVC4::context::Context context;
+    ConstraintStateTracker tracker(context);
+
+    MockConstraint *constraint = new MockConstraint(2);
+    constraint->initializeCDOs(&context);
+    constraint->registerStateTracker(&tracker);
+    tracker.initialize({constraint});
+
+    constraint->markInfeasiblePhase(static_cast<PhaseStatus>(0));
+    context.push();
+    TS_ASSERT_EQUALS(tracker.popNewlyFixedConstraint(), constraint);
+    TS_ASSERT(!tracker.hasNewlyFixedConstraint());
+    context.pop();
+    // The constraint was fixed at level 0 but consumed at level 1
+    TS_ASSERT(tracker.hasNewlyFixedConstraint());
+    TS_ASSERT_EQUALS(tracker.popNewlyFixedConstraint(), constraint);
+
+    delete constraint;
+  }
+
+  void test_active_constraints() {
+    CVC4::context::Context context;
+    ConstraintStateTracker tracker(context);
+
+    List<PLConstraint *> constraints;
+    for (unsigned i = 0; i < 4; ++i) {
+      MockConstraint *constraint = new MockConstraint(2);
+      constraint->initializeCDOs(&context);
+      constraint->registerStateTracker(&tracker);
+      constraints.append(constraint);
+    }
+    tracker.initialize(constraints);
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 4u);
+
+    auto it = constraints.begin();
+    PLConstraint *first = *it;
+    PLConstraint *second = *(++it);
+
+    context.push();
+    first->setActive(false);
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 3u);
+    // Deactivating twice has no further effect
+    first->setActive(false);
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 3u);
+
+    context.push();
+    second->setActive(false);
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 2u);
+    for (unsigned i = 0; i < tracker.getNumberOfActiveConstraints(); ++i) {
+      TS_ASSERT(tracker.getActiveConstraint(i)->isActive());
+      TS_ASSERT_DIFFERS(tracker.getActiveConstraint(i), first);
+      TS_ASSERT_DIFFERS(tracker.getActiveConstraint(i), second);
+    }
+
+    context.pop();
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 3u);
+    for (unsigned i = 0; i < tracker.getNumberOfActiveConstraints(); ++i)
+      TS_ASSERT_DIFFERS(tracker.getActiveConstraint(i), first);
+
+    context.pop();
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 4u);
+
+    // Deactivation and re-activation at level 0, as done on restart
+    second->setActive(false);
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 3u);
+    second->setActive(true);
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 4u);
+
+    for (const auto &constraint : constraints) delete constraint;
+  }
+
+  void test_add_constraint() {
+    CVC4::context::Context context;
+    ConstraintStateTracker tracker(context);
+
+    MockConstraint *constraint1 = new MockConstraint(2);
+    MockConstraint *constraint2 = new MockConstraint(2);
+    constraint1->initializeCDOs(&context);
+    constraint1->registerStateTracker(&tracker);
+    tracker.initialize({constraint1});
+
+    context.push();
+    constraint1->setActive(false);
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 0u);
+    context.pop();
+
+    // A constraint fixed before it is added is enqueued
+    constraint2->initializeCDOs(&context);
+    constraint2->markInfeasiblePhase(static_cast<PhaseStatus>(0));
+    constraint2->registerStateTracker(&tracker);
+    TS_ASSERT(!tracker.hasNewlyFixedConstraint());
+    TS_ASSERT_THROWS_NOTHING(tracker.addConstraint(constraint2));
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 2u);
+    TS_ASSERT_EQUALS(tracker.popNewlyFixedConstraint(), constraint2);
+
+    context.push();
+    constraint2->setActive(false);
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 1u);
+    TS_ASSERT_EQUALS(tracker.getActiveConstraint(0), constraint1);
+    context.pop();
+    TS_ASSERT_EQUALS(tracker.getNumberOfActiveConstraints(), 2u);
+
+    delete constraint1;
+    delete constraint2;
+  }
+};
@@ -239,6 +239,37 @@ class GurobiWrapperTestSuite : public CxxTest::TestSuite {
       TS_ASSERT(constraints.exists("C1"));
     }
 
+#else
+    TS_ASSERT(true);
+#endif  // ENABLE_GUROBI
+  }
+
+  void test_reuse_environments() {
+#ifdef ENABLE_GUROBI
+    GurobiWrapper::setReuseEnvironments(true);
+    TS_ASSERT_EQUALS(GurobiWrapper::getNumberOfIdleEnvironments(), 0U);
+
+    {
+      GurobiWrapper first;
+      GurobiWrapper second;
+    }
+    TS_ASSERT_EQUALS(GurobiWrapper::getNumberOfIdleEnvironments(), 2U);
+
+    {
+      // Solves as usual with a reused environment
+      GurobiWrapper gurobi;
+      TS_ASSERT_EQUALS(GurobiWrapper::getNumberOfIdleEnvironments(), 1U);
+
+      gurobi.addVariable("x", 0, 3);
+      List<GurobiWrapper::Term> cost = {GurobiWrapper::Term(-1, "x")};
+      gurobi.setCost(cost);
+      TS_ASSERT_THROWS_NOTHING(gurobi.solve());
+      TS_ASSERT(gurobi.optimal());
+    }
+    TS_ASSERT_EQUALS(GurobiWrapper::getNumberOfIdleEnvironments(), 2U);
+
+    GurobiWrapper::setReuseEnvironments(false);
+    TS_ASSERT_EQUALS(GurobiWrapper::getNumberOfIdleEnvironments(), 0U);
 #else
     TS_ASSERT(true);
 #endif  // ENABLE_GUROBI
@@ -158,4 +158,28 @@ class InputQueryTestSuite : public CxxTest::TestSuite {
 
     delete inputQuery;
   }
+
+  void test_pl_constraints_of_single_steps() {
+    InputQuery inputQuery;
+    inputQuery.setNumberOfVariables(7);
+    for (unsigned i = 0; i < 6; ++i) inputQuery.markVariableToStep(i, i / 2);
+
+    PLConstraint *step0 = new OneHotConstraint({0, 1});
+    PLConstraint *acrossSteps = new OneHotConstraint({1, 2});
+    PLConstraint *step2 = new OneHotConstraint({4, 5});
+    PLConstraint *withoutStep = new OneHotConstraint({5, 6});
+    PLConstraint *alsoStep0 = new OneHotConstraint({0, 1});
+    inputQuery.addPLConstraint(step0);
+    inputQuery.addPLConstraint(acrossSteps);
+    inputQuery.addPLConstraint(step2);
+    inputQuery.addPLConstraint(withoutStep);
+    inputQuery.addPLConstraint(alsoStep0);
+
+    Map<unsigned, Vector<PLConstraint *>> constraintsOfStep;
+    inputQuery.getPLConstraintsOfSingleSteps(constraintsOfStep);
+    TS_ASSERT_EQUALS(constraintsOfStep.size(), 2u);
+    TS_ASSERT_EQUALS(constraintsOfStep[0],
+                     Vector<PLConstraint *>({step0, alsoStep0}));
+    TS_ASSERT_EQUALS(constraintsOfStep[2], Vector<PLConstraint *>({step2}));
+  }
 };
@@ -0,0 +1,100 @@
+#include <cxxtest/TestSuite.h>
+
+#include "FloatUtils.h"
+#include "GlobalConfiguration.h"
+#include "MILPCheckScheduler.h"
+
+class MILPCheckSchedulerTestSuite : public CxxTest::TestSuite {
+ public:
+  void test_threshold_without_records() {
+    MILPCheckScheduler scheduler(0.5);
+    scheduler.initialize(10);
+
+    TS_ASSERT(!scheduler.decideToSolveMILP(2));
+    TS_ASSERT(!scheduler.decideToSolveMILP(5));
+    TS_ASSERT(scheduler.decideToSolveMILP(8));
+  }
+
+  void test_records_override_threshold() {
+    MILPCheckScheduler scheduler(0.5);
+    scheduler.initialize(10);
+
+    // At depth 2 the MILP decides every state, the LP none
+    for (unsigned i = 0; i < GlobalConfiguration::MILP_CHECK_MIN_SAMPLES;
+         ++i) {
+      scheduler.recordLPCheck(2, 100, false);
+      scheduler.recordMILPCheck(2, 100, true);
+    }
+    TS_ASSERT(scheduler.decideToSolveMILP(2));
+
+    // A faster LP check that decides as often wins
+    for (unsigned i = 0; i < 2 * GlobalConfiguration::MILP_CHECK_MIN_SAMPLES;
+         ++i)
+      scheduler.recordLPCheck(3, 1, true);
+    TS_ASSERT(!scheduler.decideToSolveMILP(3));
+  }
+
+  void test_records_of_all_depths() {
+    MILPCheckScheduler scheduler(0.5);
+    scheduler.initialize(10);
+
+    for (unsigned i = 0; i < GlobalConfiguration::MILP_CHECK_MIN_SAMPLES;
+         ++i) {
+      scheduler.recordLPCheck(2, 100, true);
+      scheduler.recordMILPCheck(2, 10000, false);
+    }
+
+    // No checks at depth 8: the records over all depths say LP
+    TS_ASSERT(!scheduler.decideToSolveMILP(8));
+  }
+
+  void test_exploration() {
+    MILPCheckScheduler scheduler(0.5);
+    scheduler.initialize(10);
+
+    unsigned period = GlobalConfiguration::MILP_CHECK_EXPLORATION_PERIOD;
+    for (unsigned i = 0; i + 1 < period; ++i)
+      TS_ASSERT(scheduler.decideToSolveMILP(8));
+    TS_ASSERT(!scheduler.decideToSolveMILP(8));
+    TS_ASSERT(scheduler.decideToSolveMILP(8));
+  }
+
+  void test_time_limit() {
+    MILPCheckScheduler scheduler(0.5);
+    scheduler.initialize(10);
+
+    TS_ASSERT(FloatUtils::areEqual(
+        scheduler.getMILPTimeLimit(2),
+        GlobalConfiguration::MILP_CHECK_MIN_TIME_LIMIT));
+
+    // A multiple of the time of an LP check
+    for (unsigned i = 0; i < GlobalConfiguration::MILP_CHECK_MIN_SAMPLES;
+         ++i)
+      scheduler.recordLPCheck(2, 2000, false);
+    TS_ASSERT(FloatUtils::areEqual(
+        scheduler.getMILPTimeLimit(2),
+        0.002 * GlobalConfiguration::MILP_CHECK_TIME_LIMIT_FACTOR));
+
+    for (unsigned i = 0; i < GlobalConfiguration::MILP_CHECK_MIN_SAMPLES;
+         ++i)
+      scheduler.recordLPCheck(8, 10000000, false);
+    TS_ASSERT(FloatUtils::areEqual(
+        scheduler.getMILPTimeLimit(8),
+        GlobalConfiguration::MILP_CHECK_MAX_TIME_LIMIT));
+  }
+
+  void test_initialize_forgets_records() {
+    MILPCheckScheduler scheduler(0.5);
+    scheduler.initialize(10);
+
+    for (unsigned i = 0; i < GlobalConfiguration::MILP_CHECK_MIN_SAMPLES;
+         ++i) {
+      scheduler.recordLPCheck(8, 1, true);
+      scheduler.recordMILPCheck(8, 10000, false);
+    }
+    TS_ASSERT(!scheduler.decideToSolveMILP(8));
+
+    scheduler.initialize(10);
+    TS_ASSERT(scheduler.decideToSolveMILP(8));
+  }
+};
@@ -242,4 +242,304 @@ class MILPEncoderTestSuite : public CxxTest::TestSuite {
     gurobi.solve();
     gurobi.haveFeasibleSolution();
   }
+
+  void populateGatedQuery(InputQuery &inputQuery, BoundManager &bm,
+                          CVC4::context::Context &context) {
+    // OneHot (x0, x1), both fixed to 0.5 in the relaxation
+    // x2 is between 0 and 10
+    //
+    // x2 + 10 x0 <= 12, i.e., x0 = 1 -> x2 <= 2
+    // x2 - 10 x1 >= -5, i.e., x1 = 1 -> x2 >= 5
+    // x0 + x1 = 1
+    inputQuery.setNumberOfVariables(3);
+    inputQuery.setLowerBound(0, 0.5);
+    inputQuery.setUpperBound(0, 0.5);
+    inputQuery.setLowerBound(1, 0.5);
+    inputQuery.setUpperBound(1, 0.5);
+    inputQuery.setLowerBound(2, 0);
+    inputQuery.setUpperBound(2, 10);
+
+    inputQuery.addPLConstraint(new OneHotConstraint({0, 1}));
+    for (const auto &plConstraint : inputQuery.getPLConstraints())
+      plConstraint->initializeCDOs(&context);
+
+    Equation eq1(Equation::LE);
+    eq1.addAddend(1, 2);
+    eq1.addAddend(10, 0);
+    eq1.setScalar(12);
+
+    Equation eq2(Equation::GE);
+    eq2.addAddend(1, 2);
+    eq2.addAddend(-10, 1);
+    eq2.setScalar(-5);
+
+    Equation eq3;
+    eq3.addAddend(1, 0);
+    eq3.addAddend(1, 1);
+    eq3.setScalar(1);
+
+    inputQuery.addEquation(eq1);
+    inputQuery.addEquation(eq2);
+    inputQuery.addEquation(eq3);
+
+    bm.initialize(inputQuery.getNumberOfVariables());
+    for (unsigned i = 0; i < inputQuery.getNumberOfVariables(); ++i) {
+      bm.setLowerBound(i, inputQuery.getLowerBound(i));
+      bm.setUpperBound(i, inputQuery.getUpperBound(i));
+    }
+  }
+
+  void test_encode_hull_formulation() {
+    List<GurobiWrapper::Term> objective;
+    objective.append(GurobiWrapper::Term(1, "x2"));
+
+    {
+      // Big-M: x2 <= 12 - 5
+      InputQuery inputQuery;
+      CVC4::context::Context context;
+      BoundManager bm(context);
+      populateGatedQuery(inputQuery, bm, context);
+      GurobiWrapper gurobi;
+
+      MILPEncoder encoder(bm);
+      encoder.encodeInputQuery(gurobi, inputQuery, true);
+      gurobi.setObjective(objective);
+      gurobi.solve();
+      TS_ASSERT(gurobi.optimal());
+      TS_ASSERT(FloatUtils::areEqual(gurobi.getObjectiveValue(), 7));
+    }
+
+    {
+      // Hull: x2 <= 0.5 * 2 + 0.5 * 10
+      InputQuery inputQuery;
+      CVC4::context::Context context;
+      BoundManager bm(context);
+      populateGatedQuery(inputQuery, bm, context);
+      GurobiWrapper gurobi;
+      Statistics statistics;
+
+      MILPEncoder encoder(bm);
+      encoder.setStatistics(&statistics);
+      encoder.setHullFillIn(10);
+      encoder.encodeInputQuery(gurobi, inputQuery, true);
+      gurobi.setObjective(objective);
+      gurobi.solve();
+      TS_ASSERT(gurobi.optimal());
+      TS_ASSERT(FloatUtils::areEqual(gurobi.getObjectiveValue(), 6));
+      TS_ASSERT_EQUALS(
+          statistics.getUnsignedAttribute(Statistics::HULL_NUM_GROUPS), 1U);
+      TS_ASSERT_EQUALS(statistics.getUnsignedAttribute(
+                           Statistics::HULL_NUM_VARIABLE_COPIES),
+                       2U);
+    }
+
+    {
+      // Over the fill-in limit: big-M
+      InputQuery inputQuery;
+      CVC4::context::Context context;
+      BoundManager bm(context);
+      populateGatedQuery(inputQuery, bm, context);
+      GurobiWrapper gurobi;
+
+      MILPEncoder encoder(bm);
+      encoder.setHullFillIn(1);
+      encoder.encodeInputQuery(gurobi, inputQuery, true);
+      gurobi.setObjective(objective);
+      gurobi.solve();
+      TS_ASSERT(FloatUtils::areEqual(gurobi.getObjectiveValue(), 7));
+    }
+  }
+
+  void test_hull_formulation_after_loosening() {
+    List<GurobiWrapper::Term> objective;
+    objective.append(GurobiWrapper::Term(1, "x2"));
+
+    InputQuery inputQuery;
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    populateGatedQuery(inputQuery, bm, context);
+    GurobiWrapper gurobi;
+
+    MILPEncoder encoder(bm);
+    encoder.setHullFillIn(10);
+    encoder.encodeInputQuery(gurobi, inputQuery, true);
+    TS_ASSERT(encoder.encodingHoldsUnderCurrentBounds());
+
+    // Tightening keeps the encoding valid
+    bm.resetBounds(2, 0, 8);
+    TS_ASSERT(encoder.encodingHoldsUnderCurrentBounds());
+
+    // x2 up to 20: the copies of the encoding stay within [0, 10], x2 <= 6
+    bm.resetBounds(2, 0, 20);
+    TS_ASSERT(!encoder.encodingHoldsUnderCurrentBounds());
+    gurobi.setUpperBound("x2", 20);
+    gurobi.setObjective(objective);
+    gurobi.solve();
+    TS_ASSERT(FloatUtils::areEqual(gurobi.getObjectiveValue(), 6));
+
+    // Encoded again: x2 + 10 x0 <= 12 is not gated by x0 with x2 up to 20,
+    // and x2 <= 7
+    gurobi.resetModel();
+    encoder.reset();
+    encoder.encodeInputQuery(gurobi, inputQuery, true);
+    TS_ASSERT(encoder.encodingHoldsUnderCurrentBounds());
+    gurobi.setObjective(objective);
+    gurobi.solve();
+    TS_ASSERT(FloatUtils::areEqual(gurobi.getObjectiveValue(), 7));
+
+    // Without the hull formulation, the encoding holds under any bounds
+    GurobiWrapper bigM;
+    MILPEncoder bigMEncoder(bm);
+    bigMEncoder.encodeInputQuery(bigM, inputQuery, true);
+    bm.resetBounds(2, -5, 30);
+    TS_ASSERT(bigMEncoder.encodingHoldsUnderCurrentBounds());
+    TS_ASSERT(!encoder.encodingHoldsUnderCurrentBounds());
+  }
+
+  void test_fixed_absolute_value_after_loosening() {
+    // x1 = Abs x0, x0 is between 1 and 4: the positive phase is fixed
+    InputQuery inputQuery;
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    inputQuery.setNumberOfVariables(2);
+    inputQuery.setLowerBound(0, 1);
+    inputQuery.setUpperBound(0, 4);
+    inputQuery.setLowerBound(1, 0);
+    inputQuery.setUpperBound(1, 4);
+
+    AbsoluteValueConstraint *abs = new AbsoluteValueConstraint(0, 1);
+    inputQuery.addPLConstraint(abs);
+    abs->transformToUseAuxVariables(inputQuery);
+    inputQuery.setUpperBound(2, 0);
+    inputQuery.setUpperBound(3, 8);
+    abs->initializeCDOs(&context);
+    for (unsigned variable : abs->getParticipatingVariables()) {
+      abs->notifyLowerBound(variable, inputQuery.getLowerBound(variable));
+      abs->notifyUpperBound(variable, inputQuery.getUpperBound(variable));
+    }
+    TS_ASSERT(abs->phaseFixed());
+
+    bm.initialize(inputQuery.getNumberOfVariables());
+    for (unsigned i = 0; i < inputQuery.getNumberOfVariables(); ++i) {
+      bm.setLowerBound(i, inputQuery.getLowerBound(i));
+      bm.setUpperBound(i, inputQuery.getUpperBound(i));
+    }
+
+    GurobiWrapper gurobi;
+    MILPEncoder encoder(bm);
+    encoder.encodeInputQuery(gurobi, inputQuery, true);
+    TS_ASSERT(encoder.encodingHoldsUnderCurrentBounds());
+
+    // Without big-M rows, the negative phase needs another encoding
+    bm.resetBounds(0, -4, 4);
+    bm.resetBounds(2, 0, 8);
+    TS_ASSERT(!encoder.encodingHoldsUnderCurrentBounds());
+  }
+
+  void test_refresh_absolute_value_big_ms() {
+    // x1 = Abs x0, x0 is between -4 and 4, x1 between 0 and 4
+    InputQuery inputQuery;
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    inputQuery.setNumberOfVariables(2);
+    inputQuery.setLowerBound(0, -4);
+    inputQuery.setUpperBound(0, 4);
+    inputQuery.setLowerBound(1, 0);
+    inputQuery.setUpperBound(1, 4);
+
+    AbsoluteValueConstraint *abs = new AbsoluteValueConstraint(0, 1);
+    inputQuery.addPLConstraint(abs);
+    abs->transformToUseAuxVariables(inputQuery);
+    inputQuery.setUpperBound(2, 8);
+    inputQuery.setUpperBound(3, 8);
+    for (unsigned variable : abs->getParticipatingVariables()) {
+      abs->notifyLowerBound(variable, inputQuery.getLowerBound(variable));
+      abs->notifyUpperBound(variable, inputQuery.getUpperBound(variable));
+    }
+    abs->initializeCDOs(&context);
+
+    bm.initialize(inputQuery.getNumberOfVariables());
+    for (unsigned i = 0; i < inputQuery.getNumberOfVariables(); ++i) {
+      bm.setLowerBound(i, inputQuery.getLowerBound(i));
+      bm.setUpperBound(i, inputQuery.getUpperBound(i));
+    }
+
+    GurobiWrapper gurobi;
+    MILPEncoder encoder(bm);
+    encoder.encodeInputQuery(gurobi, inputQuery, true);
+    gurobi.updateModel();
+    List<GurobiWrapper::Term> objective;
+    objective.append(GurobiWrapper::Term(1, "x1"));
+    gurobi.setObjective(objective);
+
+    // The bounds at the encoding: nothing to refresh
+    TS_ASSERT_EQUALS(encoder.refreshAbsoluteValueBigMs(gurobi), 0U);
+    gurobi.solve();
+    TS_ASSERT(FloatUtils::areEqual(gurobi.getObjectiveValue(), 4));
+
+    // x0 between -1 and 1: both M shrink from 8 to 5, and x1 <= 2.5
+    context.push();
+    bm.setLowerBound(0, -1);
+    bm.setUpperBound(0, 1);
+    gurobi.setLowerBound("x0", -1);
+    gurobi.setUpperBound("x0", 1);
+    TS_ASSERT_EQUALS(encoder.refreshAbsoluteValueBigMs(gurobi), 2U);
+    gurobi.solve();
+    TS_ASSERT(FloatUtils::areEqual(gurobi.getObjectiveValue(), 2.5));
+
+    List<String> rows;
+    encoder.getTightenedAbsoluteValueRows(rows);
+    TS_ASSERT_EQUALS(rows.size(), 2U);
+
+    Map<String, GurobiWrapper::IISBoundType> bounds;
+    bounds["x1"] = GurobiWrapper::IIS_LB;
+    encoder.explainTightenedAbsoluteValueRows({"a0_pos"}, bounds);
+    TS_ASSERT_EQUALS(bounds.size(), 2U);
+    TS_ASSERT_EQUALS(bounds["x0"], GurobiWrapper::IIS_LB);
+    TS_ASSERT_EQUALS(bounds["x1"], GurobiWrapper::IIS_BOTH);
+
+    // Backtracking loosens them back
+    context.pop();
+    gurobi.setLowerBound("x0", -4);
+    gurobi.setUpperBound("x0", 4);
+    TS_ASSERT_EQUALS(encoder.refreshAbsoluteValueBigMs(gurobi), 2U);
+    rows.clear();
+    encoder.getTightenedAbsoluteValueRows(rows);
+    TS_ASSERT(rows.empty());
+    gurobi.solve();
+    TS_ASSERT(FloatUtils::areEqual(gurobi.getObjectiveValue(), 4));
+    TS_ASSERT(encoder.encodingHoldsUnderCurrentBounds());
+
+    // Loosened to an infinite bound from tightened coefficients: those of
+    // the encoding are restored, and the model is to be re-encoded
+    context.push();
+    bm.setLowerBound(0, -1);
+    bm.setUpperBound(0, 1);
+    TS_ASSERT_EQUALS(encoder.refreshAbsoluteValueBigMs(gurobi), 2U);
+    context.pop();
+    bm.resetBounds(0, FloatUtils::negativeInfinity(), 4);
+    TS_ASSERT_EQUALS(encoder.refreshAbsoluteValueBigMs(gurobi), 2U);
+    rows.clear();
+    encoder.getTightenedAbsoluteValueRows(rows);
+    TS_ASSERT(rows.empty());
+    TS_ASSERT(!encoder.encodingHoldsUnderCurrentBounds());
+
+    // Without the refresh, the coefficients of the encoding stay, and the
+    // model is to be re-encoded once a bound is loosened
+    bm.resetBounds(0, -4, 4);
+    GurobiWrapper staticGurobi;
+    MILPEncoder staticEncoder(bm);
+    staticEncoder.setBigMRefresh(false);
+    staticEncoder.encodeInputQuery(staticGurobi, inputQuery, true);
+    staticGurobi.updateModel();
+    context.push();
+    bm.setLowerBound(0, -1);
+    bm.setUpperBound(0, 1);
+    TS_ASSERT_EQUALS(staticEncoder.refreshAbsoluteValueBigMs(staticGurobi),
+                     0U);
+    TS_ASSERT(staticEncoder.encodingHoldsUnderCurrentBounds());
+    context.pop();
+    bm.resetBounds(0, -5, 4);
+    TS_ASSERT(!staticEncoder.encodingHoldsUnderCurrentBounds());
+  }
 };
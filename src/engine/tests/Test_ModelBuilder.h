@@ -0,0 +1,152 @@
+#include <cxxtest/TestSuite.h>
+#include <string.h>
+
+#include "FloatUtils.h"
+#include "InputQuery.h"
+#include "MockErrno.h"
+#include "MockFileFactory.h"
+#include "ModelBuilder.h"
+#include "SoyError.h"
+
+class MockForModelBuilder : public MockFileFactory, public MockErrno {
+ public:
+};
+
+class ModelBuilderTestSuite : public CxxTest::TestSuite {
+ public:
+  MockForModelBuilder *mock;
+
+  void setUp() { TS_ASSERT(mock = new MockForModelBuilder); }
+
+  void tearDown() { TS_ASSERT_THROWS_NOTHING(delete mock); }
+
+  void test_variables() {
+    ModelBuilder builder;
+
+    double lowerBounds[] = {-1, 0, -5};
+    double upperBounds[] = {1, 10, 5};
+    int steps[] = {0, 1, -1};
+    bool isInteger[] = {false, true, false};
+
+    TS_ASSERT_EQUALS(builder.addVariable(-2, 2), 0U);
+    TS_ASSERT_EQUALS(
+        builder.addVariables(3, lowerBounds, upperBounds, steps, isInteger),
+        1U);
+    TS_ASSERT_EQUALS(builder.getNumberOfVariables(), 4U);
+
+    InputQuery inputQuery;
+    TS_ASSERT_THROWS_NOTHING(builder.generateQuery(inputQuery));
+    TS_ASSERT_EQUALS(inputQuery.getNumberOfVariables(), 4U);
+    TS_ASSERT_EQUALS(inputQuery.getLowerBound(0), -2);
+    TS_ASSERT_EQUALS(inputQuery.getUpperBound(3), 5);
+
+    TS_ASSERT(!inputQuery.variableHasStep(0));
+    TS_ASSERT(inputQuery.variableHasStep(1));
+    TS_ASSERT_EQUALS(inputQuery.getStepOfVariable(2), 1U);
+    TS_ASSERT(!inputQuery.variableHasStep(3));
+
+    TS_ASSERT_EQUALS(inputQuery.getPLConstraints().size(), 1U);
+    TS_ASSERT_EQUALS(inputQuery.getPLConstraints().front()->getType(),
+                     INTEGER);
+  }
+
+  void test_rows() {
+    ModelBuilder builder;
+    for (unsigned i = 0; i < 3; ++i) builder.addVariable(0, 10);
+
+    // x0 + 2 x1 = 3, and the CSR rows x1 - x2 >= 0, x0 + x1 + x2 <= 5
+    int indices[] = {0, 1};
+    double values[] = {1, 2};
+    TS_ASSERT_THROWS_NOTHING(
+        builder.addRow(2, indices, values, Equation::EQ, 3));
+
+    int rowStarts[] = {0, 2, 5};
+    int csrIndices[] = {1, 2, 0, 1, 2};
+    double csrValues[] = {1, -1, 1, 1, 1};
+    int types[] = {Equation::GE, Equation::LE};
+    double scalars[] = {0, 5};
+    TS_ASSERT_THROWS_NOTHING(builder.addRows(2, rowStarts, csrIndices,
+                                             csrValues, types, scalars));
+    TS_ASSERT_EQUALS(builder.getNumberOfRows(), 3U);
+
+    InputQuery inputQuery;
+    TS_ASSERT_THROWS_NOTHING(builder.generateQuery(inputQuery));
+
+    const List<Equation> &equations = inputQuery.getEquations();
+    TS_ASSERT_EQUALS(equations.size(), 3U);
+
+    auto it = equations.begin();
+    TS_ASSERT_EQUALS(it->_type, Equation::EQ);
+    TS_ASSERT_EQUALS(it->_addends.size(), 2U);
+    TS_ASSERT_EQUALS(it->getCoefficient(1), 2);
+    TS_ASSERT_EQUALS(it->_scalar, 3);
+
+    ++it;
+    TS_ASSERT_EQUALS(it->_type, Equation::GE);
+    TS_ASSERT_EQUALS(it->_addends.size(), 2U);
+    TS_ASSERT_EQUALS(it->getCoefficient(2), -1);
+    TS_ASSERT_EQUALS(it->_scalar, 0);
+
+    ++it;
+    TS_ASSERT_EQUALS(it->_type, Equation::LE);
+    TS_ASSERT_EQUALS(it->_addends.size(), 3U);
+    TS_ASSERT_EQUALS(it->_scalar, 5);
+  }
+
+  void test_groups() {
+    ModelBuilder builder;
+    for (unsigned i = 0; i < 4; ++i) builder.addVariable(-3, 3, true);
+
+    int oneHot[] = {0, 1};
+    int disjunction[] = {2, 3};
+    TS_ASSERT_THROWS_NOTHING(builder.addOneHot(2, oneHot));
+    TS_ASSERT_THROWS_NOTHING(builder.addDisjunction(2, disjunction));
+
+    InputQuery inputQuery;
+    TS_ASSERT_THROWS_NOTHING(builder.generateQuery(inputQuery));
+
+    // The group members are binary, and no longer integer constraints
+    for (unsigned i = 0; i < 4; ++i) {
+      TS_ASSERT_EQUALS(inputQuery.getLowerBound(i), 0);
+      TS_ASSERT_EQUALS(inputQuery.getUpperBound(i), 1);
+    }
+
+    const List<PLConstraint *> &constraints = inputQuery.getPLConstraints();
+    TS_ASSERT_EQUALS(constraints.size(), 2U);
+    TS_ASSERT_EQUALS(constraints.front()->getType(), ONE_HOT);
+    TS_ASSERT_EQUALS(constraints.back()->getType(), DISJUNCT);
+
+    const List<Equation> &equations = inputQuery.getEquations();
+    TS_ASSERT_EQUALS(equations.size(), 2U);
+    TS_ASSERT_EQUALS(equations.front()._type, Equation::EQ);
+    TS_ASSERT_EQUALS(equations.front()._scalar, 1);
+    TS_ASSERT_EQUALS(equations.back()._type, Equation::GE);
+    TS_ASSERT_EQUALS(equations.back()._scalar, 1);
+  }
+
+  void test_errors() {
+    ModelBuilder builder;
+    builder.addVariable(0, 1);
+
+    int indices[] = {0, 1};
+    double values[] = {1, 1};
+    TS_ASSERT_THROWS_EQUALS(
+        builder.addRow(2, indices, values, Equation::EQ, 1), const SoyError &e,
+        e.getCode(), SoyError::VARIABLE_INDEX_OUT_OF_RANGE);
+
+    int negative[] = {-1};
+    TS_ASSERT_THROWS_EQUALS(builder.addOneHot(1, negative), const SoyError &e,
+                            e.getCode(),
+                            SoyError::VARIABLE_INDEX_OUT_OF_RANGE);
+
+    int rowStarts[] = {0, 1};
+    int types[] = {7};
+    double scalars[] = {0};
+    TS_ASSERT_THROWS_EQUALS(
+        builder.addRows(1, rowStarts, indices, values, types, scalars),
+        const SoyError &e, e.getCode(), SoyError::INVALID_EQUATION_TYPE);
+
+    // A failed row is not added
+    TS_ASSERT_EQUALS(builder.getNumberOfRows(), 0U);
+  }
+};
@@ -0,0 +1,320 @@
+#include <cxxtest/TestSuite.h>
+#include <string.h>
+
+#include "FloatUtils.h"
+#include "InfeasibleQueryException.h"
+#include "InputQuery.h"
+#include "MockErrno.h"
+#include "MockFileFactory.h"
+#include "Presolver.h"
+#include "SolutionHint.h"
+#include "Statistics.h"
+#include "TypedPLConstraints.h"
+
+class MockForPresolver : public MockFileFactory, public MockErrno {
+ public:
+};
+
+class PresolverTestSuite : public CxxTest::TestSuite {
+ public:
+  MockForPresolver *mock;
+
+  void setUp() { TS_ASSERT(mock = new MockForPresolver); }
+
+  void tearDown() { TS_ASSERT_THROWS_NOTHING(delete mock); }
+
+  void addEquation(InputQuery &inputQuery, Equation::EquationType type,
+                   const List<std::pair<unsigned, double>> &addends,
+                   double scalar) {
+    Equation equation(type);
+    for (const auto &addend : addends)
+      equation.addAddend(addend.second, addend.first);
+    equation.setScalar(scalar);
+    inputQuery.addEquation(equation);
+  }
+
+  void test_fixed_variables_and_singleton_rows() {
+    InputQuery inputQuery;
+    inputQuery.setNumberOfVariables(3);
+    for (unsigned i = 0; i < 3; ++i) {
+      inputQuery.setLowerBound(i, -10);
+      inputQuery.setUpperBound(i, 10);
+    }
+    inputQuery.setLowerBound(0, 2);
+    inputQuery.setUpperBound(0, 2);
+
+    // x0 + x1 + x2 = 5, with x0 fixed to 2, and 2 x1 <= 4
+    addEquation(inputQuery, Equation::EQ, {{0, 1}, {1, 1}, {2, 1}}, 5);
+    addEquation(inputQuery, Equation::LE, {{1, 2}}, 4);
+
+    Presolver presolver;
+    Statistics statistics;
+    presolver.setStatistics(&statistics);
+    InputQuery presolved;
+    TS_ASSERT_THROWS_NOTHING(presolver.presolve(inputQuery, presolved));
+
+    TS_ASSERT(presolver.isEliminated(0));
+    TS_ASSERT_EQUALS(presolver.getPresolvedVariable(1), 0U);
+    TS_ASSERT_EQUALS(presolver.getPresolvedVariable(2), 1U);
+
+    Vector<double> presolvedAssignment;
+    presolvedAssignment.append(1);
+    presolvedAssignment.append(2);
+    Vector<double> assignment;
+    presolver.postsolve(presolvedAssignment, assignment);
+    TS_ASSERT_EQUALS(assignment.size(), 3U);
+    TS_ASSERT_EQUALS(assignment[0], 2);
+    TS_ASSERT_EQUALS(assignment[1], 1);
+    TS_ASSERT_EQUALS(assignment[2], 2);
+
+    TS_ASSERT_EQUALS(presolved.getNumberOfVariables(), 2U);
+    TS_ASSERT_EQUALS(presolved.getUpperBound(0), 2);
+    TS_ASSERT_EQUALS(presolved.getLowerBound(0), -10);
+
+    // x1 + x2 = 3
+    const List<Equation> &equations = presolved.getEquations();
+    TS_ASSERT_EQUALS(equations.size(), 1U);
+    TS_ASSERT_EQUALS(equations.front()._type, Equation::EQ);
+    TS_ASSERT_EQUALS(equations.front()._addends.size(), 2U);
+    TS_ASSERT_EQUALS(equations.front()._scalar, 3);
+
+    TS_ASSERT_EQUALS(statistics.getUnsignedAttribute(
+                         Statistics::PRESOLVE_NUM_VARIABLES_REMOVED),
+                     1U);
+    TS_ASSERT_EQUALS(statistics.getUnsignedAttribute(
+                         Statistics::PRESOLVE_NUM_EQUATIONS_REMOVED),
+                     1U);
+    TS_ASSERT_EQUALS(statistics.getUnsignedAttribute(
+                         Statistics::PRESOLVE_NUM_ADDENDS_REMOVED),
+                     1U);
+  }
+
+  void test_duplicate_rows() {
+    InputQuery inputQuery;
+    inputQuery.setNumberOfVariables(4);
+    for (unsigned i = 0; i < 4; ++i) {
+      inputQuery.setLowerBound(i, -10);
+      inputQuery.setUpperBound(i, 10);
+    }
+
+    // x0 - x1 >= 1 and -2 x0 + 2 x1 >= -6 make 1 <= x0 - x1 <= 3
+    addEquation(inputQuery, Equation::GE, {{0, 1}, {1, -1}}, 1);
+    addEquation(inputQuery, Equation::GE, {{1, 2}, {0, -2}}, -6);
+
+    // x2 + x3 <= 4 and 3 x2 + 3 x3 = 6 make x2 + x3 = 2
+    addEquation(inputQuery, Equation::LE, {{2, 1}, {3, 1}}, 4);
+    addEquation(inputQuery, Equation::EQ, {{2, 3}, {3, 3}}, 6);
+
+    Presolver presolver;
+    InputQuery presolved;
+    TS_ASSERT_THROWS_NOTHING(presolver.presolve(inputQuery, presolved));
+    TS_ASSERT_EQUALS(presolved.getNumberOfVariables(), 4U);
+
+    const List<Equation> &equations = presolved.getEquations();
+    TS_ASSERT_EQUALS(equations.size(), 3U);
+
+    auto it = equations.begin();
+    TS_ASSERT_EQUALS(it->_type, Equation::GE);
+    TS_ASSERT_EQUALS(it->getCoefficient(0), 1);
+    TS_ASSERT_EQUALS(it->getCoefficient(1), -1);
+    TS_ASSERT_EQUALS(it->_scalar, 1);
+
+    ++it;
+    TS_ASSERT_EQUALS(it->_type, Equation::EQ);
+    TS_ASSERT_EQUALS(it->getCoefficient(2), 1);
+    TS_ASSERT_EQUALS(it->getCoefficient(3), 1);
+    TS_ASSERT_EQUALS(it->_scalar, 2);
+
+    ++it;
+    TS_ASSERT_EQUALS(it->_type, Equation::LE);
+    TS_ASSERT_EQUALS(it->getCoefficient(0), 1);
+    TS_ASSERT_EQUALS(it->_scalar, 3);
+  }
+
+  void test_rows_implied_by_bounds() {
+    InputQuery inputQuery;
+    inputQuery.setNumberOfVariables(3);
+    for (unsigned i = 0; i < 3; ++i) {
+      inputQuery.setLowerBound(i, 0);
+      inputQuery.setUpperBound(i, 1);
+    }
+    inputQuery.markVariableToStep(2, 4);
+
+    // x0 + x1 <= 2 always holds, x1 - x2 >= 0 does not
+    addEquation(inputQuery, Equation::LE, {{0, 1}, {1, 1}}, 2);
+    addEquation(inputQuery, Equation::GE, {{1, 1}, {2, -1}}, 0);
+
+    Presolver presolver;
+    InputQuery presolved;
+    TS_ASSERT_THROWS_NOTHING(presolver.presolve(inputQuery, presolved));
+
+    // x0 is in no row anymore
+    TS_ASSERT(presolver.isEliminated(0));
+    TS_ASSERT_EQUALS(presolved.getNumberOfVariables(), 2U);
+    TS_ASSERT_EQUALS(presolved.getEquations().size(), 1U);
+
+    TS_ASSERT(!presolved.variableHasStep(0));
+    TS_ASSERT(presolved.variableHasStep(1));
+    TS_ASSERT_EQUALS(presolved.getStepOfVariable(1), 4U);
+  }
+
+  void test_constraints() {
+    InputQuery inputQuery;
+    inputQuery.setNumberOfVariables(5);
+    for (unsigned i = 0; i < 5; ++i) {
+      inputQuery.setLowerBound(i, 0);
+      inputQuery.setUpperBound(i, 1);
+    }
+
+    // x0 is in no row, x1 and x2 are only in the one-hot constraint, which
+    // keeps them, and x3 is an integer fixed to 1
+    inputQuery.setLowerBound(3, 1);
+    Set<unsigned> elements;
+    elements.insert(1);
+    elements.insert(2);
+    inputQuery.addPLConstraint(new OneHotConstraint(elements));
+    inputQuery.addPLConstraint(new IntegerConstraint(3));
+    addEquation(inputQuery, Equation::LE, {{3, 1}, {4, 1}}, 1.5);
+
+    Presolver presolver;
+    InputQuery presolved;
+    TS_ASSERT_THROWS_NOTHING(presolver.presolve(inputQuery, presolved));
+
+    TS_ASSERT(presolver.isEliminated(0));
+    TS_ASSERT(!presolver.isEliminated(3));
+    TS_ASSERT_EQUALS(presolved.getNumberOfVariables(), 3U);
+
+    // x4 <= 0.5 became a bound
+    TS_ASSERT(presolver.isEliminated(4));
+    TS_ASSERT(presolved.getEquations().empty());
+
+    const List<PLConstraint *> &constraints = presolved.getPLConstraints();
+    TS_ASSERT_EQUALS(constraints.size(), 2U);
+    TS_ASSERT_EQUALS(constraints.front()->getType(), ONE_HOT);
+    List<unsigned> variables =
+        constraints.front()->getParticipatingVariables();
+    TS_ASSERT_EQUALS(variables.size(), 2U);
+    TS_ASSERT(variables.exists(0));
+    TS_ASSERT(variables.exists(1));
+    TS_ASSERT_EQUALS(constraints.back()->getType(), INTEGER);
+    TS_ASSERT(constraints.back()->getParticipatingVariables().exists(2));
+
+    // The hint follows the renumbering
+    SolutionHint hint;
+    hint.setValue(0, 1);
+    hint.setValue(2, 1);
+    hint.setMode(0, 1);
+    SolutionHint presolvedHint;
+    presolver.presolveHint(hint, presolvedHint);
+    TS_ASSERT_EQUALS(presolvedHint.getAssignment().size(), 1U);
+    TS_ASSERT_EQUALS(presolvedHint.getAssignment().get(1), 1);
+    TS_ASSERT_EQUALS(presolvedHint.getModes().get(0), 1U);
+  }
+
+  void test_condensing() {
+    // x[t+1] = x[t] + u[t] for t = 0, 1, 2, with x[0] in [0, 1], the inputs
+    // in [-1, 1], the states in [-5, 5], and x[3] >= 2 when d is 1
+    InputQuery inputQuery;
+    inputQuery.setNumberOfVariables(8);
+    for (unsigned t = 0; t < 4; ++t) {
+      inputQuery.setLowerBound(t, -5);
+      inputQuery.setUpperBound(t, 5);
+      inputQuery.markVariableToStep(t, t);
+    }
+    inputQuery.setLowerBound(0, 0);
+    inputQuery.setUpperBound(0, 1);
+    for (unsigned t = 0; t < 3; ++t) {
+      inputQuery.setLowerBound(4 + t, -1);
+      inputQuery.setUpperBound(4 + t, 1);
+      inputQuery.markVariableToStep(4 + t, t);
+      addEquation(inputQuery, Equation::EQ, {{t + 1, 1}, {t, -1}, {4 + t, -1}},
+                  0);
+    }
+    inputQuery.setLowerBound(7, 0);
+    inputQuery.setUpperBound(7, 1);
+    inputQuery.addPLConstraint(new IntegerConstraint(7));
+    addEquation(inputQuery, Equation::GE, {{3, 1}, {7, -7}}, -5);
+
+    Presolver presolver;
+    InputQuery presolved;
+    TS_ASSERT_THROWS_NOTHING(presolver.presolve(inputQuery, presolved));
+    TS_ASSERT_EQUALS(presolved.getNumberOfVariables(), 8U);
+    TS_ASSERT_EQUALS(presolved.getEquations().size(), 4U);
+
+    Statistics statistics;
+    presolver.setStatistics(&statistics);
+    presolver.setMaxFillIn(100);
+    InputQuery condensed;
+    TS_ASSERT_THROWS_NOTHING(presolver.presolve(inputQuery, condensed));
+    TS_ASSERT_EQUALS(statistics.getUnsignedAttribute(
+                         Statistics::PRESOLVE_NUM_VARIABLES_CONDENSED),
+                     3U);
+
+    // The states are expressed in x[0] and the inputs, and the binary is
+    // kept. The state bounds are implied by those of x[0] and the inputs,
+    // so only the row of d is left: x0 + u0 + u1 + u2 - 7 d >= -5.
+    TS_ASSERT(presolver.isEliminated(1));
+    TS_ASSERT(presolver.isEliminated(2));
+    TS_ASSERT(presolver.isEliminated(3));
+    TS_ASSERT(!presolver.isEliminated(7));
+    TS_ASSERT_EQUALS(condensed.getNumberOfVariables(), 5U);
+
+    const List<Equation> &equations = condensed.getEquations();
+    TS_ASSERT_EQUALS(equations.size(), 1U);
+    const Equation &equation = equations.front();
+    TS_ASSERT_EQUALS(equation._type, Equation::GE);
+    TS_ASSERT_EQUALS(equation._addends.size(), 5U);
+    TS_ASSERT(FloatUtils::areEqual(equation.getCoefficient(0), 1));
+    TS_ASSERT(FloatUtils::areEqual(equation.getCoefficient(1), 1));
+    TS_ASSERT(FloatUtils::areEqual(equation.getCoefficient(4), -7));
+    TS_ASSERT(FloatUtils::areEqual(equation._scalar, -5));
+
+    // The states are rebuilt along the horizon
+    Vector<double> presolvedAssignment;
+    presolvedAssignment.append(0.5);
+    presolvedAssignment.append(1);
+    presolvedAssignment.append(0.25);
+    presolvedAssignment.append(-1);
+    presolvedAssignment.append(1);
+    Vector<double> assignment;
+    presolver.postsolve(presolvedAssignment, assignment);
+    TS_ASSERT_EQUALS(assignment.size(), 8U);
+    TS_ASSERT(FloatUtils::areEqual(assignment[1], 1.5));
+    TS_ASSERT(FloatUtils::areEqual(assignment[2], 1.75));
+    TS_ASSERT(FloatUtils::areEqual(assignment[3], 0.75));
+    TS_ASSERT(FloatUtils::areEqual(assignment[7], 1));
+
+    // A limit below the fill-in of the first substitution condenses nothing
+    presolver.setMaxFillIn(2);
+    InputQuery uncondensed;
+    TS_ASSERT_THROWS_NOTHING(presolver.presolve(inputQuery, uncondensed));
+    TS_ASSERT_EQUALS(statistics.getUnsignedAttribute(
+                         Statistics::PRESOLVE_NUM_VARIABLES_CONDENSED),
+                     0U);
+  }
+
+  void test_infeasible() {
+    InputQuery inputQuery;
+    inputQuery.setNumberOfVariables(2);
+    for (unsigned i = 0; i < 2; ++i) {
+      inputQuery.setLowerBound(i, 0);
+      inputQuery.setUpperBound(i, 1);
+    }
+
+    // x0 + x1 >= 3 cannot hold
+    addEquation(inputQuery, Equation::GE, {{0, 1}, {1, 1}}, 3);
+
+    Presolver presolver;
+    InputQuery presolved;
+    TS_ASSERT_THROWS(presolver.presolve(inputQuery, presolved),
+                     const InfeasibleQueryException &);
+
+    // Neither can x0 - x1 >= 0.5 and x0 - x1 <= 0.25
+    InputQuery other;
+    other.setNumberOfVariables(2);
+    addEquation(other, Equation::GE, {{0, 1}, {1, -1}}, 0.5);
+    addEquation(other, Equation::LE, {{0, 2}, {1, -2}}, 0.5);
+    TS_ASSERT_THROWS(presolver.presolve(other, presolved),
+                     const InfeasibleQueryException &);
+  }
+};
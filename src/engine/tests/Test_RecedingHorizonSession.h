@@ -0,0 +1,168 @@
+/*********************                                                        */
+/*! \file Test_RecedingHorizonSession.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Tests of the warm solves of a session against cold solves, on a small
+ ** PWA query over two steps
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include "Engine.h"
+#include "FloatUtils.h"
+#include "InputQuery.h"
+#include "OneHotConstraint.h"
+#include "RecedingHorizonSession.h"
+#include "SoyError.h"
+
+class RecedingHorizonSessionTestSuite : public CxxTest::TestSuite {
+ public:
+  void setUp() {}
+
+  void tearDown() {}
+
+  void addRow(InputQuery &inputQuery, Equation::EquationType type,
+              unsigned state, double coefficientOfMode, unsigned mode,
+              double scalar) {
+    Equation equation(type);
+    equation.addAddend(1, state);
+    equation.addAddend(coefficientOfMode, mode);
+    equation.setScalar(scalar);
+    inputQuery.addEquation(equation);
+  }
+
+  void populateInputQuery(InputQuery &inputQuery) {
+    // The states x0, x1, x2 of steps 0, 1, 2 are between -10 and 10, and
+    // x(t + 1) = x(t) + 1. At steps 0 and 1, OneHot (d0, d1) of the step,
+    // in variables 3, 4 and 5, 6:
+    //
+    // d0 = 1 -> x(t) <= 0: x(t) + 10 d0 <= 10
+    // d1 = 1 -> x(t) >= 1: x(t) - 11 d1 >= -10
+    inputQuery.setNumberOfVariables(7);
+    for (unsigned step = 0; step < 3; ++step) {
+      inputQuery.setLowerBound(step, -10);
+      inputQuery.setUpperBound(step, 10);
+      inputQuery.markVariableToStep(step, step);
+    }
+
+    for (unsigned step = 0; step < 2; ++step) {
+      unsigned d0 = 3 + 2 * step;
+      unsigned d1 = d0 + 1;
+      for (unsigned mode = d0; mode <= d1; ++mode) {
+        inputQuery.setLowerBound(mode, 0);
+        inputQuery.setUpperBound(mode, 1);
+        inputQuery.markVariableToStep(mode, step);
+      }
+      inputQuery.addPLConstraint(new OneHotConstraint({d0, d1}));
+
+      Equation oneHot;
+      oneHot.addAddend(1, d0);
+      oneHot.addAddend(1, d1);
+      oneHot.setScalar(1);
+      inputQuery.addEquation(oneHot);
+
+      addRow(inputQuery, Equation::LE, step, 10, d0, 10);
+      addRow(inputQuery, Equation::GE, step, -11, d1, -10);
+
+      Equation dynamics;
+      dynamics.addAddend(1, step + 1);
+      dynamics.addAddend(-1, step);
+      dynamics.setScalar(1);
+      inputQuery.addEquation(dynamics);
+    }
+  }
+
+  // Solve the query from scratch with the initial state x0 fixed to value
+  Engine::ExitCode solveCold(double value, Vector<double> &states) {
+    InputQuery inputQuery;
+    populateInputQuery(inputQuery);
+    inputQuery.setLowerBound(0, value);
+    inputQuery.setUpperBound(0, value);
+
+    Engine engine;
+    if (!engine.processInputQuery(inputQuery, false)) return Engine::UNSAT;
+    engine.solve();
+    states.clear();
+    if (engine.getExitCode() == Engine::SAT)
+      for (unsigned step = 0; step < 3; ++step)
+        states.append(engine.getAssignment(step));
+    return engine.getExitCode();
+  }
+
+  // Solve the session with x0 fixed to value, and compare with a cold solve
+  void solveAndCompare(RecedingHorizonSession &session, double value,
+                       Engine::ExitCode expected) {
+    session.updateBounds(0, value, value);
+    TS_ASSERT_EQUALS(session.solve(), expected);
+
+    Vector<double> states;
+    TS_ASSERT_EQUALS(solveCold(value, states), expected);
+    if (expected == Engine::SAT)
+      for (unsigned step = 0; step < 3; ++step)
+        TS_ASSERT(FloatUtils::areEqual(session.getAssignment(step),
+                                       states[step], 0.0001));
+  }
+
+  OneHotConstraint *getConstraintOfStep(RecedingHorizonSession &session,
+                                        unsigned step) {
+    for (const auto &plConstraint :
+         session.getEngine().getInputQuery()->getPLConstraints())
+      if (plConstraint->participatingVariable(3 + 2 * step))
+        return static_cast<OneHotConstraint *>(plConstraint);
+    return NULL;
+  }
+
+  void test_shifted_phase_pattern() {
+    InputQuery inputQuery;
+    populateInputQuery(inputQuery);
+    inputQuery.setLowerBound(0, 0);
+    inputQuery.setUpperBound(0, 0);
+    RecedingHorizonSession session(inputQuery, {0});
+
+    // x0 = 0 and x1 = 1: d0 holds at step 0 and d1 at step 1
+    TS_ASSERT_EQUALS(session.solve(), Engine::SAT);
+    OneHotConstraint *first = getConstraintOfStep(session, 0);
+    OneHotConstraint *second = getConstraintOfStep(session, 1);
+    TS_ASSERT(first && second);
+    TS_ASSERT(FloatUtils::areEqual(session.getAssignment(3), 1));
+    TS_ASSERT(FloatUtils::areEqual(session.getAssignment(6), 1));
+
+    // Step 0 takes the phase of step 1, and the last step keeps its own
+    const Map<PLConstraint *, PhaseStatus> &pattern =
+        session.getShiftedPhasePattern();
+    TS_ASSERT_EQUALS(pattern.size(), 2u);
+    TS_ASSERT_EQUALS(pattern[first], first->getPhaseOfElement(4));
+    TS_ASSERT_EQUALS(pattern[second], second->getPhaseOfElement(6));
+  }
+
+  void test_warm_solves_match_cold_solves() {
+    InputQuery inputQuery;
+    populateInputQuery(inputQuery);
+    RecedingHorizonSession session(inputQuery, {0});
+
+    solveAndCompare(session, 0, Engine::SAT);
+    solveAndCompare(session, -1, Engine::SAT);
+    // Between the regions of the modes
+    solveAndCompare(session, 0.5, Engine::UNSAT);
+    TS_ASSERT(session.getShiftedPhasePattern().empty());
+    solveAndCompare(session, 4, Engine::SAT);
+    solveAndCompare(session, 0, Engine::SAT);
+
+    TS_ASSERT_EQUALS(session.getNumberOfSolves(), 5u);
+    TS_ASSERT_EQUALS(session.getSolveTimesMicro().size(), 5u);
+  }
+
+  void test_only_state_bounds_are_updated() {
+    InputQuery inputQuery;
+    populateInputQuery(inputQuery);
+    RecedingHorizonSession session(inputQuery, {0});
+    TS_ASSERT_THROWS_EQUALS(
+        session.updateBounds(1, 0, 0), const SoyError &e, e.getCode(),
+        SoyError::UPDATING_BOUNDS_OF_NON_STATE_VARIABLE);
+  }
+};
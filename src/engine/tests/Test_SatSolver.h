@@ -41,6 +41,32 @@ class SatSolverTestSuite : public CxxTest::TestSuite {
     TS_ASSERT(solver.getLiteralStatus(2) == UNFIXED);
   }
 
+  void test_backtrack_clauses() {
+    // 1 2 0
+    // --- mark
+    // -1 0
+    // -2 0
+    CadicalWrapper solver;
+    for (unsigned i = 1; i <= 2; ++i) solver.getFreshVariable();
+
+    solver.addConstraint({1, 2});
+    unsigned mark = solver.getClauseMark();
+    solver.addConstraint({-1});
+    solver.addConstraint({-2});
+
+    TS_ASSERT_THROWS_NOTHING(solver.solve());
+    TS_ASSERT(solver.infeasible());
+
+    TS_ASSERT_THROWS_NOTHING(solver.backtrackClauses(mark));
+    TS_ASSERT_EQUALS(solver.getClauseMark(), mark);
+    TS_ASSERT_THROWS_NOTHING(solver.solve());
+    TS_ASSERT(solver.haveFeasibleSolution());
+
+    solver.addConstraint({-1});
+    TS_ASSERT_THROWS_NOTHING(solver.solve());
+    TS_ASSERT_EQUALS(solver.getLiteralStatus(2), TRUE);
+  }
+
   void test_fixed_with_solve() {
     // -1 2 3 0
     // -1 -2 0
@@ -0,0 +1,90 @@
+/*********************                                                        */
+/*! \file HintParser.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#include "HintParser.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+#include "CommonError.h"
+#include "File.h"
+#include "InputParserError.h"
+#include "SolutionHint.h"
+
+namespace {
+double parseNumber(const String &token, const String &line) {
+  char *rest;
+  double value = strtod(token.ascii(), &rest);
+  if (rest == token.ascii() || *rest != '\0')
+    throw InputParserError(InputParserError::UNEXPECTED_INPUT, line.ascii());
+  return value;
+}
+
+unsigned parseUnsigned(const String &token, const String &line) {
+  double value = parseNumber(token, line);
+  if (!(value >= 0 && value <= UINT_MAX && value == floor(value)))
+    throw InputParserError(InputParserError::UNEXPECTED_INPUT, line.ascii());
+  return value;
+}
+}  // namespace
+
+HintParser::HintParser(const String &path) { parse(path); }
+
+void HintParser::parse(const String &path) {
+  if (!File::exists(path))
+    throw InputParserError(InputParserError::FILE_DOESNT_EXIST, path.ascii());
+
+  File file(path);
+  file.open(IFile::MODE_READ);
+
+  while (true) {
+    String line;
+    try {
+      line = file.readLine();
+    } catch (const CommonError &e) {
+      // Reading past the end of the file
+      if (e.getCode() == CommonError::READ_FAILED) break;
+      throw;
+    }
+    parseLine(line);
+  }
+}
+
+void HintParser::parseLine(const String &line) {
+  List<String> tokens = line.tokenize("\t\r\n ");
+  if (tokens.empty() || tokens.begin()->ascii()[0] == '#') return;
+
+  auto it = tokens.begin();
+  if (*it == "mode") {
+    if (tokens.size() != 3)
+      throw InputParserError(InputParserError::UNEXPECTED_INPUT, line.ascii());
+    unsigned step = parseUnsigned(*(++it), line);
+    unsigned mode = parseUnsigned(*(++it), line);
+    _modeOfStep[step] = mode;
+  } else if (tokens.size() == 2) {
+    String name = *it;
+    _valueOfName[name] = parseNumber(*(++it), line);
+  } else {
+    throw InputParserError(InputParserError::UNEXPECTED_INPUT, line.ascii());
+  }
+}
+
+void HintParser::generateHint(const Map<String, unsigned> &variableNames,
+                              SolutionHint &hint) const {
+  hint.clear();
+  for (const auto &pair : _valueOfName) {
+    if (!variableNames.exists(pair.first))
+      throw InputParserError(InputParserError::UNKNOWN_VARIABLE_NAME,
+                             pair.first.ascii());
+    hint.setValue(variableNames[pair.first], pair.second);
+  }
+  for (const auto &pair : _modeOfStep) hint.setMode(pair.first, pair.second);
+}
@@ -0,0 +1,50 @@
+/*********************                                                        */
+/*! \file HintParser.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Reads a solution hint from a file with one entry per line:
+ **
+ **   <variable name> <value>     the value of a variable, in the format of
+ **                               the --solution-file output, and
+ **   mode <step> <index>         the mode of a step, the index of the phase
+ **                               of its constraints.
+ **
+ ** Empty lines and lines starting with '#' are skipped. Any subset of the
+ ** variables and steps can be given. A malformed line, e.g., with a value
+ ** that is not a number, is an InputParserError.
+ **/
+
+#ifndef __HintParser_h__
+#define __HintParser_h__
+
+#include "MString.h"
+#include "Map.h"
+
+class SolutionHint;
+
+class HintParser {
+ public:
+  HintParser(const String &path);
+
+  /*
+    Extract the hint over the variables of the query, by name, e.g., from
+    MpsParser::getVariableNameToVariableIndex(). Throws an InputParserError
+    if a variable is unknown.
+  */
+  void generateHint(const Map<String, unsigned> &variableNames,
+                    SolutionHint &hint) const;
+
+ private:
+  void parse(const String &path);
+  void parseLine(const String &line);
+
+  Map<String, double> _valueOfName;
+  Map<unsigned, unsigned> _modeOfStep;
+};
+
+#endif  // __HintParser_h__
@@ -27,6 +27,7 @@ class InputParserError : public Error {
     UNSUPPORTED_BOUND_TYPE = 3,
     MULTIPLE_OBJECTIVES = 4,
     UNSUPPORT_PIECEWISE_LINEAR_CONSTRAINT = 5,
+    UNKNOWN_VARIABLE_NAME = 6,
   };
 
   InputParserError(InputParserError::Code code)
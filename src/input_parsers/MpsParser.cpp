@@ -472,6 +472,6 @@ void MpsParser::addPLConstraints(InputQuery &inputQuery) const {
 }
 
 unsigned MpsParser::variableToStep(String name) {
-  auto s = name.tokenize("[").begin()->tokenize("@").rbegin()->ascii();
-  return atoi(s);
+  String step = *name.tokenize("[").begin()->tokenize("@").rbegin();
+  return atoi(step.ascii());
 }
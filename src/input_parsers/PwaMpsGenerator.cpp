@@ -0,0 +1,391 @@
+/*********************                                                        */
+/*! \file PwaMpsGenerator.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** [[ Add lengthier description here ]]
+ **/
+
+#include "PwaMpsGenerator.h"
+
+#include <cmath>
+#include <string>
+
+#include "File.h"
+#include "InputParserError.h"
+#include "MStringf.h"
+
+PwaMpsGenerator::PwaMpsGenerator(const Parameters &parameters)
+    : _parameters(parameters), _random(parameters._seed) {
+  if (_parameters._horizon == 0 || _parameters._stateDimension == 0 ||
+      _parameters._numberOfModes == 0)
+    throw InputParserError(
+        InputParserError::UNEXPECTED_INPUT,
+        "horizon, state dimension and number of modes must be positive");
+
+  if (_parameters._unsatBias < 0 || _parameters._unsatBias > 1)
+    throw InputParserError(InputParserError::UNEXPECTED_INPUT,
+                           "the UNSAT bias must be in [0, 1]");
+
+  if (_parameters._stateBound <= 0 || _parameters._inputBound < 0)
+    throw InputParserError(InputParserError::UNEXPECTED_INPUT,
+                           "the state bound must be positive");
+}
+
+PwaMpsGenerator::RegionGeometry PwaMpsGenerator::parseGeometry(
+    const String &name) {
+  if (name == "slabs")
+    return SLABS;
+  else if (name == "voronoi")
+    return VORONOI;
+  throw InputParserError(InputParserError::UNEXPECTED_INPUT, name.ascii());
+}
+
+double PwaMpsGenerator::uniform(double low, double high) {
+  // Not std::uniform_real_distribution, whose output differs across standard
+  // libraries. Rounded so that the MPS file holds the exact values.
+  double unit = _random() / 4294967296.0;
+  return std::round((low + (high - low) * unit) * 1000) / 1000;
+}
+
+void PwaMpsGenerator::generateModes(Vector<Mode> &modes) {
+  unsigned n = _parameters._stateDimension;
+  unsigned k = _parameters._inputDimension;
+
+  for (unsigned m = 0; m < _parameters._numberOfModes; ++m) {
+    Mode mode;
+    for (unsigned i = 0; i < n; ++i) {
+      // Diagonally dominant, so that the modes are neither too stable nor
+      // too unstable
+      Vector<double> row;
+      for (unsigned j = 0; j < n; ++j)
+        row.append(i == j ? uniform(0.7, 1.1) : uniform(-0.3 / n, 0.3 / n));
+      mode._A.append(row);
+
+      row.clear();
+      for (unsigned j = 0; j < k; ++j) row.append(uniform(-1, 1));
+      mode._B.append(row);
+
+      mode._c.append(uniform(-0.5, 0.5));
+    }
+    modes.append(mode);
+  }
+}
+
+void PwaMpsGenerator::generateRegions(Vector<Mode> &modes) {
+  unsigned n = _parameters._stateDimension;
+  unsigned numberOfModes = _parameters._numberOfModes;
+  double X = _parameters._stateBound;
+
+  if (_parameters._geometry == SLABS) {
+    double width = 2 * X / numberOfModes;
+    for (unsigned m = 0; m < numberOfModes; ++m) {
+      Halfspace halfspace;
+      for (unsigned i = 0; i < n; ++i) halfspace._coefficients.append(0);
+
+      // lower <= x_0 <= upper; the outer faces are implied by the bounds
+      if (m > 0) {
+        halfspace._coefficients[0] = -1;
+        halfspace._scalar = X - m * width;
+        modes[m]._region.append(halfspace);
+      }
+      if (m + 1 < numberOfModes) {
+        halfspace._coefficients[0] = 1;
+        halfspace._scalar = -X + (m + 1) * width;
+        modes[m]._region.append(halfspace);
+      }
+    }
+  } else {
+    Vector<Vector<double>> centers;
+    for (unsigned m = 0; m < numberOfModes; ++m) {
+      Vector<double> center;
+      for (unsigned i = 0; i < n; ++i) center.append(uniform(-X, X));
+      centers.append(center);
+    }
+
+    // x is closer to c_m than to c_o:
+    //   2 (c_o - c_m) . x <= |c_o|^2 - |c_m|^2
+    for (unsigned m = 0; m < numberOfModes; ++m) {
+      for (unsigned o = 0; o < numberOfModes; ++o) {
+        if (o == m) continue;
+        Halfspace halfspace;
+        halfspace._scalar = 0;
+        for (unsigned i = 0; i < n; ++i) {
+          halfspace._coefficients.append(2 * (centers[o][i] - centers[m][i]));
+          halfspace._scalar +=
+              centers[o][i] * centers[o][i] - centers[m][i] * centers[m][i];
+        }
+        modes[m]._region.append(halfspace);
+      }
+    }
+  }
+}
+
+double PwaMpsGenerator::generateInitialState() {
+  double magnitude = _parameters._stateBound *
+                     (0.2 + 0.6 * _parameters._unsatBias) * uniform(0.8, 1);
+  return uniform(0, 1) < 0.5 ? -magnitude : magnitude;
+}
+
+unsigned PwaMpsGenerator::addColumn(const String &name, double lower,
+                                    double upper, bool isBinary) {
+  Column column;
+  column._name = name;
+  column._lowerBound = lower;
+  column._upperBound = upper;
+  column._isBinary = isBinary;
+  _columns.append(column);
+  return _columns.size() - 1;
+}
+
+unsigned PwaMpsGenerator::addRow(const String &name, char type, double rhs) {
+  Row row;
+  row._name = name;
+  row._type = type;
+  row._rhs = rhs;
+  _rows.append(row);
+  return _rows.size() - 1;
+}
+
+void PwaMpsGenerator::addEntry(unsigned row, unsigned column,
+                               double coefficient) {
+  if (coefficient == 0) return;
+  Entry entry;
+  entry._row = row;
+  entry._coefficient = coefficient;
+  _columns[column]._entries.append(entry);
+}
+
+String PwaMpsGenerator::generate() {
+  _random.seed(_parameters._seed);
+  _rows.clear();
+  _columns.clear();
+
+  unsigned N = _parameters._horizon;
+  unsigned n = _parameters._stateDimension;
+  unsigned k = _parameters._inputDimension;
+  unsigned numberOfModes = _parameters._numberOfModes;
+  double X = _parameters._stateBound;
+  double U = _parameters._inputBound;
+  double bias = _parameters._unsatBias;
+
+  Vector<Mode> modes;
+  generateModes(modes);
+  generateRegions(modes);
+
+  // The columns: the states x<i>@<t>, the inputs u<i>@<t> and the mode
+  // binaries d<m>@<t>, with the binaries last so that they form a single
+  // integer block
+  double targetRadius = std::round(X * 0.5 * (1 - bias) * 1000) / 1000;
+  Vector<Vector<unsigned>> x;
+  for (unsigned t = 0; t <= N; ++t) {
+    Vector<unsigned> step;
+    for (unsigned i = 0; i < n; ++i) {
+      double lower = -X;
+      double upper = X;
+      if (t == 0) {
+        lower = upper = generateInitialState();
+      } else if (t == N) {
+        lower = -targetRadius;
+        upper = targetRadius;
+      }
+      step.append(addColumn(Stringf("x%u@%u", i, t), lower, upper, false));
+    }
+    x.append(step);
+  }
+
+  Vector<Vector<unsigned>> u;
+  for (unsigned t = 0; t < N; ++t) {
+    Vector<unsigned> step;
+    for (unsigned i = 0; i < k; ++i)
+      step.append(addColumn(Stringf("u%u@%u", i, t), -U, U, false));
+    u.append(step);
+  }
+
+  Vector<Vector<unsigned>> d;
+  for (unsigned t = 0; t < N; ++t) {
+    Vector<unsigned> step;
+    for (unsigned m = 0; m < numberOfModes; ++m)
+      step.append(addColumn(Stringf("d%u@%u", m, t), 0, 1, true));
+    d.append(step);
+  }
+
+  addRow("obj", 'N', 0);
+
+  for (unsigned t = 0; t < N; ++t) {
+    // Exactly one mode is active
+    unsigned oneHot = addRow(Stringf("onehot_%u", t), 'E', 1);
+    for (unsigned m = 0; m < numberOfModes; ++m) addEntry(oneHot, d[t][m], 1);
+
+    for (unsigned m = 0; m < numberOfModes; ++m) {
+      const Mode &mode = modes[m];
+
+      // d = 1 -> h . x[t] <= g, relaxed by M (1 - d)
+      for (unsigned j = 0; j < mode._region.size(); ++j) {
+        const Halfspace &halfspace = mode._region[j];
+        double M = -halfspace._scalar;
+        for (unsigned i = 0; i < n; ++i)
+          M += std::fabs(halfspace._coefficients[i]) * X;
+        // The bounds alone imply the halfspace
+        if (M <= 0) continue;
+
+        unsigned row = addRow(Stringf("region_%u_%u_%u", t, m, j), 'L',
+                              halfspace._scalar + M);
+        for (unsigned i = 0; i < n; ++i)
+          addEntry(row, x[t][i], halfspace._coefficients[i]);
+        addEntry(row, d[t][m], M);
+      }
+
+      // d = 1 -> x[t+1] = A x[t] + B u[t] + c, relaxed by M (1 - d)
+      for (unsigned i = 0; i < n; ++i) {
+        double M = X + std::fabs(mode._c[i]);
+        for (unsigned j = 0; j < n; ++j) M += std::fabs(mode._A[i][j]) * X;
+        for (unsigned j = 0; j < k; ++j) M += std::fabs(mode._B[i][j]) * U;
+
+        unsigned upper = addRow(Stringf("dyn_ub_%u_%u_%u", t, m, i), 'L',
+                                mode._c[i] + M);
+        unsigned lower = addRow(Stringf("dyn_lb_%u_%u_%u", t, m, i), 'G',
+                                mode._c[i] - M);
+        for (unsigned row : {upper, lower}) {
+          addEntry(row, x[t + 1][i], 1);
+          for (unsigned j = 0; j < n; ++j)
+            addEntry(row, x[t][j], -mode._A[i][j]);
+          for (unsigned j = 0; j < k; ++j)
+            addEntry(row, u[t][j], -mode._B[i][j]);
+        }
+        addEntry(upper, d[t][m], M);
+        addEntry(lower, d[t][m], -M);
+      }
+    }
+  }
+
+  return toMps();
+}
+
+String PwaMpsGenerator::toMps() const {
+  // Built in a std::string, which appends in place
+  std::string mps;
+  mps += Stringf("NAME          pwa_mpc_%u\n", _parameters._seed).ascii();
+
+  mps += "ROWS\n";
+  for (const auto &row : _rows)
+    mps += Stringf(" %c  %s\n", row._type, row._name.ascii()).ascii();
+
+  mps += "COLUMNS\n";
+  bool markingInteger = false;
+  for (const auto &column : _columns) {
+    if (column._isBinary != markingInteger) {
+      markingInteger = column._isBinary;
+      mps += Stringf("    MARKER    'MARKER'    '%s'\n",
+                     markingInteger ? "INTORG" : "INTEND")
+                 .ascii();
+    }
+    for (const auto &entry : column._entries)
+      mps += Stringf("    %-12s %-20s %.10g\n", column._name.ascii(),
+                     _rows[entry._row]._name.ascii(), entry._coefficient)
+                 .ascii();
+  }
+  if (markingInteger) mps += "    MARKER    'MARKER'    'INTEND'\n";
+
+  mps += "RHS\n";
+  for (const auto &row : _rows) {
+    if (row._type == 'N' || row._rhs == 0) continue;
+    mps += Stringf("    rhs          %-20s %.10g\n", row._name.ascii(),
+                   row._rhs)
+               .ascii();
+  }
+
+  mps += "BOUNDS\n";
+  for (const auto &column : _columns) {
+    const char *name = column._name.ascii();
+    if (column._lowerBound == column._upperBound) {
+      mps += Stringf(" FX bnd       %-12s %.10g\n", name, column._lowerBound)
+                 .ascii();
+    } else {
+      mps += Stringf(" LO bnd       %-12s %.10g\n", name, column._lowerBound)
+                 .ascii();
+      mps += Stringf(" UP bnd       %-12s %.10g\n", name, column._upperBound)
+                 .ascii();
+    }
+  }
+  mps += "ENDATA\n";
+
+  return String(mps);
+}
+
+String PwaMpsGenerator::generatePwa() {
+  _random.seed(_parameters._seed);
+
+  unsigned n = _parameters._stateDimension;
+  unsigned k = _parameters._inputDimension;
+  double X = _parameters._stateBound;
+  double U = _parameters._inputBound;
+
+  Vector<Mode> modes;
+  generateModes(modes);
+  generateRegions(modes);
+
+  // Drawn in the order of generate(), so that both describe the same problem
+  Vector<double> initialState;
+  for (unsigned i = 0; i < n; ++i) initialState.append(generateInitialState());
+  double targetRadius =
+      std::round(X * 0.5 * (1 - _parameters._unsatBias) * 1000) / 1000;
+
+  auto line = [](const char *keyword, const Vector<double> &values) {
+    std::string text = keyword;
+    for (const auto &value : values) text += Stringf(" %.10g", value).ascii();
+    return text + "\n";
+  };
+  auto repeat = [](unsigned count, double value) {
+    Vector<double> values;
+    for (unsigned i = 0; i < count; ++i) values.append(value);
+    return values;
+  };
+
+  std::string pwa;
+  pwa += Stringf("# pwa_mpc_%u\n", _parameters._seed).ascii();
+  pwa += Stringf("states %u\ninputs %u\nhorizon %u\n", n, k,
+                 _parameters._horizon)
+             .ascii();
+  pwa += line("state_lower", repeat(n, -X));
+  pwa += line("state_upper", repeat(n, X));
+  pwa += line("input_lower", repeat(k, -U));
+  pwa += line("input_upper", repeat(k, U));
+  pwa += line("initial_lower", initialState);
+  pwa += line("initial_upper", initialState);
+  pwa += line("target_lower", repeat(n, -targetRadius));
+  pwa += line("target_upper", repeat(n, targetRadius));
+
+  for (const auto &mode : modes) {
+    Vector<double> A;
+    Vector<double> B;
+    for (unsigned i = 0; i < n; ++i) {
+      for (const auto &value : mode._A[i]) A.append(value);
+      for (const auto &value : mode._B[i]) B.append(value);
+    }
+    pwa += "mode\n";
+    pwa += line("A", A);
+    pwa += line("B", B);
+    pwa += line("c", mode._c);
+    for (const auto &halfspace : mode._region) {
+      Vector<double> values = halfspace._coefficients;
+      values.append(halfspace._scalar);
+      pwa += line("region", values);
+    }
+  }
+
+  return String(pwa);
+}
+
+void PwaMpsGenerator::writeToFile(const String &path) {
+  bool isPwa =
+      path.length() > 4 && path.substring(path.length() - 4, 4) == ".pwa";
+  String contents = isPwa ? generatePwa() : generate();
+  File file(path);
+  file.open(File::MODE_WRITE_TRUNCATE);
+  file.write(contents);
+}
@@ -0,0 +1,145 @@
+/*********************                                                        */
+/*! \file PwaMpsGenerator.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Generates random model-predictive-control problems over piecewise-affine
+ ** (PWA) systems, in the MPS dialect read by MpsParser:
+ **
+ **   x[t+1] = A_m x[t] + B_m u[t] + c_m   if x[t] is in region m
+ **
+ ** for t = 0, ..., horizon - 1. The regions partition the state box. The
+ ** active mode of each step is encoded by binaries d<m>@<t> that form a
+ ** one-hot row, and the dynamics and region rows are enforced by big-M
+ ** constraints on those binaries. Every variable name carries an @<step>
+ ** suffix, which MpsParser uses to assign variables to steps.
+ **
+ ** The initial state is fixed and the final state must lie in a box around
+ ** the origin. The UNSAT bias moves the initial state away from the origin
+ ** and shrinks the target box, making infeasible instances more likely.
+ **/
+
+#ifndef __PwaMpsGenerator_h__
+#define __PwaMpsGenerator_h__
+
+#include <random>
+
+#include "MString.h"
+#include "Vector.h"
+
+class PwaMpsGenerator {
+ public:
+  enum RegionGeometry {
+    // Slabs of equal width along the first state dimension
+    SLABS = 0,
+    // The Voronoi cells of random centers in the state box
+    VORONOI = 1,
+  };
+
+  struct Parameters {
+    Parameters()
+        : _horizon(10),
+          _stateDimension(2),
+          _inputDimension(1),
+          _numberOfModes(3),
+          _geometry(SLABS),
+          _seed(1),
+          _unsatBias(0.5),
+          _stateBound(10),
+          _inputBound(1) {}
+
+    unsigned _horizon;
+    unsigned _stateDimension;
+    unsigned _inputDimension;
+    unsigned _numberOfModes;
+    RegionGeometry _geometry;
+    unsigned _seed;
+    // In [0, 1]
+    double _unsatBias;
+    // The box |x_i| <= _stateBound, |u_i| <= _inputBound
+    double _stateBound;
+    double _inputBound;
+  };
+
+  PwaMpsGenerator(const Parameters &parameters);
+
+  /*
+    The problem, as the contents of an MPS file. The same parameters always
+    produce the same problem.
+  */
+  String generate();
+
+  /*
+    The same problem, as the contents of a native .pwa file (see PwaParser),
+    which describes the system once instead of per step.
+  */
+  String generatePwa();
+
+  /*
+    Write the problem in the native format if the path ends with .pwa, and
+    in MPS format otherwise.
+  */
+  void writeToFile(const String &path);
+
+  /*
+    "slabs" or "voronoi"; throws InputParserError otherwise.
+  */
+  static RegionGeometry parseGeometry(const String &name);
+
+ private:
+  // The row a . x <= b over the state variables of a step
+  struct Halfspace {
+    Vector<double> _coefficients;
+    double _scalar;
+  };
+
+  struct Mode {
+    Vector<Vector<double>> _A;
+    Vector<Vector<double>> _B;
+    Vector<double> _c;
+    Vector<Halfspace> _region;
+  };
+
+  Parameters _parameters;
+  std::mt19937 _random;
+
+  // The problem, collected per column before being written
+  struct Row {
+    String _name;
+    char _type;
+    double _rhs;
+  };
+  struct Entry {
+    unsigned _row;
+    double _coefficient;
+  };
+  struct Column {
+    String _name;
+    Vector<Entry> _entries;
+    double _lowerBound;
+    double _upperBound;
+    bool _isBinary;
+  };
+  Vector<Row> _rows;
+  Vector<Column> _columns;
+
+  double uniform(double low, double high);
+
+  void generateModes(Vector<Mode> &modes);
+  void generateRegions(Vector<Mode> &modes);
+  // The fixed initial state, drawn after the modes and the regions
+  double generateInitialState();
+
+  unsigned addColumn(const String &name, double lower, double upper,
+                     bool isBinary);
+  unsigned addRow(const String &name, char type, double rhs);
+  void addEntry(unsigned row, unsigned column, double coefficient);
+
+  String toMps() const;
+};
+
+#endif  // __PwaMpsGenerator_h__
@@ -0,0 +1,363 @@
+/*********************                                                        */
+/*! \file PwaParser.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#include "PwaParser.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+#include "CommonError.h"
+#include "File.h"
+#include "InputParserError.h"
+#include "InputQuery.h"
+#include "MStringf.h"
+#include "ModelBuilder.h"
+#include "Set.h"
+
+namespace {
+// The largest value of sum_j a_j v_j over the box lower <= v <= upper
+double maximum(const double *coefficients, const Vector<double> &lower,
+               const Vector<double> &upper) {
+  double value = 0;
+  for (unsigned j = 0; j < lower.size(); ++j)
+    value += coefficients[j] * (coefficients[j] > 0 ? upper[j] : lower[j]);
+  return value;
+}
+
+double minimum(const double *coefficients, const Vector<double> &lower,
+               const Vector<double> &upper) {
+  double value = 0;
+  for (unsigned j = 0; j < lower.size(); ++j)
+    value += coefficients[j] * (coefficients[j] > 0 ? lower[j] : upper[j]);
+  return value;
+}
+}  // namespace
+
+PwaParser::PwaParser(const String &path)
+    : _stateDimension(0), _inputDimension(0), _horizon(0) {
+  parse(path);
+  checkSystem();
+}
+
+void PwaParser::parse(const String &path) {
+  if (!File::exists(path))
+    throw InputParserError(InputParserError::FILE_DOESNT_EXIST, path.ascii());
+
+  File file(path);
+  file.open(IFile::MODE_READ);
+
+  while (true) {
+    String line;
+    try {
+      line = file.readLine();
+    } catch (const CommonError &e) {
+      // Reading past the end of the file
+      if (e.getCode() == CommonError::READ_FAILED) break;
+      throw;
+    }
+    parseLine(line);
+  }
+}
+
+Vector<double> PwaParser::parseValues(const String &keyword,
+                                      List<String>::iterator begin,
+                                      List<String>::iterator end,
+                                      unsigned count) {
+  Vector<double> values;
+  for (auto it = begin; it != end; ++it) {
+    char *rest;
+    double value = strtod(it->ascii(), &rest);
+    if (rest == it->ascii() || *rest != '\0')
+      throw InputParserError(
+          InputParserError::UNEXPECTED_INPUT,
+          Stringf("%s: %s is not a number", keyword.ascii(), it->ascii())
+              .ascii());
+    values.append(value);
+  }
+  if (values.size() != count)
+    throw InputParserError(
+        InputParserError::UNEXPECTED_INPUT,
+        Stringf("%s: expected %u values, got %u", keyword.ascii(), count,
+                values.size())
+            .ascii());
+  return values;
+}
+
+unsigned PwaParser::parseUnsigned(const String &keyword, double value) {
+  if (!(value >= 0 && value <= UINT_MAX && value == floor(value)))
+    throw InputParserError(
+        InputParserError::UNEXPECTED_INPUT,
+        Stringf("%s: expected a non-negative integer, got %g", keyword.ascii(),
+                value)
+            .ascii());
+  return value;
+}
+
+void PwaParser::parseLine(const String &line) {
+  List<String> tokens = line.tokenize("\t\r\n ");
+  if (tokens.empty() || tokens.begin()->ascii()[0] == '#') return;
+
+  auto it = tokens.begin();
+  String keyword = *it;
+  ++it;
+  unsigned numberOfValues = tokens.size() - 1;
+
+  unsigned n = _stateDimension;
+  unsigned k = _inputDimension;
+  if (keyword == "states") {
+    _stateDimension =
+        parseUnsigned(keyword, parseValues(keyword, it, tokens.end(), 1)[0]);
+  } else if (keyword == "inputs") {
+    _inputDimension =
+        parseUnsigned(keyword, parseValues(keyword, it, tokens.end(), 1)[0]);
+  } else if (keyword == "horizon") {
+    _horizon =
+        parseUnsigned(keyword, parseValues(keyword, it, tokens.end(), 1)[0]);
+  } else if (keyword == "state_lower") {
+    _stateLower = parseValues(keyword, it, tokens.end(), n);
+  } else if (keyword == "state_upper") {
+    _stateUpper = parseValues(keyword, it, tokens.end(), n);
+  } else if (keyword == "input_lower") {
+    _inputLower = parseValues(keyword, it, tokens.end(), k);
+  } else if (keyword == "input_upper") {
+    _inputUpper = parseValues(keyword, it, tokens.end(), k);
+  } else if (keyword == "initial_lower") {
+    _initialLower = parseValues(keyword, it, tokens.end(), n);
+  } else if (keyword == "initial_upper") {
+    _initialUpper = parseValues(keyword, it, tokens.end(), n);
+  } else if (keyword == "target_lower") {
+    _targetLower = parseValues(keyword, it, tokens.end(), n);
+  } else if (keyword == "target_upper") {
+    _targetUpper = parseValues(keyword, it, tokens.end(), n);
+  } else if (keyword == "mode") {
+    Mode mode;
+    mode._hasSuccessors = false;
+    _modes.append(mode);
+  } else {
+    if (_modes.empty())
+      throw InputParserError(InputParserError::UNEXPECTED_INPUT,
+                             (keyword + " before the first mode").ascii());
+    Mode &mode = _modes[_modes.size() - 1];
+
+    if (keyword == "A") {
+      mode._A = parseValues(keyword, it, tokens.end(), n * n);
+    } else if (keyword == "B") {
+      mode._B = parseValues(keyword, it, tokens.end(), n * k);
+    } else if (keyword == "c") {
+      mode._c = parseValues(keyword, it, tokens.end(), n);
+    } else if (keyword == "region") {
+      Vector<double> values = parseValues(keyword, it, tokens.end(), n + 1);
+      Halfspace halfspace;
+      for (unsigned i = 0; i < n; ++i)
+        halfspace._coefficients.append(values[i]);
+      halfspace._scalar = values[n];
+      mode._region.append(halfspace);
+    } else if (keyword == "successors") {
+      mode._hasSuccessors = true;
+      for (const auto &value :
+           parseValues(keyword, it, tokens.end(), numberOfValues))
+        mode._successors.append(parseUnsigned(keyword, value));
+    } else {
+      throw InputParserError(InputParserError::UNEXPECTED_INPUT, line.ascii());
+    }
+  }
+}
+
+void PwaParser::checkSystem() const {
+  unsigned n = _stateDimension;
+  unsigned k = _inputDimension;
+
+  if (n == 0 || _modes.empty())
+    throw InputParserError(InputParserError::UNEXPECTED_INPUT,
+                           "the system needs states and at least one mode");
+
+  // The big-M constants are computed from the boxes
+  if (_stateLower.size() != n || _stateUpper.size() != n ||
+      _inputLower.size() != k || _inputUpper.size() != k)
+    throw InputParserError(InputParserError::UNEXPECTED_INPUT,
+                           "the state and input boxes must be given");
+
+  for (unsigned m = 0; m < _modes.size(); ++m) {
+    const Mode &mode = _modes[m];
+    if (mode._A.size() != n * n || mode._B.size() != n * k ||
+        mode._c.size() != n)
+      throw InputParserError(
+          InputParserError::UNEXPECTED_INPUT,
+          Stringf("mode %u: A, B and c must be given", m).ascii());
+    for (const auto &successor : mode._successors)
+      if (successor >= _modes.size())
+        throw InputParserError(
+            InputParserError::UNEXPECTED_INPUT,
+            Stringf("mode %u: unknown successor %u", m, successor).ascii());
+  }
+}
+
+void PwaParser::getStateBox(unsigned t, unsigned horizon,
+                            Vector<double> &lower,
+                            Vector<double> &upper) const {
+  lower = _stateLower;
+  upper = _stateUpper;
+
+  const Vector<double> *stepLower = NULL;
+  const Vector<double> *stepUpper = NULL;
+  if (t == 0) {
+    stepLower = &_initialLower;
+    stepUpper = &_initialUpper;
+  } else if (t == horizon) {
+    stepLower = &_targetLower;
+    stepUpper = &_targetUpper;
+  }
+  if (!stepLower) return;
+
+  for (unsigned i = 0; i < _stateDimension; ++i) {
+    if (!stepLower->empty() && (*stepLower)[i] > lower[i])
+      lower[i] = (*stepLower)[i];
+    if (!stepUpper->empty() && (*stepUpper)[i] < upper[i])
+      upper[i] = (*stepUpper)[i];
+  }
+}
+
+unsigned PwaParser::addVariable(ModelBuilder &builder, const String &name,
+                                double lower, double upper, unsigned step) {
+  unsigned variable = builder.addVariable(lower, upper, false, step);
+  _variableNameToIndex[name] = variable;
+  return variable;
+}
+
+void PwaParser::generateQuery(InputQuery &inputQuery, unsigned horizon) {
+  if (horizon == 0) horizon = _horizon;
+  if (horizon == 0)
+    throw InputParserError(InputParserError::UNEXPECTED_INPUT,
+                           "no horizon given");
+
+  unsigned N = horizon;
+  unsigned n = _stateDimension;
+  unsigned k = _inputDimension;
+  unsigned numberOfModes = _modes.size();
+
+  ModelBuilder builder;
+  _variableNameToIndex.clear();
+
+  // The variables, in the order of PwaMpsGenerator: the states, the inputs
+  // and the mode binaries
+  Vector<Vector<double>> stateLower(N + 1);
+  Vector<Vector<double>> stateUpper(N + 1);
+  Vector<Vector<int>> x(N + 1);
+  for (unsigned t = 0; t <= N; ++t) {
+    getStateBox(t, N, stateLower[t], stateUpper[t]);
+    for (unsigned i = 0; i < n; ++i)
+      x[t].append(addVariable(builder, Stringf("x%u@%u", i, t),
+                              stateLower[t][i], stateUpper[t][i], t));
+  }
+
+  Vector<Vector<int>> u(N);
+  for (unsigned t = 0; t < N; ++t)
+    for (unsigned i = 0; i < k; ++i)
+      u[t].append(addVariable(builder, Stringf("u%u@%u", i, t),
+                              _inputLower[i], _inputUpper[i], t));
+
+  // A mode is inactive at a step whose state box misses its region
+  Vector<Set<unsigned>> inactiveModes(N);
+  Vector<Vector<int>> d(N);
+  for (unsigned t = 0; t < N; ++t) {
+    for (unsigned m = 0; m < numberOfModes; ++m) {
+      for (const auto &halfspace : _modes[m]._region)
+        if (minimum(halfspace._coefficients.data(), stateLower[t],
+                    stateUpper[t]) > halfspace._scalar)
+          inactiveModes[t].insert(m);
+      d[t].append(addVariable(builder, Stringf("d%u@%u", m, t), 0,
+                              inactiveModes[t].exists(m) ? 0 : 1, t));
+    }
+  }
+
+  Vector<int> indices;
+  Vector<double> values;
+  auto addEntry = [&](int variable, double coefficient) {
+    if (coefficient == 0) return;
+    indices.append(variable);
+    values.append(coefficient);
+  };
+  auto addRow = [&](Equation::EquationType type, double scalar) {
+    builder.addRow(indices.size(), indices.data(), values.data(), type,
+                   scalar);
+    indices.clear();
+    values.clear();
+  };
+
+  for (unsigned t = 0; t < N; ++t) {
+    builder.addOneHot(numberOfModes, d[t].data());
+
+    for (unsigned m = 0; m < numberOfModes; ++m) {
+      if (inactiveModes[t].exists(m)) continue;
+      const Mode &mode = _modes[m];
+
+      // d = 1 -> h . x[t] <= g, relaxed by the largest violation M
+      for (const auto &halfspace : mode._region) {
+        double M = maximum(halfspace._coefficients.data(), stateLower[t],
+                           stateUpper[t]) -
+                   halfspace._scalar;
+        // The box alone implies the facet
+        if (M <= 0) continue;
+
+        for (unsigned i = 0; i < n; ++i)
+          addEntry(x[t][i], halfspace._coefficients[i]);
+        addEntry(d[t][m], M);
+        addRow(Equation::LE, halfspace._scalar + M);
+      }
+
+      // d = 1 -> x[t+1] = A x[t] + B u[t] + c. The residual
+      // x[t+1] - A x[t] - B u[t] - c ranges over [low, high] on the boxes,
+      // which relax the two sides when d = 0.
+      for (unsigned i = 0; i < n; ++i) {
+        const double *a = mode._A.data() + i * n;
+        const double *b = mode._B.data() + i * k;
+
+        double high = stateUpper[t + 1][i] - mode._c[i] -
+                      minimum(a, stateLower[t], stateUpper[t]) -
+                      (k > 0 ? minimum(b, _inputLower, _inputUpper) : 0);
+        double low = stateLower[t + 1][i] - mode._c[i] -
+                     maximum(a, stateLower[t], stateUpper[t]) -
+                     (k > 0 ? maximum(b, _inputLower, _inputUpper) : 0);
+
+        auto addResidual = [&]() {
+          addEntry(x[t + 1][i], 1);
+          for (unsigned j = 0; j < n; ++j) addEntry(x[t][j], -a[j]);
+          for (unsigned j = 0; j < k; ++j) addEntry(u[t][j], -b[j]);
+        };
+
+        if (high > 0) {
+          addResidual();
+          addEntry(d[t][m], high);
+          addRow(Equation::LE, mode._c[i] + high);
+        }
+        if (low < 0) {
+          addResidual();
+          addEntry(d[t][m], low);
+          addRow(Equation::GE, mode._c[i] + low);
+        }
+      }
+
+      // d[t][m] = 1 -> one of its successors is active at t + 1
+      if (mode._hasSuccessors && t + 1 < N) {
+        for (const auto &successor : mode._successors)
+          addEntry(d[t + 1][successor], 1);
+        addEntry(d[t][m], -1);
+        addRow(Equation::GE, 0);
+      }
+    }
+  }
+
+  builder.generateQuery(inputQuery);
+}
+
+Map<String, unsigned> PwaParser::getVariableNameToVariableIndex() const {
+  return _variableNameToIndex;
+}
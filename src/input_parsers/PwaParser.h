@@ -0,0 +1,138 @@
+/*********************                                                        */
+/*! \file PwaParser.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Reads a piecewise-affine (PWA) system in the native .pwa format and
+ ** expands it over a horizon into a query:
+ **
+ **   x[t+1] = A_m x[t] + B_m u[t] + c_m   if mode m is active at step t
+ **
+ ** The file describes the system once; the horizon is given by the file or
+ ** by the caller. It has one keyword per line, followed by its values:
+ **
+ **   states <n>                      the dimension of the state
+ **   inputs <k>                      the dimension of the input
+ **   horizon <N>                     the default horizon
+ **   state_lower <n values>          the state box, at every step
+ **   state_upper <n values>
+ **   input_lower <k values>          the input box
+ **   input_upper <k values>
+ **   initial_lower <n values>        the box of x[0]; fixed if equal
+ **   initial_upper <n values>
+ **   target_lower <n values>         the box of x[N]
+ **   target_upper <n values>
+ **   mode                            starts a new mode
+ **   A <n * n values>                its dynamics, row-major
+ **   B <n * k values>
+ **   c <n values>
+ **   region <n values> <g>           a facet h . x <= g of its region
+ **   successors <modes>              the modes that may follow it
+ **
+ ** The dimensions come first. The boxes are optional (unbounded, or the
+ ** state box), as are the successors (any mode). Empty lines and lines
+ ** starting with '#' are skipped.
+ **
+ ** The variables are those of PwaMpsGenerator, x<i>@<t>, u<i>@<t> and the
+ ** mode binaries d<m>@<t>, so solution and hint files are interchangeable,
+ ** and each is tagged with its step. The mode binaries of a step form a
+ ** one-hot group. The big-M constant of each dynamics and region row is the
+ ** largest violation of that row, for that mode and step, over the boxes of
+ ** the step, rather than a bound shared by all modes. A mode whose region
+ ** misses the state box of a step is fixed inactive at that step.
+ **/
+
+#ifndef __PwaParser_h__
+#define __PwaParser_h__
+
+#include "MString.h"
+#include "Map.h"
+#include "Vector.h"
+
+class InputQuery;
+class ModelBuilder;
+
+class PwaParser {
+ public:
+  PwaParser(const String &path);
+
+  /*
+    Expand the system over the horizon, or over the horizon of the file if
+    it is 0. Throws an InputParserError if neither is given.
+  */
+  void generateQuery(InputQuery &inputQuery, unsigned horizon = 0);
+
+  Map<String, unsigned> getVariableNameToVariableIndex() const;
+
+  unsigned getStateDimension() const { return _stateDimension; }
+  unsigned getInputDimension() const { return _inputDimension; }
+  unsigned getNumberOfModes() const { return _modes.size(); }
+
+ private:
+  // The facet a . x <= b of a region
+  struct Halfspace {
+    Vector<double> _coefficients;
+    double _scalar;
+  };
+
+  struct Mode {
+    // Row-major
+    Vector<double> _A;
+    Vector<double> _B;
+    Vector<double> _c;
+    Vector<Halfspace> _region;
+    bool _hasSuccessors;
+    Vector<unsigned> _successors;
+  };
+
+  unsigned _stateDimension;
+  unsigned _inputDimension;
+  unsigned _horizon;
+
+  Vector<double> _stateLower;
+  Vector<double> _stateUpper;
+  Vector<double> _inputLower;
+  Vector<double> _inputUpper;
+  Vector<double> _initialLower;
+  Vector<double> _initialUpper;
+  Vector<double> _targetLower;
+  Vector<double> _targetUpper;
+
+  Vector<Mode> _modes;
+
+  // The names of the variables of the last generated query
+  Map<String, unsigned> _variableNameToIndex;
+
+  void parse(const String &path);
+  void parseLine(const String &line);
+  void checkSystem() const;
+
+  /*
+    The values of a keyword line, of which there must be count
+  */
+  static Vector<double> parseValues(const String &keyword,
+                                    List<String>::iterator begin,
+                                    List<String>::iterator end,
+                                    unsigned count);
+
+  /*
+    A value of a keyword line that must be a non-negative integer, e.g., a
+    dimension
+  */
+  static unsigned parseUnsigned(const String &keyword, double value);
+
+  /*
+    The box of the state at step t of a horizon
+  */
+  void getStateBox(unsigned t, unsigned horizon, Vector<double> &lower,
+                   Vector<double> &upper) const;
+
+  unsigned addVariable(ModelBuilder &builder, const String &name,
+                       double lower, double upper, unsigned step);
+};
+
+#endif  // __PwaParser_h__
@@ -0,0 +1,96 @@
+/*********************                                                        */
+/*! \file main.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Writes a random PWA control problem in MPS or native PWA format, e.g.
+ **
+ **   ./pwa_generator --horizon 20 --modes 4 --geometry voronoi --seed 7
+ **       --output pwa_7.mps
+ **/
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "Error.h"
+#include "PwaMpsGenerator.h"
+#include "boost/program_options.hpp"
+
+int main(int argc, char *argv[]) {
+  PwaMpsGenerator::Parameters parameters;
+  std::string output;
+  std::string geometry = "slabs";
+
+  boost::program_options::options_description options(
+      "usage: ./pwa_generator --output <file.mps|file.pwa> [<options>]");
+  options.add_options()("help", "Print this message.")(
+      "output", boost::program_options::value<std::string>(&output),
+      "The file to write: native PWA format if it ends with .pwa, MPS "
+      "otherwise.")(
+      "horizon",
+      boost::program_options::value<unsigned>(&parameters._horizon)
+          ->default_value(parameters._horizon),
+      "Number of steps.")(
+      "state-dim",
+      boost::program_options::value<unsigned>(&parameters._stateDimension)
+          ->default_value(parameters._stateDimension),
+      "Dimension of the state.")(
+      "input-dim",
+      boost::program_options::value<unsigned>(&parameters._inputDimension)
+          ->default_value(parameters._inputDimension),
+      "Dimension of the control input.")(
+      "modes",
+      boost::program_options::value<unsigned>(&parameters._numberOfModes)
+          ->default_value(parameters._numberOfModes),
+      "Number of modes (affine pieces).")(
+      "geometry",
+      boost::program_options::value<std::string>(&geometry)->default_value(
+          geometry),
+      "Shape of the mode regions: slabs/voronoi.")(
+      "seed",
+      boost::program_options::value<unsigned>(&parameters._seed)
+          ->default_value(parameters._seed),
+      "The random seed.")(
+      "unsat-bias",
+      boost::program_options::value<double>(&parameters._unsatBias)
+          ->default_value(parameters._unsatBias),
+      "In [0, 1]. Higher values make infeasible instances more likely.")(
+      "state-bound",
+      boost::program_options::value<double>(&parameters._stateBound)
+          ->default_value(parameters._stateBound),
+      "Bound on the absolute value of each state variable.")(
+      "input-bound",
+      boost::program_options::value<double>(&parameters._inputBound)
+          ->default_value(parameters._inputBound),
+      "Bound on the absolute value of each input variable.");
+
+  try {
+    boost::program_options::variables_map variables;
+    boost::program_options::store(
+        boost::program_options::parse_command_line(argc, argv, options),
+        variables);
+    boost::program_options::notify(variables);
+
+    if (variables.count("help") || output.empty()) {
+      std::cerr << options << std::endl;
+      return variables.count("help") ? 0 : 1;
+    }
+
+    parameters._geometry = PwaMpsGenerator::parseGeometry(geometry.c_str());
+    PwaMpsGenerator(parameters).writeToFile(output.c_str());
+  } catch (const boost::program_options::error &e) {
+    printf("Error: %s\n", e.what());
+    return 1;
+  } catch (const Error &e) {
+    printf("Caught a %s error. Code: %u, Errno: %i, Message: %s.\n",
+           e.getErrorClass(), e.getCode(), e.getErrno(), e.getUserMessage());
+    return 1;
+  }
+
+  return 0;
+}
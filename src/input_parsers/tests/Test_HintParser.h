@@ -0,0 +1,175 @@
+/*********************                                                        */
+/*! \file Test_HintParser.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Tests of the hint files, and of a hint that solves its query
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <cstdio>
+
+#include "Engine.h"
+#include "File.h"
+#include "FloatUtils.h"
+#include "HintParser.h"
+#include "InputParserError.h"
+#include "InputQuery.h"
+#include "MockErrno.h"
+#include "OneHotConstraint.h"
+#include "RealFiles.h"
+#include "SolutionHint.h"
+#include "Statistics.h"
+
+class MockForHintParser : public RealFiles, public MockErrno {};
+
+class HintParserTestSuite : public CxxTest::TestSuite {
+ public:
+  MockForHintParser *mock;
+  String path;
+  Map<String, unsigned> variableNames;
+
+  void setUp() {
+    TS_ASSERT(mock = new MockForHintParser);
+    path = "Test_HintParser.hint";
+    variableNames["d0"] = 0;
+    variableNames["d1"] = 1;
+    variableNames["x"] = 2;
+  }
+
+  void tearDown() {
+    remove(path.ascii());
+    TS_ASSERT_THROWS_NOTHING(delete mock);
+  }
+
+  void writeHint(const String &contents) {
+    File file(path);
+    file.open(IFile::MODE_WRITE_TRUNCATE);
+    file.write(contents);
+    file.close();
+  }
+
+  void expectParseError(const String &contents) {
+    writeHint(contents);
+    TS_ASSERT_THROWS_EQUALS(HintParser parser(path), const InputParserError &e,
+                            e.getCode(), InputParserError::UNEXPECTED_INPUT);
+  }
+
+  void test_values_and_modes() {
+    writeHint("# A hint\n"
+              "d1 1\n"
+              "\n"
+              "x -2.5\n"
+              "mode 0 1\n"
+              "mode 3 0\n");
+    HintParser parser(path);
+    SolutionHint hint;
+    hint.setValue(0, 1);
+    parser.generateHint(variableNames, hint);
+
+    // The previous hint is replaced
+    TS_ASSERT_EQUALS(hint.getAssignment().size(), 2U);
+    TS_ASSERT_EQUALS(hint.getAssignment()[1], 1);
+    TS_ASSERT_EQUALS(hint.getAssignment()[2], -2.5);
+    TS_ASSERT_EQUALS(hint.getModes().size(), 2U);
+    TS_ASSERT_EQUALS(hint.getModes()[0], 1U);
+    TS_ASSERT_EQUALS(hint.getModes()[3], 0U);
+  }
+
+  void test_partial_hint() {
+    writeHint("x 3\n");
+    SolutionHint hint;
+    HintParser(path).generateHint(variableNames, hint);
+    TS_ASSERT(!hint.empty());
+    TS_ASSERT_EQUALS(hint.getAssignment().size(), 1U);
+    TS_ASSERT(hint.getAssignment().exists(2));
+    TS_ASSERT(hint.getModes().empty());
+
+    writeHint("# Nothing\n");
+    HintParser(path).generateHint(variableNames, hint);
+    TS_ASSERT(hint.empty());
+  }
+
+  void test_unknown_variable() {
+    writeHint("d1 1\ny 2\n");
+    HintParser parser(path);
+    SolutionHint hint;
+    TS_ASSERT_THROWS_EQUALS(parser.generateHint(variableNames, hint),
+                            const InputParserError &e, e.getCode(),
+                            InputParserError::UNKNOWN_VARIABLE_NAME);
+  }
+
+  void test_missing_file() {
+    TS_ASSERT_THROWS_EQUALS(HintParser parser("Test_HintParser.missing"),
+                            const InputParserError &e, e.getCode(),
+                            InputParserError::FILE_DOESNT_EXIST);
+  }
+
+  void test_bad_hint_files() {
+    expectParseError("x\n");
+    expectParseError("x 1 2\n");
+    expectParseError("x one\n");
+    expectParseError("mode 1\n");
+    expectParseError("mode 1 2 3\n");
+    expectParseError("mode -1 0\n");
+    expectParseError("mode 0 1.5\n");
+  }
+
+  void test_hint_solves_the_query() {
+    // OneHot (x0, x1), x2 is between -10 and 10
+    //
+    // x0 = 1 -> x2 <= -1: x2 + 11 x0 <= 10
+    // x1 = 1 -> x2 >= 1: x2 - 11 x1 >= -10
+    InputQuery inputQuery;
+    inputQuery.setNumberOfVariables(3);
+    for (unsigned i = 0; i < 2; ++i) {
+      inputQuery.setLowerBound(i, 0);
+      inputQuery.setUpperBound(i, 1);
+    }
+    inputQuery.setLowerBound(2, -10);
+    inputQuery.setUpperBound(2, 10);
+    inputQuery.addPLConstraint(new OneHotConstraint({0, 1}));
+
+    Equation oneHot;
+    oneHot.addAddend(1, 0);
+    oneHot.addAddend(1, 1);
+    oneHot.setScalar(1);
+    inputQuery.addEquation(oneHot);
+
+    Equation first(Equation::LE);
+    first.addAddend(1, 2);
+    first.addAddend(11, 0);
+    first.setScalar(10);
+    inputQuery.addEquation(first);
+
+    Equation second(Equation::GE);
+    second.addAddend(1, 2);
+    second.addAddend(-11, 1);
+    second.setScalar(-10);
+    inputQuery.addEquation(second);
+
+    writeHint("d1 1\nx 4\n");
+    SolutionHint hint;
+    HintParser(path).generateHint(variableNames, hint);
+
+    Engine engine;
+    TS_ASSERT(engine.processInputQuery(inputQuery, false));
+    engine.setHint(hint);
+    TS_ASSERT(engine.solve());
+    TS_ASSERT_EQUALS(engine.getExitCode(), Engine::SAT);
+
+    // Solved by the LP with the hinted phase, before the search
+    const Statistics *statistics = engine.getStatistics();
+    TS_ASSERT_EQUALS(
+        statistics->getUnsignedAttribute(Statistics::HINT_SOLVED_QUERY), 1U);
+    TS_ASSERT_EQUALS(
+        statistics->getUnsignedAttribute(Statistics::NUM_HINTED_PHASES), 1U);
+    TS_ASSERT(FloatUtils::gte(engine.getAssignment(2), 1));
+    TS_ASSERT(FloatUtils::areEqual(engine.getAssignment(1), 1));
+  }
+};
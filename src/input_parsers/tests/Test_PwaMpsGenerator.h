@@ -0,0 +1,236 @@
+/*********************                                                        */
+/*! \file Test_PwaMpsGenerator.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Tests of the mode-selection and big-M rows of the generated MPS files
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "FloatUtils.h"
+#include "InputParserError.h"
+#include "MStringf.h"
+#include "Map.h"
+#include "MockErrno.h"
+#include "PwaMpsGenerator.h"
+#include "Set.h"
+
+// The rows, coefficients and bounds of an MPS file, by name
+struct MpsContents {
+  Map<String, char> _types;
+  Map<String, double> _rhs;
+  Map<String, Map<String, double>> _coefficients;
+  Map<String, double> _lowerBounds;
+  Map<String, double> _upperBounds;
+  Set<String> _integers;
+};
+
+class PwaMpsGeneratorTestSuite : public CxxTest::TestSuite {
+ public:
+  MockErrno *mockErrno;
+
+  void setUp() { TS_ASSERT(mockErrno = new MockErrno); }
+
+  void tearDown() { TS_ASSERT_THROWS_NOTHING(delete mockErrno); }
+
+  PwaMpsGenerator::Parameters getParameters() {
+    // One state, one input and two slabs, x <= 0 and x >= 0
+    PwaMpsGenerator::Parameters parameters;
+    parameters._horizon = 2;
+    parameters._stateDimension = 1;
+    parameters._inputDimension = 1;
+    parameters._numberOfModes = 2;
+    parameters._stateBound = 10;
+    parameters._inputBound = 1;
+    return parameters;
+  }
+
+  void parseMps(const String &mps, MpsContents &contents) {
+    String section;
+    bool markingInteger = false;
+    for (const auto &line : mps.tokenize("\n")) {
+      List<String> tokens = line.tokenize(" ");
+      if (line[0] != ' ') {
+        section = *tokens.begin();
+        continue;
+      }
+
+      Vector<String> fields;
+      for (const auto &token : tokens) fields.append(token);
+      if (section == "ROWS") {
+        contents._types[fields[1]] = fields[0][0];
+      } else if (section == "COLUMNS") {
+        if (fields[1] == "'MARKER'") {
+          markingInteger = fields[2] == "'INTORG'";
+          continue;
+        }
+        contents._coefficients[fields[1]][fields[0]] = atof(fields[2].ascii());
+        if (markingInteger) contents._integers.insert(fields[0]);
+      } else if (section == "RHS") {
+        contents._rhs[fields[1]] = atof(fields[2].ascii());
+      } else if (section == "BOUNDS") {
+        double value = atof(fields[3].ascii());
+        if (fields[0] != "UP") contents._lowerBounds[fields[2]] = value;
+        if (fields[0] != "LO") contents._upperBounds[fields[2]] = value;
+      }
+    }
+  }
+
+  double getRhs(const MpsContents &contents, const String &row) {
+    return contents._rhs.exists(row) ? contents._rhs[row] : 0;
+  }
+
+  // The range of the row over the bounds, with the mode binaries at 0
+  void getRangeWithoutModes(const MpsContents &contents, const String &row,
+                            double &lower, double &upper) {
+    lower = upper = 0;
+    for (const auto &pair : contents._coefficients[row]) {
+      if (contents._integers.exists(pair.first)) continue;
+      double low = pair.second * contents._lowerBounds[pair.first];
+      double high = pair.second * contents._upperBounds[pair.first];
+      lower += std::min(low, high);
+      upper += std::max(low, high);
+    }
+  }
+
+  void test_mode_selection_rows() {
+    MpsContents contents;
+    parseMps(PwaMpsGenerator(getParameters()).generate(), contents);
+
+    for (unsigned t = 0; t < 2; ++t) {
+      String row = Stringf("onehot_%u", t);
+      TS_ASSERT_EQUALS(contents._types[row], 'E');
+      TS_ASSERT_EQUALS(getRhs(contents, row), 1);
+      TS_ASSERT_EQUALS(contents._coefficients[row].size(), 2u);
+      for (unsigned m = 0; m < 2; ++m) {
+        String mode = Stringf("d%u@%u", m, t);
+        TS_ASSERT_EQUALS(contents._coefficients[row][mode], 1);
+        TS_ASSERT(contents._integers.exists(mode));
+        TS_ASSERT_EQUALS(contents._lowerBounds[mode], 0);
+        TS_ASSERT_EQUALS(contents._upperBounds[mode], 1);
+      }
+    }
+
+    // Only the mode binaries are integers
+    TS_ASSERT_EQUALS(contents._integers.size(), 4u);
+  }
+
+  void test_region_rows_of_slabs() {
+    MpsContents contents;
+    parseMps(PwaMpsGenerator(getParameters()).generate(), contents);
+
+    for (unsigned t = 0; t < 2; ++t) {
+      String state = Stringf("x0@%u", t);
+
+      // d0 = 1 -> x <= 0: x + 10 d0 <= 10
+      String first = Stringf("region_%u_0_0", t);
+      TS_ASSERT_EQUALS(contents._types[first], 'L');
+      TS_ASSERT_EQUALS(contents._coefficients[first][state], 1);
+      TS_ASSERT_EQUALS(contents._coefficients[first][Stringf("d0@%u", t)], 10);
+      TS_ASSERT_EQUALS(getRhs(contents, first), 10);
+
+      // d1 = 1 -> x >= 0: -x + 10 d1 <= 10
+      String second = Stringf("region_%u_1_0", t);
+      TS_ASSERT_EQUALS(contents._coefficients[second][state], -1);
+      TS_ASSERT_EQUALS(contents._coefficients[second][Stringf("d1@%u", t)],
+                       10);
+      TS_ASSERT_EQUALS(getRhs(contents, second), 10);
+    }
+  }
+
+  void test_dynamics_rows() {
+    MpsContents contents;
+    parseMps(PwaMpsGenerator(getParameters()).generate(), contents);
+
+    for (unsigned t = 0; t < 2; ++t) {
+      for (unsigned m = 0; m < 2; ++m) {
+        String upper = Stringf("dyn_ub_%u_%u_0", t, m);
+        String lower = Stringf("dyn_lb_%u_%u_0", t, m);
+        String mode = Stringf("d%u@%u", m, t);
+        TS_ASSERT_EQUALS(contents._types[upper], 'L');
+        TS_ASSERT_EQUALS(contents._types[lower], 'G');
+
+        // The same affine map on both sides, x' - a x - b u
+        for (const auto &pair : contents._coefficients[upper])
+          if (pair.first != mode)
+            TS_ASSERT_EQUALS(contents._coefficients[lower][pair.first],
+                             pair.second);
+        TS_ASSERT_EQUALS(
+            contents._coefficients[upper][Stringf("x0@%u", t + 1)], 1);
+
+        // With d = 1, both rows leave x' - a x - b u = c
+        double M = contents._coefficients[upper][mode];
+        TS_ASSERT(M > 0);
+        TS_ASSERT_EQUALS(contents._coefficients[lower][mode], -M);
+        TS_ASSERT(FloatUtils::areEqual(getRhs(contents, upper) - M,
+                                       getRhs(contents, lower) + M));
+      }
+    }
+  }
+
+  void test_big_m_rows_are_slack_for_inactive_modes() {
+    // Each big-M row holds over the whole box when its mode is inactive, for
+    // both geometries
+    PwaMpsGenerator::Parameters parameters = getParameters();
+    parameters._stateDimension = 2;
+    parameters._numberOfModes = 3;
+    for (const auto &geometry :
+         {PwaMpsGenerator::SLABS, PwaMpsGenerator::VORONOI}) {
+      parameters._geometry = geometry;
+      MpsContents contents;
+      parseMps(PwaMpsGenerator(parameters).generate(), contents);
+
+      unsigned numberOfBigMRows = 0;
+      for (const auto &pair : contents._coefficients) {
+        bool hasMode = false;
+        for (const auto &coefficient : pair.second)
+          if (contents._integers.exists(coefficient.first)) hasMode = true;
+        if (!hasMode || contents._types[pair.first] == 'E') continue;
+
+        double lower;
+        double upper;
+        getRangeWithoutModes(contents, pair.first, lower, upper);
+        double rhs = getRhs(contents, pair.first);
+        if (contents._types[pair.first] == 'L') {
+          TS_ASSERT(FloatUtils::lte(upper, rhs));
+        } else {
+          TS_ASSERT(FloatUtils::gte(lower, rhs));
+        }
+        ++numberOfBigMRows;
+      }
+      TS_ASSERT(numberOfBigMRows > 0);
+    }
+  }
+
+  void test_same_parameters_same_problem() {
+    PwaMpsGenerator::Parameters parameters = getParameters();
+    parameters._geometry = PwaMpsGenerator::VORONOI;
+    PwaMpsGenerator generator(parameters);
+    String mps = generator.generate();
+    TS_ASSERT_EQUALS(generator.generate(), mps);
+    TS_ASSERT_EQUALS(PwaMpsGenerator(parameters).generate(), mps);
+
+    parameters._seed = 2;
+    TS_ASSERT_DIFFERS(PwaMpsGenerator(parameters).generate(), mps);
+  }
+
+  void test_invalid_parameters() {
+    PwaMpsGenerator::Parameters parameters = getParameters();
+    parameters._horizon = 0;
+    TS_ASSERT_THROWS_EQUALS(PwaMpsGenerator generator(parameters),
+                            const InputParserError &e, e.getCode(),
+                            InputParserError::UNEXPECTED_INPUT);
+    TS_ASSERT_THROWS_EQUALS(PwaMpsGenerator::parseGeometry("cubes"),
+                            const InputParserError &e, e.getCode(),
+                            InputParserError::UNEXPECTED_INPUT);
+  }
+};
@@ -0,0 +1,195 @@
+/*********************                                                        */
+/*! \file Test_PwaParser.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Tests of the .pwa format and its expansion over a horizon
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <cstdio>
+
+#include "File.h"
+#include "InputParserError.h"
+#include "InputQuery.h"
+#include "MockErrno.h"
+#include "PwaParser.h"
+#include "RealFiles.h"
+
+class MockForPwaParser : public RealFiles, public MockErrno {};
+
+class PwaParserTestSuite : public CxxTest::TestSuite {
+ public:
+  MockForPwaParser *mock;
+  String path;
+
+  void setUp() {
+    TS_ASSERT(mock = new MockForPwaParser);
+    path = "Test_PwaParser.pwa";
+  }
+
+  void tearDown() {
+    remove(path.ascii());
+    TS_ASSERT_THROWS_NOTHING(delete mock);
+  }
+
+  void writeSystem(const String &contents) {
+    File file(path);
+    file.open(IFile::MODE_WRITE_TRUNCATE);
+    file.write(contents);
+    file.close();
+  }
+
+  // A scalar system over one step. Mode 0, x <= 0, misses the initial box;
+  // mode 1, x <= 3, does not contain it.
+  String getSystem() {
+    return "# A scalar system\n"
+           "states 1\n"
+           "inputs 1\n"
+           "horizon 1\n"
+           "state_lower -10\n"
+           "state_upper 10\n"
+           "input_lower -1\n"
+           "input_upper 1\n"
+           "initial_lower 1\n"
+           "initial_upper 5\n"
+           "\n"
+           "mode\n"
+           "A 1\n"
+           "B 1\n"
+           "c 0\n"
+           "region 1 0\n"
+           "mode\n"
+           "A 0.5\n"
+           "B 0\n"
+           "c 2\n"
+           "region 1 3\n"
+           "successors 0 1\n";
+  }
+
+  bool hasEquation(const InputQuery &inputQuery, const Equation &equation) {
+    for (const auto &other : inputQuery.getEquations())
+      if (other.equivalent(equation)) return true;
+    return false;
+  }
+
+  void expectParseError(const String &contents) {
+    writeSystem(contents);
+    TS_ASSERT_THROWS_EQUALS(PwaParser parser(path), const InputParserError &e,
+                            e.getCode(), InputParserError::UNEXPECTED_INPUT);
+  }
+
+  void test_parse_and_expand() {
+    writeSystem(getSystem());
+    PwaParser parser(path);
+    TS_ASSERT_EQUALS(parser.getStateDimension(), 1U);
+    TS_ASSERT_EQUALS(parser.getInputDimension(), 1U);
+    TS_ASSERT_EQUALS(parser.getNumberOfModes(), 2U);
+
+    InputQuery inputQuery;
+    TS_ASSERT_THROWS_NOTHING(parser.generateQuery(inputQuery));
+    TS_ASSERT_EQUALS(inputQuery.getNumberOfVariables(), 5U);
+
+    Map<String, unsigned> names = parser.getVariableNameToVariableIndex();
+    unsigned x0 = names["x0@0"];
+    unsigned x1 = names["x0@1"];
+    unsigned u0 = names["u0@0"];
+    unsigned d0 = names["d0@0"];
+    unsigned d1 = names["d1@0"];
+    TS_ASSERT_EQUALS(inputQuery.getLowerBound(x0), 1);
+    TS_ASSERT_EQUALS(inputQuery.getUpperBound(x0), 5);
+    TS_ASSERT_EQUALS(inputQuery.getLowerBound(u0), -1);
+    TS_ASSERT_EQUALS(inputQuery.getStepOfVariable(x1), 1U);
+
+    // Mode 0 is inactive, and has no rows but its one-hot group
+    TS_ASSERT_EQUALS(inputQuery.getUpperBound(d0), 0);
+    TS_ASSERT_EQUALS(inputQuery.getUpperBound(d1), 1);
+    for (const auto &equation : inputQuery.getEquations())
+      if (equation._type != Equation::EQ)
+        TS_ASSERT(!equation.getParticipatingVariables().exists(d0));
+
+    // The region row, relaxed by the largest violation 5 - 3 of x <= 3
+    Equation region(Equation::LE);
+    region.addAddend(1, x0);
+    region.addAddend(2, d1);
+    region.setScalar(5);
+    TS_ASSERT(hasEquation(inputQuery, region));
+
+    // The dynamics x1 = 0.5 x0 + 2, whose residual ranges over
+    // [-10 - 2 - 2.5, 10 - 2 - 0.5]
+    Equation upper(Equation::LE);
+    upper.addAddend(1, x1);
+    upper.addAddend(-0.5, x0);
+    upper.addAddend(7.5, d1);
+    upper.setScalar(9.5);
+    TS_ASSERT(hasEquation(inputQuery, upper));
+
+    Equation lower(Equation::GE);
+    lower.addAddend(1, x1);
+    lower.addAddend(-0.5, x0);
+    lower.addAddend(-14.5, d1);
+    lower.setScalar(-12.5);
+    TS_ASSERT(hasEquation(inputQuery, lower));
+
+    Equation oneHot(Equation::EQ);
+    oneHot.addAddend(1, d0);
+    oneHot.addAddend(1, d1);
+    oneHot.setScalar(1);
+    TS_ASSERT(hasEquation(inputQuery, oneHot));
+    TS_ASSERT_EQUALS(inputQuery.getEquations().size(), 4U);
+    TS_ASSERT_EQUALS(inputQuery.getPLConstraints().size(), 1U);
+  }
+
+  void test_horizon_of_the_caller() {
+    writeSystem(getSystem());
+    PwaParser parser(path);
+    InputQuery inputQuery;
+    parser.generateQuery(inputQuery, 3);
+
+    // The states of 4 steps, the inputs and mode binaries of 3
+    TS_ASSERT_EQUALS(inputQuery.getNumberOfVariables(), 13U);
+    TS_ASSERT(parser.getVariableNameToVariableIndex().exists("d1@2"));
+    TS_ASSERT_EQUALS(inputQuery.getPLConstraints().size(), 3U);
+  }
+
+  void test_missing_file() {
+    TS_ASSERT_THROWS_EQUALS(PwaParser parser("Test_PwaParser.missing"),
+                            const InputParserError &e, e.getCode(),
+                            InputParserError::FILE_DOESNT_EXIST);
+  }
+
+  void test_malformed_keywords() {
+    expectParseError(getSystem() + "unknown 1\n");
+    expectParseError("states 1\nA 1\n");
+    expectParseError(getSystem() + "c two\n");
+    expectParseError(getSystem() + "c 2x\n");
+  }
+
+  void test_dimension_mismatches() {
+    expectParseError(getSystem() + "A 1 2\n");
+    expectParseError(getSystem() + "region 1\n");
+    expectParseError(getSystem() + "state_lower -10 -10\n");
+    expectParseError(getSystem() + "successors 2\n");
+
+    // Without the boxes of the inputs
+    expectParseError("states 1\ninputs 1\nstate_lower 0\nstate_upper 1\n"
+                     "mode\nA 1\nB 1\nc 0\n");
+    // Without B
+    expectParseError("states 1\ninputs 1\nstate_lower 0\nstate_upper 1\n"
+                     "input_lower 0\ninput_upper 1\nmode\nA 1\nc 0\n");
+  }
+
+  void test_dimensions_are_non_negative_integers() {
+    expectParseError("states 1.5\n");
+    expectParseError("states -1\n");
+    expectParseError("inputs 1e20\n");
+    expectParseError("horizon 2.5\n");
+    expectParseError(getSystem() + "successors 0.5\n");
+    expectParseError(getSystem() + "successors -1\n");
+  }
+};
@@ -31,6 +31,13 @@ void PLConstraintScoreTracker::initialize(
   _plConstraints = plConstraints;
 }
 
+void PLConstraintScoreTracker::addConstraint(PLConstraint *constraint) {
+  ASSERT(!_plConstraintToScore.exists(constraint));
+  _scores.insert({constraint, 0});
+  _plConstraintToScore[constraint] = 0;
+  _plConstraints.append(constraint);
+}
+
 void PLConstraintScoreTracker::decayScores() {
   for (const auto &constraint : _plConstraints) {
     double oldScore = _plConstraintToScore[constraint];
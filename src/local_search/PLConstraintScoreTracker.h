@@ -53,6 +53,11 @@ class PLConstraintScoreTracker {
   */
   void initialize(const List<PLConstraint *> &plConstraints);
 
+  /*
+    Start tracking one more constraint, with score 0.
+  */
+  void addConstraint(PLConstraint *constraint);
+
   /*
     Empty the local variables.
   */
@@ -27,6 +27,7 @@
 #include "SoyError.h"
 #include "OneHotConstraint.h"
 #include "Options.h"
+#include "Profiler.h"
 #include "Set.h"
 #include "SmtCore.h"
 
@@ -83,12 +84,16 @@ LinearExpression SoIManager::getLastAcceptedSoIPhasePattern() const {
 }
 
 void SoIManager::initializePhasePattern() {
+  PROFILE_SCOPE("soi_initialize");
   struct timespec start = TimeUtils::sampleMicro();
 
   resetPhasePattern();
 
-  if (_initializationStrategy ==
-      SoIInitializationStrategy::CURRENT_ASSIGNMENT) {
+  if (!_givenPhasePattern.empty() ||
+      _initializationStrategy == SoIInitializationStrategy::GIVEN) {
+    initializePhasePatternWithGivenPattern();
+  } else if (_initializationStrategy ==
+             SoIInitializationStrategy::CURRENT_ASSIGNMENT) {
     initializePhasePatternWithCurrentAssignment();
   } else if (_initializationStrategy ==
              SoIInitializationStrategy::CURRENT_ASSIGNMENT_SAT) {
@@ -146,7 +151,9 @@ void SoIManager::initializePhasePatternWithCurrentAssignmentSat() {
   std::random_shuffle(temp.begin(), temp.end());
 
   for (const auto &pair : temp) {
-    _satSolver->setDirection(pair.first->getLiteralOfPhaseStatus(pair.second));
+    if (pair.first->phaseStatusHasLiteral(pair.second))
+      _satSolver->setDirection(
+          pair.first->getLiteralOfPhaseStatus(pair.second));
   }
 
   unsigned numDiffers = _satSolver->directionAwareSolve();
@@ -159,8 +166,9 @@ void SoIManager::initializePhasePatternWithCurrentAssignmentSat() {
     }
 
     for (const auto &pair : _currentPhasePattern) {
-      for (const auto &phase : pair.first->getAllCases()) {
-        if (_satSolver->getAssignment(
+      for (const auto &phase : pair.first->getCaseSpan()) {
+        if (pair.first->phaseStatusHasLiteral(phase) &&
+            _satSolver->getAssignment(
                 pair.first->getLiteralOfPhaseStatus(phase))) {
           _currentPhasePattern[pair.first] = phase;
           break;
@@ -170,7 +178,31 @@ void SoIManager::initializePhasePatternWithCurrentAssignmentSat() {
   }
 }
 
+void SoIManager::setInitialPhasePattern(
+    const Map<PLConstraint *, PhaseStatus> &pattern) {
+  _givenPhasePattern = pattern;
+}
+
+void SoIManager::initializePhasePatternWithGivenPattern() {
+  for (const auto &plConstraint : _plConstraints) {
+    ASSERT(!_currentPhasePattern.exists(plConstraint));
+    if (plConstraint->supportSoI() && plConstraint->isActive() &&
+        !plConstraint->phaseFixed()) {
+      PhaseStatus phase = plConstraint->getPhaseStatusInAssignment();
+      if (_givenPhasePattern.exists(plConstraint)) {
+        PhaseStatus given = _givenPhasePattern[plConstraint];
+        for (const auto &candidate : plConstraint->getCaseSpan())
+          if (candidate == given && plConstraint->isFeasible(given))
+            phase = given;
+      }
+      _currentPhasePattern[plConstraint] = phase;
+    }
+  }
+  _givenPhasePattern.clear();
+}
+
 void SoIManager::proposePhasePatternUpdate() {
+  PROFILE_SCOPE("propose_update");
   struct timespec start = TimeUtils::sampleMicro();
 
   _currentPhasePattern = _lastAcceptedPhasePattern;
@@ -223,21 +255,18 @@ void SoIManager::proposePhasePatternUpdateRandomly() {
 
   // Next, pick an alternative phase.
   PhaseStatus currentPhase = _currentPhasePattern[plConstraintToUpdate];
-  List<PhaseStatus> allPhases = plConstraintToUpdate->getAllFeasibleCases();
-  allPhases.erase(currentPhase);
-  if (allPhases.size() == 1) {
+  unsigned numberOfAlternatives =
+      plConstraintToUpdate->numberOfFeasibleAlternatives(currentPhase);
+  if (numberOfAlternatives == 1) {
     // There are only two possible phases. So we just flip the phase.
-    PhaseStatus phase = *(allPhases.begin());
+    PhaseStatus phase =
+        plConstraintToUpdate->getFeasibleAlternative(currentPhase, 0);
     _currentPhasePattern[plConstraintToUpdate] = phase;
     _constraintsUpdatedInLastProposal[plConstraintToUpdate] = phase;
   } else {
-    auto it = allPhases.begin();
-    unsigned index = (unsigned)T::rand() % allPhases.size();
-    while (index > 0) {
-      ++it;
-      --index;
-    }
-    PhaseStatus phase = *it;
+    unsigned index = (unsigned)T::rand() % numberOfAlternatives;
+    PhaseStatus phase =
+        plConstraintToUpdate->getFeasibleAlternative(currentPhase, index);
     _currentPhasePattern[plConstraintToUpdate] = phase;
     _constraintsUpdatedInLastProposal[plConstraintToUpdate] = phase;
   }
@@ -266,21 +295,18 @@ void SoIManager::proposePhasePatternUpdateGreedy() {
 
   // Next, pick an alternative phase.
   PhaseStatus currentPhase = _currentPhasePattern[plConstraintToUpdate];
-  List<PhaseStatus> allPhases = plConstraintToUpdate->getAllFeasibleCases();
-  allPhases.erase(currentPhase);
-  if (allPhases.size() == 1) {
+  unsigned numberOfAlternatives =
+      plConstraintToUpdate->numberOfFeasibleAlternatives(currentPhase);
+  if (numberOfAlternatives == 1) {
     // There are only two possible phases. So we just flip the phase.
-    PhaseStatus phase = *(allPhases.begin());
+    PhaseStatus phase =
+        plConstraintToUpdate->getFeasibleAlternative(currentPhase, 0);
     _currentPhasePattern[plConstraintToUpdate] = phase;
     _constraintsUpdatedInLastProposal[plConstraintToUpdate] = phase;
   } else {
-    auto it = allPhases.begin();
-    unsigned index = (unsigned)rand() % allPhases.size();
-    while (index > 0) {
-      ++it;
-      --index;
-    }
-    PhaseStatus phase = *it;
+    unsigned index = (unsigned)rand() % numberOfAlternatives;
+    PhaseStatus phase =
+        plConstraintToUpdate->getFeasibleAlternative(currentPhase, index);
 
     // double reducedCost = 0;
     // PhaseStatus phase = PHASE_NOT_FIXED;
@@ -318,21 +344,17 @@ void SoIManager::proposePhasePatternUpdateGreedySat() {
 
       // Next, pick an alternative phase.
       PhaseStatus currentPhase = _currentPhasePattern[plConstraintToUpdate];
-      List<PhaseStatus> allPhases = plConstraintToUpdate->getAllFeasibleCases();
-      allPhases.erase(currentPhase);
-      if (allPhases.size() == 1) {
+      unsigned numberOfAlternatives =
+          plConstraintToUpdate->numberOfFeasibleAlternatives(currentPhase);
+      if (numberOfAlternatives == 1) {
         // There are only two possible phases. So we just flip the phase.
-        phase = *(allPhases.begin());
+        phase = plConstraintToUpdate->getFeasibleAlternative(currentPhase, 0);
         _currentPhasePattern[plConstraintToUpdate] = phase;
         _constraintsUpdatedInLastProposal[plConstraintToUpdate] = phase;
       } else {
-        auto it = allPhases.begin();
-        unsigned index = (unsigned)rand() % allPhases.size();
-        while (index > 0) {
-          ++it;
-          --index;
-        }
-        phase = *it;
+        unsigned index = (unsigned)rand() % numberOfAlternatives;
+        phase =
+            plConstraintToUpdate->getFeasibleAlternative(currentPhase, index);
       }
   } while (remembered(plConstraintToUpdate, phase) && attempts--);
 
@@ -345,12 +367,14 @@ void SoIManager::proposePhasePatternUpdateGreedySat() {
   std::random_shuffle(temp.begin(), temp.end());
 
   for (const auto &pair : temp) {
-    if (pair.first != plConstraintToUpdate)
+    if (pair.first != plConstraintToUpdate &&
+        pair.first->phaseStatusHasLiteral(pair.second))
       _satSolver->setDirection(
           pair.first->getLiteralOfPhaseStatus(pair.second));
   }
-  _satSolver->setDirection(
-      plConstraintToUpdate->getLiteralOfPhaseStatus(phase));
+  if (plConstraintToUpdate->phaseStatusHasLiteral(phase))
+    _satSolver->setDirection(
+        plConstraintToUpdate->getLiteralOfPhaseStatus(phase));
 
   unsigned numDiffers = _satSolver->directionAwareSolve();
   _satSolver->resetAllDirections();
@@ -362,8 +386,9 @@ void SoIManager::proposePhasePatternUpdateGreedySat() {
     }
 
     for (const auto &pair : _currentPhasePattern) {
-      for (const auto &phase : pair.first->getAllCases()) {
-        if (_satSolver->getAssignment(
+      for (const auto &phase : pair.first->getCaseSpan()) {
+        if (pair.first->phaseStatusHasLiteral(phase) &&
+            _satSolver->getAssignment(
                 pair.first->getLiteralOfPhaseStatus(phase))) {
           if (pair.second != phase) {
             _constraintsUpdatedInLastProposal[pair.first] = phase;
@@ -405,21 +430,17 @@ void SoIManager::proposePhasePatternUpdateProp() {
 
       // Next, pick an alternative phase.
       PhaseStatus currentPhase = _currentPhasePattern[plConstraintToUpdate];
-      List<PhaseStatus> allPhases = plConstraintToUpdate->getAllFeasibleCases();
-      allPhases.erase(currentPhase);
-      if (allPhases.size() == 1) {
+      unsigned numberOfAlternatives =
+          plConstraintToUpdate->numberOfFeasibleAlternatives(currentPhase);
+      if (numberOfAlternatives == 1) {
         // There are only two possible phases. So we just flip the phase.
-        phase = *(allPhases.begin());
+        phase = plConstraintToUpdate->getFeasibleAlternative(currentPhase, 0);
         _currentPhasePattern[plConstraintToUpdate] = phase;
         _constraintsUpdatedInLastProposal[plConstraintToUpdate] = phase;
       } else {
-        auto it = allPhases.begin();
-        unsigned index = (unsigned)rand() % allPhases.size();
-        while (index > 0) {
-          ++it;
-          --index;
-        }
-        phase = *it;
+        unsigned index = (unsigned)rand() % numberOfAlternatives;
+        phase =
+            plConstraintToUpdate->getFeasibleAlternative(currentPhase, index);
       }
   } while (remembered(plConstraintToUpdate, phase));
 
@@ -432,12 +453,14 @@ void SoIManager::proposePhasePatternUpdateProp() {
   std::random_shuffle(temp.begin(), temp.end());
 
   for (const auto &pair : temp) {
-    if (pair.first != plConstraintToUpdate)
+    if (pair.first != plConstraintToUpdate &&
+        pair.first->phaseStatusHasLiteral(pair.second))
       _satSolver->setDirection(
           pair.first->getLiteralOfPhaseStatus(pair.second));
   }
-  _satSolver->setDirection(
-      plConstraintToUpdate->getLiteralOfPhaseStatus(phase));
+  if (plConstraintToUpdate->phaseStatusHasLiteral(phase))
+    _satSolver->setDirection(
+        plConstraintToUpdate->getLiteralOfPhaseStatus(phase));
 
   unsigned numDiffers = _satSolver->directionAwareSolve();
   _satSolver->resetAllDirections();
@@ -449,8 +472,9 @@ void SoIManager::proposePhasePatternUpdateProp() {
     }
 
     for (const auto &pair : _currentPhasePattern) {
-      for (const auto &phase : pair.first->getAllCases()) {
-        if (_satSolver->getAssignment(
+      for (const auto &phase : pair.first->getCaseSpan()) {
+        if (pair.first->phaseStatusHasLiteral(phase) &&
+            _satSolver->getAssignment(
                 pair.first->getLiteralOfPhaseStatus(phase))) {
           if (pair.second != phase) {
             _constraintsUpdatedInLastProposal[pair.first] = phase;
@@ -658,7 +682,7 @@ void SoIManager::cacheCurrentPhasePattern(double cost) {
   info._cost = cost;
 
   for (const auto &plConstraint : _plConstraints) {
-    for (const auto &var : plConstraint->getParticipatingVariables()) {
+    for (const auto &var : plConstraint->getParticipatingVariableSpan()) {
       info._assignment[var] = _assignmentManager->getAssignment(var);
     }
   }
@@ -700,14 +724,17 @@ void SoIManager::phasePatternString(String &s) {
 
 void SoIManager::addCurrentPhasePatternAsConflict(CadicalWrapper &cadical) {
   SOI_LOG("Adding current phase pattern as conflict");
-  List<int> clause;
+  _clauseBuffer.clear();
   for (const auto &plConstraint : _plConstraints) {
-    if (_currentPhasePattern.exists(plConstraint))
-      clause.append(-plConstraint->getLiteralOfPhaseStatus(
-          _currentPhasePattern[plConstraint]));
-    else
-      clause.append(-plConstraint->getLiteralOfPhaseStatus(
+    if (_currentPhasePattern.exists(plConstraint)) {
+      PhaseStatus phase = _currentPhasePattern[plConstraint];
+      // A pattern with a phase without a literal cannot be ruled out by
+      // the SAT solver
+      if (!plConstraint->phaseStatusHasLiteral(phase)) return;
+      _clauseBuffer.append(-plConstraint->getLiteralOfPhaseStatus(phase));
+    } else if (plConstraint->getType() != PiecewiseLinearFunctionType::INTEGER)
+      _clauseBuffer.append(-plConstraint->getLiteralOfPhaseStatus(
           plConstraint->getNextFeasibleCase()));
   }
-  cadical.addConstraint(clause);
+  cadical.addClause(_clauseBuffer);
 }
@@ -66,6 +66,15 @@ class SoIManager {
   */
   void initializePhasePattern();
 
+  /*
+    Start the next call to initializePhasePattern() from the given phase
+    pattern, e.g., the one of a previous solution, instead of the configured
+    initialization strategy. Constraints without a phase in the pattern, or
+    whose phase there is no longer feasible, take the phase of the current
+    assignment.
+  */
+  void setInitialPhasePattern(const Map<PLConstraint *, PhaseStatus> &pattern);
+
   /*
     Called when the previous heuristic cost cannot be minimized to 0 (i.e., no
     satisfying assignment found for the previous activation pattern).
@@ -141,6 +150,12 @@ class SoIManager {
   */
   Map<PLConstraint *, PhaseStatus> _lastAcceptedPhasePattern;
 
+  /*
+    The phase pattern to start the next initialization from, see
+    setInitialPhasePattern().
+  */
+  Map<PLConstraint *, PhaseStatus> _givenPhasePattern;
+
   /*
     The constraints in the current phase pattern (i.e., participating in the
     SoI) stored in a Vector for ease of random access.
@@ -153,6 +168,11 @@ class SoIManager {
   */
   Map<PLConstraint *, PhaseStatus> _constraintsUpdatedInLastProposal;
 
+  /*
+    Scratch buffer for the clause blocking the current phase pattern.
+  */
+  Vector<int> _clauseBuffer;
+
   Statistics *_statistics;
 
   AssignmentManager *_assignmentManager;
@@ -178,6 +198,12 @@ class SoIManager {
   */
   void initializePhasePatternWithCurrentAssignmentSat();
 
+  /*
+    Set _currentPhasePattern according to _givenPhasePattern, and the current
+    assignment for the constraints it does not cover, then consume it.
+  */
+  void initializePhasePatternWithGivenPattern();
+
   /*
     Choose one piecewise linear constraint in the current phase pattern
     and set it to a uniform-randomly chosen alternative phase status (for ReLU
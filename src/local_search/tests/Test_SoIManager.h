@@ -150,6 +150,86 @@ class SoIManagerTestSuite : public CxxTest::TestSuite {
     }
   }
 
+  void test_initialize_with_given_pattern() {
+    Options::get()->setString(Options::SOI_INITIALIZATION_STRATEGY,
+                              "current-assignment");
+
+    CVC4::context::Context context;
+
+    InputQuery ipq;
+    BoundManager bm(context);
+    bm.initialize(6);
+    for (unsigned i = 0; i < 6; ++i) {
+      bm.setLowerBound(i, 0);
+      bm.setUpperBound(i, 1);
+    }
+    AssignmentManager am(bm);
+
+    OneHotConstraint *r1 = new OneHotConstraint({0, 1, 2});
+    OneHotConstraint *r2 = new OneHotConstraint({3, 4, 5});
+    List<PLConstraint *> constraints = {r1, r2};
+    for (const auto &constraint : constraints) {
+      constraint->initializeCDOs(&context);
+      constraint->registerBoundManager(&bm);
+      constraint->registerAssignmentManager(&am);
+      ipq.addPLConstraint(constraint);
+    }
+
+    SoIManager soiManager(ipq);
+    soiManager.setAssignmentManager(&am);
+
+    am.setAssignment(0, 0.1);
+    am.setAssignment(1, 0.1);
+    am.setAssignment(2, 0.8);
+    am.setAssignment(3, 0.5);
+    am.setAssignment(4, 0.4);
+    am.setAssignment(5, 0.1);
+
+    // The given phase of r2 is infeasible, so r2 takes the phase of the
+    // current assignment
+    r2->notifyUpperBound(4, 0);
+    Map<PLConstraint *, PhaseStatus> given;
+    given[r1] = r1->getPhaseOfElement(0);
+    given[r2] = r2->getPhaseOfElement(4);
+    soiManager.setInitialPhasePattern(given);
+
+    {
+      TS_ASSERT_THROWS_NOTHING(soiManager.initializePhasePattern());
+      LinearExpression correct;
+      correct._constant = 2;
+      correct._addends[0] = -1;
+      correct._addends[3] = -1;
+      TS_ASSERT_EQUALS(correct, soiManager.getCurrentSoIPhasePattern());
+      TS_ASSERT_EQUALS(correct, soiManager.getLastAcceptedSoIPhasePattern());
+    }
+
+    // The given pattern is only used once
+    {
+      TS_ASSERT_THROWS_NOTHING(soiManager.initializePhasePattern());
+      LinearExpression correct;
+      correct._constant = 2;
+      correct._addends[2] = -1;
+      correct._addends[3] = -1;
+      TS_ASSERT_EQUALS(correct, soiManager.getCurrentSoIPhasePattern());
+    }
+
+    // Without a given pattern, the "given" strategy falls back to the
+    // current assignment
+    Options::get()->setString(Options::SOI_INITIALIZATION_STRATEGY, "given");
+    SoIManager givenSoIManager(ipq);
+    givenSoIManager.setAssignmentManager(&am);
+    {
+      TS_ASSERT_THROWS_NOTHING(givenSoIManager.initializePhasePattern());
+      LinearExpression correct;
+      correct._constant = 2;
+      correct._addends[2] = -1;
+      correct._addends[3] = -1;
+      TS_ASSERT_EQUALS(correct, givenSoIManager.getCurrentSoIPhasePattern());
+    }
+    Options::get()->setString(Options::SOI_INITIALIZATION_STRATEGY,
+                              "current-assignment");
+  }
+
   void test_initialize_and_greedy() {
     Options::get()->setString(Options::SOI_INITIALIZATION_STRATEGY,
                               "current-assignment");
@@ -0,0 +1,176 @@
+/*********************                                                        */
+/*! \file BatchSolver.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#include "BatchSolver.h"
+
+#include <sys/stat.h>
+
+#include <cmath>
+#include <list>
+#include <thread>
+
+#include "CommonError.h"
+#include "DnCManager.h"
+#include "Error.h"
+#include "File.h"
+#include "GurobiWrapper.h"
+#include "InputQuery.h"
+#include "MStringf.h"
+#include "Map.h"
+#include "MpsParser.h"
+#include "SoyError.h"
+#include "TimeUtils.h"
+
+BatchSolver::BatchSolver(const Vector<String> &queryPaths, unsigned coreBudget,
+                         unsigned workersPerQuery, unsigned timeoutInSeconds)
+    : _queryPaths(queryPaths),
+      _workersPerQuery(workersPerQuery > 0 ? workersPerQuery : 1),
+      _numberOfThreads(1),
+      _timeoutInSeconds(timeoutInSeconds),
+      _results(queryPaths.size()),
+      _totalTimeMicro(0),
+      _nextQuery(0) {
+  if (coreBudget == 0) coreBudget = std::thread::hardware_concurrency();
+  if (coreBudget / _workersPerQuery > 1)
+    _numberOfThreads = coreBudget / _workersPerQuery;
+  if (_numberOfThreads > _queryPaths.size() && _queryPaths.size() > 0)
+    _numberOfThreads = _queryPaths.size();
+}
+
+void BatchSolver::run() {
+  printf("BatchSolver: %u queries, %u at a time with %u workers each\n",
+         _queryPaths.size(), _numberOfThreads, _workersPerQuery);
+
+  GurobiWrapper::setReuseEnvironments(true);
+  struct timespec start = TimeUtils::sampleMicro();
+
+  _nextQuery = 0;
+  std::list<std::thread> threads;
+  for (unsigned i = 0; i < _numberOfThreads; ++i)
+    threads.push_back(std::thread(&BatchSolver::solveQueries, this));
+  for (auto &thread : threads) thread.join();
+
+  struct timespec end = TimeUtils::sampleMicro();
+  _totalTimeMicro = TimeUtils::timePassed(start, end);
+  GurobiWrapper::setReuseEnvironments(false);
+}
+
+void BatchSolver::solveQueries() {
+  unsigned index;
+  while ((index = _nextQuery++) < _queryPaths.size()) solveQuery(index);
+}
+
+void BatchSolver::solveQuery(unsigned index) {
+  QueryResult &result = _results[index];
+  result._queryPath = _queryPaths[index];
+  result._visitedTreeStates = 0;
+
+  struct timespec start = TimeUtils::sampleMicro();
+  try {
+    if (!File::exists(result._queryPath))
+      throw SoyError(SoyError::FILE_DOESNT_EXIST, result._queryPath.ascii());
+
+    InputQuery inputQuery;
+    MpsParser(result._queryPath).generateQuery(inputQuery);
+
+    DnCManager dncManager(&inputQuery);
+    dncManager.solve(_timeoutInSeconds, _workersPerQuery);
+    result._result = dncManager.getResultString();
+    result._visitedTreeStates = dncManager.getNumberOfVisitedTreeStates();
+  } catch (const Error &e) {
+    std::lock_guard<std::mutex> lock(_printMutex);
+    printf("BatchSolver: %s: caught a %s error. Code: %u, Message: %s.\n",
+           result._queryPath.ascii(), e.getErrorClass(), e.getCode(),
+           e.getUserMessage());
+    result._result = "ERROR";
+  }
+  struct timespec end = TimeUtils::sampleMicro();
+  result._timeMicro = TimeUtils::timePassed(start, end);
+
+  std::lock_guard<std::mutex> lock(_printMutex);
+  printf("BatchSolver: [%u/%u] %s %s %.3f s\n", index + 1, _queryPaths.size(),
+         result._queryPath.ascii(), result._result.ascii(),
+         result._timeMicro / 1000000.0);
+  fflush(stdout);
+}
+
+void BatchSolver::printStatistics() const {
+  Map<String, unsigned> queriesOfResult;
+  Vector<unsigned long long> times;
+  for (const auto &result : _results) {
+    if (!queriesOfResult.exists(result._result))
+      queriesOfResult[result._result] = 0;
+    ++queriesOfResult[result._result];
+    times.append(result._timeMicro);
+  }
+
+  printf("BatchSolver: %u queries in %.3f s\n", _results.size(),
+         _totalTimeMicro / 1000000.0);
+  for (const auto &pair : queriesOfResult)
+    printf("\t%s: %u\n", pair.first.ascii(), pair.second);
+  if (_totalTimeMicro > 0)
+    printf("\tThroughput: %.2f queries/s\n",
+           _results.size() * 1000000.0 / _totalTimeMicro);
+  printf("\tLatency (ms): p50 %.3f, p90 %.3f, p99 %.3f, max %.3f\n",
+         getPercentile(times, 50) / 1000.0, getPercentile(times, 90) / 1000.0,
+         getPercentile(times, 99) / 1000.0,
+         getPercentile(times, 100) / 1000.0);
+}
+
+void BatchSolver::writeSummaryFile(const String &path) const {
+  File summaryFile(path);
+  summaryFile.open(File::MODE_WRITE_TRUNCATE);
+  for (const auto &result : _results)
+    summaryFile.write(result._queryPath +
+                      Stringf(" %s %llu %llu\n", result._result.ascii(),
+                              result._timeMicro, result._visitedTreeStates));
+}
+
+void BatchSolver::collectQueryPaths(const String &path,
+                                    Vector<String> &queryPaths) {
+  struct stat status;
+  if (stat(path.ascii(), &status) != 0)
+    throw SoyError(SoyError::FILE_DOESNT_EXIST, path.ascii());
+
+  if (S_ISDIR(status.st_mode)) {
+    File::listDirectory(path, ".mps", queryPaths);
+    return;
+  }
+
+  String directory = "";
+  int separator = path.length() - 1;
+  while (separator >= 0 && path[separator] != '/') --separator;
+  if (separator >= 0) directory = path.substring(0, separator + 1);
+
+  File manifest(path);
+  manifest.open(File::MODE_READ);
+  while (true) {
+    String line;
+    try {
+      line = manifest.readLine().trim();
+    } catch (const CommonError &e) {
+      if (e.getCode() == CommonError::READ_FAILED) break;
+      throw;
+    }
+
+    if (line.length() == 0 || line[0] == '#') continue;
+    queryPaths.append(line[0] == '/' ? line : directory + line);
+  }
+}
+
+unsigned long long BatchSolver::getPercentile(Vector<unsigned long long> times,
+                                              double percentile) {
+  if (times.empty()) return 0;
+  times.sort();
+  unsigned rank = (unsigned)std::ceil(percentile / 100 * times.size());
+  if (rank < 1) rank = 1;
+  if (rank > times.size()) rank = times.size();
+  return times[rank - 1];
+}
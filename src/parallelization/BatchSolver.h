@@ -0,0 +1,106 @@
+/*********************                                                        */
+/*! \file BatchSolver.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Solves many query files in one process, e.g., the thousands of small
+ ** queries of a controller validation, so that they do not each pay for
+ ** starting the process and for checking the Gurobi license. The queries run
+ ** concurrently on a fixed pool of threads: with a budget of c cores and w
+ ** workers per query, c / w queries are solved at a time, each by a
+ ** DnCManager with w workers. The Gurobi environments of finished queries
+ ** are reused, see GurobiWrapper::setReuseEnvironments().
+ **
+ ** The result of each query is reported as soon as it is solved, and the
+ ** throughput and the latency percentiles at the end.
+ **/
+
+#ifndef __BatchSolver_h__
+#define __BatchSolver_h__
+
+#include <atomic>
+#include <mutex>
+
+#include "MString.h"
+#include "Vector.h"
+
+class BatchSolver {
+ public:
+  struct QueryResult {
+    String _queryPath;
+    // sat/unsat/TIMEOUT/ERROR/..., as in the summary file
+    String _result;
+    unsigned long long _timeMicro;
+    unsigned long long _visitedTreeStates;
+  };
+
+  BatchSolver(const Vector<String> &queryPaths, unsigned coreBudget,
+              unsigned workersPerQuery, unsigned timeoutInSeconds);
+
+  /*
+    Solve all the queries. A query that fails is reported as ERROR, and the
+    others are solved as usual.
+  */
+  void run();
+
+  // In the order of the query paths
+  const Vector<QueryResult> &getResults() const { return _results; }
+
+  // Queries solved at a time
+  unsigned getNumberOfThreads() const { return _numberOfThreads; }
+
+  /*
+    Print the number of queries of each result, the throughput and the
+    latency percentiles
+  */
+  void printStatistics() const;
+
+  /*
+    Write a line per query, "<query> <result> <microseconds> <visited tree
+    states>", in the order of the query paths
+  */
+  void writeSummaryFile(const String &path) const;
+
+  /*
+    The queries of a batch: the .mps files of a directory, sorted by name,
+    or the lines of a manifest file, skipping empty lines and lines starting
+    with '#'. Relative paths of a manifest are relative to its directory.
+    Throws a SoyError if the path does not exist.
+  */
+  static void collectQueryPaths(const String &path,
+                                Vector<String> &queryPaths);
+
+  /*
+    The nearest-rank percentile, in [0, 100], of the times. 0 if there are
+    none.
+  */
+  static unsigned long long getPercentile(Vector<unsigned long long> times,
+                                          double percentile);
+
+ private:
+  Vector<String> _queryPaths;
+  unsigned _workersPerQuery;
+  unsigned _numberOfThreads;
+  unsigned _timeoutInSeconds;
+
+  Vector<QueryResult> _results;
+  unsigned long long _totalTimeMicro;
+
+  // The next query to solve, shared by the threads
+  std::atomic_uint _nextQuery;
+  // Keeps the report lines of different threads apart
+  std::mutex _printMutex;
+
+  /*
+    The loop of a thread: solve the next query until there are none
+  */
+  void solveQueries();
+
+  void solveQuery(unsigned index);
+};
+
+#endif  // __BatchSolver_h__
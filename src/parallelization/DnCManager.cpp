@@ -24,12 +24,14 @@
 #include "DnCWorker.h"
 #include "GetCPUData.h"
 #include "GlobalConfiguration.h"
+#include "InfeasibleQueryException.h"
 #include "MStringf.h"
 #include "SoyError.h"
 #include "MpsParser.h"
 #include "Options.h"
 #include "PiecewiseLinearCaseSplit.h"
 #include "TimeUtils.h"
+#include "TraceRecorder.h"
 #include "Vector.h"
 
 #ifdef ENABLE_OPENBLAS
@@ -48,9 +50,14 @@ void DnCManager::dncSolve(WorkerQueue *workload, std::shared_ptr<Engine> engine,
 
   getCPUId(cpuId);
   DNC_MANAGER_LOG(Stringf("Thread #%u on CPU %u", threadId, cpuId).ascii());
+  TraceRecorder::setThreadName(Stringf("worker %u", threadId));
 
   engine->setRandomSeed(seed);
-  if (threadId != 0) engine->processInputQuery(*inputQuery, false);
+  if (threadId != 0) {
+    // The query of the base engine comes with its root cuts
+    engine->setRootCutsAdded();
+    engine->processInputQuery(*inputQuery, false);
+  }
 
   DnCWorker worker(workload, engine, std::ref(numUnsolvedSubQueries),
                    std::ref(shouldQuitSolving), threadId, verbosity);
@@ -65,7 +72,11 @@ DnCManager::DnCManager(InputQuery *inputQuery)
       _workload(NULL),
       _timeoutReached(false),
       _numUnsolvedSubQueries(0),
-      _verbosity(Options::get()->getInt(Options::VERBOSITY)) {}
+      _shouldQuitSolving(false),
+      _quitRequested(false),
+      _verbosity(Options::get()->getInt(Options::VERBOSITY)) {
+  _presolve = !Options::get()->getBool(Options::NO_PRESOLVE);
+}
 
 DnCManager::~DnCManager() { freeMemoryIfNeeded(); }
 
@@ -83,9 +94,13 @@ void DnCManager::freeMemoryIfNeeded() {
 }
 
 void DnCManager::solve() {
+  solve(Options::get()->getInt(Options::TIMEOUT),
+        Options::get()->getInt(Options::NUM_WORKERS));
+}
+
+void DnCManager::solve(unsigned timeoutInSeconds, unsigned numWorkers) {
   enum { MICROSECONDS_IN_SECOND = 1000000 };
 
-  unsigned timeoutInSeconds = Options::get()->getInt(Options::TIMEOUT);
   unsigned long long timeoutInMicroSeconds =
       (unsigned long long)timeoutInSeconds *
       (unsigned long long)MICROSECONDS_IN_SECOND;
@@ -94,10 +109,9 @@ void DnCManager::solve() {
 
   struct timespec startTime = TimeUtils::sampleMicro();
 
-  unsigned numWorkers = Options::get()->getInt(Options::NUM_WORKERS);
-
   // Preprocess the input query and create an engine for each of the threads
   if (!createEngines(numWorkers)) {
+    _statisticsAggregator.snapshot();
     _exitCode = DnCManager::UNSAT;
     return;
   }
@@ -128,10 +142,9 @@ void DnCManager::solve() {
 
   // Create objects shared across workers
   _numUnsolvedSubQueries = 1;
-  std::atomic_bool shouldQuitSolving(false);
-  WorkerQueue *workload = new WorkerQueue(0);
+  _shouldQuitSolving = _quitRequested.load();
   for (auto &subQuery : subQueries) {
-    if (!workload->push(subQuery)) {
+    if (!_workload->push(subQuery)) {
       // This should never happen
       ASSERT(false);
     }
@@ -145,9 +158,9 @@ void DnCManager::solve() {
   if (numWorkers == 1) {
     for (unsigned threadId = 0; threadId < numWorkers; ++threadId) {
       std::unique_ptr<InputQuery> inputQuery = nullptr;
-      dncSolve(workload, _engines[threadId],
+      dncSolve(_workload, _engines[threadId],
                threadId != 0 ? std::move(inputQuery) : nullptr,
-               std::ref(_numUnsolvedSubQueries), std::ref(shouldQuitSolving), threadId,
+               std::ref(_numUnsolvedSubQueries), std::ref(_shouldQuitSolving), threadId,
                _verbosity, seed + threadId);
     }
   } else {
@@ -161,18 +174,18 @@ void DnCManager::solve() {
           std::unique_ptr<InputQuery>(new InputQuery(*(baseInputQuery)));
 
     threads.push_back(std::thread(
-        dncSolve, workload, _engines[threadId],
+        dncSolve, _workload, _engines[threadId],
         threadId != 0 ? std::move(inputQuery) : nullptr,
-        std::ref(_numUnsolvedSubQueries), std::ref(shouldQuitSolving), threadId,
+        std::ref(_numUnsolvedSubQueries), std::ref(_shouldQuitSolving), threadId,
         _verbosity, seed + threadId));
   }
 
   // Wait until either all subQueries are solved or a satisfying assignment is
   // found by some worker
-  while (!shouldQuitSolving.load()) {
+  while (!_shouldQuitSolving.load()) {
     updateTimeoutReached(startTime, timeoutInMicroSeconds);
     if (_timeoutReached)
-      shouldQuitSolving = true;
+      _shouldQuitSolving = true;
     else
       std::this_thread::sleep_for(std::chrono::milliseconds(numWorkers));
   }
@@ -182,22 +195,51 @@ void DnCManager::solve() {
 
   for (auto &thread : threads) thread.join();
   }
+  _statisticsAggregator.snapshot();
   updateDnCExitCode();
   return;
 }
 
+void DnCManager::quitSignal() {
+  _quitRequested = true;
+  _shouldQuitSolving = true;
+  std::lock_guard<std::mutex> lock(_enginesMutex);
+  for (auto &engine : _engines) engine->quitSignal();
+}
+
 DnCManager::DnCExitCode DnCManager::getExitCode() const { return _exitCode; }
 
 void DnCManager::extractSolution(const MpsParser &mpsParser,
                                  Map<String, double> &solution) {
-  for (const auto &pair : mpsParser.getVariableNameToVariableIndex())
-    solution[pair.first] = _engineWithSATAssignment->getAssignment(pair.second);
+  extractSolution(mpsParser.getVariableNameToVariableIndex(), solution);
+}
+
+void DnCManager::extractSolution(const Map<String, unsigned> &variableNames,
+                                 Map<String, double> &solution) {
+  Vector<double> assignment;
+  getAssignment(assignment);
+  for (const auto &pair : variableNames)
+    solution[pair.first] = assignment[pair.second];
+}
+
+void DnCManager::getAssignment(Vector<double> &assignment) const {
+  unsigned numberOfVariables =
+      _engineWithSATAssignment->getInputQuery()->getNumberOfVariables();
+  assignment.clear();
+  for (unsigned i = 0; i < numberOfVariables; ++i)
+    assignment.append(_engineWithSATAssignment->getAssignment(i));
+
+  if (_presolvedQuery) {
+    Vector<double> presolvedAssignment = assignment;
+    _presolver.postsolve(presolvedAssignment, assignment);
+  }
 }
 
 void DnCManager::updateDnCExitCode() {
   bool hasSat = false;
   bool hasError = false;
   bool hasQuitRequested = false;
+  bool hasTimeout = false;
   for (auto &engine : _engines) {
     Engine::ExitCode result = engine->getExitCode();
     if (result == Engine::SAT) {
@@ -208,14 +250,16 @@ void DnCManager::updateDnCExitCode() {
       hasError = true;
     else if (result == Engine::QUIT_REQUESTED)
       hasQuitRequested = true;
+    else if (result == Engine::TIMEOUT)
+      hasTimeout = true;
   }
   if (hasSat)
     _exitCode = DnCManager::SAT;
-  else if (_timeoutReached)
+  else if (_timeoutReached || hasTimeout)
     _exitCode = DnCManager::TIMEOUT;
   else if (_numUnsolvedSubQueries.load() <= 0)
     _exitCode = DnCManager::UNSAT;
-  else if (hasQuitRequested)
+  else if (hasQuitRequested || _quitRequested.load())
     _exitCode = DnCManager::QUIT_REQUESTED;
   else if (hasError)
     _exitCode = DnCManager::ERROR;
@@ -245,19 +289,33 @@ String DnCManager::getResultString() {
   }
 }
 
-double DnCManager::getAverageTimePerSoICheck() {
-  auto stats = (*_engines.begin())->getStatistics();
-  return stats->getUnsignedAttribute(Statistics::NUM_VISITED_TREE_STATES);
+unsigned long long DnCManager::getNumberOfVisitedTreeStates() const {
+  return _statisticsAggregator.getSum(Statistics::NUM_VISITED_TREE_STATES);
 }
 
-double DnCManager::getAverageProposalPerDeepSoI() {
-  auto stats = (*_engines.begin())->getStatistics();
-  unsigned numPhasePatternInitializations =
-    stats->getUnsignedAttribute(Statistics::NUM_PHASE_PATTERN_INITIALIZATIONS);
+double DnCManager::getAverageTimePerSoICheck() const {
+  unsigned long long timeMicro = _statisticsAggregator.getSum(
+      Statistics::TOTAL_TIME_MINIMIZING_SOI_COST_WITH_GUROBI_MICRO);
+  unsigned long long numChecks =
+      _statisticsAggregator.getSum(
+          Statistics::NUM_PROPOSED_PHASE_PATTERN_UPDATE) +
+      _statisticsAggregator.getSum(
+          Statistics::NUM_PHASE_PATTERN_INITIALIZATIONS);
+
+  if (numChecks == 0) return 0;
+  return (double)timeMicro / numChecks / 1000;
+}
+
+double DnCManager::getAverageProposalPerDeepSoI() const {
+  unsigned long long numPhasePatternInitializations =
+      _statisticsAggregator.getSum(
+          Statistics::NUM_PHASE_PATTERN_INITIALIZATIONS);
   unsigned long long numProposedPhasePatternUpdate =
-    stats->getLongAttribute(Statistics::NUM_PROPOSED_PHASE_PATTERN_UPDATE);
+      _statisticsAggregator.getSum(
+          Statistics::NUM_PROPOSED_PHASE_PATTERN_UPDATE);
 
-  return (double) numProposedPhasePatternUpdate / numPhasePatternInitializations;
+  if (numPhasePatternInitializations == 0) return 0;
+  return (double)numProposedPhasePatternUpdate / numPhasePatternInitializations;
 }
 
 
@@ -267,8 +325,10 @@ void DnCManager::getSolution(std::map<int, double> &ret,
   InputQuery *solvedInputQuery = _engineWithSATAssignment->getInputQuery();
   _engineWithSATAssignment->extractSolution(*(solvedInputQuery));
 
+  Vector<double> assignment;
+  getAssignment(assignment);
   for (unsigned i = 0; i < inputQuery.getNumberOfVariables(); ++i) {
-    double value = solvedInputQuery->getSolutionValue(i);
+    double value = assignment[i];
     inputQuery.setSolutionValue(i, value);
     ret[i] = value;
   }
@@ -311,23 +371,53 @@ void DnCManager::printResult() {
 bool DnCManager::createEngines(unsigned numberOfEngines) {
   // Create the base engine
   _baseEngine = std::make_shared<Engine>();
-  _engines.append(_baseEngine);
-  if (!_baseEngine->processInputQuery(*_baseInputQuery))
+  appendEngine(_baseEngine);
+  _statisticsAggregator.addWorker(_baseEngine->getStatistics());
+  // The engines solve the presolved query, over its own variables
+  InputQuery *inputQuery = _baseInputQuery;
+  SolutionHint hint = _hint;
+  if (_presolve) {
+    _presolvedQuery = std::unique_ptr<InputQuery>(new InputQuery);
+    _presolver.setStatistics(_baseEngine->getStatistics());
+    _presolver.setMaxFillIn(
+        Options::get()->getInt(Options::CONDENSE_FILL_IN));
+    try {
+      _presolver.presolve(*_baseInputQuery, *_presolvedQuery);
+    } catch (const InfeasibleQueryException &) {
+      return false;
+    }
+    _presolver.presolveHint(_hint, hint);
+    inputQuery = _presolvedQuery.get();
+  }
+
+  if (!_baseEngine->processInputQuery(*inputQuery))
     // Solved by preprocessing, we are done!
     return false;
 
+  // Once for all engines, which copy the query of the base engine
+  if (!_baseEngine->addRootCuts()) return false;
+
   _baseEngine->setVerbosity(_verbosity);
+  _baseEngine->setHint(hint);
 
   // Create engines for each thread
   for (unsigned i = 1; i < numberOfEngines; ++i) {
     auto engine = std::make_shared<Engine>();
     engine->setVerbosity(0);
-    _engines.append(engine);
+    appendEngine(engine);
+    _statisticsAggregator.addWorker(engine->getStatistics());
   }
 
   return true;
 }
 
+void DnCManager::appendEngine(std::shared_ptr<Engine> engine) {
+  std::lock_guard<std::mutex> lock(_enginesMutex);
+  // An engine created after quitSignal() quits right away
+  if (_quitRequested) engine->quitSignal();
+  _engines.append(engine);
+}
+
 void DnCManager::updateTimeoutReached(
     timespec startTime, unsigned long long timeoutInMicroSeconds) {
   if (timeoutInMicroSeconds == 0) return;
@@ -17,9 +17,13 @@
 #define __DnCManager_h__
 
 #include <atomic>
+#include <memory>
+#include <mutex>
 
 #include "Engine.h"
 #include "InputQuery.h"
+#include "Presolver.h"
+#include "StatisticsAggregator.h"
 #include "SubQuery.h"
 #include "Vector.h"
 
@@ -47,25 +51,60 @@ class DnCManager {
   void freeMemoryIfNeeded();
 
   /*
-    Perform the Divide-and-conquer solving
+    Perform the Divide-and-conquer solving, with the timeout and the number
+    of workers of the options
   */
   void solve();
 
+  /*
+    Perform the Divide-and-conquer solving with the given timeout (0 for
+    none) and number of workers
+  */
+  void solve(unsigned timeoutInSeconds, unsigned numWorkers);
+
+  /*
+    Ask the workers to stop, from any thread. The solve ends with
+    QUIT_REQUESTED unless it was already decided. Sticky: a solve that has
+    not started yet quits right away.
+  */
+  void quitSignal();
+
   /*
     Return the DnCExitCode of the DnCManager
   */
   DnCExitCode getExitCode() const;
 
   void extractSolution(const MpsParser &mpsParser, Map<String, double> &solution);
+  // The values of the variables, by name
+  void extractSolution(const Map<String, unsigned> &variableNames,
+                       Map<String, double> &solution);
+
+  /*
+    Warm start the base engine from the hint, see Engine::setHint()
+  */
+  void setHint(const SolutionHint &hint) { _hint = hint; }
 
   /*
     Get the string representation of the exitcode
   */
   String getResultString();
 
-  double getAverageTimePerSoICheck();
+  /*
+    Statistics merged over all workers, as of the end of solve()
+  */
+  const StatisticsAggregator &getStatisticsAggregator() const {
+    return _statisticsAggregator;
+  }
 
-  double getAverageProposalPerDeepSoI();
+  unsigned long long getNumberOfVisitedTreeStates() const;
+
+  /*
+    Average time (in milliseconds) of an LP solve during the SoI-based local
+    search
+  */
+  double getAverageTimePerSoICheck() const;
+
+  double getAverageProposalPerDeepSoI() const;
 
   /*
     Print the result of DnC solving
@@ -93,12 +132,23 @@ class DnCManager {
   */
   bool createEngines(unsigned numberOfEngines);
 
+  /*
+    Add an engine to _engines, passing on an earlier quitSignal()
+  */
+  void appendEngine(std::shared_ptr<Engine> engine);
+
   /*
     Read the exitCode of the engine of each thread, and update the manager's
     exitCode.
   */
   void updateDnCExitCode();
 
+  /*
+    The satisfying assignment of the variables of the input query, through
+    the presolver if it ran
+  */
+  void getAssignment(Vector<double> &assignment) const;
+
   /*
     Set _timeoutReached to true if timeout has been reached
   */
@@ -115,17 +165,40 @@ class DnCManager {
   */
   Vector<std::shared_ptr<Engine>> _engines;
 
+  /*
+    Guards _engines against quitSignal()
+  */
+  std::mutex _enginesMutex;
+
+  /*
+    Collects the statistics of _engines
+  */
+  StatisticsAggregator _statisticsAggregator;
+
   /*
     The engine with the satisfying assignment
   */
   std::shared_ptr<Engine> _engineWithSATAssignment;
 
+  /*
+    Given to the base engine once the query is processed
+  */
+  SolutionHint _hint;
+
   /*
     Alternatively, we could construct the DnCManager by directly providing the
     inputQuery instead of the network and property filepaths.
   */
   InputQuery *_baseInputQuery;
 
+  /*
+    The reduced input query solved by the engines, if presolving is on, and
+    the map back to the variables of the input query
+  */
+  std::unique_ptr<InputQuery> _presolvedQuery;
+  Presolver _presolver;
+  bool _presolve;
+
   /*
     The exit code of the DnCManager.
   */
@@ -146,6 +219,13 @@ class DnCManager {
   */
   std::atomic_int _numUnsolvedSubQueries;
 
+  /*
+    Set by the workers when the query is decided, on timeout and by
+    quitSignal()
+  */
+  std::atomic_bool _shouldQuitSolving;
+  std::atomic_bool _quitRequested;
+
   /*
     The level of verbosity
   */
@@ -64,6 +64,9 @@ void DnCWorker::popOneSubQueryAndSolve() {
         // case SAT
         *_numUnsolvedSubQueries -= 1;
         delete subQuery;
+      } else if (result == Engine::TIMEOUT) {
+        // case TIMEOUT, the time of the whole query is up
+        delete subQuery;
       } else if (result == Engine::ERROR) {
         // case ERROR
         std::cout << "Error!" << std::endl;
@@ -0,0 +1,438 @@
+/*********************                                                        */
+/*! \file SolverDaemon.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#include "SolverDaemon.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <list>
+
+#include "CommonError.h"
+#include "DnCManager.h"
+#include "Error.h"
+#include "File.h"
+#include "GurobiWrapper.h"
+#include "HintParser.h"
+#include "InputQuery.h"
+#include "MStringf.h"
+#include "MpsParser.h"
+#include "SoyError.h"
+#include "TimeUtils.h"
+
+SolverDaemon::Connection::Connection(int descriptor)
+    : _finished(false), _descriptor(descriptor) {}
+
+SolverDaemon::Connection::~Connection() { ::close(_descriptor); }
+
+bool SolverDaemon::Connection::readLine(String &line) {
+  enum {
+    SIZE_OF_BUFFER = 4096,
+  };
+
+  size_t separator;
+  while ((separator = _readBuffer.find('\n')) == std::string::npos) {
+    char buffer[SIZE_OF_BUFFER];
+    ssize_t n = ::read(_descriptor, buffer, SIZE_OF_BUFFER);
+    if (n <= 0) return false;
+    _readBuffer.append(buffer, n);
+  }
+
+  std::string result = _readBuffer.substr(0, separator);
+  _readBuffer.erase(0, separator + 1);
+  if (!result.empty() && result[result.size() - 1] == '\r')
+    result.erase(result.size() - 1);
+  line = String(result.c_str());
+  return true;
+}
+
+void SolverDaemon::Connection::send(const String &line) {
+  std::lock_guard<std::mutex> lock(_sendMutex);
+  sendLocked(line);
+}
+
+void SolverDaemon::Connection::sendLocked(const String &line) {
+  String message = line + "\n";
+  const char *data = message.ascii();
+  size_t remaining = message.length();
+  while (remaining > 0) {
+    // MSG_NOSIGNAL: a client that disconnected must not kill the daemon
+    ssize_t n = ::send(_descriptor, data, remaining, MSG_NOSIGNAL);
+    if (n <= 0) return;
+    data += n;
+    remaining -= n;
+  }
+}
+
+void SolverDaemon::Connection::close() { ::shutdown(_descriptor, SHUT_RDWR); }
+
+SolverDaemon::SolverDaemon(const String &socketPath, unsigned poolSize)
+    : _socketPath(socketPath),
+      _poolSize(poolSize > 0 ? poolSize : 1),
+      _listeningDescriptor(-1),
+      _shuttingDown(false),
+      _nextRequestId(0),
+      _freeSlots(_poolSize) {}
+
+SolverDaemon::~SolverDaemon() {
+  SignalHandler::getInstance()->unregisterClient(this);
+  if (_listeningDescriptor != -1) {
+    ::close(_listeningDescriptor);
+    ::unlink(_socketPath.ascii());
+  }
+}
+
+void SolverDaemon::run() {
+  openSocket();
+
+  SignalHandler::getInstance()->initialize();
+  SignalHandler::getInstance()->registerClient(this);
+
+  // Check the license and create the environments of the first solves now,
+  // rather than when the first query arrives
+  GurobiWrapper::setReuseEnvironments(true);
+  {
+    std::list<std::unique_ptr<GurobiWrapper>> warm;
+    for (unsigned i = 0; i < _poolSize; ++i)
+      warm.push_back(std::unique_ptr<GurobiWrapper>(new GurobiWrapper));
+  }
+
+  for (unsigned i = 0; i < _poolSize; ++i)
+    _runners.push_back(std::thread(&SolverDaemon::runRequests, this));
+
+  printf("SolverDaemon: listening on %s with %u workers\n",
+         _socketPath.ascii(), _poolSize);
+  fflush(stdout);
+
+  while (!_shuttingDown) {
+    int descriptor = ::accept(_listeningDescriptor, NULL, NULL);
+    if (descriptor == -1) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      // Also how shutdown() wakes up the loop
+      break;
+    }
+
+    auto connection = std::make_shared<Connection>(descriptor);
+    std::lock_guard<std::mutex> lock(_mutex);
+    reapConnections();
+    _connections.append(connection);
+    connection->_thread =
+        std::thread(&SolverDaemon::serveConnection, this, connection);
+  }
+  shutdown();
+
+  // Cancel the solves, and wait for the pool and the clients
+  List<std::shared_ptr<Request>> cancelled;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    cancelled = _queue;
+    _queue.clear();
+    for (const auto &pair : _running) {
+      pair.second->_cancelled = true;
+      if (pair.second->_manager) pair.second->_manager->quitSignal();
+    }
+  }
+  _requestsChanged.notify_all();
+  for (const auto &request : cancelled)
+    request->_connection->send(Stringf("cancelled %u", request->_id));
+  for (auto &runner : _runners) runner.join();
+  _runners.clear();
+
+  List<std::shared_ptr<Connection>> connections;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    connections = _connections;
+    _connections.clear();
+  }
+  for (auto &connection : connections) {
+    connection->close();
+    connection->_thread.join();
+  }
+
+  GurobiWrapper::setReuseEnvironments(false);
+  printf("SolverDaemon: shut down\n");
+}
+
+void SolverDaemon::shutdown() {
+  _shuttingDown = true;
+  // Wakes up accept()
+  if (_listeningDescriptor != -1)
+    ::shutdown(_listeningDescriptor, SHUT_RDWR);
+}
+
+void SolverDaemon::openSocket() {
+  struct sockaddr_un address;
+  if (_socketPath.length() >= sizeof(address.sun_path))
+    throw CommonError(CommonError::OPEN_FAILED,
+                      (String("Socket path too long: ") + _socketPath).ascii());
+
+  _listeningDescriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (_listeningDescriptor == -1)
+    throw CommonError(CommonError::OPEN_FAILED, _socketPath.ascii());
+
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, _socketPath.ascii(), sizeof(address.sun_path) - 1);
+
+  // A socket left behind by a daemon that was killed
+  ::unlink(_socketPath.ascii());
+
+  if (::bind(_listeningDescriptor, (struct sockaddr *)&address,
+             sizeof(address)) == -1 ||
+      ::listen(_listeningDescriptor, SOMAXCONN) == -1) {
+    ::close(_listeningDescriptor);
+    _listeningDescriptor = -1;
+    throw CommonError(CommonError::OPEN_FAILED, _socketPath.ascii());
+  }
+}
+
+void SolverDaemon::serveConnection(std::shared_ptr<Connection> connection) {
+  String line;
+  while (!_shuttingDown && connection->readLine(line)) {
+    List<String> arguments = line.tokenize(" \t");
+    if (arguments.empty()) continue;
+
+    String command = arguments.front();
+    arguments.erase(arguments.begin());
+    if (command == "solve") {
+      enqueueRequest(connection, arguments);
+    } else if (command == "cancel" && arguments.size() == 1) {
+      cancelRequest(connection, atoi(arguments.front().ascii()));
+    } else if (command == "shutdown") {
+      shutdown();
+    } else {
+      // Client text is appended rather than formatted, Stringf is bounded
+      connection->send(String("error - unknown command: ") + line);
+    }
+  }
+
+  cancelRequestsOf(connection);
+  connection->_finished = true;
+}
+
+void SolverDaemon::enqueueRequest(std::shared_ptr<Connection> connection,
+                                  const List<String> &arguments) {
+  auto request = std::make_shared<Request>();
+  request->_timeoutInSeconds = 0;
+  request->_numWorkers = 1;
+  request->_connection = connection;
+  request->_manager = NULL;
+  request->_cancelled = false;
+
+  for (const auto &argument : arguments) {
+    if (argument.contains("=")) {
+      unsigned separator = argument.find("=");
+      String key = argument.substring(0, separator);
+      String value =
+          argument.substring(separator + 1, argument.length() - separator - 1);
+      if (key == "timeout")
+        request->_timeoutInSeconds = atoi(value.ascii());
+      else if (key == "workers")
+        request->_numWorkers = atoi(value.ascii());
+      else if (key == "hint")
+        request->_hintPath = value;
+      else {
+        connection->send(String("error - unknown argument: ") + argument);
+        return;
+      }
+    } else if (request->_queryPath == "") {
+      request->_queryPath = argument;
+    } else {
+      connection->send(String("error - unexpected argument: ") + argument);
+      return;
+    }
+  }
+
+  if (request->_queryPath == "") {
+    connection->send("error - usage: solve <mps file> [timeout=<seconds>] "
+                     "[workers=<n>] [hint=<hint file>]");
+    return;
+  }
+  if (request->_numWorkers == 0) request->_numWorkers = 1;
+  if (request->_numWorkers > _poolSize) request->_numWorkers = _poolSize;
+
+  {
+    // "queued" goes before "started", sent by the thread that takes it
+    std::unique_lock<std::mutex> sendLock = connection->lockSends();
+    unsigned position = 0;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_shuttingDown) {
+        request->_id = _nextRequestId++;
+        _queue.append(request);
+        position = _queue.size();
+      }
+    }
+    if (position == 0) {
+      connection->sendLocked("error - shutting down");
+      return;
+    }
+    connection->sendLocked(Stringf("queued %u %u", request->_id, position));
+  }
+  _requestsChanged.notify_all();
+}
+
+void SolverDaemon::cancelRequest(std::shared_ptr<Connection> connection,
+                                 unsigned id) {
+  String reply = Stringf("error %u no such request", id);
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    bool queued = false;
+    for (auto it = _queue.begin(); it != _queue.end(); ++it) {
+      if ((*it)->_id == id && (*it)->_connection == connection) {
+        _queue.erase(it);
+        reply = Stringf("cancelled %u", id);
+        queued = true;
+        break;
+      }
+    }
+
+    if (!queued && _running.exists(id) &&
+        _running[id]->_connection == connection) {
+      // The solve ends with QUIT_REQUESTED, and is reported as usual
+      Request &request = *_running[id];
+      request._cancelled = true;
+      if (request._manager) request._manager->quitSignal();
+      return;
+    }
+  }
+  connection->send(reply);
+}
+
+void SolverDaemon::cancelRequestsOf(std::shared_ptr<Connection> connection) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (auto it = _queue.begin(); it != _queue.end();) {
+    if ((*it)->_connection == connection)
+      it = _queue.erase(it);
+    else
+      ++it;
+  }
+
+  for (const auto &pair : _running) {
+    Request &request = *pair.second;
+    if (request._connection != connection) continue;
+    request._cancelled = true;
+    if (request._manager) request._manager->quitSignal();
+  }
+}
+
+void SolverDaemon::runRequests() {
+  while (true) {
+    std::shared_ptr<Request> request;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      // The first request waits for enough free slots, and the others wait
+      // for it, so that large requests are not starved by small ones
+      _requestsChanged.wait(lock, [&] {
+        return _shuttingDown ||
+               (!_queue.empty() &&
+                _queue.front()->_numWorkers <= _freeSlots);
+      });
+      if (_shuttingDown) return;
+
+      request = _queue.front();
+      _queue.erase(_queue.begin());
+      _freeSlots -= request->_numWorkers;
+      _running[request->_id] = request;
+    }
+    // Another request may fit in the remaining slots
+    _requestsChanged.notify_all();
+
+    solveRequest(*request);
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _freeSlots += request->_numWorkers;
+      _running.erase(request->_id);
+    }
+    _requestsChanged.notify_all();
+  }
+}
+
+void SolverDaemon::solveRequest(Request &request) {
+  std::shared_ptr<Connection> connection = request._connection;
+  connection->send(Stringf("started %u", request._id));
+
+  try {
+    if (!File::exists(request._queryPath))
+      throw SoyError(SoyError::FILE_DOESNT_EXIST, request._queryPath.ascii());
+
+    struct timespec start = TimeUtils::sampleMicro();
+
+    InputQuery inputQuery;
+    MpsParser mpsParser(request._queryPath);
+    mpsParser.generateQuery(inputQuery);
+
+    DnCManager dncManager(&inputQuery);
+    if (request._hintPath != "") {
+      SolutionHint hint;
+      HintParser(request._hintPath)
+          .generateHint(mpsParser.getVariableNameToVariableIndex(), hint);
+      dncManager.setHint(hint);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      request._manager = &dncManager;
+      // Cancelled while the query was parsed
+      if (request._cancelled) dncManager.quitSignal();
+    }
+
+    try {
+      dncManager.solve(request._timeoutInSeconds, request._numWorkers);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      request._manager = NULL;
+      throw;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      request._manager = NULL;
+    }
+
+    struct timespec end = TimeUtils::sampleMicro();
+    connection->send(Stringf("result %u %s %llu", request._id,
+                             dncManager.getResultString().ascii(),
+                             TimeUtils::timePassed(start, end)));
+
+    if (dncManager.getExitCode() == DnCManager::SAT) {
+      Map<String, double> solution;
+      dncManager.extractSolution(mpsParser, solution);
+      for (const auto &pair : solution)
+        connection->send(Stringf("solution %u ", request._id) + pair.first +
+                         Stringf(" %.10f", pair.second));
+    }
+
+    String statistics = dncManager.getStatisticsAggregator().getJsonReport();
+    statistics.replaceAll("\n", " ");
+    connection->send(Stringf("statistics %u ", request._id) + statistics);
+  } catch (const Error &e) {
+    connection->send(Stringf("error %u %s error %u: ", request._id,
+                             e.getErrorClass(), e.getCode()) +
+                     e.getUserMessage());
+  }
+
+  connection->send(Stringf("done %u", request._id));
+}
+
+void SolverDaemon::reapConnections() {
+  for (auto it = _connections.begin(); it != _connections.end();) {
+    if ((*it)->_finished) {
+      (*it)->_thread.join();
+      it = _connections.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
@@ -0,0 +1,186 @@
+/*********************                                                        */
+/*! \file SolverDaemon.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** A long-running server that solves queries sent over a Unix-domain socket,
+ ** so that a client solving many small queries, e.g., a controller at every
+ ** control period, pays for starting the process and for checking the Gurobi
+ ** license once. The Gurobi environments of finished solves are kept for the
+ ** next ones, see GurobiWrapper::setReuseEnvironments().
+ **
+ ** The protocol is line based. A client sends
+ **
+ **   solve <mps file> [timeout=<seconds>] [workers=<n>] [hint=<hint file>]
+ **   cancel <id>
+ **   shutdown
+ **
+ ** and the daemon answers a solve with
+ **
+ **   queued <id> <position in the queue>
+ **   started <id>
+ **   result <id> <sat/unsat/TIMEOUT/QUIT_REQUESTED/ERROR> <microseconds>
+ **   solution <id> <variable> <value>      (one per variable, if sat)
+ **   statistics <id> <JSON of StatisticsAggregator::getJsonReport()>
+ **   done <id>
+ **
+ ** or with "cancelled <id>" if it is cancelled before it starts, and with
+ ** "error <id or -> <message>" for a failed request. The id is assigned by
+ ** the daemon. The messages of concurrent solves of a client interleave.
+ **
+ ** Each solve takes as many slots of the pool as it has workers, at most the
+ ** size of the pool, and the solves start in order as slots become free. A
+ ** client that disconnects cancels its solves. A running solve is cancelled
+ ** through DnCManager::quitSignal().
+ **/
+
+#ifndef __SolverDaemon_h__
+#define __SolverDaemon_h__
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "List.h"
+#include "MString.h"
+#include "Map.h"
+#include "SignalHandler.h"
+
+class DnCManager;
+
+class SolverDaemon : public SignalHandler::Signalable {
+ public:
+  SolverDaemon(const String &socketPath, unsigned poolSize);
+  ~SolverDaemon();
+
+  /*
+    Listen on the socket and serve the clients until shutdown() is called,
+    a client sends "shutdown" or the process receives SIGTERM. Throws a
+    CommonError if the socket cannot be set up.
+  */
+  void run();
+
+  /*
+    Stop accepting clients and cancel all solves. Safe to call from a signal
+    handler.
+  */
+  void shutdown();
+
+  void quitSignal() { shutdown(); }
+
+  unsigned getPoolSize() const { return _poolSize; }
+
+ private:
+  class Connection {
+   public:
+    Connection(int descriptor);
+    ~Connection();
+
+    /*
+      The next line sent by the client, without the line separator. Return
+      false once the client disconnects.
+    */
+    bool readLine(String &line);
+
+    /*
+      Send a line to the client. Lines sent from different threads do not
+      interleave. Lost if the client has disconnected.
+    */
+    void send(const String &line);
+
+    /*
+      Hold back the lines of other threads, e.g., to order a reply before
+      the messages its request leads to. The lines of the caller are sent
+      with sendLocked() meanwhile.
+    */
+    std::unique_lock<std::mutex> lockSends() {
+      return std::unique_lock<std::mutex>(_sendMutex);
+    }
+    void sendLocked(const String &line);
+
+    // Wake up a readLine() blocked in another thread
+    void close();
+
+    std::thread _thread;
+    std::atomic_bool _finished;
+
+   private:
+    int _descriptor;
+    std::string _readBuffer;
+    std::mutex _sendMutex;
+  };
+
+  struct Request {
+    unsigned _id;
+    String _queryPath;
+    String _hintPath;
+    unsigned _timeoutInSeconds;
+    unsigned _numWorkers;
+    std::shared_ptr<Connection> _connection;
+
+    // Set while the request is being solved, guarded by _mutex
+    DnCManager *_manager;
+    bool _cancelled;
+  };
+
+  String _socketPath;
+  unsigned _poolSize;
+  int _listeningDescriptor;
+  std::atomic_bool _shuttingDown;
+
+  /*
+    Guards everything below. No line is sent while it is held, as a client
+    that does not read would block the daemon.
+  */
+  std::mutex _mutex;
+  std::condition_variable _requestsChanged;
+
+  unsigned _nextRequestId;
+  unsigned _freeSlots;
+  List<std::shared_ptr<Request>> _queue;
+  Map<unsigned, std::shared_ptr<Request>> _running;
+  List<std::shared_ptr<Connection>> _connections;
+
+  std::list<std::thread> _runners;
+
+  /*
+    Create, bind and listen on the socket
+  */
+  void openSocket();
+
+  /*
+    Read and execute the commands of a client until it disconnects
+  */
+  void serveConnection(std::shared_ptr<Connection> connection);
+
+  void enqueueRequest(std::shared_ptr<Connection> connection,
+                      const List<String> &arguments);
+  void cancelRequest(std::shared_ptr<Connection> connection, unsigned id);
+  void cancelRequestsOf(std::shared_ptr<Connection> connection);
+
+  /*
+    The loop of a thread of the pool: take the first request of the queue
+    once there are enough free slots, and solve it
+  */
+  void runRequests();
+
+  /*
+    Solve a request and send the result to its client
+  */
+  void solveRequest(Request &request);
+
+  /*
+    Join the connection threads that are done
+  */
+  void reapConnections();
+};
+
+#endif  // __SolverDaemon_h__
@@ -0,0 +1,100 @@
+/*********************                                                        */
+/*! \file Test_BatchSolver.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#include "BatchSolver.h"
+#include "File.h"
+#include "MockErrno.h"
+#include "RealFiles.h"
+#include "SoyError.h"
+
+class MockForBatchSolver : public RealFiles, public MockErrno {};
+
+class BatchSolverTestSuite : public CxxTest::TestSuite {
+ public:
+  MockForBatchSolver *mock;
+
+  void setUp() { TS_ASSERT(mock = new MockForBatchSolver); }
+
+  void tearDown() { TS_ASSERT_THROWS_NOTHING(delete mock); }
+
+  void writeFile(const String &path, const String &contents) {
+    File file(path);
+    file.open(IFile::MODE_WRITE_TRUNCATE);
+    file.write(contents);
+    file.close();
+  }
+
+  void test_percentile() {
+    Vector<unsigned long long> times;
+    TS_ASSERT_EQUALS(BatchSolver::getPercentile(times, 50), 0U);
+
+    for (unsigned long long time : {50, 10, 40, 20, 30}) times.append(time);
+    TS_ASSERT_EQUALS(BatchSolver::getPercentile(times, 0), 10U);
+    TS_ASSERT_EQUALS(BatchSolver::getPercentile(times, 20), 10U);
+    TS_ASSERT_EQUALS(BatchSolver::getPercentile(times, 50), 30U);
+    TS_ASSERT_EQUALS(BatchSolver::getPercentile(times, 90), 50U);
+    TS_ASSERT_EQUALS(BatchSolver::getPercentile(times, 100), 50U);
+  }
+
+  void test_collect_query_paths_of_missing_path() {
+    Vector<String> queryPaths;
+    TS_ASSERT_THROWS_EQUALS(
+        BatchSolver::collectQueryPaths("Test_BatchSolver.missing", queryPaths),
+        const SoyError &e, e.getCode(), SoyError::FILE_DOESNT_EXIST);
+  }
+
+  void test_collect_query_paths_of_directory_and_manifest() {
+    String directory = "Test_BatchSolver.queries";
+    mkdir(directory.ascii(), 0755);
+    for (const auto &name : {"b.mps", "a.mps", "notes.txt", "c.mps.txt"})
+      writeFile(directory + "/" + name, "");
+    writeFile(directory + "/manifest", "# Queries\nb.mps\n\n/tmp/d.mps\n");
+
+    // The .mps files of the directory, sorted by name
+    Vector<String> queryPaths;
+    BatchSolver::collectQueryPaths(directory, queryPaths);
+    TS_ASSERT_EQUALS(queryPaths.size(), 2U);
+    TS_ASSERT_EQUALS(queryPaths[0], directory + "/a.mps");
+    TS_ASSERT_EQUALS(queryPaths[1], directory + "/b.mps");
+
+    // The lines of a manifest, relative to its directory
+    queryPaths.clear();
+    BatchSolver::collectQueryPaths(directory + "/manifest", queryPaths);
+    TS_ASSERT_EQUALS(queryPaths.size(), 2U);
+    TS_ASSERT_EQUALS(queryPaths[0], directory + "/b.mps");
+    TS_ASSERT_EQUALS(queryPaths[1], String("/tmp/d.mps"));
+
+    for (const auto &name :
+         {"b.mps", "a.mps", "notes.txt", "c.mps.txt", "manifest"})
+      remove((directory + "/" + name).ascii());
+    rmdir(directory.ascii());
+  }
+
+  void test_threads_under_core_budget() {
+    Vector<String> queryPaths;
+    for (unsigned i = 0; i < 10; ++i) queryPaths.append("query.mps");
+
+    TS_ASSERT_EQUALS(BatchSolver(queryPaths, 8, 2, 0).getNumberOfThreads(),
+                     4U);
+    TS_ASSERT_EQUALS(BatchSolver(queryPaths, 8, 3, 0).getNumberOfThreads(),
+                     2U);
+    TS_ASSERT_EQUALS(BatchSolver(queryPaths, 2, 4, 0).getNumberOfThreads(),
+                     1U);
+    TS_ASSERT_EQUALS(BatchSolver(queryPaths, 64, 1, 0).getNumberOfThreads(),
+                     10U);
+  }
+};
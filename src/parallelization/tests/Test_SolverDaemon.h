@@ -0,0 +1,237 @@
+/*********************                                                        */
+/*! \file Test_SolverDaemon.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Tests of the protocol of the daemon, through a client on a temporary
+ ** socket
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "File.h"
+#include "MStringf.h"
+#include "MockErrno.h"
+#include "RealFiles.h"
+#include "SolverDaemon.h"
+
+class MockForSolverDaemon : public RealFiles, public MockErrno {};
+
+class Client {
+ public:
+  Client(const String &socketPath) : _descriptor(-1) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.ascii(),
+            sizeof(address.sun_path) - 1);
+
+    // The daemon binds the socket once its thread runs
+    for (unsigned attempt = 0; attempt < 500; ++attempt) {
+      _descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+      if (::connect(_descriptor, (struct sockaddr *)&address,
+                    sizeof(address)) == 0)
+        return;
+      ::close(_descriptor);
+      _descriptor = -1;
+      usleep(10000);
+    }
+  }
+
+  ~Client() {
+    if (_descriptor != -1) ::close(_descriptor);
+  }
+
+  bool connected() const { return _descriptor != -1; }
+
+  void send(const String &line) {
+    String message = line + "\n";
+    TS_ASSERT_EQUALS(
+        ::write(_descriptor, message.ascii(), message.length()),
+        (ssize_t)message.length());
+  }
+
+  // The next line of the daemon, or "" once it disconnects
+  String readLine() {
+    size_t separator;
+    while ((separator = _buffer.find('\n')) == std::string::npos) {
+      char buffer[4096];
+      ssize_t n = ::read(_descriptor, buffer, sizeof(buffer));
+      if (n <= 0) return "";
+      _buffer.append(buffer, n);
+    }
+    String line(_buffer.substr(0, separator).c_str());
+    _buffer.erase(0, separator + 1);
+    return line;
+  }
+
+  // Read up to the "done" line of a request, and return the lines read
+  List<String> readUntilDone(unsigned id) {
+    List<String> lines;
+    String done = Stringf("done %u", id);
+    String line;
+    do {
+      line = readLine();
+      lines.append(line);
+    } while (line != "" && line != done);
+    return lines;
+  }
+
+ private:
+  int _descriptor;
+  std::string _buffer;
+};
+
+class SolverDaemonTestSuite : public CxxTest::TestSuite {
+ public:
+  MockForSolverDaemon *mock;
+  String socketPath;
+  String queryPath;
+  String hintPath;
+
+  void setUp() {
+    TS_ASSERT(mock = new MockForSolverDaemon);
+    socketPath = "Test_SolverDaemon.socket";
+    queryPath = "Test_SolverDaemon.mps";
+    hintPath = "Test_SolverDaemon.hint";
+
+    File file(queryPath);
+    file.open(IFile::MODE_WRITE_TRUNCATE);
+    file.write("NAME      feasible\n"
+               "ROWS\n"
+               " N  obj\n"
+               " L  e1\n"
+               "COLUMNS\n"
+               "    x0        obj       0   e1        1\n"
+               "    x1        obj       0   e1        2\n"
+               "RHS\n"
+               "    rhs       e1        3\n"
+               "BOUNDS\n"
+               " LO bnd       x0        0\n"
+               " UP bnd       x0        1\n"
+               " LO bnd       x1        0\n"
+               " UP bnd       x1        1\n"
+               "ENDATA\n");
+    file.close();
+  }
+
+  void tearDown() {
+    remove(queryPath.ascii());
+    remove(hintPath.ascii());
+    TS_ASSERT_THROWS_NOTHING(delete mock);
+  }
+
+  bool contains(const List<String> &lines, const String &line) {
+    for (const auto &other : lines)
+      if (other == line) return true;
+    return false;
+  }
+
+  bool startsWith(const String &line, const String &prefix) {
+    return line.length() >= prefix.length() &&
+           line.substring(0, prefix.length()) == prefix;
+  }
+
+  bool containsPrefix(const List<String> &lines, const String &prefix) {
+    for (const auto &line : lines)
+      if (startsWith(line, prefix)) return true;
+    return false;
+  }
+
+  void test_protocol() {
+    SolverDaemon daemon(socketPath, 1);
+    std::thread server([&daemon] { daemon.run(); });
+
+    {
+      Client client(socketPath);
+      TS_ASSERT(client.connected());
+
+      // Unknown and malformed commands
+      client.send("hello world");
+      TS_ASSERT_EQUALS(client.readLine(),
+                       String("error - unknown command: hello world"));
+      client.send("solve");
+      TS_ASSERT(startsWith(client.readLine(), "error - usage: solve"));
+      client.send(Stringf("solve %s limit=3", queryPath.ascii()));
+      TS_ASSERT_EQUALS(client.readLine(),
+                       String("error - unknown argument: limit=3"));
+      client.send("cancel 7");
+      TS_ASSERT_EQUALS(client.readLine(), String("error 7 no such request"));
+
+      // A solve
+      client.send(Stringf("solve %s timeout=60", queryPath.ascii()));
+      TS_ASSERT_EQUALS(client.readLine(), String("queued 0 1"));
+      TS_ASSERT_EQUALS(client.readLine(), String("started 0"));
+      List<String> lines = client.readUntilDone(0);
+      TS_ASSERT(containsPrefix(lines, "result 0 sat "));
+      TS_ASSERT(containsPrefix(lines, "solution 0 x0 "));
+      TS_ASSERT(containsPrefix(lines, "solution 0 x1 "));
+      TS_ASSERT(containsPrefix(lines, "statistics 0 {"));
+      TS_ASSERT(contains(lines, "done 0"));
+
+      // A finished request cannot be cancelled
+      client.send("cancel 0");
+      TS_ASSERT_EQUALS(client.readLine(), String("error 0 no such request"));
+
+      // A missing query
+      client.send("solve Test_SolverDaemon.missing");
+      TS_ASSERT_EQUALS(client.readLine(), String("queued 1 1"));
+      TS_ASSERT_EQUALS(client.readLine(), String("started 1"));
+      lines = client.readUntilDone(1);
+      TS_ASSERT(containsPrefix(lines, "error 1 "));
+      TS_ASSERT(contains(lines, "done 1"));
+
+      // The hint is read from a FIFO, which holds the only slot of the pool
+      // until it is written, so that the next request waits in the queue
+      TS_ASSERT_EQUALS(mkfifo(hintPath.ascii(), 0600), 0);
+      client.send(Stringf("solve %s hint=%s", queryPath.ascii(),
+                          hintPath.ascii()));
+      TS_ASSERT_EQUALS(client.readLine(), String("queued 2 1"));
+      TS_ASSERT_EQUALS(client.readLine(), String("started 2"));
+      client.send(Stringf("solve %s", queryPath.ascii()));
+      TS_ASSERT_EQUALS(client.readLine(), String("queued 3 1"));
+
+      // Cancel the queued request, then the running one
+      client.send("cancel 3");
+      TS_ASSERT_EQUALS(client.readLine(), String("cancelled 3"));
+      client.send("cancel 2");
+      // Answered once the previous command is done, as the commands of a
+      // client are executed in order
+      client.send("cancel 9");
+      TS_ASSERT_EQUALS(client.readLine(), String("error 9 no such request"));
+
+      int fifo = ::open(hintPath.ascii(), O_WRONLY);
+      TS_ASSERT(fifo != -1);
+      const char *hint = "# No hint\n";
+      TS_ASSERT_EQUALS(::write(fifo, hint, strlen(hint)),
+                       (ssize_t)strlen(hint));
+      ::close(fifo);
+
+      lines = client.readUntilDone(2);
+      TS_ASSERT(containsPrefix(lines, "result 2 QUIT_REQUESTED "));
+      TS_ASSERT(!containsPrefix(lines, "solution 2 "));
+      TS_ASSERT(contains(lines, "done 2"));
+
+      // Shutdown stops the daemon, which disconnects its clients
+      client.send("shutdown");
+      TS_ASSERT_EQUALS(client.readLine(), String(""));
+    }
+
+    server.join();
+  }
+};
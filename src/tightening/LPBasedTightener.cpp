@@ -103,8 +103,7 @@ unsigned LPBasedTightener::performLPBasedTightening() {
     gurobi.setVerbosity(0);
     milpEncoder.encodeInputQueryForSteps(gurobi, _inputQuery, steps, true);
 
-    List<unsigned> variables = constraint->getParticipatingVariables();
-    for (const auto &variable : variables) {
+    for (const auto &variable : constraint->getParticipatingVariableSpan()) {
       // Tighten lower bound
       if (constraint->participatingVariable(variable)) {
         List<GurobiWrapper::Term> terms;
@@ -0,0 +1,448 @@
+/*********************                                                        */
+/*! \file RootCutGenerator.cpp
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** The separation loop of the root cuts. The relaxation is encoded once in
+ ** a Gurobi model of its own, and the cuts of each round are appended to
+ ** it. The conditional bounds of a group are computed by probing: each
+ ** element is fixed to 1 in turn, and each variable of the rows of the
+ ** group is minimized and maximized. An element whose probe is infeasible
+ ** is fixed to 0, which removes its branch from the search.
+ **/
+
+#include "RootCutGenerator.h"
+
+#include "BoundManager.h"
+#include "FloatUtils.h"
+#include "GlobalConfiguration.h"
+#include "GurobiWrapper.h"
+#include "InfeasibleQueryException.h"
+#include "InputQuery.h"
+#include "MILPEncoder.h"
+#include "Statistics.h"
+#include "TimeUtils.h"
+#include "TypedPLConstraints.h"
+
+namespace {
+// The discrete variables of the constraints, which are not bounded by
+// disjunctive cuts
+struct DiscreteVariableCollector {
+  explicit DiscreteVariableCollector(Set<unsigned> &variables)
+      : _variables(variables) {}
+
+  void operator()(AbsoluteValueConstraint *) {}
+
+  template <class T>
+  void operator()(T *constraint) {
+    for (unsigned variable : constraint->getParticipatingVariableSpan())
+      _variables.insert(variable);
+  }
+
+  Set<unsigned> &_variables;
+};
+
+String variableName(unsigned variable) { return Stringf("x%u", variable); }
+
+// Minimize (sign 1) or maximize (sign -1) the variable on the relaxation:
+// the optimum, an infinite bound if unbounded, or false if infeasible
+bool optimize(GurobiWrapper &gurobi, unsigned variable, int sign,
+              double &bound) {
+  List<GurobiWrapper::Term> terms;
+  terms.append(GurobiWrapper::Term(1, variableName(variable)));
+  if (sign > 0)
+    gurobi.setCost(terms, 0);
+  else
+    gurobi.setObjective(terms, 0);
+  gurobi.solve();
+  if (gurobi.infeasible()) return false;
+  if (gurobi.optimal())
+    bound = gurobi.getObjectiveValue();
+  else
+    bound = sign > 0 ? FloatUtils::negativeInfinity() : FloatUtils::infinity();
+  return true;
+}
+}  // namespace
+
+RootCutGenerator::RootCutGenerator(const BoundManager &boundManager,
+                                   const InputQuery &inputQuery)
+    : _boundManager(boundManager),
+      _inputQuery(inputQuery),
+      _statistics(NULL),
+      _numberOfRounds(0),
+      _numberOfExcludedElements(0),
+      _boundImprovement(0) {
+  initializeGroups();
+}
+
+void RootCutGenerator::initializeGroups() {
+  TypedPLConstraints constraints(_inputQuery.getPLConstraints());
+  Set<unsigned> discreteVariables;
+  DiscreteVariableCollector collector(discreteVariables);
+  constraints.forEach(collector);
+
+  for (const auto &oneHot : constraints.getOneHotConstraints()) {
+    Group group;
+    for (const auto &element : oneHot->getElements()) {
+      _groupOfElement[element] = _groups.size();
+      group._elements.append(element);
+    }
+    _groups.append(group);
+  }
+
+  // The continuous variables of the rows of the elements of each group
+  Vector<Set<unsigned>> variablesOfGroup(_groups.size());
+  for (const auto &equation : _inputQuery.getEquations()) {
+    Set<unsigned> groups;
+    for (const auto &addend : equation._addends)
+      if (_groupOfElement.exists(addend._variable))
+        groups.insert(_groupOfElement[addend._variable]);
+    if (groups.empty()) continue;
+    for (const auto &addend : equation._addends)
+      if (!discreteVariables.exists(addend._variable))
+        for (const auto &group : groups)
+          variablesOfGroup[group].insert(addend._variable);
+  }
+
+  for (unsigned i = 0; i < _groups.size(); ++i) {
+    Group &group = _groups[i];
+    for (const auto &variable : variablesOfGroup[i])
+      group._variables.append(variable);
+    unsigned numberOfElements = group._elements.size();
+    group._lowerBounds = Vector<Vector<double>>(
+        numberOfElements,
+        Vector<double>(group._variables.size(), FloatUtils::negativeInfinity()));
+    group._upperBounds = Vector<Vector<double>>(
+        numberOfElements,
+        Vector<double>(group._variables.size(), FloatUtils::infinity()));
+    group._feasible = Vector<char>(numberOfElements, 1);
+  }
+}
+
+void RootCutGenerator::addLemmas(const List<Vector<PhaseStatus>> &lemmas) {
+  Vector<PLConstraint *> constraints;
+  for (const auto &constraint : _inputQuery.getPLConstraints())
+    constraints.append(constraint);
+
+  // As in Engine::addAllLemmasToSatSolver(), each lemma applies to every
+  // window of consecutive constraints
+  for (const auto &lemma : lemmas) {
+    if (lemma.size() > 2) continue;
+    for (unsigned i = 0; i + lemma.size() <= constraints.size(); ++i) {
+      Vector<unsigned> elements;
+      for (unsigned j = 0; j < lemma.size(); ++j) {
+        PLConstraint *constraint = constraints[i + j];
+        if (constraint->getType() != PiecewiseLinearFunctionType::ONE_HOT)
+          break;
+        elements.append(static_cast<OneHotConstraint *>(constraint)
+                            ->getElementOfPhase(lemma[j]));
+      }
+      if (elements.size() != lemma.size()) continue;
+
+      if (elements.size() == 1) {
+        _excludedElements.insert(elements[0]);
+      } else if (elements[0] != elements[1]) {
+        _conflicts[elements[0]].insert(elements[1]);
+        _conflicts[elements[1]].insert(elements[0]);
+      }
+    }
+  }
+}
+
+void RootCutGenerator::generateCuts(unsigned maxRounds, List<Equation> &cuts) {
+  struct timespec start = TimeUtils::sampleMicro();
+
+  GurobiWrapper gurobi;
+  MILPEncoder encoder(_boundManager);
+  encoder.encodeInputQuery(gurobi, _inputQuery, true);
+  gurobi.updateModel();
+
+  unsigned numberOfVariables = _inputQuery.getNumberOfVariables();
+  unsigned numberOfCuts = 0;
+  double initialWidth = 0;
+  double width = 0;
+  _numberOfRounds = 0;
+  _numberOfExcludedElements = 0;
+  _boundImprovement = 0;
+  _separatedCliques.clear();
+
+  // The lemmas of one phase hold regardless of the relaxation
+  List<Equation> exclusionCuts;
+  for (const auto &element : _excludedElements)
+    addExclusionCut(element, exclusionCuts);
+  for (const auto &cut : exclusionCuts) {
+    encoder.encodeEquation(gurobi, cut);
+    cuts.append(cut);
+    ++numberOfCuts;
+  }
+
+  while (_numberOfRounds < maxRounds) {
+    gurobi.setCost(List<GurobiWrapper::Term>(), 0);
+    gurobi.solve();
+    if (gurobi.infeasible()) throw InfeasibleQueryException();
+    if (!gurobi.haveFeasibleSolution()) break;
+    _point.clear();
+    for (unsigned i = 0; i < numberOfVariables; ++i)
+      _point.append(gurobi.getAssignment(variableName(i)));
+
+    // Only a fractional group can have a violated disjunctive cut, as its
+    // conditional bounds hold at the solution otherwise
+    List<Equation> roundCuts;
+    for (auto &group : _groups) {
+      if (_numberOfRounds > 0 && !isFractional(group)) continue;
+      probeGroup(gurobi, group);
+      excludeInfeasibleElements(group, roundCuts);
+      separateGroupCuts(group, roundCuts);
+    }
+    separateCliqueCuts(roundCuts);
+    ++_numberOfRounds;
+
+    double previousWidth = width;
+    width = getTotalWidth();
+    if (_numberOfRounds == 1) initialWidth = width;
+
+    for (const auto &cut : roundCuts) {
+      encoder.encodeEquation(gurobi, cut);
+      cuts.append(cut);
+      ++numberOfCuts;
+    }
+    gurobi.updateModel();
+
+    if (roundCuts.empty()) break;
+    // The width only measures the progress if there are conditional bounds
+    if (_numberOfRounds > 1 && previousWidth > 0 &&
+        previousWidth - width <=
+            GlobalConfiguration::ROOT_CUT_STALL_IMPROVEMENT * previousWidth)
+      break;
+  }
+
+  List<Equation> boundCuts;
+  addImpliedBoundCuts(boundCuts);
+  numberOfCuts += boundCuts.size();
+  cuts.append(boundCuts);
+  _boundImprovement = initialWidth - width;
+
+  if (_statistics) {
+    _statistics->setUnsignedAttribute(Statistics::NUM_ROOT_CUTS,
+                                      numberOfCuts);
+    _statistics->setUnsignedAttribute(Statistics::NUM_ROOT_CUT_ROUNDS,
+                                      _numberOfRounds);
+    _statistics->setUnsignedAttribute(
+        Statistics::NUM_ROOT_CUT_EXCLUDED_ELEMENTS, _numberOfExcludedElements);
+    _statistics->setDoubleAttribute(Statistics::ROOT_CUT_BOUND_IMPROVEMENT,
+                                    _boundImprovement);
+    struct timespec end = TimeUtils::sampleMicro();
+    _statistics->incLongAttribute(Statistics::TIME_ROOT_CUTS_MICRO,
+                                  TimeUtils::timePassed(start, end));
+  }
+}
+
+bool RootCutGenerator::isFractional(const Group &group) const {
+  for (const auto &element : group._elements)
+    if (!FloatUtils::isZero(_point[element],
+                            GlobalConfiguration::ROOT_CUT_MIN_VIOLATION) &&
+        !FloatUtils::areEqual(_point[element], 1,
+                              GlobalConfiguration::ROOT_CUT_MIN_VIOLATION))
+      return true;
+  return false;
+}
+
+void RootCutGenerator::probeGroup(GurobiWrapper &gurobi, Group &group) {
+  for (unsigned k = 0; k < group._elements.size(); ++k) {
+    unsigned element = group._elements[k];
+    if (!group._feasible[k]) continue;
+    if (FloatUtils::lt(_boundManager.getUpperBound(element), 1)) {
+      group._feasible[k] = false;
+      continue;
+    }
+
+    String name = variableName(element);
+    double lowerBound = gurobi.getLowerBound(name);
+    gurobi.setLowerBound(name, 1);
+
+    if (group._variables.empty()) {
+      gurobi.setCost(List<GurobiWrapper::Term>(), 0);
+      gurobi.solve();
+      if (gurobi.infeasible()) group._feasible[k] = false;
+    }
+
+    for (unsigned j = 0; j < group._variables.size(); ++j) {
+      unsigned variable = group._variables[j];
+      if (!optimize(gurobi, variable, 1, group._lowerBounds[k][j]) ||
+          !optimize(gurobi, variable, -1, group._upperBounds[k][j])) {
+        group._feasible[k] = false;
+        break;
+      }
+    }
+
+    gurobi.setLowerBound(name, lowerBound);
+    gurobi.updateModel();
+  }
+
+  // Over the elements that can be 1, the range of each variable
+  for (unsigned j = 0; j < group._variables.size(); ++j) {
+    double lower = FloatUtils::infinity();
+    double upper = FloatUtils::negativeInfinity();
+    for (unsigned k = 0; k < group._elements.size(); ++k) {
+      if (!group._feasible[k]) continue;
+      lower = FloatUtils::min(lower, group._lowerBounds[k][j]);
+      upper = FloatUtils::max(upper, group._upperBounds[k][j]);
+    }
+
+    unsigned variable = group._variables[j];
+    if (!_impliedLowerBounds.exists(variable) ||
+        _impliedLowerBounds[variable] < lower)
+      _impliedLowerBounds[variable] = lower;
+    if (!_impliedUpperBounds.exists(variable) ||
+        _impliedUpperBounds[variable] > upper)
+      _impliedUpperBounds[variable] = upper;
+  }
+}
+
+void RootCutGenerator::addExclusionCut(unsigned element,
+                                       List<Equation> &cuts) {
+  if (FloatUtils::isZero(_boundManager.getUpperBound(element))) return;
+  Equation cut(Equation::LE);
+  cut.addAddend(1, element);
+  cut.setScalar(0);
+  cuts.append(cut);
+  ++_numberOfExcludedElements;
+}
+
+void RootCutGenerator::excludeInfeasibleElements(const Group &group,
+                                                 List<Equation> &cuts) {
+  // Added even if the solution satisfies them, as they spare the search
+  // the branches of the elements
+  for (unsigned k = 0; k < group._elements.size(); ++k) {
+    unsigned element = group._elements[k];
+    if (group._feasible[k] || _excludedElements.exists(element)) continue;
+    _excludedElements.insert(element);
+    addExclusionCut(element, cuts);
+  }
+}
+
+void RootCutGenerator::separateGroupCuts(const Group &group,
+                                         List<Equation> &cuts) const {
+  // sum_k L_k d_k <= x <= sum_k U_k d_k over the elements that can be 1
+  for (unsigned j = 0; j < group._variables.size(); ++j) {
+    Equation lowerCut(Equation::GE);
+    Equation upperCut(Equation::LE);
+    bool lowerCutFinite = true;
+    bool upperCutFinite = true;
+    for (unsigned k = 0; k < group._elements.size(); ++k) {
+      if (!group._feasible[k]) continue;
+      double lower = group._lowerBounds[k][j];
+      double upper = group._upperBounds[k][j];
+      if (!FloatUtils::isFinite(lower)) lowerCutFinite = false;
+      if (!FloatUtils::isFinite(upper)) upperCutFinite = false;
+      if (lowerCutFinite && !FloatUtils::isZero(lower))
+        lowerCut.addAddend(-lower, group._elements[k]);
+      if (upperCutFinite && !FloatUtils::isZero(upper))
+        upperCut.addAddend(-upper, group._elements[k]);
+    }
+
+    unsigned variable = group._variables[j];
+    lowerCut.addAddend(1, variable);
+    lowerCut.setScalar(0);
+    upperCut.addAddend(1, variable);
+    upperCut.setScalar(0);
+    if (lowerCutFinite && isViolated(lowerCut)) cuts.append(lowerCut);
+    if (upperCutFinite && isViolated(upperCut)) cuts.append(upperCut);
+  }
+}
+
+void RootCutGenerator::separateCliqueCuts(List<Equation> &cuts) {
+  for (const auto &pair : _conflicts) {
+    unsigned element = pair.first;
+    if (FloatUtils::isZero(_point[element],
+                           GlobalConfiguration::ROOT_CUT_MIN_VIOLATION))
+      continue;
+
+    // The conflicting elements of each other group are pairwise exclusive,
+    // so they form a clique with the element
+    Map<unsigned, Set<unsigned>> conflictsByGroup;
+    for (const auto &other : pair.second)
+      conflictsByGroup[_groupOfElement[other]].insert(other);
+
+    const Group &group = _groups[_groupOfElement[element]];
+    for (const auto &entry : conflictsByGroup) {
+      Set<unsigned> clique = entry.second;
+      clique.insert(element);
+
+      // Extend it with the elements of the group of the element that
+      // conflict with all of them
+      for (const auto &sibling : group._elements) {
+        if (sibling == element || !_conflicts.exists(sibling)) continue;
+        bool conflicting = true;
+        for (const auto &other : entry.second)
+          if (!_conflicts[sibling].exists(other)) conflicting = false;
+        if (conflicting) clique.insert(sibling);
+      }
+
+      if (_separatedCliques.exists(clique)) continue;
+      Equation cut(Equation::LE);
+      for (const auto &variable : clique) cut.addAddend(1, variable);
+      cut.setScalar(1);
+      if (isViolated(cut)) {
+        _separatedCliques.insert(clique);
+        cuts.append(cut);
+      }
+    }
+  }
+}
+
+void RootCutGenerator::addImpliedBoundCuts(List<Equation> &cuts) const {
+  for (const auto &pair : _impliedLowerBounds) {
+    unsigned variable = pair.first;
+    if (FloatUtils::isFinite(pair.second) &&
+        FloatUtils::gt(pair.second, _boundManager.getLowerBound(variable),
+                       GlobalConfiguration::ROOT_CUT_MIN_VIOLATION)) {
+      Equation cut(Equation::GE);
+      cut.addAddend(1, variable);
+      cut.setScalar(pair.second);
+      cuts.append(cut);
+    }
+  }
+  for (const auto &pair : _impliedUpperBounds) {
+    unsigned variable = pair.first;
+    if (FloatUtils::isFinite(pair.second) &&
+        FloatUtils::lt(pair.second, _boundManager.getUpperBound(variable),
+                       GlobalConfiguration::ROOT_CUT_MIN_VIOLATION)) {
+      Equation cut(Equation::LE);
+      cut.addAddend(1, variable);
+      cut.setScalar(pair.second);
+      cuts.append(cut);
+    }
+  }
+}
+
+double RootCutGenerator::getTotalWidth() const {
+  double width = 0;
+  for (const auto &pair : _impliedLowerBounds) {
+    unsigned variable = pair.first;
+    double upper = _impliedUpperBounds.get(variable);
+    if (FloatUtils::isFinite(pair.second) && FloatUtils::isFinite(upper) &&
+        upper > pair.second)
+      width += upper - pair.second;
+  }
+  return width;
+}
+
+bool RootCutGenerator::isViolated(const Equation &cut) const {
+  double value = 0;
+  for (const auto &addend : cut._addends)
+    value += addend._coefficient * _point[addend._variable];
+  switch (cut._type) {
+    case Equation::LE:
+      return value > cut._scalar + GlobalConfiguration::ROOT_CUT_MIN_VIOLATION;
+    case Equation::GE:
+      return value < cut._scalar - GlobalConfiguration::ROOT_CUT_MIN_VIOLATION;
+    default:
+      return !FloatUtils::areEqual(value, cut._scalar,
+                                   GlobalConfiguration::ROOT_CUT_MIN_VIOLATION);
+  }
+}
@@ -0,0 +1,142 @@
+/*********************                                                        */
+/*! \file RootCutGenerator.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Cuts that strengthen the LP relaxation of a query at the root, before
+ ** the search. They target the one-hot structure of PWA encodings, whose
+ ** big-M rows are loose when the mode binaries are fractional:
+ **
+ **   - disjunctive cuts: the bounds [L_k, U_k] of a variable x when the
+ **     element d_k of a one-hot group is 1 are computed on the relaxation,
+ **     and, as exactly one element is 1, sum_k L_k d_k <= x <= sum_k U_k d_k,
+ **   - implied-bound cuts: d_k <= 0 when the relaxation is infeasible with
+ **     d_k = 1 or when a lemma of one phase excludes d_k, which removes the
+ **     branch of d_k from the search, and the bounds of x implied by its
+ **     conditional bounds, and
+ **   - clique cuts: the sum of elements that pairwise cannot be 1, by the
+ **     one-hot groups and the lemmas of two phases, is at most 1.
+ **
+ ** Each round solves the relaxation and adds the cuts its solution
+ ** violates, re-computing the conditional bounds of the groups left
+ ** fractional. The loop stops when no cut is violated, after a number of
+ ** rounds, or when the width of the conditional bounds stalls.
+ **
+ ** The cuts are valid under the bounds they were computed with.
+ **/
+
+#ifndef __RootCutGenerator_h__
+#define __RootCutGenerator_h__
+
+#include "Equation.h"
+#include "List.h"
+#include "Map.h"
+#include "PLConstraint.h"
+#include "Set.h"
+#include "Vector.h"
+
+class BoundManager;
+class GurobiWrapper;
+class InputQuery;
+class Statistics;
+
+class RootCutGenerator {
+ public:
+  RootCutGenerator(const BoundManager &boundManager,
+                   const InputQuery &inputQuery);
+
+  void setStatistics(Statistics *statistics) { _statistics = statistics; }
+
+  /*
+    Take the lemmas over windows of consecutive constraints of the query,
+    see Engine::computeInitialPattern(). Those of one or two one-hot
+    constraints give implied-bound and clique cuts.
+  */
+  void addLemmas(const List<Vector<PhaseStatus>> &lemmas);
+
+  /*
+    Run at most maxRounds rounds of separation and append the cuts, over
+    the variables of the query. Throws InfeasibleQueryException if the
+    relaxation is infeasible.
+  */
+  void generateCuts(unsigned maxRounds, List<Equation> &cuts);
+
+  unsigned getNumberOfRounds() const { return _numberOfRounds; }
+
+  /*
+    The elements of the groups fixed to 0 by the cuts
+  */
+  unsigned getNumberOfExcludedElements() const {
+    return _numberOfExcludedElements;
+  }
+
+  /*
+    How much the cuts shrank the total width of the conditional bounds
+  */
+  double getBoundImprovement() const { return _boundImprovement; }
+
+ private:
+  // A one-hot group, and the variables of the rows of its elements
+  struct Group {
+    Vector<unsigned> _elements;
+    Vector<unsigned> _variables;
+
+    // By element, then by variable: the bounds of the variable when the
+    // element is 1
+    Vector<Vector<double>> _lowerBounds;
+    Vector<Vector<double>> _upperBounds;
+    // By element: whether the relaxation is feasible with the element 1
+    Vector<char> _feasible;
+  };
+
+  const BoundManager &_boundManager;
+  const InputQuery &_inputQuery;
+  Statistics *_statistics;
+
+  Vector<Group> _groups;
+  Map<unsigned, unsigned> _groupOfElement;
+
+  // The elements that cannot be 1, and the pairs that cannot both be 1
+  Set<unsigned> _excludedElements;
+  Map<unsigned, Set<unsigned>> _conflicts;
+  Set<Set<unsigned>> _separatedCliques;
+
+  // The solution of the relaxation in the current round
+  Vector<double> _point;
+
+  // By variable: the bounds implied by the conditional bounds of its groups
+  Map<unsigned, double> _impliedLowerBounds;
+  Map<unsigned, double> _impliedUpperBounds;
+
+  unsigned _numberOfRounds;
+  unsigned _numberOfExcludedElements;
+  double _boundImprovement;
+
+  void initializeGroups();
+
+  bool isFractional(const Group &group) const;
+
+  /*
+    Compute the conditional bounds of the variables of the group
+  */
+  void probeGroup(GurobiWrapper &gurobi, Group &group);
+
+  // Fix to 0 an element that cannot be 1, unless its bounds already do
+  void addExclusionCut(unsigned element, List<Equation> &cuts);
+  void excludeInfeasibleElements(const Group &group, List<Equation> &cuts);
+  void separateGroupCuts(const Group &group, List<Equation> &cuts) const;
+  void separateCliqueCuts(List<Equation> &cuts);
+  void addImpliedBoundCuts(List<Equation> &cuts) const;
+
+  // The total width of the implied bounds, over the variables with finite
+  // ones
+  double getTotalWidth() const;
+
+  bool isViolated(const Equation &cut) const;
+};
+
+#endif  // __RootCutGenerator_h__
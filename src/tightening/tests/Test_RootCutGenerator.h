@@ -0,0 +1,190 @@
+/*********************                                                        */
+/*! \file Test_RootCutGenerator.h
+ ** \verbatim
+ ** This file is part of the Soy project.
+ ** Copyright (c) 2023 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** Tests of the root cuts on a small PWA query in big-M form
+**/
+
+#include <cxxtest/TestSuite.h>
+
+#include "BoundManager.h"
+#include "FloatUtils.h"
+#include "InfeasibleQueryException.h"
+#include "InputQuery.h"
+#include "OneHotConstraint.h"
+#include "RootCutGenerator.h"
+#include "Statistics.h"
+
+class RootCutGeneratorTestSuite : public CxxTest::TestSuite {
+ public:
+  void setUp() {}
+
+  void tearDown() {}
+
+  void addRow(InputQuery &inputQuery, Equation::EquationType type,
+              double coefficientOfX, double coefficientOfElement,
+              unsigned element, double scalar) {
+    Equation equation(type);
+    equation.addAddend(coefficientOfX, 3);
+    equation.addAddend(coefficientOfElement, element);
+    equation.setScalar(scalar);
+    inputQuery.addEquation(equation);
+  }
+
+  void populateInputQuery(InputQuery &inputQuery, BoundManager &bm,
+                          CVC4::context::Context &context) {
+    // OneHot (x0, x1, x2), x3 is between -20 and 20
+    //
+    // x0 = 1 -> -3 <= x3 <= 2, by the big-M rows
+    //   x3 + 18 x0 <= 20, x3 - 17 x0 >= -20
+    // x1 = 1 -> 5 <= x3 <= 7, by the big-M rows
+    //   x3 + 13 x1 <= 20, x3 - 25 x1 >= -20
+    // x2 = 1 -> x3 >= 30, which its bounds exclude, by the big-M row
+    //   x3 - 50 x2 >= -20
+    inputQuery.setNumberOfVariables(4);
+    for (unsigned i = 0; i < 3; ++i) {
+      inputQuery.setLowerBound(i, 0);
+      inputQuery.setUpperBound(i, 1);
+    }
+    inputQuery.setLowerBound(3, -20);
+    inputQuery.setUpperBound(3, 20);
+
+    inputQuery.addPLConstraint(new OneHotConstraint({0, 1, 2}));
+    for (const auto &plConstraint : inputQuery.getPLConstraints())
+      plConstraint->initializeCDOs(&context);
+
+    Equation oneHot;
+    oneHot.addAddend(1, 0);
+    oneHot.addAddend(1, 1);
+    oneHot.addAddend(1, 2);
+    oneHot.setScalar(1);
+    inputQuery.addEquation(oneHot);
+
+    addRow(inputQuery, Equation::LE, 1, 18, 0, 20);
+    addRow(inputQuery, Equation::GE, 1, -17, 0, -20);
+    addRow(inputQuery, Equation::LE, 1, 13, 1, 20);
+    addRow(inputQuery, Equation::GE, 1, -25, 1, -20);
+    addRow(inputQuery, Equation::GE, 1, -50, 2, -20);
+
+    bm.initialize(inputQuery.getNumberOfVariables());
+    for (unsigned i = 0; i < inputQuery.getNumberOfVariables(); ++i) {
+      bm.setLowerBound(i, inputQuery.getLowerBound(i));
+      bm.setUpperBound(i, inputQuery.getUpperBound(i));
+    }
+  }
+
+  bool hasBoundCut(const List<Equation> &cuts, unsigned variable,
+                   Equation::EquationType type, double scalar) {
+    for (const auto &cut : cuts)
+      if (cut._addends.size() == 1 && cut._type == type &&
+          cut._addends.begin()->_variable == variable &&
+          FloatUtils::areEqual(cut._addends.begin()->_coefficient, 1) &&
+          FloatUtils::areEqual(cut._scalar, scalar, 0.0001))
+        return true;
+    return false;
+  }
+
+  bool holds(const Equation &cut, const Vector<double> &point) {
+    double value = 0;
+    for (const auto &addend : cut._addends)
+      value += addend._coefficient * point[addend._variable];
+    if (cut._type == Equation::LE)
+      return FloatUtils::lte(value, cut._scalar, 0.0001);
+    if (cut._type == Equation::GE)
+      return FloatUtils::gte(value, cut._scalar, 0.0001);
+    return FloatUtils::areEqual(value, cut._scalar, 0.0001);
+  }
+
+  void test_implied_bound_cuts() {
+    InputQuery inputQuery;
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    populateInputQuery(inputQuery, bm, context);
+
+    Statistics statistics;
+    RootCutGenerator generator(bm, inputQuery);
+    generator.setStatistics(&statistics);
+    List<Equation> cuts;
+    TS_ASSERT_THROWS_NOTHING(generator.generateCuts(5, cuts));
+
+    // The probe of x2 is infeasible, and the others bound x3 to [-3, 7]
+    TS_ASSERT(hasBoundCut(cuts, 2, Equation::LE, 0));
+    TS_ASSERT(hasBoundCut(cuts, 3, Equation::GE, -3));
+    TS_ASSERT(hasBoundCut(cuts, 3, Equation::LE, 7));
+    TS_ASSERT_EQUALS(generator.getNumberOfExcludedElements(), 1u);
+    TS_ASSERT(generator.getNumberOfRounds() >= 1);
+
+    TS_ASSERT_EQUALS(
+        statistics.getUnsignedAttribute(Statistics::NUM_ROOT_CUTS),
+        cuts.size());
+    TS_ASSERT_EQUALS(statistics.getUnsignedAttribute(
+                         Statistics::NUM_ROOT_CUT_EXCLUDED_ELEMENTS),
+                     1u);
+  }
+
+  void test_cuts_keep_the_solutions() {
+    InputQuery inputQuery;
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    populateInputQuery(inputQuery, bm, context);
+
+    RootCutGenerator generator(bm, inputQuery);
+    List<Equation> cuts;
+    TS_ASSERT_THROWS_NOTHING(generator.generateCuts(5, cuts));
+    TS_ASSERT(!cuts.empty());
+
+    // The disjunctive cuts, as all others, hold in each mode
+    Vector<double> firstMode = {1, 0, 0, -3};
+    Vector<double> secondMode = {0, 1, 0, 7};
+    for (const auto &cut : cuts) {
+      TS_ASSERT(holds(cut, firstMode));
+      TS_ASSERT(holds(cut, secondMode));
+    }
+  }
+
+  void test_lemma_of_one_phase() {
+    InputQuery inputQuery;
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    populateInputQuery(inputQuery, bm, context);
+
+    // A lemma excluding x1, leaving x3 in [-3, 2]
+    OneHotConstraint *oneHot = static_cast<OneHotConstraint *>(
+        *inputQuery.getPLConstraints().begin());
+    List<Vector<PhaseStatus>> lemmas;
+    lemmas.append(Vector<PhaseStatus>({oneHot->getPhaseOfElement(1)}));
+
+    RootCutGenerator generator(bm, inputQuery);
+    generator.addLemmas(lemmas);
+    List<Equation> cuts;
+    TS_ASSERT_THROWS_NOTHING(generator.generateCuts(5, cuts));
+
+    TS_ASSERT(hasBoundCut(cuts, 1, Equation::LE, 0));
+    TS_ASSERT(hasBoundCut(cuts, 2, Equation::LE, 0));
+    TS_ASSERT(hasBoundCut(cuts, 3, Equation::LE, 2));
+    TS_ASSERT_EQUALS(generator.getNumberOfExcludedElements(), 2u);
+  }
+
+  void test_infeasible_relaxation() {
+    InputQuery inputQuery;
+    CVC4::context::Context context;
+    BoundManager bm(context);
+    populateInputQuery(inputQuery, bm, context);
+
+    // x3 >= 25, above its upper bound
+    Equation equation(Equation::GE);
+    equation.addAddend(1, 3);
+    equation.setScalar(25);
+    inputQuery.addEquation(equation);
+
+    RootCutGenerator generator(bm, inputQuery);
+    List<Equation> cuts;
+    TS_ASSERT_THROWS(generator.generateCuts(5, cuts),
+                     const InfeasibleQueryException &);
+  }
+};